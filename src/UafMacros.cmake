@@ -32,6 +32,12 @@ MACRO(handleOptions)
 
     OPTION( BUILD_WITH_MULTIPLE_PROCESSES   "Set to ON if you want to build the UAF with multiple processes" OFF )
 
+    OPTION( UAF_WITH_DEBUG_LOGGING  "Set to OFF if you want to strip all debug logging from the UAF at compile time" ON )
+
+    IF ( NOT UAF_WITH_DEBUG_LOGGING )
+        ADD_DEFINITIONS( -DUAF_NO_DEBUG_LOGGING )
+    ENDIF ( NOT UAF_WITH_DEBUG_LOGGING )
+
 ENDMACRO(handleOptions)
 
 # ----------------------------------------------------------------------------
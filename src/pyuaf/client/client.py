@@ -24,9 +24,107 @@
 
 from pyuaf.client.requests import __getElementFromKwargs__
 
+
+class __NotificationDispatcher__(object):
+    """
+    A fixed-size pool of worker threads that call the notification callback functions.
+
+    The notifications of a single publish are grouped per callback function, and each group
+    ("batch") is handled as a single job: the callback function is called for each notification
+    of the batch in turn, by the same worker thread. The jobs are stored in a bounded queue: if
+    the queue is full, the thread that delivers the notifications is blocked until there is room
+    again.
+
+    If ordered is True, all notifications of the same clientHandle are handled by the same
+    worker thread, so they are delivered in the order in which they were received.
+    """
+
+    def __init__(self, noOfThreads, maxQueueSize, ordered):
+        noOfThreads = max(1, noOfThreads)
+
+        self.__ordered__ = ordered
+
+        # in case of ordered delivery, each worker thread has its own queue
+        if ordered:
+            self.__queues__ = [ queue.Queue(maxQueueSize) for i in range(noOfThreads) ]
+        else:
+            self.__queues__ = [ queue.Queue(maxQueueSize) ]
+
+        # the worker threads should not prevent the interpreter from exiting
+        self.__threads__ = []
+        for i in range(noOfThreads):
+            q = self.__queues__[i % len(self.__queues__)]
+            t = threading.Thread(target=__NotificationDispatcher__.__work__, args=[q])
+            t.daemon = True
+            t.start()
+            self.__threads__.append((t, q))
+
+    @staticmethod
+    def __work__(q):
+        while True:
+            job = q.get()
+            if job is None:
+                break
+            f, notifications = job
+            for notification in notifications:
+                try:
+                    f(notification)
+                except Exception:
+                    # print the traceback, like the thread that used to call each callback
+                    # function did, and continue with the next notification
+                    traceback.print_exc()
+
+    def createBatches(self):
+        """
+        Create an empty dictionary to collect the batches of a single publish.
+        """
+        return dict()
+
+    def addToBatches(self, batches, f, notification):
+        """
+        Add a notification for the callback function f to the batches.
+        """
+        if self.__ordered__:
+            qIndex = notification.clientHandle % len(self.__queues__)
+        else:
+            qIndex = 0
+
+        # bound methods are created again for each attribute access, so preferably compare
+        # the callback functions by value
+        try:
+            key = (f, qIndex)
+            hash(key)
+        except TypeError:
+            key = (id(f), qIndex)
+
+        try:
+            batches[key][1].append(notification)
+        except KeyError:
+            batches[key] = (f, [notification])
+
+    def dispatch(self, batches):
+        """
+        Put the batches in the queues (blocking if the queues are full).
+        """
+        for key, job in batches.items():
+            self.__queues__[key[1]].put(job)
+
+    def stop(self):
+        """
+        Let the worker threads finish, after the jobs that are queued already.
+        """
+        for t, q in self.__threads__:
+            try:
+                q.put_nowait(None)
+            except queue.Full:
+                pass # the (daemon) thread will be stopped when the interpreter exits
+
+
+
 class Client(ClientBase):
 
-    def __init__(self, settings=None, loggingCallback=None):
+    def __init__(self, settings=None, loggingCallback=None,
+                 notificationThreads=4, notificationQueueSize=1000, orderedNotifications=False):
         """
         Construct a UAF client.
 
@@ -44,6 +142,21 @@ class Client(ClientBase):
         :param callback: A callback function for the logging. This function should have one
                          input argument, which you should call "msg" or so,
                          because this argument is of type :class:`pyuaf.util.LogMessage`.
+        :param notificationThreads: The number of threads that call the notification callback
+                                    functions (as provided by e.g. the 'notificationCallbacks'
+                                    argument of :meth:`~pyuaf.client.Client.createMonitoredData`).
+                                    The notifications that are received by a single publish are
+                                    passed to each callback function by a single thread.
+        :type  notificationThreads: ``int``
+        :param notificationQueueSize: The maximum number of notification batches that may wait
+                                      for a free thread. If the queue is full, the reception of
+                                      new notifications is delayed.
+        :type  notificationQueueSize: ``int``
+        :param orderedNotifications: True to guarantee that the notifications of the same
+                                     monitored item (i.e. with the same clientHandle) are passed
+                                     to the callback functions in the order in which they were
+                                     received.
+        :type  orderedNotifications: ``bool``
         """
         # define the logging, untrustedCertificate and connectError callbacks
         self.__loggingCallback__ = loggingCallback
@@ -76,11 +189,18 @@ class Client(ClientBase):
         self.__dataNotificationLock__ = threading.Lock()
         self.__eventNotificationLock__ = threading.Lock()
 
+        # define the thread pool that calls the notification callbacks
+        self.__notificationDispatcher__ = __NotificationDispatcher__(notificationThreads,
+                                                                     notificationQueueSize,
+                                                                     orderedNotifications)
+
 
     def __del__(self):
         # first disconnect all sessions, to avoid memory problems when the client
         # is garbage collected before any ongoing callback threads are fired!
         self.manuallyDisconnectAllSessions()
+        # let the notification callback threads finish
+        self.__notificationDispatcher__.stop()
         # wait some time for any ongoing callback threads to be fired
         time.sleep(0.1)
 #        ClientBase.__del__(self)
@@ -224,20 +344,22 @@ class Client(ClientBase):
         or to a callback function (if one is found for the given client handle).
         """
         notificationsWithoutCallback = []
+        batches = self.__notificationDispatcher__.createBatches()
 
         try:
             self.__dataNotificationLock__.acquire()
 
             for notification in dataNotifications:
-                try:
-                    f = self.__dataNotificationCallbacks__[notification.clientHandle]
-                    t = threading.Thread(target=f, args=[notification])
-                    t.start()
-                except:
+                f = self.__dataNotificationCallbacks__.get(notification.clientHandle)
+                if f is None:
                     notificationsWithoutCallback.append(notification)
+                else:
+                    self.__notificationDispatcher__.addToBatches(batches, f, notification)
         finally:
             self.__dataNotificationLock__.release()
 
+        self.__notificationDispatcher__.dispatch(batches)
+
         if len(notificationsWithoutCallback) > 0:
             try:
                 self.dataChangesReceived(notificationsWithoutCallback)
@@ -277,20 +399,22 @@ class Client(ClientBase):
         or to a callback function (if one is found for the given client handle).
         """
         notificationsWithoutCallback = []
+        batches = self.__notificationDispatcher__.createBatches()
 
         try:
             self.__eventNotificationLock__.acquire()
 
             for notification in eventNotifications:
-                try:
-                    f = self.__eventNotificationCallbacks__[notification.clientHandle]
-                    t = threading.Thread(target=f, args=[notification])
-                    t.start()
-                except:
+                f = self.__eventNotificationCallbacks__.get(notification.clientHandle)
+                if f is None:
                     notificationsWithoutCallback.append(notification)
+                else:
+                    self.__notificationDispatcher__.addToBatches(batches, f, notification)
         finally:
             self.__eventNotificationLock__.release()
 
+        self.__notificationDispatcher__.dispatch(batches)
+
         if len(notificationsWithoutCallback) > 0:
             try:
                 self.eventsReceived(notificationsWithoutCallback)
@@ -880,6 +1004,138 @@ class Client(ClientBase):
         return ClientBase.setClientSettings(self, settings)
 
 
+    def noOfDroppedLogMessages(self):
+        """
+        Get the total number of log messages that were dropped because the buffer of the
+        asynchronous logging was full.
+
+        Only relevant if :attr:`~pyuaf.client.settings.ClientSettings.logAsynchronously` is
+        ``True`` and :attr:`~pyuaf.client.settings.ClientSettings.logOverflowPolicy` is
+        :attr:`~pyuaf.util.logoverflowpolicies.Drop`.
+
+        :return: The number of dropped log messages.
+        :rtype:  ``int``
+        """
+        return ClientBase.noOfDroppedLogMessages(self)
+
+
+    def noOfAddressCacheHits(self):
+        """
+        Get the number of times that a resolved address was found in the address cache (so that
+        it didn't need to be resolved by the server).
+
+        :return: The number of address cache hits.
+        :rtype:  ``int``
+        """
+        return ClientBase.noOfAddressCacheHits(self)
+
+
+    def noOfAddressCacheNegativeHits(self):
+        """
+        Get the number of times that an address which could not be resolved was found in the
+        address cache (see
+        :attr:`~pyuaf.client.settings.ClientSettings.addressCacheNegativeTtlSec`).
+
+        :return: The number of negative address cache hits.
+        :rtype:  ``int``
+        """
+        return ClientBase.noOfAddressCacheNegativeHits(self)
+
+
+    def noOfAddressCacheMisses(self):
+        """
+        Get the number of times that an address was not found in the address cache.
+
+        :return: The number of address cache misses.
+        :rtype:  ``int``
+        """
+        return ClientBase.noOfAddressCacheMisses(self)
+
+
+    def noOfAddressCacheEvictions(self):
+        """
+        Get the number of addresses that were evicted from the address cache because it was full
+        (see :attr:`~pyuaf.client.settings.ClientSettings.addressCacheMaxSize`).
+
+        :return: The number of address cache evictions.
+        :rtype:  ``int``
+        """
+        return ClientBase.noOfAddressCacheEvictions(self)
+
+
+    def notificationQueueDepth(self):
+        """
+        Get the number of notifications (data changes and events) that are queued, but not yet
+        delivered (see :attr:`~pyuaf.client.settings.ClientSettings.notificationQueueEnable`).
+
+        :return: The number of queued notifications.
+        :rtype:  ``int``
+        """
+        return ClientBase.notificationQueueDepth(self)
+
+
+    def maxNotificationQueueDepth(self):
+        """
+        Get the highest number of notifications that were queued at the same time.
+
+        :return: The maximum number of queued notifications.
+        :rtype:  ``int``
+        """
+        return ClientBase.maxNotificationQueueDepth(self)
+
+
+    def noOfDroppedNotifications(self):
+        """
+        Get the number of notifications that were dropped because the notification queue of
+        their subscription was full
+        (see :attr:`~pyuaf.client.settings.ClientSettings.notificationQueueSize`).
+
+        :return: The number of dropped notifications.
+        :rtype:  ``int``
+        """
+        return ClientBase.noOfDroppedNotifications(self)
+
+
+    def saveAddressCacheSnapshot(self, path):
+        """
+        Save the address cache to a snapshot file.
+
+        This is done automatically if
+        :attr:`~pyuaf.client.settings.ClientSettings.addressCacheSnapshotPath` is not empty,
+        but you can also call this method to save a snapshot to a specific file.
+
+        :param path: The path of the snapshot file.
+        :type  path: ``str``
+        :raise pyuaf.util.errors.PathCreationError:
+             Raised in case the file could not be written.
+        :raise pyuaf.util.errors.UafError:
+             Base exception, catch this to handle any other errors.
+        """
+        ClientBase.saveAddressCacheSnapshot(self, path).test()
+
+
+    def loadAddressCacheSnapshot(self, path):
+        """
+        Restore the address cache from a snapshot file.
+
+        This is done automatically when
+        :attr:`~pyuaf.client.settings.ClientSettings.addressCacheSnapshotPath` is changed,
+        but you can also call this method to load a snapshot from a specific file.
+        The restored addresses of a server only become available once the client has connected
+        to the server, and they are dropped if the NamespaceArray of the server has changed.
+
+        :param path: The path of the snapshot file.
+        :type  path: ``str``
+        :raise pyuaf.util.errors.PathNotExistsError:
+             Raised in case the file does not exist.
+        :raise pyuaf.util.errors.UnexpectedError:
+             Raised in case the file is not a valid snapshot.
+        :raise pyuaf.util.errors.UafError:
+             Base exception, catch this to handle any other errors.
+        """
+        ClientBase.loadAddressCacheSnapshot(self, path).test()
+
+
     def findServersNow(self):
        """
        Discover the servers immediately (instead of waiting for the background thread) by
@@ -1346,6 +1602,55 @@ class Client(ClientBase):
         return result
 
 
+    def readCached(self, addresses, maxAgeSec, **kwargs):
+        """
+        Read the values of a number of nodes, preferably from the latest value cache.
+
+        The values of nodes that are monitored (by monitored data items that were created while
+        :attr:`~pyuaf.client.settings.ClientSettings.latestValueCacheEnable` was ``True``) are
+        taken from the cache, if they were received (or confirmed by a keep-alive of their
+        subscription) at most maxAgeSec seconds ago. The values of the other nodes are read from
+        the server, by a single synchronous read request. If all values were cached, no request
+        is sent, and the requestHandle of the result is
+        :attr:`~pyuaf.util.constants.REQUESTHANDLE_NOT_ASSIGNED`.
+
+        :param addresses: A single address or a list of addresses of nodes of which the value
+                          should be read.
+        :type  addresses: :class:`~pyuaf.util.Address` or a ``list`` of :class:`~pyuaf.util.Address`
+        :param maxAgeSec: The maximum age of a cached value, in seconds.
+        :type  maxAgeSec: ``float``
+        :param kwargs: The following \*\*kwargs are available (see :ref:`note-client-kwargs`).
+                       If a clientConnectionId is given, only values cached by that session are
+                       used. The other kwargs are only used if values must be read from the server:
+
+           - clientConnectionId: (type: ``int``)
+           - sessionSettings (type: :class:`~pyuaf.client.settings.SessionSettings`)
+           - serviceSettings (type: :class:`~pyuaf.client.settings.ReadSettings`)
+           - translateSettings (type: :class:`~pyuaf.client.settings.TranslateBrowsePathsToNodeIdsSettings`)
+
+        :return: The result of the read request.
+        :rtype:  :class:`~pyuaf.client.results.ReadResult`
+        :raise pyuaf.util.errors.UafError:
+             Base exception, catch this to handle any UAF errors.
+        """
+        if type(addresses) == pyuaf.util.Address:
+            addressVector = pyuaf.util.AddressVector([addresses])
+        else:
+            addressVector = pyuaf.util.AddressVector(addresses)
+        result = pyuaf.client.results.ReadResult()
+
+        ClientBase.readCached(self,
+                              addressVector,
+                              maxAgeSec,
+                              __getElementFromKwargs__(kwargs, "clientConnectionId"   , pyuaf.util.constants.CLIENTHANDLE_NOT_ASSIGNED),
+                              __getElementFromKwargs__(kwargs, "serviceSettings"      , None),
+                              __getElementFromKwargs__(kwargs, "translateSettings"    , None),
+                              __getElementFromKwargs__(kwargs, "sessionSettings"      , None),
+                              result).test()
+
+        return result
+
+
     def beginRead(self, addresses, attributeId=pyuaf.util.attributeids.Value, callback=None, **kwargs):
         """
         Read a number of node attributes asynchronously.
@@ -2515,6 +2820,92 @@ class Client(ClientBase):
         return results
 
 
+    def registerNodes(self, addresses, serviceSettings=None):
+        """
+        Register nodes that you access frequently (e.g. by cyclic reading or writing).
+
+        The servers assign an alias (typically a numeric NodeId) to each registered node.
+        All subsequent :meth:`~pyuaf.client.Client.read` and :meth:`~pyuaf.client.Client.write`
+        calls (and their asynchronous and generic counterparts) then automatically use these
+        aliases instead of the original NodeIds, which makes them more efficient (especially
+        for nodes with long string identifiers).
+
+        The nodes are registered again automatically when a session is reconnected, so you
+        only need to register them once.
+
+        Example:
+
+        .. doctest::
+
+            >>> import pyuaf
+            >>> from pyuaf.util import Address, NodeId
+            >>> from pyuaf.client import Client
+            >>>
+            >>> myClient     = Client("myClient", ["opc.tcp://localhost:4841"])
+            >>>
+            >>> nameSpaceUri = "http://mycompany.com/mymachine"
+            >>> serverUri    = "http://mycompany.com/servers/plc1"
+            >>> temperature  = Address( NodeId("myMachine.temperature", nameSpaceUri), serverUri)
+            >>>
+            >>> statuses = myClient.registerNodes([temperature])
+            >>>
+            >>> # from now on, the alias of the temperature node will be used:
+            >>> result = myClient.read([temperature])
+
+        :param addresses:        A single address or a list of addresses of the nodes to register.
+        :type  addresses:        :class:`~pyuaf.util.Address` or a ``list`` of
+                                 :class:`~pyuaf.util.Address`
+        :param serviceSettings:  The service settings to be used (leave None for default settings).
+        :type  serviceSettings:  :class:`pyuaf.client.settings.ServiceSettings`
+        :return:                 A list of statuses, one for each address.
+        :rtype:                  :class:`~pyuaf.util.StatusVector`.
+        :raise pyuaf.util.errors.UafError:
+             Base exception, catch this to handle any UAF errors.
+        """
+        if type(addresses) == pyuaf.util.Address:
+            addressVector = pyuaf.util.AddressVector([addresses])
+        else:
+            addressVector = pyuaf.util.AddressVector(addresses)
+
+        if serviceSettings is None:
+            serviceSettings = pyuaf.client.settings.ServiceSettings()
+
+        results = pyuaf.util.StatusVector()
+        status = ClientBase.registerNodes(self, addressVector, serviceSettings, results)
+        status.test()
+        return results
+
+
+    def unregisterNodes(self, addresses, serviceSettings=None):
+        """
+        Unregister nodes that were registered before by :meth:`~pyuaf.client.Client.registerNodes`.
+
+        From then on, the original NodeIds will be used again.
+
+        :param addresses:        A single address or a list of addresses of the nodes to unregister.
+        :type  addresses:        :class:`~pyuaf.util.Address` or a ``list`` of
+                                 :class:`~pyuaf.util.Address`
+        :param serviceSettings:  The service settings to be used (leave None for default settings).
+        :type  serviceSettings:  :class:`pyuaf.client.settings.ServiceSettings`
+        :return:                 A list of statuses, one for each address.
+        :rtype:                  :class:`~pyuaf.util.StatusVector`.
+        :raise pyuaf.util.errors.UafError:
+             Base exception, catch this to handle any UAF errors.
+        """
+        if type(addresses) == pyuaf.util.Address:
+            addressVector = pyuaf.util.AddressVector([addresses])
+        else:
+            addressVector = pyuaf.util.AddressVector(addresses)
+
+        if serviceSettings is None:
+            serviceSettings = pyuaf.client.settings.ServiceSettings()
+
+        results = pyuaf.util.StatusVector()
+        status = ClientBase.unregisterNodes(self, addressVector, serviceSettings, results)
+        status.test()
+        return results
+
+
     def structureDefinition(self, dataTypeId):
         """
         Get a structure definition for the given datatype NodeId.
@@ -73,6 +73,8 @@
 // add some import stuff to the __init__.py file that will be produced
 %pythoncode %{
 import _thread, threading
+import queue
+import traceback
 import time
 %}
 
@@ -94,6 +96,7 @@ import time
 
 // import the wrapped modules from pyuaf.util
 %import(module="pyuaf.util.loglevels")               "pyuaf/util/util_loglevels.i"
+%import(module="pyuaf.util.logoverflowpolicies")     "pyuaf/util/util_logoverflowpolicies.i"
 %import(module="pyuaf.util.applicationtypes")        "pyuaf/util/util_applicationtypes.i"
 %import(module="pyuaf.util.attributeids")            "pyuaf/util/util_attributeids.i"
 %import(module="pyuaf.util.constants")               "pyuaf/util/util_constants.i"
@@ -138,6 +141,9 @@ import time
 %rename(__dispatch_callComplete__)                          uaf::ClientInterface::callComplete;
 %rename(__dispatch_dataChangesReceived__)                   uaf::ClientInterface::dataChangesReceived;
 %rename(__dispatch_eventsReceived__)                        uaf::ClientInterface::eventsReceived;
+// the batches are passed to Python via the methods above (which receive a copy anyway)
+%ignore uaf::ClientInterface::dataChangeBatchReceived;
+%ignore uaf::ClientInterface::eventBatchReceived;
 %rename(__dispatch_keepAliveReceived__)                     uaf::ClientInterface::keepAliveReceived;
 %rename(__dispatch_connectionStatusChanged__)               uaf::ClientInterface::connectionStatusChanged;
 %rename(__dispatch_subscriptionStatusChanged__)             uaf::ClientInterface::subscriptionStatusChanged;
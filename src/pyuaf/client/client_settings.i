@@ -58,6 +58,7 @@
 %import(module="pyuaf.util.messagesecuritymodes")   "pyuaf/util/util_messagesecuritymodes.i"
 %import(module="pyuaf.util.usertokentypes")         "pyuaf/util/util_usertokentypes.i"
 %import(module="pyuaf.util.loglevels")              "pyuaf/util/util_loglevels.i"
+%import(module="pyuaf.util.logoverflowpolicies")    "pyuaf/util/util_logoverflowpolicies.i"
 %import(module="pyuaf.util.applicationtypes")       "pyuaf/util/util_applicationtypes.i"
 %import(module="pyuaf.util.attributeids")           "pyuaf/util/util_attributeids.i"
 %import(module="pyuaf.util.constants")              "pyuaf/util/util_constants.i"
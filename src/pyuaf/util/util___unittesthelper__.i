@@ -27,6 +27,7 @@
 #include "uaf/util/expandednodeid.h"
 #include "uaf/util/localizedtext.h"
 #include "uaf/util/extensionobject.h"
+#include "uaf/util/status.h"
 #include <stdio.h>
 %}
 
@@ -38,6 +39,7 @@
 %import "uaf/util/localizedtext.h"
 %import "uaf/util/qualifiedname.h"
 %import "uaf/util/extensionobject.h"
+%import "uaf/util/status.h"
 
 
 // we'll test the python typemaps, so include them here
@@ -323,5 +325,15 @@
         {
             return uaf::Variant(v);
         }
+
+        std::size_t sizeOfStatus() const
+        {
+            return sizeof(uaf::Status);
+        }
+
+        std::size_t sizeOfPointer() const
+        {
+            return sizeof(void*);
+        }
     };
 %}
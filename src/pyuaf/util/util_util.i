@@ -104,6 +104,7 @@
 
 // import the submodules
 %import "pyuaf/util/util_loglevels.i"
+%import "pyuaf/util/util_logoverflowpolicies.i"
 %import "pyuaf/util/util_applicationtypes.i"
 %import "pyuaf/util/util_attributeids.i"
 %import "pyuaf/util/util_constants.i"
@@ -126,16 +127,21 @@
 
 // before including any classes in a generic way, specify the "special treatments" of certain classes:
 %rename(__and__) uaf::Mask::operator&&;
+%rename(__or__) uaf::Mask::operator||;
 %rename(__dispatch_logMessageReceived__) uaf::LoggingInterface::logMessageReceived;
 %ignore extractServerUri(const Address& object, std::string& serverUri);
 %ignore operator>(const DateTime&, const DateTime&);
 %ignore uaf::DateTime::DateTime(const FILETIME& t);
+%ignore uaf::LogMessage::currentTime(int64_t& ctime, int16_t& msec);
 
 // The default SWIG output returned by uaf::Status::opcUaStatusCode() is a signed representation (Long) of an unsigned 32-bit integer.
 // The returned value (a Long which can only be positive) does not correspond bit-to-bit to the original OPC UA status codes, e.g. as found in
 // pyuaf.util.opcuastatuscodes (which may appear to be negative ints because Python interprets the unsigned value as a signed value).
 // We therefore manually convert the output of the opcUaStatusCode() method, so that the result can be compared to pyuaf.util.opcuastatuscodes.
 // (Note that the convert_uint32_to_int32() function is defined in src/pyuaf/util/init_extras.py)
+// The errors of a uaf::Status are accessed in C++ via raisedBy_<ErrorName>() accessor methods, so we
+// only need the non-const accessors (which return a reference, so the error can be modified in place).
+%warnfilter(512) uaf::Status;
 %extend uaf::Status {
   %pythoncode {
     def test(self):
@@ -186,6 +192,15 @@ UAF_WRAP_CLASS("uaf/util/range.h"                  , uaf , Range
 UAF_WRAP_CLASS("uaf/util/euinformation.h"          , uaf , EUInformation           , COPY_YES, TOSTRING_YES, COMP_NO,  pyuaf.util, VECTOR_NO)
 
 
+// In Python, the errors of a Status remain attributes (e.g. status.raisedBy_UnexpectedError.message),
+// so turn the raisedBy_<ErrorName>() accessor methods into properties:
+%pythoncode %{
+for _name in [_n for _n in dir(Status) if _n.startswith("raisedBy_")]:
+    setattr(Status, _name, property(getattr(Status, _name)))
+del _name
+%}
+
+
 // also include the Variant typemap(s)
 #if defined(SWIGPYTHON)
     %include "pyuaf/util/util_variant_python.i"
@@ -31,6 +31,16 @@ namespace uaf
     using std::pair;
 
 
+    // the number of threads that execute the background tasks
+    static const size_t BACKGROUND_THREADS = 4;
+
+    // the maximum number of background tasks waiting for a thread
+    static const size_t BACKGROUND_QUEUE_SIZE = 1024;
+
+    // the delay after which a background task is tried again, if the queue was full
+    static const double BACKGROUND_RETRY_DELAY_SEC = 1.0;
+
+
     // Constructor
     // =============================================================================================
     Client::Client()
@@ -85,13 +95,16 @@ namespace uaf
         discoverer_     = new Discoverer(logger_->loggerFactory(), database_);
         sessionFactory_ = new SessionFactory(logger_->loggerFactory(), this, discoverer_, database_);
         resolver_       = new Resolver(logger_->loggerFactory(), sessionFactory_, database_);
+        backgroundPool_ = new ThreadPool(BACKGROUND_THREADS, BACKGROUND_QUEUE_SIZE);
 
-        logger_->debug("Now starting the thread to periodically check the requests");
+        schedulePeriodicBackgroundTasks();
+
+        UAF_LOG_DEBUG(logger_, "Now starting the thread to execute the background tasks");
 
         // start the thread
         start();
 
-        logger_->debug("The client has been constructed");
+        UAF_LOG_DEBUG(logger_, "The client has been constructed");
     }
 
 
@@ -99,15 +112,25 @@ namespace uaf
     // =============================================================================================
     Client::~Client()
     {
-        logger_->debug("Destructing the client");
+        UAF_LOG_DEBUG(logger_, "Destructing the client");
 
         // make sure the thread isn't doing anything
         //UaMutexLocker locker(&threadStoppingMutex_);
 
         doFinishThread_ = true;
 
+        database_->backgroundTasks.wake();
+
         wait();
 
+        // the jobs that are still queued will return immediately, since doFinishThread_ is set
+        delete backgroundPool_;
+        backgroundPool_ = 0;
+
+        // save the address cache, so that a new client can restore it
+        string snapshotPath = addressCacheSnapshotPath();
+        if (!snapshotPath.empty())
+            database_->addressCache.saveSnapshot(snapshotPath);
 
         delete resolver_;
         resolver_ = 0;
@@ -136,21 +159,138 @@ namespace uaf
     }
 
 
+    // Get the number of dropped log messages
+    //==============================================================================================
+    uint64_t Client::noOfDroppedLogMessages() const
+    {
+        return logger_->loggerFactory()->noOfDroppedMessages();
+    }
+
+
+    // Get the number of address cache hits
+    //==============================================================================================
+    uint64_t Client::noOfAddressCacheHits() const
+    {
+        return database_->addressCache.noOfHits();
+    }
+
+
+    // Get the number of negative address cache hits
+    //==============================================================================================
+    uint64_t Client::noOfAddressCacheNegativeHits() const
+    {
+        return database_->addressCache.noOfNegativeHits();
+    }
+
+
+    // Get the number of address cache misses
+    //==============================================================================================
+    uint64_t Client::noOfAddressCacheMisses() const
+    {
+        return database_->addressCache.noOfMisses();
+    }
+
+
+    // Get the number of address cache evictions
+    //==============================================================================================
+    uint64_t Client::noOfAddressCacheEvictions() const
+    {
+        return database_->addressCache.noOfEvictions();
+    }
+
+
+    // Get the number of queued notifications
+    //==============================================================================================
+    uint64_t Client::notificationQueueDepth() const
+    {
+        return database_->notificationDispatcher.queueDepth();
+    }
+
+
+    // Get the maximum number of queued notifications
+    //==============================================================================================
+    uint64_t Client::maxNotificationQueueDepth() const
+    {
+        return database_->notificationDispatcher.maxQueueDepth();
+    }
+
+
+    // Get the number of dropped notifications
+    //==============================================================================================
+    uint64_t Client::noOfDroppedNotifications() const
+    {
+        return database_->notificationDispatcher.noOfDroppedNotifications();
+    }
+
+
+    // Save the address cache to a snapshot file
+    //==============================================================================================
+    Status Client::saveAddressCacheSnapshot(const string& path)
+    {
+        return database_->addressCache.saveSnapshot(path);
+    }
+
+
+    // Restore the address cache from a snapshot file
+    //==============================================================================================
+    Status Client::loadAddressCacheSnapshot(const string& path)
+    {
+        return database_->addressCache.loadSnapshot(path);
+    }
+
+
+    // Get the path of the address cache snapshot
+    //==============================================================================================
+    string Client::addressCacheSnapshotPath()
+    {
+        UaMutexLocker locker(&addressCacheSnapshotPathMutex_); // unlocks when out of scope
+        return addressCacheSnapshotPath_;
+    }
+
+
     // Set the client config
     //==============================================================================================
     void Client::setClientSettings(const ClientSettings& settings)
     {
-        logger_->debug("Now updating the ClientSettings");
+        UAF_LOG_DEBUG(logger_, "Now updating the ClientSettings");
 
         logger_->loggerFactory()->setStdOutLevel(settings.logToStdOutLevel);
         logger_->loggerFactory()->setCallbackLevel(settings.logToCallbackLevel);
+        logger_->loggerFactory()->setAsyncLogging(settings.logAsynchronously,
+                                                  settings.logBufferSize,
+                                                  settings.logOverflowPolicy);
+        database_->addressCache.setMaxSize(settings.addressCacheMaxSize);
+        database_->addressCache.setNegativeTtl(settings.addressCacheNegativeTtlSec);
+        database_->createMonitoredDataRequestStore.setBackoff(
+                settings.persistedRequestsRetryMinSec, settings.persistedRequestsRetryMaxSec);
+        database_->createMonitoredEventsRequestStore.setBackoff(
+                settings.persistedRequestsRetryMinSec, settings.persistedRequestsRetryMaxSec);
+        database_->notificationDispatcher.setNoOfThreads(settings.notificationDispatcherThreads);
 
         bool doFindServers = (settings.discoveryUrls != database_->clientSettings.discoveryUrls);
+        bool doLoadSnapshot = (settings.addressCacheSnapshotPath != addressCacheSnapshotPath())
+                              && !settings.addressCacheSnapshotPath.empty();
         database_->clientSettings = settings;
 
+        {
+            UaMutexLocker locker(&addressCacheSnapshotPathMutex_); // unlocks when out of scope
+            addressCacheSnapshotPath_ = settings.addressCacheSnapshotPath;
+        }
+
+        if (doLoadSnapshot)
+        {
+            UAF_LOG_DEBUG(logger_, "The addressCacheSnapshotPath was changed, so we restore "
+                                   "the address cache");
+            // (if the file doesn't exist yet, the cache will simply be saved there later)
+            database_->addressCache.loadSnapshot(settings.addressCacheSnapshotPath);
+        }
+
+        // the intervals may have been shortened
+        schedulePeriodicBackgroundTasks();
+
         if (doFindServers)
         {
-            logger_->debug("The discoveryUrls were changed, so we rediscover the system");
+            UAF_LOG_DEBUG(logger_, "The discoveryUrls were changed, so we rediscover the system");
             findServersNow();
         }
     }
@@ -211,7 +351,7 @@ namespace uaf
             uaf::ReadResult&                                    result)
     {
         // log read request
-        logger_->debug("Reading %d node attributes", addresses.size());
+        UAF_LOG_DEBUG(logger_, "Reading %d node attributes", addresses.size());
 
         ReadRequest request(0, clientConnectionId, serviceSettings, translateSettings, sessionSettings);
 
@@ -225,6 +365,79 @@ namespace uaf
     }
 
 
+    // Read a number of node values, preferably from the latest value cache
+    //==============================================================================================
+    Status Client::readCached(
+            const std::vector<uaf::Address>&                    addresses,
+            double                                              maxAgeSec,
+            uaf::ClientConnectionId                             clientConnectionId,
+            const uaf::ReadSettings*                            serviceSettings,
+            const uaf::TranslateBrowsePathsToNodeIdsSettings*   translateSettings,
+            const uaf::SessionSettings*                         sessionSettings,
+            uaf::ReadResult&                                    result)
+    {
+        Status ret = statuscodes::Good;
+
+        result.targets.clear();
+        result.targets.resize(addresses.size());
+
+        vector<bool> found;
+        size_t noOfCachedValues = database_->latestValueCache.get(
+                addresses, maxAgeSec, clientConnectionId, result.targets, found);
+
+        UAF_LOG_DEBUG(logger_, "Reading %d node values, of which %d are cached",
+                      addresses.size(), noOfCachedValues);
+
+        // read the other values from the server
+        if (noOfCachedValues < addresses.size())
+        {
+            vector<Address> missingAddresses;
+            vector<size_t>  missingRanks;
+            missingAddresses.reserve(addresses.size() - noOfCachedValues);
+            missingRanks.reserve(addresses.size() - noOfCachedValues);
+
+            for (size_t i = 0; i < addresses.size(); i++)
+            {
+                if (!found[i])
+                {
+                    missingAddresses.push_back(addresses[i]);
+                    missingRanks.push_back(i);
+                }
+            }
+
+            ReadResult serverResult;
+            ret = read(missingAddresses,
+                       attributeids::Value,
+                       clientConnectionId,
+                       serviceSettings,
+                       translateSettings,
+                       sessionSettings,
+                       serverResult);
+
+            result.requestHandle = serverResult.requestHandle;
+
+            for (size_t i = 0; i < missingRanks.size(); i++)
+            {
+                if (i < serverResult.targets.size())
+                    result.targets[missingRanks[i]] = serverResult.targets[i];
+                else
+                    result.targets[missingRanks[i]].status = ret;
+            }
+
+            result.overallStatus = serverResult.overallStatus;
+        }
+        else
+        {
+            result.requestHandle = uaf::constants::REQUESTHANDLE_NOT_ASSIGNED;
+            result.overallStatus = statuscodes::Good;
+        }
+
+        result.updateOverallStatus();
+
+        return ret;
+    }
+
+
     // Read a number of node attributes asynchronously
     //==============================================================================================
     Status Client::beginRead(
@@ -237,7 +450,7 @@ namespace uaf
             uaf::AsyncReadResult&                               result)
     {
         // log read request
-        logger_->debug("Reading %d node attributes", addresses.size());
+        UAF_LOG_DEBUG(logger_, "Reading %d node attributes", addresses.size());
 
         AsyncReadRequest request(0, clientConnectionId, serviceSettings, translateSettings, sessionSettings);
 
@@ -264,7 +477,7 @@ namespace uaf
             uaf::WriteResult&                                   result)
     {
         // log write request
-        logger_->debug("Writing %d node attributes", addresses.size());
+        UAF_LOG_DEBUG(logger_, "Writing %d node attributes", addresses.size());
 
         // create a write request
         WriteRequest request(0, clientConnectionId, serviceSettings, translateSettings, sessionSettings);
@@ -298,7 +511,7 @@ namespace uaf
             uaf::AsyncWriteResult&                              result)
     {
         // log write request
-        logger_->debug("Writing %d node attributes", addresses.size());
+        UAF_LOG_DEBUG(logger_, "Writing %d node attributes", addresses.size());
 
         // create a write request
         AsyncWriteRequest request(0, clientConnectionId, serviceSettings, translateSettings, sessionSettings);
@@ -389,7 +602,7 @@ namespace uaf
             uaf::BrowseResult&                  result)
     {
         // log read request
-        logger_->debug("Browsing %d nodes", addresses.size());
+        UAF_LOG_DEBUG(logger_, "Browsing %d nodes", addresses.size());
 
         // override the necessary parameters
         BrowseSettings serviceSettingsCopy;
@@ -433,7 +646,7 @@ namespace uaf
             uaf::HistoryReadRawModifiedResult&                  result)
     {
         // log read request
-        logger_->debug("Reading the raw historical data of %d nodes", addresses.size());
+        UAF_LOG_DEBUG(logger_, "Reading the raw historical data of %d nodes", addresses.size());
 
         // override the necessary parameters
         HistoryReadRawModifiedSettings serviceSettingsCopy;
@@ -487,7 +700,7 @@ namespace uaf
             uaf::HistoryReadRawModifiedResult&                  result)
     {
         // log read request
-        logger_->debug("Reading the historical data modifications of %d nodes", addresses.size());
+        UAF_LOG_DEBUG(logger_, "Reading the historical data modifications of %d nodes", addresses.size());
 
         // override the necessary parameters
         HistoryReadRawModifiedSettings serviceSettingsCopy;
@@ -537,7 +750,7 @@ namespace uaf
             uaf::BrowseNextResult&                              result)
     {
         // log read request
-        logger_->debug("BrowseNext %d continuation points", continuationPoints.size());
+        UAF_LOG_DEBUG(logger_, "BrowseNext %d continuation points", continuationPoints.size());
 
         Status ret;
 
@@ -871,68 +1084,208 @@ namespace uaf
     // =============================================================================================
     void Client::dataChangesReceived(std::vector<uaf::DataChangeNotification> notifications)
     {
-        std::vector<uaf::DataChangeNotification>::const_iterator iter;
-        for (iter = notifications.begin(); iter != notifications.end(); ++iter)
-        {
-            dataCallbackRegistry_.CallCallback(*iter);
-        }
+        dataCallbackRegistry_.CallCallbacks(notifications);
     }
 
     // Handle events
     // =============================================================================================
     void Client::eventsReceived(std::vector<uaf::EventNotification> notifications)
     {
-        std::vector<uaf::EventNotification>::const_iterator iter;
-        for (iter = notifications.begin(); iter != notifications.end(); ++iter)
+        eventCallbackRegistry_.CallCallbacks(notifications);
+    }
+
+    // A job to execute a background task on the background pool
+    // =============================================================================================
+    class Client::BackgroundJob : public ThreadPoolJob
+    {
+    public:
+        BackgroundJob(Client* client, uint64_t taskId)
+        : ThreadPoolJob(true),
+          client_(client),
+          taskId_(taskId)
+        {}
+
+        void execute()
         {
-            eventCallbackRegistry_.CallCallback(*iter);
+            client_->executeBackgroundTask(taskId_);
+
+            bool rerun;
+            {
+                UaMutexLocker locker(&client_->backgroundTasksMutex_); // unlocks when out of scope
+                client_->runningBackgroundTasks_.erase(taskId_);
+                rerun = (client_->rerunBackgroundTasks_.erase(taskId_) > 0);
+            }
+
+            // the task became due again while it was running
+            if (rerun && !client_->doFinishThread_)
+                client_->database_->backgroundTasks.schedule(taskId_);
         }
-    }
+
+    private:
+        Client*  client_;
+        uint64_t taskId_;
+    };
+
 
     // Run the thread
     // =============================================================================================
     void Client::run()
     {
-        logger_->debug("Thread has started to periodically check the requests");
+        UAF_LOG_DEBUG(logger_, "Thread has started to execute the background tasks");
 
-        // declare the current time and the time of the last actions
-        time_t currentTime;
-        time_t lastTime;
+        vector<uint64_t> dueTaskIds;
 
-        // initialize the time values
-        time(&currentTime);
-        time(&lastTime);
+        while (!doFinishThread_)
+        {
+            // sleep until a task is due (the destructor wakes us up to finish the thread)
+            dueTaskIds.clear();
+            database_->backgroundTasks.takeDueTasks(dueTaskIds, OpcUa_UInt32_Max);
 
+            for (vector<uint64_t>::const_iterator it = dueTaskIds.begin();
+                 it != dueTaskIds.end() && !doFinishThread_;
+                 ++it)
+            {
+                startBackgroundTask(*it);
+            }
+        }
+    }
 
-        double updateInterval;
 
-        while (!doFinishThread_)
+    // Schedule the periodic background tasks
+    // =============================================================================================
+    void Client::schedulePeriodicBackgroundTasks()
+    {
+        double updateInterval   = database_->clientSettings.discoveryIntervalSec;
+        double snapshotInterval = database_->clientSettings.addressCacheAutosaveIntervalSec;
+
+        database_->backgroundTasks.schedule(
+                backgroundtasks::toTaskId(backgroundtasks::Discovery), updateInterval);
+        database_->backgroundTasks.schedule(
+                backgroundtasks::toTaskId(backgroundtasks::HouseKeeping), updateInterval);
+
+        if (snapshotInterval > 0)
+            database_->backgroundTasks.schedule(
+                    backgroundtasks::toTaskId(backgroundtasks::AddressCacheSnapshot),
+                    snapshotInterval);
+    }
+
+
+    // Start a background task
+    // =============================================================================================
+    void Client::startBackgroundTask(uint64_t taskId)
+    {
+        backgroundtasks::BackgroundTask task = backgroundtasks::toTask(taskId);
+
+        UAF_LOG_DEBUG(logger_, "Background task %s is due (clientConnectionId %d)",
+                      backgroundtasks::toString(task).c_str(),
+                      backgroundtasks::toClientConnectionId(taskId));
+
+        // the periodic tasks are scheduled again right away, so their period doesn't depend
+        // on how long they take
+        if (   (task == backgroundtasks::Discovery)
+            || (task == backgroundtasks::HouseKeeping)
+            || (task == backgroundtasks::AddressCacheSnapshot))
+            schedulePeriodicBackgroundTasks();
+
+        // the housekeeping is split into independent tasks: one per session (so that a
+        // session that takes long to reconnect doesn't delay the others), and one for the
+        // persisted requests
+        if (task == backgroundtasks::HouseKeeping)
         {
-            updateInterval = database_->clientSettings.discoveryIntervalSec;
+            vector<SessionInformation> infos = sessionFactory_->allSessionInformations();
+            for (vector<SessionInformation>::const_iterator it = infos.begin();
+                 it != infos.end();
+                 ++it)
+            {
+                database_->backgroundTasks.schedule(backgroundtasks::toTaskId(
+                        backgroundtasks::SessionHouseKeeping, it->clientConnectionId));
+            }
 
-            msleep(100);
+            database_->backgroundTasks.schedule(backgroundtasks::toTaskId(
+                    backgroundtasks::PersistedRequests));
+            return;
+        }
+
+        // a task is never executed twice at the same time: if it's still running, it will
+        // simply be executed once more when it has finished
+        {
+            UaMutexLocker locker(&backgroundTasksMutex_); // unlocks when out of scope
+            if (runningBackgroundTasks_.count(taskId) > 0)
+            {
+                rerunBackgroundTasks_.insert(taskId);
+                return;
+            }
+            runningBackgroundTasks_.insert(taskId);
+        }
 
-            time(&currentTime);
+        if (!backgroundPool_->addJob(new BackgroundJob(this, taskId), false))
+        {
+            logger_->warning("The background pool is too busy, so background task %s "
+                             "will be tried again later",
+                             backgroundtasks::toString(task).c_str());
 
-            if (difftime(currentTime, lastTime) > updateInterval)
             {
-                logger_->debug("Now discovering the system and checking the persistent requests");
+                UaMutexLocker locker(&backgroundTasksMutex_); // unlocks when out of scope
+                runningBackgroundTasks_.erase(taskId);
+            }
+            database_->backgroundTasks.schedule(taskId, BACKGROUND_RETRY_DELAY_SEC);
+        }
+    }
 
-                // update the lastTime
-                time(&lastTime);
 
-                if (!doFinishThread_)
-                    discoverer_->findServers();
+    // Execute a background task
+    // =============================================================================================
+    void Client::executeBackgroundTask(uint64_t taskId)
+    {
+        if (doFinishThread_)
+            return;
 
-                if (!doFinishThread_)
-                    sessionFactory_->doHouseKeeping();
+        switch (backgroundtasks::toTask(taskId))
+        {
+            case backgroundtasks::Discovery:
+            {
+                UAF_LOG_DEBUG(logger_, "Now discovering the system");
+                discoverer_->findServers();
+                break;
+            }
+            case backgroundtasks::SessionHouseKeeping:
+            {
+                sessionFactory_->doHouseKeeping(backgroundtasks::toClientConnectionId(taskId));
+                break;
+            }
+            case backgroundtasks::PersistedRequests:
+            {
+                UAF_LOG_DEBUG(logger_, "Now checking the persistent requests");
 
-                if (!doFinishThread_)
-                    processPersistedRequests(database_->createMonitoredDataRequestStore);
+                processPersistedRequests(database_->createMonitoredDataRequestStore);
 
                 if (!doFinishThread_)
                     processPersistedRequests(database_->createMonitoredEventsRequestStore);
+
+                // come back when the backoff of the next server expires
+                double dataDelay, eventsDelay;
+                bool dataPending
+                        = database_->createMonitoredDataRequestStore.getNextRetryDelay(dataDelay);
+                bool eventsPending
+                        = database_->createMonitoredEventsRequestStore.getNextRetryDelay(eventsDelay);
+
+                if (dataPending && eventsPending)
+                    database_->backgroundTasks.schedule(taskId, std::min(dataDelay, eventsDelay));
+                else if (dataPending)
+                    database_->backgroundTasks.schedule(taskId, dataDelay);
+                else if (eventsPending)
+                    database_->backgroundTasks.schedule(taskId, eventsDelay);
+                break;
             }
+            case backgroundtasks::AddressCacheSnapshot:
+            {
+                string snapshotPath = addressCacheSnapshotPath();
+                if (!snapshotPath.empty())
+                    database_->addressCache.saveSnapshot(snapshotPath);
+                break;
+            }
+            default:
+                break;
         }
     }
 
@@ -1053,6 +1406,81 @@ namespace uaf
     }
 
 
+    // Register nodes
+    // =============================================================================================
+    Status Client::registerNodes(
+            const vector<Address>&  addresses,
+            const ServiceSettings*  serviceSettings,
+            vector<Status>&         results)
+    {
+        return changeNodeRegistrations(true, addresses, serviceSettings, results);
+    }
+
+
+    // Unregister nodes
+    // =============================================================================================
+    Status Client::unregisterNodes(
+            const vector<Address>&  addresses,
+            const ServiceSettings*  serviceSettings,
+            vector<Status>&         results)
+    {
+        return changeNodeRegistrations(false, addresses, serviceSettings, results);
+    }
+
+
+    // Register or unregister nodes
+    // =============================================================================================
+    Status Client::changeNodeRegistrations(
+            bool                    registering,
+            const vector<Address>&  addresses,
+            const ServiceSettings*  serviceSettings,
+            vector<Status>&         results)
+    {
+        Status ret;
+
+        vector<ExpandedNodeId> expandedNodeIds;
+        vector<Status>         resolutionStatuses;
+
+        results.resize(addresses.size());
+
+        // resolve the addresses first
+        ret = resolver_->resolve(addresses, expandedNodeIds, resolutionStatuses);
+
+        if (ret.isGood())
+        {
+            vector<ExpandedNodeId> resolvedNodeIds;
+            vector<std::size_t>    indexes;
+            vector<Status>         registrationResults;
+
+            for (std::size_t i = 0; i < addresses.size(); i++)
+            {
+                results[i] = resolutionStatuses[i];
+                if (results[i].isGood())
+                {
+                    resolvedNodeIds.push_back(expandedNodeIds[i]);
+                    indexes.push_back(i);
+                }
+            }
+
+            if (registering)
+                ret = sessionFactory_->registerNodes(resolvedNodeIds, serviceSettings, registrationResults);
+            else
+                ret = sessionFactory_->unregisterNodes(resolvedNodeIds, serviceSettings, registrationResults);
+
+            for (std::size_t j = 0; j < indexes.size(); j++)
+                results[indexes[j]] = registrationResults[j];
+        }
+        else
+        {
+            // none of the nodes has been processed
+            for (std::size_t i = 0; i < addresses.size(); i++)
+                results[i] = resolutionStatuses[i].isBad() ? resolutionStatuses[i] : ret;
+        }
+
+        return ret;
+    }
+
+
     // Private template function implementation: assign a UAF handle
     // =============================================================================================
     template <typename _Service>
@@ -1081,7 +1509,7 @@ namespace uaf
         }
 
         if (ret.isGood())
-            logger_->debug("Assigning handle %d to the request", currentRequestHandle_);
+            UAF_LOG_DEBUG(logger_, "Assigning handle %d to the request", currentRequestHandle_);
         else
             logger_->error(ret.toString());
 
@@ -1097,12 +1525,13 @@ namespace uaf
         // create a typedef for the vector holding the correct type of items
         typedef std::vector<typename _Store::Item> Items;
 
-        // get the items that need to be reconstructed
-        Items items = store.getBadItems();
+        // get the items that need to be reconstructed now (i.e. only the bad targets of the
+        // servers that just became reachable, or of which the backoff has expired)
+        Items items = store.getItemsToRetry();
 
         if (items.size() > 0)
-            logger_->debug("A total of %d persistent requests need to be re-processed",
-                           items.size());
+            UAF_LOG_DEBUG(logger_, "A total of %d persistent requests need to be re-processed",
+                                   items.size());
 
         // loop through the items and process them
         // (We don't have to care about the Status result of the processRequest function,
@@ -1138,8 +1567,8 @@ namespace uaf
         // declare the return Status
         uaf::Status ret;
 
-        logger_->debug("Processing the following %sRequest:", _Service::name().c_str());
-        logger_->debug(request.toString());
+        UAF_LOG_DEBUG(logger_, "Processing the following %sRequest:", _Service::name().c_str());
+        UAF_LOG_DEBUG(logger_, request.toString());
 
         // resize the result
         result.targets.resize(request.targets.size());
@@ -1192,8 +1621,8 @@ namespace uaf
         // log the result, if good
         if (ret.isGood())
         {
-            logger_->debug("%sResult %d:", _Service::name().c_str(), result.requestHandle);
-            logger_->debug(result.toString());
+            UAF_LOG_DEBUG(logger_, "%sResult %d:", _Service::name().c_str(), result.requestHandle);
+            UAF_LOG_DEBUG(logger_, result.toString());
         }
 
         // if client handles were assigned, copy them to the diagnostics of the Status object
@@ -26,6 +26,8 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <set>
+#include <algorithm>
 // SDK
 #include "uabasecpp/uathread.h"
 #include "uabasecpp/uamutex.h"
@@ -115,6 +117,101 @@ namespace uaf
         void setClientSettings(const uaf::ClientSettings& settings);
 
 
+        /**
+         * Get the total number of log messages that were dropped because the buffer of the
+         * asynchronous logging was full.
+         *
+         * @return The number of dropped log messages.
+         */
+        uint64_t noOfDroppedLogMessages() const;
+
+
+        /**
+         * Get the number of times that a resolved address was found in the address cache.
+         *
+         * @return The number of address cache hits.
+         */
+        uint64_t noOfAddressCacheHits() const;
+
+
+        /**
+         * Get the number of times that an address which could not be resolved was found in the
+         * address cache (see ClientSettings::addressCacheNegativeTtlSec).
+         *
+         * @return The number of negative address cache hits.
+         */
+        uint64_t noOfAddressCacheNegativeHits() const;
+
+
+        /**
+         * Get the number of times that an address was not found in the address cache.
+         *
+         * @return The number of address cache misses.
+         */
+        uint64_t noOfAddressCacheMisses() const;
+
+
+        /**
+         * Get the number of addresses that were evicted from the address cache because it was
+         * full (see ClientSettings::addressCacheMaxSize).
+         *
+         * @return The number of address cache evictions.
+         */
+        uint64_t noOfAddressCacheEvictions() const;
+
+
+        /**
+         * Get the number of notifications that are queued, but not yet delivered
+         * (see ClientSettings::notificationQueueEnable).
+         *
+         * @return The number of queued notifications.
+         */
+        uint64_t notificationQueueDepth() const;
+
+
+        /**
+         * Get the highest number of notifications that were queued at the same time.
+         *
+         * @return The maximum number of queued notifications.
+         */
+        uint64_t maxNotificationQueueDepth() const;
+
+
+        /**
+         * Get the number of notifications that were dropped because the notification queue of
+         * their subscription was full (see ClientSettings::notificationQueueSize).
+         *
+         * @return The number of dropped notifications.
+         */
+        uint64_t noOfDroppedNotifications() const;
+
+
+        /**
+         * Save the address cache to a snapshot file.
+         *
+         * This is done automatically if ClientSettings::addressCacheSnapshotPath is not empty,
+         * but you can also call this function to save a snapshot to a specific file.
+         *
+         * @param path  The path of the snapshot file.
+         * @return      Good if the snapshot was saved.
+         */
+        uaf::Status saveAddressCacheSnapshot(const std::string& path);
+
+
+        /**
+         * Restore the address cache from a snapshot file.
+         *
+         * This is done automatically when ClientSettings::addressCacheSnapshotPath is changed,
+         * but you can also call this function to load a snapshot from a specific file.
+         * The restored addresses of a server only become available once the client has connected
+         * to the server, and they are dropped if the NamespaceArray of the server has changed.
+         *
+         * @param path  The path of the snapshot file.
+         * @return      Good if the snapshot was loaded.
+         */
+        uaf::Status loadAddressCacheSnapshot(const std::string& path);
+
+
         ////////////////////////////////////////////////////////////////////////////////////////////
         /**
          *  @name ServerDiscovery
@@ -195,6 +292,36 @@ namespace uaf
                 uaf::ReadResult&                                    result);
 
 
+        /**
+         * Read the values of a number of nodes, preferably from the latest value cache.
+         *
+         * The values of nodes that are monitored (by monitored data items that were created
+         * while ClientSettings::latestValueCacheEnable was true) are taken from the cache, if
+         * they were received (or confirmed by a keep-alive of their subscription) at most
+         * maxAgeSec seconds ago. The values of the other nodes are read from the server, by a
+         * single synchronous read request. If all values were cached, no request is sent, and
+         * the requestHandle of the result is uaf::constants::REQUESTHANDLE_NOT_ASSIGNED.
+         *
+         * @param addresses         Addresses of the nodes of which the values should be read.
+         * @param maxAgeSec         The maximum age of a cached value, in seconds.
+         * @param clientConnectionId If not uaf::constants::CLIENTHANDLE_NOT_ASSIGNED, only values
+         *                          cached by this session are used, and the other values are
+         *                          read by this session (see read()).
+         * @param serviceSettings, translateSettings, sessionSettings
+         *                          Only used if values must be read from the server (see read()).
+         * @param result            Result of the request.
+         * @return                  Client-side status.
+         */
+        uaf::Status readCached(
+                const std::vector<uaf::Address>&                    addresses,
+                double                                              maxAgeSec,
+                uaf::ClientConnectionId                             clientConnectionId,
+                const uaf::ReadSettings*                            serviceSettings,
+                const uaf::TranslateBrowsePathsToNodeIdsSettings*   translateSettings,
+                const uaf::SessionSettings*                         sessionSettings,
+                uaf::ReadResult&                                    result);
+
+
 
         /**
          * Read a number of node attributes asynchronously.
@@ -761,6 +888,52 @@ namespace uaf
         		uaf::StructureDefinition& definition);
 
 
+        ///@} //////////////////////////////////////////////////////////////////////////////////////
+        /**
+         *  @name RegisteredNodes
+         *  Register nodes that are accessed frequently.
+         */
+        ///@{
+
+
+        /**
+         * Register nodes (by the RegisterNodes service of their servers).
+         *
+         * The servers assign an alias (typically a numeric NodeId) to each registered node,
+         * which is used automatically instead of the original NodeId by all subsequent Read
+         * and Write services (within the sessions that are configured for the servers). This
+         * makes these services more efficient, especially for nodes with long string
+         * identifiers that are accessed frequently (e.g. by cyclic polling).
+         *
+         * The nodes are registered again automatically when a session is reconnected.
+         *
+         * @param addresses         The addresses of the nodes to register.
+         * @param serviceSettings   The service settings to be used.
+         *                          Assign to NULL to use the default service settings.
+         * @param results           Output parameter: a status for each address.
+         * @return                  Good if all nodes could be registered, bad if not.
+         */
+        uaf::Status registerNodes(
+                const std::vector<uaf::Address>&    addresses,
+                const uaf::ServiceSettings*         serviceSettings,
+                std::vector<uaf::Status>&           results);
+
+
+        /**
+         * Unregister nodes that were registered before by registerNodes().
+         *
+         * @param addresses         The addresses of the nodes to unregister.
+         * @param serviceSettings   The service settings to be used.
+         *                          Assign to NULL to use the default service settings.
+         * @param results           Output parameter: a status for each address.
+         * @return                  Good if all nodes could be unregistered, bad if not.
+         */
+        uaf::Status unregisterNodes(
+                const std::vector<uaf::Address>&    addresses,
+                const uaf::ServiceSettings*         serviceSettings,
+                std::vector<uaf::Status>&           results);
+
+
         ///@} //////////////////////////////////////////////////////////////////////////////////////
         /**
          *  @name ManualConnection
@@ -1177,18 +1350,70 @@ namespace uaf
         /** The mutex to lock when the currentRequestHandle_ is read or manipulated. */
         UaMutex requestHandleMutex_;
 
+        /** A copy of ClientSettings::addressCacheSnapshotPath, which can be read by the thread
+         *  (only to be read or manipulated when addressCacheSnapshotPathMutex_ is locked). */
+        std::string addressCacheSnapshotPath_;
+
+        /** The mutex to lock when the addressCacheSnapshotPath_ is read or manipulated. */
+        UaMutex addressCacheSnapshotPathMutex_;
+
+        /** The pool of threads that execute the background tasks (discovery, housekeeping, ...),
+         *  as they become due on the database_->backgroundTasks timer wheel. */
+        uaf::ThreadPool* backgroundPool_;
+
+        /** The background tasks that are currently being executed by the pool, and the tasks
+         *  that became due again in the meantime (only to be read or manipulated when
+         *  backgroundTasksMutex_ is locked). */
+        std::set<uint64_t> runningBackgroundTasks_;
+        std::set<uint64_t> rerunBackgroundTasks_;
+
+        /** The mutex to lock when the running or rerun background tasks are manipulated. */
+        UaMutex backgroundTasksMutex_;
+
+        /** A job to execute a background task on the background pool. */
+        class BackgroundJob;
+
         /** The callback registry for events. */
         uaf::CallbackRegistry<EventNotification> eventCallbackRegistry_;
 
         /** The callback registry for monitored data. */
         uaf::CallbackRegistry<DataChangeNotification> dataCallbackRegistry_;
 
+        /**
+         * Get the path of the address cache snapshot (thread-safe).
+         */
+        std::string addressCacheSnapshotPath();
+
         /**
          * Run method of the thread.
          */
         void run();
 
 
+        /**
+         * Schedule the periodic background tasks, according to the current client settings.
+         *
+         * Tasks that are already scheduled keep their deadline, unless the new one is earlier.
+         */
+        void schedulePeriodicBackgroundTasks();
+
+
+        /**
+         * Start a background task that has become due.
+         *
+         * @param taskId    The number identifying the task (see uaf::backgroundtasks).
+         */
+        void startBackgroundTask(uint64_t taskId);
+
+
+        /**
+         * Execute a background task (called by a thread of the background pool).
+         *
+         * @param taskId    The number identifying the task (see uaf::backgroundtasks).
+         */
+        void executeBackgroundTask(uint64_t taskId);
+
+
         /**
          * Common code of the constructors.
          */
@@ -1210,6 +1435,22 @@ namespace uaf
         virtual void eventsReceived(std::vector<uaf::EventNotification> notifications);
 
 
+        /**
+         * Register or unregister nodes (common code of registerNodes and unregisterNodes).
+         *
+         * @param registering       True to register the nodes, false to unregister them.
+         * @param addresses         The addresses of the nodes.
+         * @param serviceSettings   The service settings to be used (may be NULL).
+         * @param results           Output parameter: a status for each address.
+         * @return                  Good if all nodes could be processed, bad if not.
+         */
+        uaf::Status changeNodeRegistrations(
+                bool                                registering,
+                const std::vector<uaf::Address>&    addresses,
+                const uaf::ServiceSettings*         serviceSettings,
+                std::vector<uaf::Status>&           results);
+
+
 
 #ifndef SWIG /* The private template functions below do not need to be seen by SWIG. */
 
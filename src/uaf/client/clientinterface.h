@@ -126,6 +126,36 @@ namespace uaf
         virtual void dataChangesReceived(std::vector<uaf::DataChangeNotification> notifications) {}
 
 
+        /**
+         * Override this method to handle the events of a publish response without copying them.
+         *
+         * The notifications are passed by reference, so they are only valid during the call.
+         * By default, a copy of them is passed to eventsReceived().
+         *
+         * @param notifications Received event notifications.
+         */
+        virtual void eventBatchReceived(const std::vector<uaf::EventNotification>& notifications)
+        {
+            eventsReceived(notifications);
+        }
+
+
+        /**
+         * Override this method to handle the data changes of a publish response without copying
+         * them.
+         *
+         * The notifications are passed by reference, so they are only valid during the call.
+         * By default, a copy of them is passed to dataChangesReceived().
+         *
+         * @param notifications Received data change notifications.
+         */
+        virtual void dataChangeBatchReceived(
+                const std::vector<uaf::DataChangeNotification>& notifications)
+        {
+            dataChangesReceived(notifications);
+        }
+
+
         /**
          * Override this method to handle keep alive notifications.
          *
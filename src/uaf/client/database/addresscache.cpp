@@ -20,6 +20,11 @@
 
 #include "uaf/client/database/addresscache.h"
 
+// STD
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+
 
 
 
@@ -28,16 +33,21 @@ namespace uaf
     using namespace uaf;
     using std::string;
     using std::vector;
-    using std::map;
     using std::size_t;
 
 
     // Constructor
     // =============================================================================================
     AddressCache::AddressCache(LoggerFactory* loggerFactory)
+    : maxSizePerShard_(0),
+      hits_(0),
+      negativeHits_(0),
+      misses_(0),
+      evictions_(0),
+      negativeTtlMs_(0)
     {
         logger_ = new Logger(loggerFactory, "AddressCache");
-        logger_->debug("The address cache has been constructed");
+        UAF_LOG_DEBUG(logger_, "The address cache has been constructed");
     }
 
 
@@ -45,7 +55,7 @@ namespace uaf
     // =============================================================================================
     AddressCache::~AddressCache()
     {
-        logger_->debug("Destructing the address cache");
+        UAF_LOG_DEBUG(logger_, "Destructing the address cache");
 
         clear();
 
@@ -60,9 +70,13 @@ namespace uaf
     {
         logger_->info("Clearing the address cache");
 
-        UaMutexLocker locker(&mutex_); // unlocks when locker goes out of scope
+        for (size_t i = 0; i < noOfShards; i++)
+        {
+            UaMutexLocker locker(&shards_[i].mutex); // unlocks when locker goes out of scope
 
-        cache_.clear();
+            shards_[i].cache.clear();
+            shards_[i].lru.clear();
+        }
     }
 
 
@@ -72,25 +86,33 @@ namespace uaf
     {
         logger_->info("Clearing the cached addresses for ServerUri '%s':", serverUri.c_str());
 
-        UaMutexLocker locker(&mutex_); // unlocks when locker goes out of scope
+        size_t        noOfRemoved = 0;
+        const Server* server      = getServer(serverUri);
 
-        Cache::iterator it = cache_.begin();
-        while(it != cache_.end())
+        for (size_t i = 0; i < noOfShards && server != 0; i++)
         {
-            if (it->second.serverUri() == serverUri)
-            {
-                logger_->debug("Removing the address from the cache");
-                cache_.erase(it++);  // The post increment increments the iterator but returns the
-                                     // original value for use by erase
-            }
-            else
+            Shard& shard = shards_[i];
+
+            UaMutexLocker locker(&shard.mutex); // unlocks when locker goes out of scope
+
+            Cache::iterator it = shard.cache.begin();
+            while(it != shard.cache.end())
             {
-                ++it; // Can use pre-increment here to make sure you have the efficient version
+                if (it->second.server == server)
+                {
+                    Cache::iterator removed = it++;
+                    erase(shard, removed);
+                    noOfRemoved++;
+                }
+                else
+                {
+                    ++it;
+                }
             }
         }
 
-        logger_->debug("All cached addresses for ServerUri '%s' have been cleared",
-                       serverUri.c_str());
+        UAF_LOG_DEBUG(logger_, "All %d cached addresses for ServerUri '%s' have been cleared",
+                               noOfRemoved, serverUri.c_str());
 
     }
 
@@ -102,21 +124,10 @@ namespace uaf
             const ExpandedNodeId&   expandedNodeId,
             bool                    replaceIfExists)
     {
-
-        UaMutexLocker locker(&mutex_); // unlocks when locker goes out of scope
-
-        Cache::iterator iter = cache_.find(address);
-
-        if (iter == cache_.end() || replaceIfExists)
-        {
+        if (insert(address, expandedNodeId, replaceIfExists))
             logger_->info("The address is now cached");
-
-            cache_[address] = expandedNodeId;
-        }
         else
-        {
             logger_->info("The address was already cached and we mustn't replace it");
-        }
     }
 
 
@@ -128,38 +139,101 @@ namespace uaf
             bool                            replaceIfExists)
     {
         if (replaceIfExists)
-            logger_->debug("Caching %d addresses (existing items will be replaced)",
-                           addresses.size());
+            UAF_LOG_DEBUG(logger_, "Caching %d addresses (existing items will be replaced)",
+                                   addresses.size());
         else
-            logger_->debug("Caching %d addresses (existing items will NOT be replaced)",
-                           addresses.size());
+            UAF_LOG_DEBUG(logger_, "Caching %d addresses (existing items will NOT be replaced)",
+                                   addresses.size());
 
         for (size_t i = 0; i < addresses.size(); i++)
             add(addresses[i], expandedNodeIds[i], replaceIfExists);
     }
 
 
+    // Add an address that could not be resolved to the cache
+    // =============================================================================================
+    void AddressCache::addFailure(const Address& address, const Status& status)
+    {
+        if (negativeTtlMs_ == 0)
+            return;
+
+        // the failure belongs to the server of the (innermost) starting address
+        const Address* startingAddress = &address;
+        while (startingAddress->isRelativePath())
+            startingAddress = startingAddress->getStartingAddress();
+
+        string serverUri;
+        extractServerUri(*startingAddress, serverUri);
+
+        insert(address, ExpandedNodeId(), status, serverUri, true);
+
+        UAF_LOG_INFO(logger_, "The address could not be resolved, this is now cached: %s",
+                              status.toString().c_str());
+    }
+
+
     // Find the resolved ExpandedNodeId for a particular address
     // =============================================================================================
     bool AddressCache::find(const Address& address, uaf::ExpandedNodeId& expandedNodeId)
     {
-        logger_->debug("Trying to find the following address in the cache (size=%d)", cache_.size());
-        logger_->debug(address.toString());
+        Status status;
+        return find(address, expandedNodeId, status) && status.isGood();
+    }
 
-        UaMutexLocker locker(&mutex_); // unlocks when locker goes out of scope
 
-        Cache::const_iterator iter = cache_.find(address);
+    // Find the resolved ExpandedNodeId (or the failure) for a particular address
+    // =============================================================================================
+    bool AddressCache::find(
+            const Address&          address,
+            uaf::ExpandedNodeId&    expandedNodeId,
+            Status&                 status)
+    {
+        UAF_LOG_DEBUG(logger_, "Trying to find the following address in the cache (size=%d)", size());
+        UAF_LOG_DEBUG(logger_, address.toString());
 
-        bool found = (iter != cache_.end());
+        bool found;
+
+        {
+            Shard& shard = shardOf(address);
+
+            UaMutexLocker locker(&shard.mutex); // unlocks when locker goes out of scope
+
+            Cache::iterator iter = shard.cache.find(address);
+
+            found = (iter != shard.cache.end());
+
+            // remove the entry if it has been invalidated or if it has expired
+            if (found && !isValid(iter->second, Clock::now()))
+            {
+                erase(shard, iter);
+                found = false;
+            }
+
+            if (found)
+            {
+                expandedNodeId = iter->second.expandedNodeId;
+                status         = iter->second.status;
+
+                // mark the address as the most recently used one
+                shard.lru.splice(shard.lru.begin(), shard.lru, iter->second.lruPosition);
+            }
+        }
 
         if (found)
         {
-            expandedNodeId = iter->second;
+            if (status.isGood())
+                hits_++;
+            else
+                negativeHits_++;
             logger_->info("The address was found in the cache");
-            logger_->info("It corresponds to %s", expandedNodeId.toString().c_str());
+            if (status.isGood())
+                UAF_LOG_INFO(logger_, "It corresponds to %s", expandedNodeId.toString().c_str());
+            else
+                UAF_LOG_INFO(logger_, "It could not be resolved: %s", status.toString().c_str());
         }
         else
         {
+            misses_++;
             logger_->info("The address was not found in the cache");
         }
 
@@ -167,8 +241,668 @@ namespace uaf
     }
 
 
+    // Invalidate all cached addresses of a server
+    // =============================================================================================
+    void AddressCache::invalidate(const string& serverUri)
+    {
+        logger_->info("Invalidating the cached addresses for ServerUri '%s'", serverUri.c_str());
 
+        Server* server = getServer(serverUri);
+        if (server != 0)
+            server->generation++;
+    }
 
-}
 
+    // Set the time to live of the cached failures
+    // =============================================================================================
+    void AddressCache::setNegativeTtl(double seconds)
+    {
+        negativeTtlMs_ = (seconds > 0.0 ? int64_t(seconds * 1000.0) : 0);
+    }
+
+
+    // Limit the size of the cache
+    // =============================================================================================
+    void AddressCache::setMaxSize(uint32_t maxSize)
+    {
+        // round up, so that the cache can hold at least maxSize addresses
+        size_t maxSizePerShard = (maxSize + noOfShards - 1) / noOfShards;
+
+        if (maxSizePerShard == maxSizePerShard_)
+            return;
+
+        logger_->info("Limiting the address cache to %d addresses", maxSize);
+
+        maxSizePerShard_ = maxSizePerShard;
+
+        for (size_t i = 0; i < noOfShards; i++)
+        {
+            UaMutexLocker locker(&shards_[i].mutex); // unlocks when locker goes out of scope
+            evictIfNeeded(shards_[i]);
+        }
+    }
+
+
+    // Get the number of cached addresses
+    // =============================================================================================
+    size_t AddressCache::size() const
+    {
+        size_t ret = 0;
+
+        for (size_t i = 0; i < noOfShards; i++)
+        {
+            UaMutexLocker locker(&shards_[i].mutex); // unlocks when locker goes out of scope
+            ret += shards_[i].cache.size();
+        }
+
+        return ret;
+    }
+
+
+    // Get the shard of an address
+    // =============================================================================================
+    AddressCache::Shard& AddressCache::shardOf(const Address& address)
+    {
+        // the lowest bits of the hash are used by the hash maps, so mix in the higher bits
+        size_t hash = address.hash();
+        return shards_[(hash ^ (hash >> 16)) % noOfShards];
+    }
+
+
+    // Evict the least recently used addresses of a shard
+    // =============================================================================================
+    void AddressCache::evictIfNeeded(Shard& shard)
+    {
+        size_t maxSizePerShard = maxSizePerShard_;
+
+        while (maxSizePerShard != 0 && shard.cache.size() > maxSizePerShard)
+        {
+            erase(shard, shard.cache.find(*shard.lru.back()));
+            evictions_++;
+        }
+    }
+
+
+    // Remove an entry from a shard
+    // =============================================================================================
+    void AddressCache::erase(Shard& shard, Cache::iterator iter)
+    {
+        shard.lru.erase(iter->second.lruPosition);
+        shard.cache.erase(iter);
+    }
+
+
+    // Check if an entry can still be used
+    // =============================================================================================
+    bool AddressCache::isValid(const Entry& entry, Clock::time_point now)
+    {
+        if (entry.server != 0 && entry.server->generation != entry.generation)
+            return false;
+        else if (entry.status.isNotGood() && now >= entry.expiry)
+            return false;
+        else
+            return true;
+    }
+
+
+    // Get the server with the given URI
+    // =============================================================================================
+    AddressCache::Server* AddressCache::getServer(const string& serverUri)
+    {
+        if (serverUri.empty())
+            return 0;
+
+        UaMutexLocker locker(&serversMutex_); // unlocks when locker goes out of scope
+        return &servers_[serverUri];
+    }
+
+
+    // Add an address to the cache without logging
+    // =============================================================================================
+    bool AddressCache::insert(
+            const Address&          address,
+            const ExpandedNodeId&   expandedNodeId,
+            bool                    replaceIfExists)
+    {
+        return insert(address,
+                      expandedNodeId,
+                      Status(statuscodes::Good),
+                      expandedNodeId.serverUri(),
+                      replaceIfExists);
+    }
+
+
+    // Add an address (or failure) to the cache without logging
+    // =============================================================================================
+    bool AddressCache::insert(
+            const Address&          address,
+            const ExpandedNodeId&   expandedNodeId,
+            const Status&           status,
+            const string&           serverUri,
+            bool                    replaceIfExists)
+    {
+        // determine the generation before locking the shard (if the server is invalidated in the
+        // meantime, the entry will simply be invalid)
+        Entry entry;
+        entry.expandedNodeId = expandedNodeId;
+        entry.status         = status;
+        entry.server         = getServer(serverUri);
+        entry.generation     = (entry.server != 0 ? uint64_t(entry.server->generation) : 0);
+        if (status.isNotGood())
+            entry.expiry = Clock::now() + std::chrono::milliseconds(int64_t(negativeTtlMs_));
+
+        Shard& shard = shardOf(address);
+
+        UaMutexLocker locker(&shard.mutex); // unlocks when locker goes out of scope
+
+        Cache::iterator iter = shard.cache.find(address);
+
+        if (iter == shard.cache.end())
+        {
+            iter = shard.cache.insert(Cache::value_type(address, entry)).first;
+            shard.lru.push_front(&iter->first);
+            iter->second.lruPosition = shard.lru.begin();
+            evictIfNeeded(shard);
+            return true;
+        }
+        else if (replaceIfExists || !isValid(iter->second, Clock::now()))
+        {
+            entry.lruPosition = iter->second.lruPosition;
+            iter->second = entry;
+            shard.lru.splice(shard.lru.begin(), shard.lru, iter->second.lruPosition);
+            return true;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+
+    // Register the NamespaceArray fingerprint of a server
+    // =============================================================================================
+    void AddressCache::setNamespaceArrayFingerprint(const string& serverUri, uint64_t fingerprint)
+    {
+        SnapshotEntries restored;
+        size_t          noOfDropped = 0;
+        bool            changed     = false;
+
+        {
+            UaMutexLocker locker(&snapshotMutex_); // unlocks when locker goes out of scope
+
+            Fingerprints::iterator known = fingerprints_.find(serverUri);
+            changed = (known != fingerprints_.end() && known->second != fingerprint);
+            fingerprints_[serverUri] = fingerprint;
+
+            PendingServers::iterator pending = pending_.find(serverUri);
+            if (pending != pending_.end())
+            {
+                if (pending->second.fingerprint == fingerprint)
+                    restored.swap(pending->second.entries);
+                else
+                    noOfDropped = pending->second.entries.size();
+
+                pending_.erase(pending);
+            }
+        }
+
+        if (changed)
+        {
+            logger_->info("The NamespaceArray of ServerUri '%s' has changed", serverUri.c_str());
+            invalidate(serverUri);
+        }
+
+        // the cached addresses (e.g. resolved since the snapshot was loaded) have priority
+        for (size_t i = 0; i < restored.size(); i++)
+            insert(restored[i].first, restored[i].second, false);
+
+        if (!restored.empty())
+            logger_->info("%d addresses of ServerUri '%s' have been restored from the snapshot",
+                          restored.size(), serverUri.c_str());
+
+        if (noOfDropped > 0)
+            logger_->info("%d addresses of ServerUri '%s' from the snapshot have been dropped, "
+                          "since the NamespaceArray has changed", noOfDropped, serverUri.c_str());
+    }
+
+
+    // The snapshot file format (all integers are little-endian):
+    //  - magic "UAFADDRC", followed by uint32 version
+    //  - uint32 number of servers, and for each server:
+    //     - string serverUri, uint64 NamespaceArray fingerprint
+    //     - uint32 number of entries, and for each entry: Address, ExpandedNodeId
+    // Strings are stored as uint32 length + bytes.
+    static const char     snapshotMagic[]  = "UAFADDRC";
+    static const uint32_t snapshotVersion  = 1;
+
+    // Relative paths nested deeper than this are considered to be corrupt
+    static const size_t   snapshotMaxDepth = 64;
 
+
+    // Write an unsigned integer to a snapshot
+    // =============================================================================================
+    static void writeUInt(string& buffer, uint64_t value, size_t noOfBytes)
+    {
+        for (size_t i = 0; i < noOfBytes; i++)
+            buffer.push_back(char((value >> (8 * i)) & 0xFF));
+    }
+
+
+    // Write a string to a snapshot
+    // =============================================================================================
+    static void writeString(string& buffer, const string& value)
+    {
+        writeUInt(buffer, value.size(), 4);
+        buffer.append(value);
+    }
+
+
+    // Write a NodeId to a snapshot
+    // =============================================================================================
+    static void writeNodeId(string& buffer, const NodeId& nodeId)
+    {
+        NodeIdIdentifier identifier = nodeId.identifier();
+
+        writeUInt(buffer,   (nodeId.hasNameSpaceIndex() ? 1 : 0)
+                          | (nodeId.hasNameSpaceUri() ? 2 : 0), 1);
+        writeUInt(buffer, nodeId.nameSpaceIndex(), 2);
+        writeString(buffer, nodeId.nameSpaceUri());
+        writeUInt(buffer, identifier.type, 1);
+
+        if (identifier.type == nodeididentifiertypes::Identifier_Numeric)
+            writeUInt(buffer, identifier.idNumeric, 4);
+        else if (identifier.type == nodeididentifiertypes::Identifier_String)
+            writeString(buffer, identifier.idString);
+        else if (identifier.type == nodeididentifiertypes::Identifier_Guid)
+            writeString(buffer, identifier.idGuid.toString());
+        else
+            writeString(buffer, string((const char*)identifier.idOpaque.data(),
+                                       identifier.idOpaque.length()));
+    }
+
+
+    // Write an ExpandedNodeId to a snapshot
+    // =============================================================================================
+    static void writeExpandedNodeId(string& buffer, const ExpandedNodeId& expandedNodeId)
+    {
+        writeNodeId(buffer, expandedNodeId.nodeId());
+        writeUInt(buffer,   (expandedNodeId.hasServerIndex() ? 1 : 0)
+                          | (expandedNodeId.hasServerUri() ? 2 : 0), 1);
+        writeUInt(buffer, expandedNodeId.serverIndex(), 4);
+        writeString(buffer, expandedNodeId.serverUri());
+    }
+
+
+    // Write an Address to a snapshot
+    // =============================================================================================
+    static void writeAddress(string& buffer, const Address& address)
+    {
+        if (address.isExpandedNodeId())
+        {
+            writeUInt(buffer, 0, 1);
+            writeExpandedNodeId(buffer, address.getExpandedNodeId());
+        }
+        else
+        {
+            vector<RelativePathElement> relativePath = address.getRelativePath();
+
+            writeUInt(buffer, 1, 1);
+            writeAddress(buffer, *address.getStartingAddress());
+            writeUInt(buffer, relativePath.size(), 4);
+
+            for (size_t i = 0; i < relativePath.size(); i++)
+            {
+                const QualifiedName& targetName = relativePath[i].targetName;
+                writeUInt(buffer,   (targetName.hasNameSpaceIndex() ? 1 : 0)
+                                  | (targetName.hasNameSpaceUri() ? 2 : 0), 1);
+                writeUInt(buffer, targetName.nameSpaceIndex(), 2);
+                writeString(buffer, targetName.nameSpaceUri());
+                writeString(buffer, targetName.name());
+                writeNodeId(buffer, relativePath[i].referenceType);
+                writeUInt(buffer,   (relativePath[i].isInverse ? 1 : 0)
+                                  | (relativePath[i].includeSubtypes ? 2 : 0), 1);
+            }
+        }
+    }
+
+
+    // Reader of a snapshot, which fails (rather than reads beyond the end) if the data is corrupt
+    // =============================================================================================
+    struct SnapshotReader
+    {
+        SnapshotReader(const string& buffer) : buffer(buffer), position(0), ok(true) {}
+
+        const string&   buffer;
+        size_t          position;
+        bool            ok;
+
+        uint64_t readUInt(size_t noOfBytes)
+        {
+            uint64_t value = 0;
+            if (!ok || buffer.size() - position < noOfBytes)
+            {
+                ok = false;
+                return 0;
+            }
+            for (size_t i = 0; i < noOfBytes; i++)
+                value |= uint64_t(uint8_t(buffer[position++])) << (8 * i);
+            return value;
+        }
+
+        string readString()
+        {
+            size_t length = size_t(readUInt(4));
+            if (!ok || buffer.size() - position < length)
+            {
+                ok = false;
+                return string();
+            }
+            position += length;
+            return buffer.substr(position - length, length);
+        }
+
+        NodeId readNodeId()
+        {
+            uint64_t         flags          = readUInt(1);
+            NameSpaceIndex   nameSpaceIndex = NameSpaceIndex(readUInt(2));
+            string           nameSpaceUri   = readString();
+            NodeIdIdentifier identifier;
+            uint64_t         type           = readUInt(1);
+
+            if (type == nodeididentifiertypes::Identifier_Numeric)
+                identifier = NodeIdIdentifier(uint32_t(readUInt(4)));
+            else if (type == nodeididentifiertypes::Identifier_String)
+                identifier = NodeIdIdentifier(readString());
+            else if (type == nodeididentifiertypes::Identifier_Guid)
+                identifier = NodeIdIdentifier(Guid(readString()));
+            else if (type == nodeididentifiertypes::Identifier_Opaque)
+            {
+                string opaque = readString();
+                vector<uint8_t> data(opaque.begin(), opaque.end());
+                identifier = NodeIdIdentifier(ByteString(int32_t(data.size()),
+                                                         data.empty() ? 0 : &data[0]));
+            }
+            else
+                ok = false;
+
+            if ((flags & 1) && (flags & 2))
+                return NodeId(identifier, nameSpaceUri, nameSpaceIndex);
+            else if (flags & 1)
+                return NodeId(identifier, nameSpaceIndex);
+            else
+                return NodeId(identifier, nameSpaceUri);
+        }
+
+        ExpandedNodeId readExpandedNodeId()
+        {
+            NodeId      nodeId      = readNodeId();
+            uint64_t    flags       = readUInt(1);
+            ServerIndex serverIndex = ServerIndex(readUInt(4));
+            string      serverUri   = readString();
+
+            if ((flags & 1) && (flags & 2))
+                return ExpandedNodeId(nodeId, serverUri, serverIndex);
+            else if (flags & 1)
+                return ExpandedNodeId(nodeId, serverIndex);
+            else
+                return ExpandedNodeId(nodeId, serverUri);
+        }
+
+        Address readAddress(size_t depth = 0)
+        {
+            uint64_t type = readUInt(1);
+
+            if (type == 0)
+                return Address(readExpandedNodeId());
+
+            if (type != 1 || depth >= snapshotMaxDepth)
+            {
+                ok = false;
+                return Address();
+            }
+
+            Address startingAddress = readAddress(depth + 1);
+            size_t  noOfElements    = size_t(readUInt(4));
+
+            vector<RelativePathElement> relativePath;
+            for (size_t i = 0; i < noOfElements && ok; i++)
+            {
+                uint64_t    nameFlags      = readUInt(1);
+                uint16_t    nameSpaceIndex = uint16_t(readUInt(2));
+                string      nameSpaceUri   = readString();
+                string      name           = readString();
+                NodeId      referenceType  = readNodeId();
+                uint64_t    elementFlags   = readUInt(1);
+
+                QualifiedName targetName;
+                if ((nameFlags & 1) && (nameFlags & 2))
+                    targetName = QualifiedName(name, nameSpaceUri, nameSpaceIndex);
+                else if (nameFlags & 1)
+                    targetName = QualifiedName(name, nameSpaceIndex);
+                else if (nameFlags & 2)
+                    targetName = QualifiedName(name, nameSpaceUri);
+                else
+                    targetName = QualifiedName(name);
+
+                relativePath.push_back(RelativePathElement(targetName,
+                                                           referenceType,
+                                                           (elementFlags & 1) != 0,
+                                                           (elementFlags & 2) != 0));
+            }
+
+            return Address(&startingAddress, relativePath);
+        }
+    };
+
+
+    // Save the cache to a snapshot
+    // =============================================================================================
+    Status AddressCache::saveSnapshot(const string& path)
+    {
+        UAF_LOG_DEBUG(logger_, "Saving the address cache to snapshot '%s'", path.c_str());
+
+        Status ret;
+        size_t noOfAddresses = 0;
+        string buffer;
+
+        {
+            UaMutexLocker locker(&snapshotMutex_); // unlocks when locker goes out of scope
+
+            // group the cached addresses per server (if the server's fingerprint is known)
+            // (failures are not saved, since they are only cached for a short time)
+            std::map<string, SnapshotEntries> servers;
+            Clock::time_point now = Clock::now();
+
+            for (size_t i = 0; i < noOfShards; i++)
+            {
+                UaMutexLocker shardLocker(&shards_[i].mutex); // unlocks when out of scope
+
+                for (Cache::const_iterator it = shards_[i].cache.begin();
+                     it != shards_[i].cache.end();
+                     ++it)
+                {
+                    const string& serverUri = it->second.expandedNodeId.serverUri();
+                    if (   it->second.status.isGood()
+                        && isValid(it->second, now)
+                        && fingerprints_.find(serverUri) != fingerprints_.end())
+                        servers[serverUri].push_back(
+                                std::make_pair(it->first, it->second.expandedNodeId));
+                }
+            }
+
+            buffer.append(snapshotMagic, sizeof(snapshotMagic) - 1);
+            writeUInt(buffer, snapshotVersion, 4);
+            writeUInt(buffer, servers.size() + pending_.size(), 4);
+
+            for (std::map<string, SnapshotEntries>::const_iterator it = servers.begin();
+                 it != servers.end();
+                 ++it)
+            {
+                writeString(buffer, it->first);
+                writeUInt(buffer, fingerprints_[it->first], 8);
+                writeUInt(buffer, it->second.size(), 4);
+                for (size_t i = 0; i < it->second.size(); i++)
+                {
+                    writeAddress(buffer, it->second[i].first);
+                    writeExpandedNodeId(buffer, it->second[i].second);
+                }
+                noOfAddresses += it->second.size();
+            }
+
+            // also keep the restored addresses of servers that were not connected (yet)
+            for (PendingServers::const_iterator it = pending_.begin(); it != pending_.end(); ++it)
+            {
+                writeString(buffer, it->first);
+                writeUInt(buffer, it->second.fingerprint, 8);
+                writeUInt(buffer, it->second.entries.size(), 4);
+                for (size_t i = 0; i < it->second.entries.size(); i++)
+                {
+                    writeAddress(buffer, it->second.entries[i].first);
+                    writeExpandedNodeId(buffer, it->second.entries[i].second);
+                }
+                noOfAddresses += it->second.entries.size();
+            }
+        }
+
+        // write a temporary file first, so that a crash can never leave a corrupt snapshot
+        string temporaryPath = path + ".tmp";
+        bool   written;
+        {
+            std::ofstream file(temporaryPath.c_str(),
+                               std::ios::out | std::ios::binary | std::ios::trunc);
+            file.write(buffer.data(), buffer.size());
+            file.close();
+            written = !file.fail();
+        }
+
+        // (on some platforms, rename() fails if the destination exists already)
+        if (written && std::rename(temporaryPath.c_str(), path.c_str()) != 0)
+        {
+            std::remove(path.c_str());
+            written = (std::rename(temporaryPath.c_str(), path.c_str()) == 0);
+        }
+
+        if (written)
+        {
+            logger_->info("%d addresses have been saved to snapshot '%s' (%d bytes)",
+                          noOfAddresses, path.c_str(), buffer.size());
+            ret = statuscodes::Good;
+        }
+        else
+        {
+            std::remove(temporaryPath.c_str());
+            ret = PathCreationError(path, "address cache snapshot");
+            logger_->error(ret);
+        }
+
+        return ret;
+    }
+
+
+    // Restore the cache from a snapshot
+    // =============================================================================================
+    Status AddressCache::loadSnapshot(const string& path)
+    {
+        UAF_LOG_DEBUG(logger_, "Loading the address cache from snapshot '%s'", path.c_str());
+
+        Status ret;
+        string buffer;
+
+        {
+            std::ifstream file(path.c_str(), std::ios::in | std::ios::binary);
+            if (!file.is_open())
+            {
+                ret = PathNotExistsError(path, "address cache snapshot");
+                logger_->info(ret.toString());
+                return ret;
+            }
+            buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        }
+
+        // parse the complete file before touching the cache, so a corrupt file is ignored
+        SnapshotReader reader(buffer);
+        PendingServers servers;
+        size_t         noOfAddresses = 0;
+
+        bool validHeader = buffer.compare(0, sizeof(snapshotMagic) - 1, snapshotMagic) == 0;
+        reader.position = sizeof(snapshotMagic) - 1;
+
+        if (validHeader && reader.readUInt(4) == snapshotVersion)
+        {
+            size_t noOfServers = size_t(reader.readUInt(4));
+
+            for (size_t i = 0; i < noOfServers && reader.ok; i++)
+            {
+                PendingServer& server = servers[reader.readString()];
+
+                server.fingerprint = reader.readUInt(8);
+                size_t noOfEntries = size_t(reader.readUInt(4));
+
+                for (size_t j = 0; j < noOfEntries && reader.ok; j++)
+                {
+                    Address        address        = reader.readAddress();
+                    ExpandedNodeId expandedNodeId = reader.readExpandedNodeId();
+                    server.entries.push_back(std::make_pair(address, expandedNodeId));
+                }
+
+                noOfAddresses += server.entries.size();
+            }
+        }
+        else
+        {
+            reader.ok = false;
+        }
+
+        if (!reader.ok || reader.position != buffer.size())
+        {
+            ret = UnexpectedError(uaf::format("The address cache snapshot '%s' is corrupt or "
+                                              "has an unsupported version", path.c_str()));
+            logger_->error(ret);
+            return ret;
+        }
+
+        // restore the addresses of the servers of which the fingerprint is already known,
+        // and keep the others until their fingerprint becomes known
+        SnapshotEntries restored;
+        size_t          noOfDropped = 0;
+
+        {
+            UaMutexLocker locker(&snapshotMutex_); // unlocks when locker goes out of scope
+
+            for (PendingServers::iterator it = servers.begin(); it != servers.end(); ++it)
+            {
+                Fingerprints::const_iterator known = fingerprints_.find(it->first);
+
+                if (known == fingerprints_.end())
+                {
+                    pending_[it->first] = it->second;
+                }
+                else if (known->second == it->second.fingerprint)
+                {
+                    restored.insert(restored.end(),
+                                    it->second.entries.begin(),
+                                    it->second.entries.end());
+                }
+                else
+                {
+                    noOfDropped += it->second.entries.size();
+                }
+            }
+        }
+
+        for (size_t i = 0; i < restored.size(); i++)
+            insert(restored[i].first, restored[i].second, false);
+
+        logger_->info("%d addresses of %d servers have been loaded from snapshot '%s' "
+                      "(%d restored, %d dropped, the others will be restored once the server's "
+                      "NamespaceArray is known)",
+                      noOfAddresses, servers.size(), path.c_str(), restored.size(), noOfDropped);
+
+        ret = statuscodes::Good;
+        return ret;
+    }
+
+
+
+
+}
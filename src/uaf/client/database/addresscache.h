@@ -25,7 +25,13 @@
 #include <string>
 #include <sstream>
 #include <vector>
+#include <list>
 #include <map>
+#include <utility>
+#include <unordered_map>
+#include <atomic>
+#include <chrono>
+#include <stdint.h>
 // SDK
 #include "uabasecpp/uamutex.h"
 // UAF
@@ -44,6 +50,26 @@ namespace uaf
     * A uaf::AddressCache can speed up address resolution by storing the ExpandedNodeId for each
     * Address.
     *
+    * The cache is split into a fixed number of shards (selected by the hash of the address), each
+    * having its own hash map and its own lock, so that threads resolving different addresses
+    * rarely have to wait for each other. The size of the cache can be limited, in which case the
+    * least recently used addresses are evicted first.
+    *
+    * Addresses that could not be resolved because the server reported that they don't exist
+    * (e.g. BadNoMatch) can be cached as well, for a short time only, so that a typo in an address
+    * doesn't cause a round trip to the server for every request.
+    *
+    * Each server has a generation counter, which is incremented when the cached addresses of the
+    * server cannot be trusted anymore (e.g. because the server has changed its NamespaceArray, or
+    * because the session to the server was lost). Cached addresses of an older generation are
+    * not used anymore, and are removed lazily (i.e. when they are found, or evicted).
+    *
+    * The cache can be saved to a compact binary snapshot file, and restored from it later (e.g.
+    * when the client is restarted). The addresses are stored per server, together with the
+    * fingerprint of the NamespaceArray of the server. Restored addresses only become available
+    * once a session to the server has read its NamespaceArray, and they are dropped if the
+    * fingerprint of the NamespaceArray has changed in the meantime.
+    *
     * @ingroup ClientDatabase
     ***********************************************************************************************/
     class UAF_EXPORT AddressCache
@@ -103,16 +129,155 @@ namespace uaf
                 bool                                    replaceIfExists = false);
 
 
+        /**
+         * Add an address that could not be resolved to the cache.
+         *
+         * The failure is cached for the time specified by setNegativeTtl() only. Only add failures
+         * that will not disappear by simply retrying (e.g. a BadNoMatch reported by the server).
+         *
+         * @param address   The address that could not be resolved.
+         * @param status    The reason why the address could not be resolved.
+         */
+        void addFailure(const uaf::Address& address, const uaf::Status& status);
+
+
         /**
          * Find a the resolved expanded node id of the specified address in the cache.
          *
          * @param address           The address to look up.
          * @param expandedNodeId    The found expandedNodeId (if the address was cached of course).
-         * @return                  True if the address was found, false if not.
+         * @return                  True if the address was found, false if not (or if only a
+         *                          failure was cached).
          */
         bool find(const uaf::Address& address, uaf::ExpandedNodeId& expandedNodeId);
 
 
+        /**
+         * Find the resolved expanded node id, or the cached failure, of the specified address.
+         *
+         * @param address           The address to look up.
+         * @param expandedNodeId    The found expandedNodeId (if the address was resolved).
+         * @param status            Good if the address was resolved, or the reason why the
+         *                          address could not be resolved.
+         * @return                  True if the address (or its failure) was found, false if not.
+         */
+        bool find(
+                const uaf::Address&     address,
+                uaf::ExpandedNodeId&    expandedNodeId,
+                uaf::Status&            status);
+
+
+        /**
+         * Invalidate all cached addresses (and failures) of a server.
+         *
+         * This only increments the generation of the server, so it takes constant time. The
+         * invalidated addresses are removed lazily.
+         *
+         * @param serverUri The URI of the server.
+         */
+        void invalidate(const std::string& serverUri);
+
+
+        /**
+         * Set the time that failures remain cached.
+         *
+         * @param seconds   The time to live of failures, in seconds (0 to not cache them at all).
+         */
+        void setNegativeTtl(double seconds);
+
+
+        /**
+         * Limit the number of cached addresses.
+         *
+         * If the cache holds more addresses already, the least recently used ones are evicted
+         * immediately.
+         *
+         * @param maxSize   The maximum number of cached addresses, or 0 for no limit.
+         */
+        void setMaxSize(uint32_t maxSize);
+
+
+        /**
+         * Get the number of cached addresses.
+         *
+         * @return The number of cached addresses.
+         */
+        std::size_t size() const;
+
+
+        /**
+         * Get the number of times that a resolved address was found in the cache.
+         *
+         * @return The number of hits.
+         */
+        uint64_t noOfHits() const { return hits_; }
+
+
+        /**
+         * Get the number of times that an address was found in the cache, as an address that
+         * could not be resolved (see setNegativeTtl()).
+         *
+         * @return The number of negative hits.
+         */
+        uint64_t noOfNegativeHits() const { return negativeHits_; }
+
+
+        /**
+         * Get the number of times that an address was not found in the cache.
+         *
+         * @return The number of misses.
+         */
+        uint64_t noOfMisses() const { return misses_; }
+
+
+        /**
+         * Get the number of addresses that were evicted because the cache was full.
+         *
+         * @return The number of evictions.
+         */
+        uint64_t noOfEvictions() const { return evictions_; }
+
+
+        /**
+         * Register the fingerprint of the NamespaceArray of a server.
+         *
+         * This function is called whenever a session has read the NamespaceArray of a server.
+         * Addresses of the server that were restored from a snapshot are added to the cache if
+         * they were saved with the same fingerprint, and dropped if not. If the fingerprint of
+         * a server changes, all cached addresses of that server are removed.
+         *
+         * @param serverUri     The URI of the server.
+         * @param fingerprint   The fingerprint of the NamespaceArray (see
+         *                      NamespaceArray::fingerprint()).
+         */
+        void setNamespaceArrayFingerprint(const std::string& serverUri, uint64_t fingerprint);
+
+
+        /**
+         * Save the cached addresses to a snapshot file.
+         *
+         * Only the addresses of servers of which the NamespaceArray fingerprint is known are
+         * saved, as well as the restored addresses that are still waiting to be validated.
+         * The file is written atomically (via a temporary file which is renamed afterwards).
+         *
+         * @param path  The path of the snapshot file.
+         * @return      Good if the snapshot was saved, PathCreationError if not.
+         */
+        uaf::Status saveSnapshot(const std::string& path);
+
+
+        /**
+         * Restore the addresses from a snapshot file.
+         *
+         * Addresses that are already cached are not replaced.
+         *
+         * @param path  The path of the snapshot file.
+         * @return      Good if the snapshot was loaded, PathNotExistsError if the file does not
+         *              exist, or UnexpectedError if the file is not a valid snapshot.
+         */
+        uaf::Status loadSnapshot(const std::string& path);
+
+
 
     private:
 
@@ -124,8 +289,79 @@ namespace uaf
         // private typedefs
 
 
+        /** Hash function of the addresses. */
+        struct AddressHash
+        {
+            std::size_t operator()(const uaf::Address& address) const { return address.hash(); }
+        };
+
+        /** The cached addresses, ordered from most recently used to least recently used. */
+        typedef std::list<const uaf::Address*> LruList;
+
+        /** The clock to determine whether cached failures have expired. */
+        typedef std::chrono::steady_clock Clock;
+
+        /** A server of which addresses are cached. */
+        struct Server
+        {
+            Server() : generation(0) {}
+            std::atomic<uint64_t> generation;
+        };
+
+        /** The servers, per server URI (they are never removed, so pointers to them remain
+         *  valid). */
+        typedef std::map<std::string, Server> Servers;
+
+        /** A cached ExpandedNodeId (or failure), and its position in the LruList. */
+        struct Entry
+        {
+            Entry() : server(0), generation(0) {}
+
+            /** The resolved ExpandedNodeId (if status is Good). */
+            uaf::ExpandedNodeId expandedNodeId;
+            /** Good, or the reason why the address could not be resolved. */
+            uaf::Status         status;
+            /** The server of the address (0 if unknown), and its generation when cached. */
+            const Server*       server;
+            uint64_t            generation;
+            /** The time at which a cached failure expires. */
+            Clock::time_point   expiry;
+            LruList::iterator   lruPosition;
+        };
+
         /** A cache stores the addresses and their corresponding ExpandedNodeIds. */
-        typedef std::map<uaf::Address, uaf::ExpandedNodeId> Cache;
+        typedef std::unordered_map<uaf::Address, Entry, AddressHash> Cache;
+
+        /** A shard of the cache, with its own lock. */
+        struct Shard
+        {
+            Cache   cache;
+            LruList lru;
+            mutable UaMutex mutex;
+        };
+
+        /** The cached addresses of a single server, as stored in a snapshot. */
+        typedef std::vector< std::pair<uaf::Address, uaf::ExpandedNodeId> > SnapshotEntries;
+
+        /** The restored addresses of a server, which still need to be validated. */
+        struct PendingServer
+        {
+            uint64_t        fingerprint;
+            SnapshotEntries entries;
+        };
+
+        /** The restored addresses, per server URI. */
+        typedef std::map<std::string, PendingServer> PendingServers;
+
+        /** The NamespaceArray fingerprints, per server URI. */
+        typedef std::map<std::string, uint64_t> Fingerprints;
+
+
+        // private constants
+
+
+        /** The number of shards. */
+        static const std::size_t noOfShards = 16;
 
 
         // private members
@@ -134,11 +370,63 @@ namespace uaf
         /** The logger of the address cache. */
         uaf::Logger* logger_;
 
-        /** The map containing the cached addresses. */
-        Cache cache_;
+        /** The shards containing the cached addresses. */
+        Shard shards_[noOfShards];
+
+        /** The maximum number of cached addresses per shard (0 for no limit). */
+        std::atomic<std::size_t> maxSizePerShard_;
+
+        /** The statistics. */
+        std::atomic<uint64_t> hits_;
+        std::atomic<uint64_t> negativeHits_;
+        std::atomic<uint64_t> misses_;
+        std::atomic<uint64_t> evictions_;
+
+        /** The servers of the cached addresses, and their lock. */
+        Servers     servers_;
+        UaMutex     serversMutex_;
+
+        /** The time to live of cached failures, in milliseconds (0 for no negative caching). */
+        std::atomic<int64_t> negativeTtlMs_;
+
+        /** The known NamespaceArray fingerprints and the restored addresses, and their lock. */
+        Fingerprints    fingerprints_;
+        PendingServers  pending_;
+        UaMutex         snapshotMutex_;
+
+
+        // private functions
+
+
+        /** Get the shard of an address. */
+        Shard& shardOf(const uaf::Address& address);
+
+        /** Evict the least recently used addresses of a (locked!) shard if it's too large. */
+        void evictIfNeeded(Shard& shard);
+
+        /** Add an address to the cache without logging, and return true if it was cached. */
+        bool insert(
+                const uaf::Address&         address,
+                const uaf::ExpandedNodeId&  expandedNodeId,
+                bool                        replaceIfExists);
+
+        /** Add an address (or failure, if the status is not good) to the cache without logging,
+         *  and return true if it was cached. */
+        bool insert(
+                const uaf::Address&         address,
+                const uaf::ExpandedNodeId&  expandedNodeId,
+                const uaf::Status&          status,
+                const std::string&          serverUri,
+                bool                        replaceIfExists);
+
+        /** Get the server with the given URI (created if needed, 0 for an empty URI). */
+        Server* getServer(const std::string& serverUri);
+
+        /** Check if an entry can still be used (i.e. not invalidated, and not expired). */
+        static bool isValid(const Entry& entry, Clock::time_point now);
 
-        /** The mutex to safely manipulate the map. */
-        UaMutex mutex_;
+        /** Remove an entry from a (locked!) shard. */
+        static void erase(Shard& shard, Cache::iterator iter);
 
     };
 
@@ -0,0 +1,123 @@
+/* This file is part of the UAF (Unified Architecture Framework) project.
+ *
+ * Copyright (C) 2012 Wim Pessemier (Institute of Astronomy, KULeuven)
+ *
+ * Project website: http://www.ster.kuleuven.be/uaf
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef UAF_BACKGROUNDTASKS_H_
+#define UAF_BACKGROUNDTASKS_H_
+
+// STD
+#include <string>
+#include <stdint.h>
+// SDK
+// UAF
+#include "uaf/util/util.h"
+#include "uaf/util/handles.h"
+#include "uaf/client/clientexport.h"
+
+
+/** @file */
+
+
+namespace uaf
+{
+
+    namespace backgroundtasks
+    {
+
+        /**
+         * The tasks that are executed in the background by the client.
+         *
+         * The tasks are scheduled on the uaf::TimerWheel of the uaf::Database, either periodically
+         * by the client itself, or immediately by the sessions and subscriptions when their
+         * state changes.
+         *
+         * @ingroup ClientDatabase
+         */
+        enum BackgroundTask
+        {
+            Discovery            = 0, /**< Discover the servers in the network. */
+            HouseKeeping         = 1, /**< Check all sessions and the persisted requests. */
+            SessionHouseKeeping  = 2, /**< Check a single session (e.g. reconnect it). */
+            PersistedRequests    = 3, /**< Process the persisted requests that are not OK. */
+            AddressCacheSnapshot = 4  /**< Save a snapshot of the address cache. */
+        };
+
+
+        /**
+         * Get a string representation of the BackgroundTask.
+         *
+         * @param task  The task as a numerical value (e.g. 0).
+         * @return      The corresponding name of the task (e.g. "Discovery").
+         *
+         * @ingroup ClientDatabase
+         */
+        std::string UAF_EXPORT toString(BackgroundTask task);
+
+
+        /**
+         * Get the number that identifies a task on the timer wheel.
+         *
+         * @param task                  The kind of task.
+         * @param clientConnectionId    The session for which the task is meant (only relevant
+         *                              for SessionHouseKeeping tasks).
+         * @return                      The number identifying the task.
+         *
+         * @ingroup ClientDatabase
+         */
+        inline uint64_t toTaskId(
+                BackgroundTask          task,
+                uaf::ClientConnectionId clientConnectionId = 0)
+        {
+            return (uint64_t(task) << 32) | uint64_t(clientConnectionId);
+        }
+
+
+        /**
+         * Get the kind of task, identified by a number on the timer wheel.
+         *
+         * @param taskId    The number identifying the task.
+         * @return          The kind of task.
+         *
+         * @ingroup ClientDatabase
+         */
+        inline BackgroundTask toTask(uint64_t taskId)
+        {
+            return BackgroundTask(taskId >> 32);
+        }
+
+
+        /**
+         * Get the session of a task, identified by a number on the timer wheel.
+         *
+         * @param taskId    The number identifying the task.
+         * @return          The ClientConnectionId of the session for which the task is meant.
+         *
+         * @ingroup ClientDatabase
+         */
+        inline uaf::ClientConnectionId toClientConnectionId(uint64_t taskId)
+        {
+            return uaf::ClientConnectionId(taskId & 0xFFFFFFFF);
+        }
+    }
+
+}
+
+
+#endif /* UAF_BACKGROUNDTASKS_H_ */
@@ -35,7 +35,15 @@ namespace uaf
       clientConnectionId_(0),
       clientSubscriptionHandle_(0),
       clientHandle_(0)
-    {}
+    {
+        addressCache.setMaxSize(clientSettings.addressCacheMaxSize);
+        addressCache.setNegativeTtl(clientSettings.addressCacheNegativeTtlSec);
+        createMonitoredDataRequestStore.setBackoff(clientSettings.persistedRequestsRetryMinSec,
+                                                   clientSettings.persistedRequestsRetryMaxSec);
+        createMonitoredEventsRequestStore.setBackoff(clientSettings.persistedRequestsRetryMinSec,
+                                                     clientSettings.persistedRequestsRetryMaxSec);
+        notificationDispatcher.setNoOfThreads(clientSettings.notificationDispatcherThreads);
+    }
 
 
     // Create a unique clientConnectionId
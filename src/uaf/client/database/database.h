@@ -26,10 +26,14 @@
 // SDK
 // UAF
 #include "uaf/util/constants.h"
+#include "uaf/util/timerwheel.h"
 #include "uaf/client/clientexport.h"
 #include "uaf/client/clientservices.h"
 #include "uaf/client/database/requeststore.h"
 #include "uaf/client/database/addresscache.h"
+#include "uaf/client/database/backgroundtasks.h"
+#include "uaf/client/database/latestvaluecache.h"
+#include "uaf/client/subscriptions/notificationdispatcher.h"
 #include "uaf/client/settings/clientsettings.h"
 
 
@@ -69,6 +73,16 @@ namespace uaf
         /** The cache used by the resolver. */
         uaf::AddressCache addressCache;
 
+        /** The deadlines of the background tasks of the client (see uaf::backgroundtasks).
+         *  Sessions and subscriptions schedule tasks on it when their state changes. */
+        uaf::TimerWheel backgroundTasks;
+
+        /** The dispatcher that delivers the queued notifications of the subscriptions. */
+        uaf::NotificationDispatcher notificationDispatcher;
+
+        /** The latest values of the monitored data items (if enabled by the client settings). */
+        uaf::LatestValueCache latestValueCache;
+
         /** A vector storing all the client handles that were ever assigned. */
         std::vector<uaf::ClientHandle> allClientHandles;
 
@@ -291,14 +305,11 @@ namespace uaf
 
         if (mask.size() == result.targets.size())
         {
-            for (std::size_t i = 0; i < result.targets.size(); i++)
+            for (std::size_t i = mask.nextSet(0); i < mask.size(); i = mask.nextSet(i + 1))
             {
-                if (mask.isSet(i))
+                if (result.targets[i].clientHandle == uaf::constants::CLIENTHANDLE_NOT_ASSIGNED)
                 {
-                    if (result.targets[i].clientHandle == uaf::constants::CLIENTHANDLE_NOT_ASSIGNED)
-                    {
-                        result.targets[i].clientHandle = database->createUniqueClientHandle();
-                    }
+                    result.targets[i].clientHandle = database->createUniqueClientHandle();
                 }
             }
 
@@ -344,14 +355,11 @@ namespace uaf
 
         if (mask.size() == result.targets.size())
         {
-            for (std::size_t i = 0; i < result.targets.size(); i++)
+            for (std::size_t i = mask.nextSet(0); i < mask.size(); i = mask.nextSet(i + 1))
             {
-                if (mask.isSet(i))
+                if (result.targets[i].clientHandle == uaf::constants::CLIENTHANDLE_NOT_ASSIGNED)
                 {
-                    if (result.targets[i].clientHandle == uaf::constants::CLIENTHANDLE_NOT_ASSIGNED)
-                    {
-                        result.targets[i].clientHandle = database->createUniqueClientHandle();
-                    }
+                    result.targets[i].clientHandle = database->createUniqueClientHandle();
                 }
             }
 
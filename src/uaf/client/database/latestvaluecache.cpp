@@ -0,0 +1,336 @@
+/* This file is part of the UAF (Unified Architecture Framework) project.
+ *
+ * Copyright (C) 2012 Wim Pessemier (Institute of Astronomy, KULeuven)
+ *
+ * Project website: http://www.ster.kuleuven.be/uaf
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "uaf/client/database/latestvaluecache.h"
+
+// STD
+
+
+namespace uaf
+{
+    using namespace uaf;
+    using std::vector;
+    using std::size_t;
+
+
+    // Constructor
+    // =============================================================================================
+    LatestValueCache::LatestValueCache()
+    : index_(new Index())
+    {}
+
+
+    // Destructor
+    // =============================================================================================
+    LatestValueCache::~LatestValueCache()
+    {
+        UaMutexLocker locker(&writeMutex_); // unlocks when out of scope
+
+        for (Items::iterator it = items_.begin(); it != items_.end(); ++it)
+        {
+            delete it->second.slot->value.load();
+            delete it->second.slot;
+        }
+        items_.clear();
+
+        delete index_.load();
+
+        for (size_t i = 0; i < retiredIndexes_.size(); i++)
+            delete retiredIndexes_[i];
+        for (size_t i = 0; i < retiredSlots_.size(); i++)
+            delete retiredSlots_[i];
+        for (size_t i = 0; i < retiredValues_.size(); i++)
+            delete retiredValues_[i];
+    }
+
+
+    // Add monitored items
+    // =============================================================================================
+    void LatestValueCache::add(
+            const vector<Address>&      addresses,
+            const vector<ClientHandle>& clientHandles)
+    {
+        {
+            UaMutexLocker locker(&writeMutex_); // unlocks when out of scope
+
+            Index* index = new Index(*index_.load());
+
+            for (size_t i = 0; i < addresses.size() && i < clientHandles.size(); i++)
+            {
+                Items::iterator it = items_.find(clientHandles[i]);
+
+                if (it == items_.end())
+                {
+                    Item item;
+                    item.slot    = new Slot();
+                    item.address = addresses[i];
+                    it = items_.insert(Items::value_type(clientHandles[i], item)).first;
+                }
+                else if (it->second.address != addresses[i])
+                {
+                    // the monitored item now has another address
+                    Index::iterator indexIt = index->find(it->second.address);
+                    if (indexIt != index->end() && indexIt->second == it->second.slot)
+                        index->erase(indexIt);
+                    it->second.address = addresses[i];
+                }
+
+                (*index)[addresses[i]] = it->second.slot;
+            }
+
+            publish(index);
+        }
+
+        reclaim();
+    }
+
+
+    // Remove monitored items
+    // =============================================================================================
+    void LatestValueCache::remove(const vector<ClientHandle>& clientHandles)
+    {
+        {
+            UaMutexLocker locker(&writeMutex_); // unlocks when out of scope
+
+            Index* index = 0;
+
+            for (size_t i = 0; i < clientHandles.size(); i++)
+            {
+                Items::iterator it = items_.find(clientHandles[i]);
+                if (it == items_.end())
+                    continue;
+
+                if (index == 0)
+                    index = new Index(*index_.load());
+
+                Index::iterator indexIt = index->find(it->second.address);
+                if (indexIt != index->end() && indexIt->second == it->second.slot)
+                    index->erase(indexIt);
+
+                const Value* value = it->second.slot->value.load();
+                if (value != 0)
+                    retiredValues_.push_back(value);
+                retiredSlots_.push_back(it->second.slot);
+
+                items_.erase(it);
+            }
+
+            // nothing to do if none of the monitored items was cached
+            if (index == 0)
+                return;
+
+            publish(index);
+        }
+
+        reclaim();
+    }
+
+
+    // Update values
+    // =============================================================================================
+    void LatestValueCache::update(
+            ClientConnectionId                      clientConnectionId,
+            const vector<DataChangeNotification>&   notifications)
+    {
+        int64_t now = Clock::now().time_since_epoch().count();
+        bool mustReclaim;
+
+        {
+            UaMutexLocker locker(&writeMutex_); // unlocks when out of scope
+
+            for (vector<DataChangeNotification>::const_iterator notificationIt = notifications.begin();
+                 notificationIt != notifications.end();
+                 ++notificationIt)
+            {
+                Items::const_iterator it = items_.find(notificationIt->clientHandle);
+                if (it == items_.end())
+                    continue;
+
+                Value* value = new Value();
+                value->dataValue          = *notificationIt;
+                value->status             = notificationIt->status;
+                value->clientConnectionId = clientConnectionId;
+
+                const Value* previousValue = it->second.slot->value.load();
+                updateSlot(it->second.slot, value, now);
+                if (previousValue != 0)
+                    retiredValues_.push_back(previousValue);
+            }
+
+            mustReclaim = retiredValues_.size() >= RECLAIM_THRESHOLD;
+        }
+
+        if (mustReclaim)
+            reclaim();
+    }
+
+
+    // Confirm values
+    // =============================================================================================
+    void LatestValueCache::confirm(const vector<ClientHandle>& clientHandles)
+    {
+        int64_t now = Clock::now().time_since_epoch().count();
+
+        UaMutexLocker locker(&writeMutex_); // unlocks when out of scope
+
+        for (size_t i = 0; i < clientHandles.size(); i++)
+        {
+            Items::const_iterator it = items_.find(clientHandles[i]);
+            if (it != items_.end() && it->second.slot->value.load() != 0)
+                updateSlot(it->second.slot, it->second.slot->value.load(), now);
+        }
+    }
+
+
+    // Get cached values
+    // =============================================================================================
+    size_t LatestValueCache::get(
+            const vector<Address>&      addresses,
+            double                      maxAgeSec,
+            ClientConnectionId          clientConnectionId,
+            vector<ReadResultTarget>&   targets,
+            vector<bool>&               found)
+    {
+        size_t ret = 0;
+
+        found.assign(addresses.size(), false);
+        if (targets.size() < addresses.size())
+            targets.resize(addresses.size());
+
+        int64_t now = Clock::now().time_since_epoch().count();
+        int64_t maxAge = std::chrono::duration_cast<Clock::duration>(
+                std::chrono::duration<double>(maxAgeSec)).count();
+
+        GracePeriod::ReadSection readSection(gracePeriod_); // leaves the section when out of scope
+
+        const Index* index = index_.load();
+
+        bool anySession = (clientConnectionId == uaf::constants::CLIENTHANDLE_NOT_ASSIGNED);
+
+        for (size_t i = 0; i < addresses.size(); i++)
+        {
+            Index::const_iterator it = index->find(addresses[i]);
+            if (it == index->end())
+                continue;
+
+            const Slot* slot = it->second;
+            const Value* value;
+            int64_t receivedAt;
+
+            // take a consistent snapshot of the slot
+            Backoff backoff;
+            for (;;)
+            {
+                uint64_t sequence = slot->sequence.load();
+                if (sequence % 2 == 1)
+                {
+                    // the slot is being updated right now (by a thread that may be preempted)
+                    backoff.pause();
+                    continue;
+                }
+
+                value      = slot->value.load();
+                receivedAt = slot->receivedAt.load();
+
+                if (slot->sequence.load() == sequence)
+                    break;
+            }
+
+            if (   value != 0
+                && now - receivedAt <= maxAge
+                && (anySession || value->clientConnectionId == clientConnectionId))
+            {
+                static_cast<DataValue&>(targets[i]) = value->dataValue;
+                targets[i].status                   = value->status;
+                targets[i].clientConnectionId       = value->clientConnectionId;
+                found[i] = true;
+                ret++;
+            }
+        }
+
+        return ret;
+    }
+
+
+    // Get the number of monitored items
+    // =============================================================================================
+    size_t LatestValueCache::size()
+    {
+        UaMutexLocker locker(&writeMutex_); // unlocks when out of scope
+        return items_.size();
+    }
+
+
+    // Update a slot
+    // =============================================================================================
+    void LatestValueCache::updateSlot(Slot* slot, const Value* value, int64_t receivedAt)
+    {
+        // only one writer at a time (the writeMutex_ is locked), so no need to compare-and-swap
+        uint64_t sequence = slot->sequence.load();
+
+        slot->sequence.store(sequence + 1);
+        slot->value.store(value);
+        slot->receivedAt.store(receivedAt);
+        slot->sequence.store(sequence + 2);
+    }
+
+
+    // Publish an index
+    // =============================================================================================
+    void LatestValueCache::publish(Index* index)
+    {
+        retiredIndexes_.push_back(index_.exchange(index));
+    }
+
+
+    // Delete the retired memory
+    // =============================================================================================
+    void LatestValueCache::reclaim()
+    {
+        // a thread that is reading can't wait for itself to finish: the retired memory will be
+        // deleted by a later call
+        if (GracePeriod::isInReadSection())
+            return;
+
+        vector<Index*>          retiredIndexes;
+        vector<Slot*>           retiredSlots;
+        vector<const Value*>    retiredValues;
+        {
+            UaMutexLocker locker(&writeMutex_); // unlocks when out of scope
+            retiredIndexes.swap(retiredIndexes_);
+            retiredSlots.swap(retiredSlots_);
+            retiredValues.swap(retiredValues_);
+        }
+
+        if (retiredIndexes.empty() && retiredSlots.empty() && retiredValues.empty())
+            return;
+
+        gracePeriod_.wait();
+
+        for (size_t i = 0; i < retiredIndexes.size(); i++)
+            delete retiredIndexes[i];
+        for (size_t i = 0; i < retiredSlots.size(); i++)
+            delete retiredSlots[i];
+        for (size_t i = 0; i < retiredValues.size(); i++)
+            delete retiredValues[i];
+    }
+
+}
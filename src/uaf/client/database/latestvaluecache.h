@@ -0,0 +1,223 @@
+/* This file is part of the UAF (Unified Architecture Framework) project.
+ *
+ * Copyright (C) 2012 Wim Pessemier (Institute of Astronomy, KULeuven)
+ *
+ * Project website: http://www.ster.kuleuven.be/uaf
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef UAF_LATESTVALUECACHE_H_
+#define UAF_LATESTVALUECACHE_H_
+
+// STD
+#include <vector>
+#include <unordered_map>
+#include <atomic>
+#include <chrono>
+#include <stdint.h>
+// SDK
+#include "uabasecpp/uamutex.h"
+// UAF
+#include "uaf/util/status.h"
+#include "uaf/util/address.h"
+#include "uaf/util/datavalue.h"
+#include "uaf/util/handles.h"
+#include "uaf/util/constants.h"
+#include "uaf/util/graceperiod.h"
+#include "uaf/client/clientexport.h"
+#include "uaf/client/results/readresulttarget.h"
+#include "uaf/client/subscriptions/datachangenotification.h"
+
+
+namespace uaf
+{
+
+
+    /*******************************************************************************************//**
+    * A uaf::LatestValueCache holds the latest value of each monitored data item, as received by
+    * its subscription.
+    *
+    * Each monitored item (identified by its ClientHandle) has a slot, holding a pointer to the
+    * latest value, the time it was received and a sequence counter. The subscriptions update the
+    * slots in place: the sequence counter is odd while a slot is being updated, so that readers
+    * can take a consistent snapshot of it without locking ("seqlock"). The values themselves are
+    * never modified but replaced, and a replaced value is only deleted after a uaf::GracePeriod,
+    * so readers can copy it without locking too.
+    *
+    * The slots are found by the address of the monitored item, via an index that is replaced as
+    * a whole when monitored items are added or removed.
+    *
+    * @ingroup ClientDatabase
+    ***********************************************************************************************/
+    class UAF_EXPORT LatestValueCache
+    {
+    public:
+
+
+        /**
+         * Construct an empty cache.
+         */
+        LatestValueCache();
+
+
+        /**
+         * Destruct the cache.
+         */
+        ~LatestValueCache();
+
+
+        /**
+         * Add monitored items to the cache (without a value yet).
+         *
+         * An address that was already added for another monitored item, will from now on refer
+         * to the given monitored item.
+         *
+         * @param addresses     The addresses of the monitored items.
+         * @param clientHandles The ClientHandles of the monitored items (same size as addresses).
+         */
+        void add(const std::vector<uaf::Address>&       addresses,
+                 const std::vector<uaf::ClientHandle>&  clientHandles);
+
+
+        /**
+         * Remove monitored items (and their values) from the cache.
+         *
+         * @param clientHandles The ClientHandles of the monitored items.
+         */
+        void remove(const std::vector<uaf::ClientHandle>& clientHandles);
+
+
+        /**
+         * Update the values of monitored items that were added before.
+         *
+         * @param clientConnectionId    The id of the session of the monitored items.
+         * @param notifications         The notifications of the monitored items.
+         */
+        void update(uaf::ClientConnectionId                         clientConnectionId,
+                    const std::vector<uaf::DataChangeNotification>& notifications);
+
+
+        /**
+         * Confirm that the values of monitored items are still the latest ones (e.g. because the
+         * server sent a keep-alive for their subscription), so they become fresh again.
+         *
+         * @param clientHandles The ClientHandles of the monitored items.
+         */
+        void confirm(const std::vector<uaf::ClientHandle>& clientHandles);
+
+
+        /**
+         * Get the cached values of a number of addresses, if they are not too old.
+         *
+         * @param addresses          The addresses of the monitored items.
+         * @param maxAgeSec          The maximum time since the values were received (or
+         *                           confirmed).
+         * @param clientConnectionId Only values received by this session are returned, unless
+         *                           it is uaf::constants::CLIENTHANDLE_NOT_ASSIGNED.
+         * @param targets            The targets to fill (same size as addresses). The targets of
+         *                           which no fresh value was cached are left untouched.
+         * @param found              Updated to tell for each address if a fresh value was found.
+         * @return                   The number of addresses of which a fresh value was found.
+         */
+        std::size_t get(const std::vector<uaf::Address>&        addresses,
+                        double                                  maxAgeSec,
+                        uaf::ClientConnectionId                 clientConnectionId,
+                        std::vector<uaf::ReadResultTarget>&     targets,
+                        std::vector<bool>&                      found);
+
+
+        /**
+         * Get the number of monitored items that have been added to the cache.
+         */
+        std::size_t size();
+
+
+    private:
+
+        // no copying or assigning allowed
+        DISALLOW_COPY_AND_ASSIGN(LatestValueCache);
+
+        /** The clock to determine the age of the values. */
+        typedef std::chrono::steady_clock Clock;
+
+        /** A received value (never modified once it is published). */
+        struct Value
+        {
+            uaf::DataValue          dataValue;
+            uaf::Status             status;
+            uaf::ClientConnectionId clientConnectionId;
+        };
+
+        /** The slot of a monitored item. */
+        struct Slot
+        {
+            Slot() : sequence(0), value(0), receivedAt(0) {}
+
+            /** Odd while the slot is being updated, incremented by 2 for each update. */
+            std::atomic<uint64_t>       sequence;
+            /** The latest value (0 if no value has been received yet). */
+            std::atomic<const Value*>   value;
+            /** The time when the value was received or confirmed, in Clock ticks. */
+            std::atomic<int64_t>        receivedAt;
+        };
+
+        /** Hash function of the addresses. */
+        struct AddressHash
+        {
+            std::size_t operator()(const uaf::Address& address) const { return address.hash(); }
+        };
+
+        /** The index to find the slots by address (never modified once it is published). */
+        typedef std::unordered_map<uaf::Address, Slot*, AddressHash> Index;
+
+        /** The slots and their addresses, by ClientHandle (only used by the writers). */
+        struct Item
+        {
+            Slot*           slot;
+            uaf::Address    address;
+        };
+        typedef std::unordered_map<uaf::ClientHandle, Item> Items;
+
+        /** The number of retired values after which they are deleted. */
+        static const std::size_t RECLAIM_THRESHOLD = 1024;
+
+        // update a slot (writeMutex_ must be locked)
+        void updateSlot(Slot* slot, const Value* value, int64_t receivedAt);
+
+        // publish a new index (writeMutex_ must be locked)
+        void publish(Index* index);
+
+        // delete the retired memory after a grace period (writeMutex_ must not be locked)
+        void reclaim();
+
+        // the currently published index
+        std::atomic<Index*>         index_;
+        // the grace period in which the index and the values are read
+        uaf::GracePeriod            gracePeriod_;
+
+        // the slots by ClientHandle, and the memory that is waiting to be deleted
+        Items                       items_;
+        std::vector<Index*>         retiredIndexes_;
+        std::vector<Slot*>          retiredSlots_;
+        std::vector<const Value*>   retiredValues_;
+        // the mutex to lock when changing the cache (never locked by the readers)
+        UaMutex                     writeMutex_;
+    };
+
+}
+
+
+#endif /* UAF_LATESTVALUECACHE_H_ */
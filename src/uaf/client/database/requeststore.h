@@ -26,12 +26,15 @@
 // STD
 #include <map>
 #include <vector>
+#include <string>
+#include <chrono>
 // SDK
 #include "uabasecpp/uamutex.h"
 // UAF
 #include "uaf/util/logger.h"
 #include "uaf/util/status.h"
 #include "uaf/util/mask.h"
+#include "uaf/util/address.h"
 #include "uaf/client/clientexport.h"
 #include "uaf/client/clientservices.h"
 
@@ -43,6 +46,11 @@ namespace uaf
     * A request store stores the requests (and their results) that always need to be reconstructed,
     * even after severe failures.
     *
+    * The store keeps an index of the bad targets per server, so that the targets can be retried
+    * per server: the targets of a server are retried with an exponential backoff (see
+    * setBackoff()), unless the backoff of the server is reset (e.g. because its session has just
+    * been reconnected).
+    *
     * @ingroup ClientDatabase
     ***********************************************************************************************/
     template <typename _Service>
@@ -130,11 +138,43 @@ namespace uaf
 
 
         /**
-         * Get the items of which the mask indicates that 1 or more targets need to be re-processed.
+         * Get the items with bad targets that should be retried now, i.e. the bad targets of the
+         * servers of which the backoff has expired.
+         *
+         * The mask of the returned items only contains these targets, and the backoff of their
+         * servers is increased (in case the retry fails again).
          *
          * @return  Items to be re-processed.
          */
-        std::vector<Item> getBadItems();
+        std::vector<Item> getItemsToRetry();
+
+
+        /**
+         * Get the time until the next retry of a server is due.
+         *
+         * @param delaySec  The number of seconds until the next retry (0 if a retry is due now).
+         * @return          True if there are bad targets (so delaySec was updated), false if not.
+         */
+        bool getNextRetryDelay(double& delaySec);
+
+
+        /**
+         * Let the bad targets of a server be retried at the next call of getItemsToRetry(),
+         * and restart the backoff of the server (e.g. because the server has become reachable).
+         *
+         * @param serverUri The URI of the server.
+         */
+        void resetBackoff(const std::string& serverUri);
+
+
+        /**
+         * Set the delays between the retries of the bad targets of a server.
+         *
+         * @param minSec    The delay before the first retry, in seconds. This delay is doubled
+         *                  after every failed retry.
+         * @param maxSec    The maximum delay, in seconds.
+         */
+        void setBackoff(double minSec, double maxSec);
 
 
         uaf::Status updateTargetStatus(
@@ -178,9 +218,48 @@ namespace uaf
         // typedef the map to store the items
         typedef typename std::map<uaf::RequestHandle, Item> ItemsMap;
 
+        typedef std::chrono::steady_clock Clock;
+
+        /* The server URI of each target of a stored item. */
+        typedef std::vector<std::string> ServerUris;
+
+        /* The bad targets of a server, and the backoff of their retries. */
+        struct Server
+        {
+            Server() : noOfRetries(0) {}
+
+            /* The number of bad targets of the server, per request handle. */
+            std::map<uaf::RequestHandle, std::size_t> badTargets;
+
+            /* The number of retries since the backoff was (re)started. */
+            uint32_t noOfRetries;
+
+            /* The time when the bad targets are due for a retry. */
+            Clock::time_point nextRetry;
+        };
+
+        typedef typename std::map<std::string, Server> ServersMap;
+
+        /* Set the bad flag of a target of an item, and update the servers_ index accordingly
+         * (mutex_ must be locked). */
+        void setTargetBad(typename ItemsMap::iterator it, std::size_t rank, bool bad);
+
+        /* Get the URI of the server of an address (empty if unknown). */
+        static std::string serverUriOf(const uaf::Address& address);
+
         /* The map that stores the items. */
         ItemsMap itemsMap_;
 
+        /* The server URIs of the targets of the stored items. */
+        std::map<uaf::RequestHandle, ServerUris> serverUrisMap_;
+
+        /* The index of the bad targets per server. */
+        ServersMap servers_;
+
+        /* The backoff of the retries, in milliseconds. */
+        int64_t minBackoffMs_;
+        int64_t maxBackoffMs_;
+
         /* The mutex to manipulate the map safely. */
         UaMutex mutex_;
 
@@ -193,6 +272,8 @@ namespace uaf
     // =============================================================================================
     template <typename _Service>
     RequestStore<_Service>::RequestStore(uaf::LoggerFactory* loggerFactory, const std::string& name)
+    : minBackoffMs_(1000),
+      maxBackoffMs_(60000)
     {
         logger_ = new uaf::Logger(loggerFactory, name);
     }
@@ -214,10 +295,12 @@ namespace uaf
     template <typename _Service>
     void RequestStore<_Service>::clear()
     {
-        logger_->debug("Now clearing the whole store");
+        UAF_LOG_DEBUG(logger_, "Now clearing the whole store");
         UaMutexLocker locker(&mutex_); // unlocks when locker goes out of scope
 
         itemsMap_.clear();
+        serverUrisMap_.clear();
+        servers_.clear();
     }
 
 
@@ -226,18 +309,22 @@ namespace uaf
     template <typename _Service>
     void RequestStore<_Service>::logCurrentState()
     {
-        logger_->debug("Current state:");
+        // don't bother locking the store if nothing will be logged anyway
+        if (!logger_->isEnabled(uaf::loglevels::Debug))
+            return;
+
+        UAF_LOG_DEBUG(logger_, "Current state:");
         UaMutexLocker locker(&mutex_); // unlocks when locker goes out of scope
 
         typedef typename ItemsMap::const_iterator Iter;
         for (Iter it = itemsMap_.begin(); it != itemsMap_.end(); ++it)
         {
-            logger_->debug("Item %d:", it->first);
-            logger_->debug(" - badTargetsMask: %s", it->second.badTargetsMask.toString().c_str());
-            logger_->debug(" - request:");
-            logger_->debug(it->second.request.toString("   ", 39));
-            logger_->debug(" - result:");
-            logger_->debug(it->second.result.toString("   ", 39));
+            UAF_LOG_DEBUG(logger_, "Item %d:", it->first);
+            UAF_LOG_DEBUG(logger_, " - badTargetsMask: %s", it->second.badTargetsMask.toString().c_str());
+            UAF_LOG_DEBUG(logger_, " - request:");
+            UAF_LOG_DEBUG(logger_, it->second.request.toString("   ", 39));
+            UAF_LOG_DEBUG(logger_, " - result:");
+            UAF_LOG_DEBUG(logger_, it->second.result.toString("   ", 39));
         }
     }
 
@@ -247,7 +334,7 @@ namespace uaf
     template <typename _Service>
     uaf::Status RequestStore<_Service>::remove(uaf::RequestHandle handle)
     {
-        logger_->debug("Now removing handle %d", handle);
+        UAF_LOG_DEBUG(logger_, "Now removing handle %d", handle);
 
         uaf::Status ret;
 
@@ -257,6 +344,13 @@ namespace uaf
 
         if (iter != itemsMap_.end())
         {
+            const uaf::Mask& badTargetsMask = iter->second.badTargetsMask;
+            for (std::size_t i = badTargetsMask.nextSet(0);
+                 i < badTargetsMask.size();
+                 i = badTargetsMask.nextSet(i + 1))
+                setTargetBad(iter, i, false);
+
+            serverUrisMap_.erase(handle);
             itemsMap_.erase(iter);
             ret = uaf::statuscodes::Good;
         }
@@ -279,8 +373,8 @@ namespace uaf
     {
         uaf::Status ret;
 
-        logger_->debug("Setting the status of request %d target %d to %s",
-                       requestHandle, targetRank, status.toString().c_str());
+        UAF_LOG_DEBUG(logger_, "Setting the status of request %d target %d to %s",
+                               requestHandle, targetRank, status.toString().c_str());
 
         UaMutexLocker locker(&mutex_); // unlocks when locker goes out of scope
 
@@ -291,10 +385,7 @@ namespace uaf
             if (targetRank < iter->second.result.targets.size())
             {
                 iter->second.result.targets[targetRank].status = status;
-                if (status.isGood())
-                    iter->second.badTargetsMask.unset(targetRank);
-                else
-                    iter->second.badTargetsMask.set(targetRank);
+                setTargetBad(iter, targetRank, status.isNotGood());
 
                 // updated successfully:
                 ret = uaf::statuscodes::Good;
@@ -310,7 +401,7 @@ namespace uaf
         }
 
         if (ret.isGood())
-            logger_->debug("The item was updated");
+            UAF_LOG_DEBUG(logger_, "The item was updated");
         else
             logger_->error(ret);
 
@@ -344,28 +435,6 @@ namespace uaf
     }
 
 
-    // Get a pointer to a result
-    // =============================================================================================
-    template <typename _Service>
-    std::vector< typename uaf::RequestStore<_Service>::Item > RequestStore<_Service>::getBadItems()
-    {
-        typename std::vector<Item> ret;
-
-        UaMutexLocker locker(&mutex_); // unlocks when locker goes out of scope
-
-        typedef typename ItemsMap::const_iterator Iter;
-        for (Iter it = itemsMap_.begin(); it != itemsMap_.end(); ++it)
-        {
-            if (it->second.badTargetsMask.setCount() > 0)
-                ret.push_back(it->second);
-        }
-
-        logCurrentState();
-
-        return ret;
-    }
-
-
     // Update a result
     // =============================================================================================
     template <typename _Service>
@@ -373,8 +442,8 @@ namespace uaf
             const ResultType&   result,
             const uaf::Mask&    mask)
     {
-        logger_->debug("Now updating the result with RequestHandle %d (mask: %s)",
-                       result.requestHandle, mask.toString().c_str());
+        UAF_LOG_DEBUG(logger_, "Now updating the result with RequestHandle %d (mask: %s)",
+                               result.requestHandle, mask.toString().c_str());
 
         uaf::Status ret;
 
@@ -396,10 +465,7 @@ namespace uaf
                     it->second.result.targets[i] = result.targets[i];
 
                 // update the badTargetsMask, since we're iterating over the targets anyway
-                if (it->second.result.targets[i].status.isNotGood())
-                    it->second.badTargetsMask.set(i);
-                else
-                    it->second.badTargetsMask.unset(i);
+                setTargetBad(it, i, it->second.result.targets[i].status.isNotGood());
 
             }
         }
@@ -421,7 +487,7 @@ namespace uaf
             const ResultType&  result,
             const uaf::Mask&   badTargetsMask)
     {
-        logger_->debug("Storing the request and result if needed");
+        UAF_LOG_DEBUG(logger_, "Storing the request and result if needed");
 
         uaf::Status ret;
 
@@ -430,16 +496,26 @@ namespace uaf
         // check if an item exists already for the given handle
         if (itemsMap_.find(result.requestHandle) == itemsMap_.end())
         {
-            // add a new item
-            itemsMap_.insert(std::pair<uaf::RequestHandle, Item>(
+            // add a new item (without bad targets, they are added to the index below)
+            typename ItemsMap::iterator it = itemsMap_.insert(std::pair<uaf::RequestHandle, Item>(
                     result.requestHandle,
-                    Item(request, result, badTargetsMask)));
+                    Item(request, result, uaf::Mask(badTargetsMask.size(), false)))).first;
 
-            logger_->debug("The request and result are now stored");
+            ServerUris& serverUris = serverUrisMap_[result.requestHandle];
+            serverUris.reserve(request.targets.size());
+            for (std::size_t i = 0; i < request.targets.size(); i++)
+                serverUris.push_back(serverUriOf(request.targets[i].address));
+
+            for (std::size_t i = badTargetsMask.nextSet(0);
+                 i < badTargetsMask.size();
+                 i = badTargetsMask.nextSet(i + 1))
+                setTargetBad(it, i, true);
+
+            UAF_LOG_DEBUG(logger_, "The request and result are now stored");
         }
         else
         {
-            logger_->debug("The request and result were already stored");
+            UAF_LOG_DEBUG(logger_, "The request and result were already stored");
         }
 
         // ToDo add checks, e.g. if a valid handle is found, and update the return status
@@ -449,6 +525,200 @@ namespace uaf
     }
 
 
+    // Get the items to retry
+    // =============================================================================================
+    template <typename _Service>
+    std::vector< typename uaf::RequestStore<_Service>::Item >
+    RequestStore<_Service>::getItemsToRetry()
+    {
+        typename std::vector<Item> ret;
+
+        UaMutexLocker locker(&mutex_); // unlocks when locker goes out of scope
+
+        Clock::time_point now = Clock::now();
+
+        // the targets to retry, per request handle
+        std::map<uaf::RequestHandle, uaf::Mask> masks;
+
+        for (typename ServersMap::iterator server = servers_.begin();
+             server != servers_.end();
+             ++server)
+        {
+            if (server->second.nextRetry > now)
+                continue;
+
+            typedef std::map<uaf::RequestHandle, std::size_t>::const_iterator Iter;
+            for (Iter bad = server->second.badTargets.begin();
+                 bad != server->second.badTargets.end();
+                 ++bad)
+            {
+                const Item&       item       = itemsMap_.find(bad->first)->second;
+                const ServerUris& serverUris = serverUrisMap_[bad->first];
+
+                uaf::Mask& mask = masks[bad->first];
+                mask.resize(item.badTargetsMask.size());
+
+                // (targets without a known server are never retried)
+                for (std::size_t i = item.badTargetsMask.nextSet(0);
+                     i < item.badTargetsMask.size() && i < serverUris.size();
+                     i = item.badTargetsMask.nextSet(i + 1))
+                {
+                    if (serverUris[i] == server->first)
+                        mask.set(i);
+                }
+            }
+
+            // if the retry fails, the next one is due after twice the previous delay
+            int64_t delayMs = minBackoffMs_;
+            for (uint32_t i = 0; i < server->second.noOfRetries && delayMs < maxBackoffMs_; i++)
+                delayMs *= 2;
+            if (delayMs > maxBackoffMs_)
+                delayMs = maxBackoffMs_;
+
+            server->second.noOfRetries++;
+            server->second.nextRetry = now + std::chrono::milliseconds(delayMs);
+
+            UAF_LOG_DEBUG(logger_, "Retrying the %d bad requests of server %s (next retry in %d ms)",
+                          int(server->second.badTargets.size()), server->first.c_str(), int(delayMs));
+        }
+
+        ret.reserve(masks.size());
+        for (std::map<uaf::RequestHandle, uaf::Mask>::const_iterator it = masks.begin();
+             it != masks.end();
+             ++it)
+        {
+            const Item& item = itemsMap_.find(it->first)->second;
+            ret.push_back(Item(item.request, item.result, it->second));
+        }
+
+        return ret;
+    }
+
+
+    // Get the delay until the next retry
+    // =============================================================================================
+    template <typename _Service>
+    bool RequestStore<_Service>::getNextRetryDelay(double& delaySec)
+    {
+        UaMutexLocker locker(&mutex_); // unlocks when locker goes out of scope
+
+        if (servers_.empty())
+            return false;
+
+        Clock::time_point next = servers_.begin()->second.nextRetry;
+        for (typename ServersMap::const_iterator it = servers_.begin(); it != servers_.end(); ++it)
+        {
+            if (it->second.nextRetry < next)
+                next = it->second.nextRetry;
+        }
+
+        Clock::time_point now = Clock::now();
+        if (next <= now)
+            delaySec = 0.0;
+        else
+            delaySec = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    next - now).count() / 1000.0;
+
+        return true;
+    }
+
+
+    // Reset the backoff of a server
+    // =============================================================================================
+    template <typename _Service>
+    void RequestStore<_Service>::resetBackoff(const std::string& serverUri)
+    {
+        UaMutexLocker locker(&mutex_); // unlocks when locker goes out of scope
+
+        typename ServersMap::iterator it = servers_.find(serverUri);
+        if (it != servers_.end())
+        {
+            UAF_LOG_DEBUG(logger_, "The requests of server %s will be retried immediately",
+                          serverUri.c_str());
+            it->second.noOfRetries = 0;
+            it->second.nextRetry   = Clock::time_point();
+        }
+    }
+
+
+    // Set the backoff
+    // =============================================================================================
+    template <typename _Service>
+    void RequestStore<_Service>::setBackoff(double minSec, double maxSec)
+    {
+        UaMutexLocker locker(&mutex_); // unlocks when locker goes out of scope
+
+        minBackoffMs_ = minSec > 0.0 ? int64_t(minSec * 1000.0) : 0;
+        maxBackoffMs_ = maxSec > 0.0 ? int64_t(maxSec * 1000.0) : 0;
+
+        // a delay of 0 would never double
+        if (minBackoffMs_ == 0)
+            minBackoffMs_ = 1;
+        if (maxBackoffMs_ < minBackoffMs_)
+            maxBackoffMs_ = minBackoffMs_;
+    }
+
+
+    // Set the bad flag of a target
+    // =============================================================================================
+    template <typename _Service>
+    void RequestStore<_Service>::setTargetBad(
+            typename ItemsMap::iterator it,
+            std::size_t                 rank,
+            bool                        bad)
+    {
+        Item& item = it->second;
+
+        bool wasBad = (rank < item.badTargetsMask.size()) && item.badTargetsMask.isSet(rank);
+        if (wasBad == bad)
+            return;
+
+        const ServerUris& serverUris = serverUrisMap_[it->first];
+        std::string serverUri = (rank < serverUris.size()) ? serverUris[rank] : std::string();
+
+        if (bad)
+        {
+            item.badTargetsMask.set(rank);
+
+            // a server without bad targets so far is retried immediately
+            servers_[serverUri].badTargets[it->first]++;
+        }
+        else
+        {
+            item.badTargetsMask.unset(rank);
+
+            typename ServersMap::iterator server = servers_.find(serverUri);
+            if (server == servers_.end())
+                return;
+
+            std::map<uaf::RequestHandle, std::size_t>::iterator count
+                    = server->second.badTargets.find(it->first);
+            if (count != server->second.badTargets.end() && --(count->second) == 0)
+                server->second.badTargets.erase(count);
+
+            // if all targets of the server are good again, then its backoff is over
+            if (server->second.badTargets.empty())
+                servers_.erase(server);
+        }
+    }
+
+
+    // Get the URI of the server of an address
+    // =============================================================================================
+    template <typename _Service>
+    std::string RequestStore<_Service>::serverUriOf(const uaf::Address& address)
+    {
+        // the server of a relative address is the server of its (innermost) starting address
+        const uaf::Address* startingAddress = &address;
+        while (startingAddress->isRelativePath())
+            startingAddress = startingAddress->getStartingAddress();
+
+        std::string serverUri;
+        uaf::extractServerUri(*startingAddress, serverUri);
+        return serverUri;
+    }
+
+
 
 
 
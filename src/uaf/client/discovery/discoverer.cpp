@@ -45,7 +45,7 @@ namespace uaf
     // =============================================================================================
     Discoverer::~Discoverer()
     {
-        logger_->debug("Destructing the discoverer");
+        UAF_LOG_DEBUG(logger_, "Destructing the discoverer");
 
         delete logger_;
         logger_ = 0;
@@ -58,7 +58,7 @@ namespace uaf
     {
         Status ret;
 
-        logger_->debug("Finding all configured servers");
+        UAF_LOG_DEBUG(logger_, "Finding all configured servers");
 
         // check if findServers() is already busy
         bool alreadyBusy;
@@ -115,9 +115,9 @@ namespace uaf
                 {
                     string url(*iter);
 
-                    logger_->debug("Finding the servers for URL '%s' (timeout %dms)",
-                                   url.c_str(),
-                                   serviceSettings.callTimeout);
+                    UAF_LOG_DEBUG(logger_, "Finding the servers for URL '%s' (timeout %dms)",
+                                           url.c_str(),
+                                           serviceSettings.callTimeout);
 
                     // invoke the FindServers service for the current URL
                     UaApplicationDescriptions desc;
@@ -140,8 +140,8 @@ namespace uaf
                             ApplicationDescription applicationDescription(desc[i]);
                             serverDescriptions.push_back(applicationDescription);
 
-                            logger_->debug("Found server at URL '%s':", url.c_str());
-                            logger_->debug(applicationDescription.toString());
+                            UAF_LOG_DEBUG(logger_, "Found server at URL '%s':", url.c_str());
+                            UAF_LOG_DEBUG(logger_, applicationDescription.toString());
                         }
                     }
                     else
@@ -183,7 +183,7 @@ namespace uaf
     {
         Status ret;
 
-        logger_->debug("Finding all configured servers on the network");
+        UAF_LOG_DEBUG(logger_, "Finding all configured servers on the network");
 
         // check if findServersOnNetwork() is already busy
         bool alreadyBusy;
@@ -219,7 +219,7 @@ namespace uaf
 
 			UaClientSdk::ClientSecurityInfo clientSecurityInfo;
 
-			logger_->debug("Finding the servers on network for URL '%s' (timeout %dms)",
+			UAF_LOG_DEBUG(logger_, "Finding the servers on network for URL '%s' (timeout %dms)",
 				serverUri.c_str(),
 				serviceSettings.callTimeout);
 
@@ -272,8 +272,8 @@ namespace uaf
 						if(!isInside)
 						{
 							database_->clientSettings.discoveryUrls.push_back(UaString(servers[i].DiscoveryUrl).toUtf8());
-							logger_->debug("Found server on network by localhost at URL '%s'.", serverUri.c_str());
-							logger_->debug("So update the discoveryUrls with '%s'.",UaString(&servers[i].DiscoveryUrl).toUtf8());
+							UAF_LOG_DEBUG(logger_, "Found server on network by localhost at URL '%s'.", serverUri.c_str());
+							UAF_LOG_DEBUG(logger_, "So update the discoveryUrls with '%s'.",UaString(&servers[i].DiscoveryUrl).toUtf8());
 						}
 					}
 
@@ -357,15 +357,21 @@ namespace uaf
     // =============================================================================================
     Status Discoverer::getEndpoints(
             const string&                   discoveryUrl,
-            vector<EndpointDescription>&    endpointDescriptions)
+            vector<EndpointDescription>&    endpointDescriptions,
+            bool                            allowCached)
     {
-        logger_->debug("Getting the endpoints for '%s'", discoveryUrl.c_str());
+        UAF_LOG_DEBUG(logger_, "Getting the endpoints for '%s'", discoveryUrl.c_str());
 
         // create the Status to return
         Status ret;
 
+        // use the cached endpoints if they were fetched recently enough
+        if (allowCached && getCachedEndpoints(discoveryUrl, endpointDescriptions))
+        {
+            ret = statuscodes::Good;
+        }
         // check if we got a non-empty URL (shouldn't be happening, may be a bug)
-        if (discoveryUrl.empty())
+        else if (discoveryUrl.empty())
         {
             ret = EmptyUrlError();
             logger_->error(ret.toString());
@@ -381,7 +387,7 @@ namespace uaf
             serviceSettings.callTimeout = int32_t(
                     database_->clientSettings.discoveryGetEndpointsTimeoutSec * 1000);
 
-            logger_->debug("Now invoking the GetEndpoints service");
+            UAF_LOG_DEBUG(logger_, "Now invoking the GetEndpoints service");
 
             // perform the service call
             SdkStatus sdkStatus = uaDiscovery_.getEndpoints(
@@ -401,17 +407,29 @@ namespace uaf
             {
                 if (uaEndpointDescriptions.length() > 0)
                 {
-                    logger_->debug("A total of %d endpoint(s) have been gotten successfully:",
-                                   uaEndpointDescriptions.length());
+                    UAF_LOG_DEBUG(logger_, "A total of %d endpoint(s) have been gotten successfully:",
+                                           uaEndpointDescriptions.length());
 
                     // fill this temporary variable and log each endpoint description
+                    CachedEndpoints fetched;
+                    fetched.fetchTime = DateTime::now();
                     for (uint32_t i = 0; i < uaEndpointDescriptions.length(); i++)
                     {
-                        endpointDescriptions.push_back(
+                        fetched.endpointDescriptions.push_back(
                                 EndpointDescription(uaEndpointDescriptions[i]));
-                        logger_->debug(" - endpoint[%d]", i);
-                        logger_->debug(string("   ") + endpointDescriptions[i].toString("   "));
+                        UAF_LOG_DEBUG(logger_, " - endpoint[%d]", i);
+                        UAF_LOG_DEBUG(logger_, string("   ")
+                                               + fetched.endpointDescriptions[i].toString("   "));
                     }
+
+                    endpointDescriptions.insert(endpointDescriptions.end(),
+                                                fetched.endpointDescriptions.begin(),
+                                                fetched.endpointDescriptions.end());
+
+                    // update the cache
+                    endpointCacheMutex_.lock();
+                    endpointCache_[discoveryUrl] = fetched;
+                    endpointCacheMutex_.unlock();
                 }
                 else
                 {
@@ -429,10 +447,49 @@ namespace uaf
     }
 
 
+    // Get the cached endpoint descriptions
+    // =============================================================================================
+    bool Discoverer::getCachedEndpoints(
+            const string&                   discoveryUrl,
+            vector<EndpointDescription>&    endpointDescriptions)
+    {
+        float timeoutSec = database_->clientSettings.discoveryEndpointsCacheTimeoutSec;
 
-}
+        if (timeoutSec <= 0)
+            return false;
+
+        UaMutexLocker locker(&endpointCacheMutex_); // auto-unlocks when out of scope
 
+        EndpointCache::const_iterator it = endpointCache_.find(discoveryUrl);
 
+        if (it == endpointCache_.end())
+            return false;
 
+        int32_t ageMs = it->second.fetchTime.msecsTo(DateTime::now());
 
+        if (ageMs < 0 || ageMs >= timeoutSec * 1000)
+            return false;
 
+        UAF_LOG_DEBUG(logger_, "Using the %d endpoint(s) that were cached %dms ago",
+                               int(it->second.endpointDescriptions.size()), ageMs);
+
+        endpointDescriptions.insert(endpointDescriptions.end(),
+                                    it->second.endpointDescriptions.begin(),
+                                    it->second.endpointDescriptions.end());
+        return true;
+    }
+
+
+    // Invalidate the cached endpoint descriptions
+    // =============================================================================================
+    void Discoverer::invalidateEndpoints(const string& discoveryUrl)
+    {
+        UaMutexLocker locker(&endpointCacheMutex_); // auto-unlocks when out of scope
+
+        if (endpointCache_.erase(discoveryUrl) > 0)
+            UAF_LOG_DEBUG(logger_, "The cached endpoints of '%s' have been invalidated",
+                                   discoveryUrl.c_str());
+    }
+
+
+}
@@ -25,6 +25,7 @@
 // STD
 #include <vector>
 #include <string>
+#include <map>
 #include <ctime>
 // SDK
 #include "uaclientcpp/uaclientsdk.h"
@@ -36,6 +37,7 @@
 #include "uaf/util/applicationdescription.h"
 #include "uaf/util/serveronnetwork.h"
 #include "uaf/util/endpointdescription.h"
+#include "uaf/util/datetime.h"
 #include "uaf/client/clientexport.h"
 #include "uaf/client/database/database.h"
 
@@ -99,13 +101,28 @@ namespace uaf
          * Get the endpoint descriptions for a given server by calling the OPC UA
          * GetEndpoints service on the given URL.
          *
+         * The fetched endpoint descriptions are cached (per discovery URL), so that they can
+         * be reused during ClientSettings::discoveryEndpointsCacheTimeoutSec.
+         *
          * @param discoveryUrl          URL of the server to discover.
          * @param endpointDescriptions  Endpoint descriptions that will be fetched.
+         * @param allowCached           True to return the cached endpoint descriptions (if they
+         *                              haven't expired yet) instead of calling the service.
          * @return                      Status of the service call.
          */
         uaf::Status getEndpoints(
                 const std::string&                      discoveryUrl,
-                std::vector<uaf::EndpointDescription>&  endpointDescriptions);
+                std::vector<uaf::EndpointDescription>&  endpointDescriptions,
+                bool                                    allowCached = false);
+
+
+        /**
+         * Forget the cached endpoint descriptions of the given URL (e.g. because a connection
+         * to one of the endpoints failed), so that they will be fetched again next time.
+         *
+         * @param discoveryUrl  URL of the server of which the endpoints must be forgotten.
+         */
+        void invalidateEndpoints(const std::string& discoveryUrl);
 
 
         /**
@@ -130,6 +147,20 @@ namespace uaf
         DISALLOW_COPY_AND_ASSIGN(Discoverer);
 
 
+        /**
+         * Get the cached endpoint descriptions of the given URL, if they haven't expired yet.
+         *
+         * @param discoveryUrl          URL of the server.
+         * @param endpointDescriptions  Output parameter: the cached endpoint descriptions are
+         *                              appended to it.
+         * @return                      True if cached endpoint descriptions were found.
+         */
+        bool getCachedEndpoints(
+                const std::string&                      discoveryUrl,
+                std::vector<uaf::EndpointDescription>&  endpointDescriptions);
+
+
+
         // the logger of the discoverer
         uaf::Logger* logger_;
         // a pointer to the shared database
@@ -144,6 +175,15 @@ namespace uaf
         std::vector<uaf::ApplicationDescription> serverDescriptions_;
         // the latest server-on-network descriptions
         std::vector<uaf::ServerOnNetwork> serverOnNetworkDescriptions_;
+        // the endpoint descriptions that were fetched, and the time when they were fetched
+        struct CachedEndpoints
+        {
+            std::vector<uaf::EndpointDescription> endpointDescriptions;
+            uaf::DateTime                         fetchTime;
+        };
+        typedef std::map<std::string, CachedEndpoints> EndpointCache;
+        EndpointCache endpointCache_;
+        UaMutex endpointCacheMutex_;
         // UaDiscovery instance
         UaClientSdk::UaDiscovery uaDiscovery_;
     };
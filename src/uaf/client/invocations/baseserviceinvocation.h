@@ -26,6 +26,7 @@
 #include <vector>
 #include <string>
 #include <map>
+#include <algorithm>
 // SDK
 // UAF
 #include "uaf/util/status.h"
@@ -35,6 +36,8 @@
 #include "uaf/util/constants.h"
 #include "uaf/client/clientexport.h"
 #include "uaf/client/sessions/sessioninformation.h"
+#include "uaf/client/sessions/operationlimits.h"
+#include "uaf/client/sessions/registerednodecache.h"
 #include "uaf/client/subscriptions/subscriptioninformation.h"
 #include "uaf/client/requests/requests.h"
 #include "uaf/client/results/results.h"
@@ -90,7 +93,8 @@ namespace uaf
         : asynchronous_(async),
           transactionId_(0),
           requestHandle_(requestHandle),
-          invocationLevel_(uaf::SessionLevel)
+          invocationLevel_(uaf::SessionLevel),
+          registeredNodes_(0)
         {}
 
 
@@ -127,7 +131,7 @@ namespace uaf
         std::vector<_ResultTarget>&         resultTargets()               { return resultTargets_; }
 
         /** Get the rank for each target. */
-        const std::vector<std::size_t>      ranks()                 const { return ranks_; }
+        const std::vector<std::size_t>&     ranks()                 const { return ranks_; }
 
         /** Is the request asynchronous? */
         bool                                asynchronous()          const { return asynchronous_; }
@@ -195,6 +199,36 @@ namespace uaf
         }
 
 
+        /**
+         * Provide the handle of the subscription that handled each target, in case the targets
+         * were spread over several subscriptions (otherwise, all targets are considered to be
+         * handled by the subscription of setSubscriptionInformation()).
+         */
+        void setClientSubscriptionHandles(
+                const std::vector<uaf::ClientSubscriptionHandle>& clientSubscriptionHandles)
+        {
+            clientSubscriptionHandles_ = clientSubscriptionHandles;
+        }
+
+
+        /**
+         * Copy everything but the targets (i.e. the settings, handles and session information)
+         * from another invocation, so that a part of its targets can be invoked separately.
+         */
+        void copyContextFrom(const BaseServiceInvocation& invocation)
+        {
+            asynchronous_               = invocation.asynchronous_;
+            transactionId_              = invocation.transactionId_;
+            serviceSettings_            = invocation.serviceSettings_;
+            requestHandle_              = invocation.requestHandle_;
+            sessionInformation_         = invocation.sessionInformation_;
+            subscriptionInformation_    = invocation.subscriptionInformation_;
+            invocationLevel_            = invocation.invocationLevel_;
+            operationLimits_            = invocation.operationLimits_;
+            registeredNodes_            = invocation.registeredNodes_;
+        }
+
+
         /** Set the relevant settings from the given request, for the given server URI. */
         void setServiceSettings(const _ServiceSettings& serviceSettings)
         {
@@ -202,6 +236,33 @@ namespace uaf
         }
 
 
+        /** Provide the operation limits of the server (to split synchronous calls if needed). */
+        void setOperationLimits(const uaf::OperationLimits& operationLimits)
+        {
+            operationLimits_ = operationLimits;
+        }
+
+
+        /** Provide the nodes registered within the session (to substitute NodeIds by aliases). */
+        void setRegisteredNodes(const uaf::RegisteredNodeCache* registeredNodes)
+        {
+            registeredNodes_ = registeredNodes;
+        }
+
+
+        /**
+         * Replace the given NodeId by its registered alias, if the node has been registered
+         * within the session.
+         *
+         * @param nodeId    The (fully resolved) NodeId to be replaced in-place.
+         */
+        void substituteRegisteredNode(OpcUa_NodeId& nodeId) const
+        {
+            if (registeredNodes_ != 0)
+                registeredNodes_->substitute(nodeId);
+        }
+
+
 
         ///@} //////////////////////////////////////////////////////////////////////////////////////
         /**
@@ -247,24 +308,7 @@ namespace uaf
             }
             else
             {
-                logger->debug("Copying the data from the synchronous UAF request to the SDK level");
-                ret = fromSyncUafToSdk(
-                        requestTargets_,
-                        serviceSettings_,
-                        nameSpaceArray,
-                        serverArray);
-
-                if (ret.isGood())
-                {
-                    logger->debug("Invoking the synchronous request at the SDK level");
-                    ret = invokeSyncSdkService(uaSession);
-                }
-
-                if (ret.isGood())
-                {
-                    logger->debug("Copying the data from SDK level to the UAF result");
-                    ret = fromSyncSdkToUaf(nameSpaceArray, serverArray, resultTargets_);
-                }
+                ret = invokeSync(uaSession, nameSpaceArray, serverArray, logger);
             }
 
             if (ret.isGood())
@@ -315,24 +359,7 @@ namespace uaf
             }
             else
             {
-                logger->debug("Copying the data from the synchronous UAF request to the SDK level");
-                ret = this->fromSyncUafToSdk(
-                        this->requestTargets(),
-                        this->serviceSettings(),
-                        nameSpaceArray,
-                        serverArray);
-
-                if (ret.isGood())
-                {
-                    logger->debug("Invoking the synchronous request at the SDK level");
-                    ret = this->invokeSyncSdkService(uaSubscription);
-                }
-
-                if (ret.isGood())
-                {
-                    logger->debug("Copying the data from SDK level to the UAF result");
-                    ret = this->fromSyncSdkToUaf(nameSpaceArray, serverArray, this->resultTargets());
-                }
+                ret = invokeSync(uaSubscription, nameSpaceArray, serverArray, logger);
             }
 
             return ret;
@@ -404,6 +431,13 @@ namespace uaf
                               "Bug in BaseServiceInvocation: " \
                               "number of result targets (%d) != number of ranks (%d)",
                               resultTargets_.size(), ranks_.size()));
+            else if (!clientSubscriptionHandles_.empty()
+                     && clientSubscriptionHandles_.size() != ranks_.size())
+                ret = uaf::UnexpectedError(
+                        uaf::format(
+                              "Bug in BaseServiceInvocation: " \
+                              "number of subscription handles (%d) != number of ranks (%d)",
+                              clientSubscriptionHandles_.size(), ranks_.size()));
 
 
             for (std::size_t i = 0; i < resultTargets_.size() && ret.isGood(); i++)
@@ -416,7 +450,9 @@ namespace uaf
                     result.targets[rank].clientConnectionId
                         = sessionInformation_.clientConnectionId;
                     result.targets[rank].clientSubscriptionHandle
-                        = subscriptionInformation_.clientSubscriptionHandle;
+                        = clientSubscriptionHandles_.empty()
+                          ? subscriptionInformation_.clientSubscriptionHandle
+                          : clientSubscriptionHandles_[i];
                 }
                 else
                 {
@@ -527,6 +563,138 @@ namespace uaf
         DISALLOW_COPY_AND_ASSIGN(BaseServiceInvocation);
 
 
+        /**
+         * Invoke the synchronous service (at the session or subscription level), split into
+         * multiple SDK calls if the number of targets exceeds the operation limit of the server.
+         *
+         * The results of all calls are copied to the result targets at the same positions as
+         * their request targets, so the ranks remain valid.
+         *
+         * @param sdkTarget         Pointer to the SDK session or subscription object.
+         * @param nameSpaceArray    The namespace array of the session.
+         * @param serverArray       The server array of the session.
+         * @param logger            Pointer to a logger.
+         * @return                  Bad if the service could not be invoked.
+         */
+        template<typename _SdkTarget>
+        uaf::Status invokeSync(
+                _SdkTarget*                 sdkTarget,
+                const uaf::NamespaceArray&  nameSpaceArray,
+                const uaf::ServerArray&     serverArray,
+                uaf::Logger*                logger)
+        {
+            uaf::Status ret(uaf::statuscodes::Good);
+
+            std::size_t noOfTargets = requestTargets_.size();
+            std::size_t chunkSize   = operationLimit(operationLimits_);
+
+            if (chunkSize == 0 || noOfTargets <= chunkSize)
+            {
+                setChunk(0, noOfTargets);
+
+                logger->debug("Copying the data from the synchronous UAF request to the SDK level");
+                ret = fromSyncUafToSdk(requestTargets_, serviceSettings_, nameSpaceArray, serverArray);
+
+                if (ret.isGood())
+                {
+                    logger->debug("Invoking the synchronous request at the SDK level");
+                    ret = invokeSyncSdkService(sdkTarget);
+                }
+
+                if (ret.isGood())
+                {
+                    logger->debug("Copying the data from SDK level to the UAF result");
+                    ret = fromSyncSdkToUaf(nameSpaceArray, serverArray, resultTargets_);
+                }
+
+                return ret;
+            }
+
+            logger->debug("The %d targets exceed the operation limit of the server, so they will "
+                          "be invoked in chunks of %d targets", int(noOfTargets), int(chunkSize));
+
+            if (resultTargets_.size() != noOfTargets)
+                resultTargets_.resize(noOfTargets);
+
+            for (std::size_t start = 0; start < noOfTargets && ret.isGood(); start += chunkSize)
+            {
+                std::size_t count = std::min(chunkSize, noOfTargets - start);
+
+                std::vector<_RequestTarget> chunkRequestTargets(
+                        requestTargets_.begin() + start,
+                        requestTargets_.begin() + start + count);
+                std::vector<_ResultTarget> chunkResultTargets;
+
+                logger->debug("Invoking targets %d to %d", int(start), int(start + count - 1));
+
+                setChunk(start, count);
+
+                ret = fromSyncUafToSdk(chunkRequestTargets, serviceSettings_, nameSpaceArray, serverArray);
+
+                if (ret.isGood())
+                    ret = invokeSyncSdkService(sdkTarget);
+
+                if (ret.isGood())
+                    ret = fromSyncSdkToUaf(nameSpaceArray, serverArray, chunkResultTargets);
+
+                if (ret.isGood() && chunkResultTargets.size() != count)
+                    ret = uaf::UnexpectedError(
+                            uaf::format("Bug in BaseServiceInvocation: " \
+                                        "number of chunk results (%d) != chunk size (%d)",
+                                        int(chunkResultTargets.size()), int(count)));
+
+                if (ret.isNotGood() && start > 0)
+                {
+                    // the previous chunks have already been processed by the server, so we
+                    // cannot simply report a bad overall status (this would leave e.g. the
+                    // monitored items of the previous chunks orphaned): instead, we report
+                    // the error for each of the targets that were not processed
+                    logger->error("Targets %d to %d could not be invoked, so their status is set",
+                                  int(start), int(noOfTargets - 1));
+                    logger->error(ret);
+
+                    for (std::size_t i = start; i < noOfTargets; i++)
+                        resultTargets_[i].status = ret;
+
+                    return uaf::Status(uaf::statuscodes::Good);
+                }
+
+                for (std::size_t i = 0; i < count && ret.isGood(); i++)
+                    resultTargets_[start + i] = chunkResultTargets[i];
+            }
+
+            return ret;
+        }
+
+
+        /**
+         * Get the maximum number of targets that can be sent in a single synchronous call.
+         *
+         * This is a virtual function, meant to be overwritten by the concrete services that
+         * are subject to one of the operation limits of the server.
+         *
+         * @param operationLimits   The operation limits of the server.
+         * @return                  The maximum number of targets, or 0 if there is no limit.
+         */
+        virtual std::size_t operationLimit(const uaf::OperationLimits& operationLimits) const
+        {
+            return 0;
+        }
+
+
+        /**
+         * Announce the range of the request targets that will be passed to the next call of
+         * fromSyncUafToSdk.
+         *
+         * This is a virtual function, meant to be overwritten by the concrete services that
+         * keep additional per-target data (such as client handles).
+         *
+         * @param start     Index of the first target.
+         * @param count     Number of targets.
+         */
+        virtual void setChunk(std::size_t start, std::size_t count) {}
+
+
 
         /**
          * Copy the synchronous request data from the UAF objects to the SDK objects.
@@ -711,8 +879,15 @@ namespace uaf
         uaf::SessionInformation    sessionInformation_;
         // some details about the subscription
         uaf::SubscriptionInformation subscriptionInformation_;
+        // the handles of the subscriptions that handled the targets (empty if all targets were
+        // handled by the subscription of subscriptionInformation_)
+        std::vector<uaf::ClientSubscriptionHandle> clientSubscriptionHandles_;
         // the level at which the service should be invoked
         uaf::InvocationLevel       invocationLevel_;
+        // the operation limits of the server
+        uaf::OperationLimits       operationLimits_;
+        // the nodes registered within the session (not owned by the invocation!)
+        const uaf::RegisteredNodeCache* registeredNodes_;
 
     };
 
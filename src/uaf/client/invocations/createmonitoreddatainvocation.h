@@ -67,6 +67,7 @@ namespace uaf
         void setHandles(const ClientHandles& clientHandles)
         {
             clientHandles_ = clientHandles;
+            allClientHandles_ = clientHandles;
         }
 
 
@@ -117,9 +118,22 @@ namespace uaf
                 std::vector<uaf::CreateMonitoredDataResultTarget>& targets);
 
 
+        /**
+         * Overridden function from uaf::BaseServiceInvocation.
+         */
+        std::size_t operationLimit(const uaf::OperationLimits& operationLimits) const;
+
+
+        /**
+         * Overridden function from uaf::BaseServiceInvocation.
+         */
+        void setChunk(std::size_t start, std::size_t count);
+
+
         // private data members used during the invocation
         OpcUa_TimestampsToReturn        uaTimeStamps_;
         ClientHandles                   clientHandles_;
+        ClientHandles                   allClientHandles_;
         UaClientSdk::ServiceSettings    uaServiceSettings_;
         UaMonitoredItemCreateRequests   uaCreateRequests_;
         UaMonitoredItemCreateResults    uaCreateResults_;
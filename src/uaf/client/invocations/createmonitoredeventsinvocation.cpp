@@ -48,8 +48,10 @@ namespace uaf
         // declare the number of targets
         size_t noOfTargets = targets.size();
 
-        // resize the number of requests
-        uaCreateRequests_.resize(noOfTargets);
+        // re-create the requests, since the invocation may be reused for several chunks
+        // (the filters, NodeIds and index ranges of a previous chunk must not be kept)
+        uaCreateRequests_.clear();
+        uaCreateRequests_.create(noOfTargets);
 
         // check if the client handles have been set correctly
         if (clientHandles_.size() == noOfTargets)
@@ -237,6 +239,25 @@ namespace uaf
     }
 
 
+    // Get the operation limit that applies to this service
+    // =============================================================================================
+    size_t CreateMonitoredEventsInvocation::operationLimit(const OperationLimits& operationLimits) const
+    {
+        return operationLimits.maxMonitoredItemsPerCall;
+    }
+
+
+    // Select the client handles of the next chunk of targets
+    // =============================================================================================
+    void CreateMonitoredEventsInvocation::setChunk(size_t start, size_t count)
+    {
+        if (start + count <= allClientHandles_.size())
+            clientHandles_.assign(
+                    allClientHandles_.begin() + start,
+                    allClientHandles_.begin() + start + count);
+        else
+            clientHandles_.clear(); // will be reported by fromSyncUafToSdk
+    }
 
 
 }
@@ -66,6 +66,7 @@ namespace uaf
         void setHandles(const ClientHandles&        clientHandles)
         {
             clientHandles_       = clientHandles;
+            allClientHandles_ = clientHandles;
         }
 
 
@@ -116,9 +117,22 @@ namespace uaf
                 std::vector<uaf::CreateMonitoredEventsResultTarget>& targets);
 
 
+        /**
+         * Overridden function from uaf::BaseServiceInvocation.
+         */
+        std::size_t operationLimit(const uaf::OperationLimits& operationLimits) const;
+
+
+        /**
+         * Overridden function from uaf::BaseServiceInvocation.
+         */
+        void setChunk(std::size_t start, std::size_t count);
+
+
         // private data members used during the invocation
         OpcUa_TimestampsToReturn        uaTimeStamps_;
         ClientHandles                   clientHandles_;
+        ClientHandles                   allClientHandles_;
         UaClientSdk::ServiceSettings    uaServiceSettings_;
         UaMonitoredItemCreateRequests   uaCreateRequests_;
         UaMonitoredItemCreateResults    uaCreateResults_;
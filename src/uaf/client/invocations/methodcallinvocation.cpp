@@ -267,6 +267,12 @@ namespace uaf
     }
 
 
+    // Get the operation limit that applies to this service
+    // =============================================================================================
+    size_t MethodCallInvocation::operationLimit(const OperationLimits& operationLimits) const
+    {
+        return operationLimits.maxNodesPerMethodCall;
+    }
 
 
 }
@@ -65,6 +65,9 @@ namespace uaf
             // only update the rest of the SDK variables if no error has occurred yet
             if (ret.isGood())
             {
+                // use the alias of the node if it was registered
+                substituteRegisteredNode(uaReadValueIds_[i].NodeId);
+
                 // update the attribute id of the target
                 uaReadValueIds_[i].AttributeId = targets[i].attributeId;
 
@@ -161,7 +164,7 @@ namespace uaf
         {
             for (uint32_t i=0; i<noOfTargets ; i++)
             {
-                targets[i].fromSdk(UaDataValue(uaDataValues_[i]));
+                targets[i].fromSdk(uaDataValues_[i]);
                 nameSpaceArray.fillVariant(targets[i].data);
                 serverArray.fillVariant(targets[i].data);
 
@@ -183,6 +186,12 @@ namespace uaf
     }
 
 
+    // Get the operation limit that applies to this service
+    // =============================================================================================
+    size_t ReadInvocation::operationLimit(const OperationLimits& operationLimits) const
+    {
+        return operationLimits.maxNodesPerRead;
+    }
 
 
 }
@@ -94,6 +94,12 @@ namespace uaf
                 std::vector<uaf::ReadResultTarget>& targets);
 
 
+        /**
+         * Overridden function from uaf::BaseServiceInvocation.
+         */
+        std::size_t operationLimit(const uaf::OperationLimits& operationLimits) const;
+
+
         // private data members used during the invocation
         OpcUa_Double                    uaMaxAge_;
         OpcUa_TimestampsToReturn        uaTimestampsToReturn_;
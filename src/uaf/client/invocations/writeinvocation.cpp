@@ -56,6 +56,9 @@ namespace uaf
             // only update the rest of the SDK variables if no error has occurred yet
             if (ret.isGood())
             {
+                // use the alias of the node if it was registered
+                substituteRegisteredNode(uaWriteValues_[i].NodeId);
+
                 // update the attribute id, index range, data and status code of the target
                 uaWriteValues_[i].AttributeId = targets[i].attributeId;
 
@@ -178,6 +181,12 @@ namespace uaf
     }
 
 
+    // Get the operation limit that applies to this service
+    // =============================================================================================
+    size_t WriteInvocation::operationLimit(const OperationLimits& operationLimits) const
+    {
+        return operationLimits.maxNodesPerWrite;
+    }
 
 
 }
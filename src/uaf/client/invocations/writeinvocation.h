@@ -96,6 +96,12 @@ namespace uaf
                 std::vector<uaf::WriteResultTarget>&   targets);
 
 
+        /**
+         * Overridden function from uaf::BaseServiceInvocation.
+         */
+        std::size_t operationLimit(const uaf::OperationLimits& operationLimits) const;
+
+
         // private data members used during the invocation
         UaClientSdk::ServiceSettings    uaServiceSettings_;
         UaWriteValues                   uaWriteValues_;
@@ -29,6 +29,18 @@ namespace uaf
     using std::size_t;
 
 
+    // Hash function and equality of addresses, to find identical addresses without copying them
+    // =============================================================================================
+    struct AddressPointerHash
+    {
+        size_t operator()(const Address* address) const { return address->hash(); }
+    };
+    struct AddressPointerEqual
+    {
+        bool operator()(const Address* a, const Address* b) const { return *a == *b; }
+    };
+
+
     // Constructor
     //==============================================================================================
     Resolver::Resolver(
@@ -39,14 +51,14 @@ namespace uaf
       database_(database)
     {
         logger_ = new Logger(loggerFactory, "Resolver");
-        logger_->debug("The resolver has been constructed");
+        UAF_LOG_DEBUG(logger_, "The resolver has been constructed");
     }
 
     // Destructor
     //==============================================================================================
     Resolver::~Resolver()
     {
-        logger_->debug("Destructing the resolver");
+        UAF_LOG_DEBUG(logger_, "Destructing the resolver");
 
         delete logger_;
         logger_ = 0;
@@ -61,7 +73,7 @@ namespace uaf
             Mask&                   expandedNodeIdMask,
             Mask&                   relativePathMask)
     {
-        logger_->debug("Resolving the addresses by querying the cache");
+        UAF_LOG_DEBUG(logger_, "Resolving the addresses by querying the cache");
 
         // declare the return status
         Status ret(statuscodes::Good);
@@ -76,24 +88,24 @@ namespace uaf
         // loop through the addresses
         for (size_t i=0; i<noOfAddresses; i++)
         {
-            logger_->debug("Trying to find address %d in the cache", i);
+            UAF_LOG_DEBUG(logger_, "Trying to find address %d in the cache", i);
 
-            if (database_->addressCache.find(addresses[i], expandedNodeIds[i]))
+            // (the cache may also tell us that the address could not be resolved recently)
+            if (database_->addressCache.find(addresses[i], expandedNodeIds[i], statuses[i]))
             {
-                statuses[i] = statuscodes::Good;
-                logger_->debug("Address %d was already cached", i);
+                UAF_LOG_DEBUG(logger_, "Address %d was already cached", i);
             }
             else
             {
                 if (addresses[i].isExpandedNodeId())
                 {
                     expandedNodeIdMask.set(i);
-                    logger_->debug("Address %d is an ExpandedNodeId not found in the cache", i);
+                    UAF_LOG_DEBUG(logger_, "Address %d is an ExpandedNodeId not found in the cache", i);
                 }
                 else if (addresses[i].isRelativePath())
                 {
                     relativePathMask.set(i);
-                    logger_->debug("Address %d is a RelativePath not found in the cache", i);
+                    UAF_LOG_DEBUG(logger_, "Address %d is a RelativePath not found in the cache", i);
                 }
                 else
                 {
@@ -115,6 +127,59 @@ namespace uaf
             const vector<Address>&  addresses,
             vector<ExpandedNodeId>& expandedNodeIds,
             vector<Status>&         statuses)
+    {
+        // declare the number of addresses
+        size_t noOfAddresses = addresses.size();
+
+        // find the identical addresses (e.g. the starting addresses of many relative paths may be
+        // the same), so that they are resolved only once
+        typedef std::unordered_map<const Address*, size_t, AddressPointerHash, AddressPointerEqual>
+                UniqueIndexes;
+        UniqueIndexes  uniqueIndexes;
+        vector<size_t> indexes(noOfAddresses);
+
+        uniqueIndexes.reserve(noOfAddresses);
+        for (size_t i = 0; i < noOfAddresses; i++)
+            indexes[i] = uniqueIndexes.insert(
+                    UniqueIndexes::value_type(&addresses[i], uniqueIndexes.size())).first->second;
+
+        if (uniqueIndexes.size() == noOfAddresses)
+            return resolveUnique(addresses, expandedNodeIds, statuses);
+
+        UAF_LOG_DEBUG(logger_, "Resolving %d unique addresses instead of %d addresses",
+                               uniqueIndexes.size(), noOfAddresses);
+
+        vector<Address> uniqueAddresses(uniqueIndexes.size());
+        for (UniqueIndexes::const_iterator it = uniqueIndexes.begin();
+             it != uniqueIndexes.end();
+             ++it)
+        {
+            uniqueAddresses[it->second] = *it->first;
+        }
+
+        vector<ExpandedNodeId> uniqueExpandedNodeIds;
+        vector<Status>         uniqueStatuses;
+        Status ret = resolveUnique(uniqueAddresses, uniqueExpandedNodeIds, uniqueStatuses);
+
+        // copy the results of the unique addresses to all (identical) addresses
+        expandedNodeIds.resize(noOfAddresses);
+        statuses.resize(noOfAddresses);
+        for (size_t i = 0; i < noOfAddresses; i++)
+        {
+            expandedNodeIds[i] = uniqueExpandedNodeIds[indexes[i]];
+            statuses[i]        = uniqueStatuses[indexes[i]];
+        }
+
+        return ret;
+    }
+
+
+    // Resolve some addresses (which are all different)
+    //==============================================================================================
+    Status Resolver::resolveUnique(
+            const vector<Address>&  addresses,
+            vector<ExpandedNodeId>& expandedNodeIds,
+            vector<Status>&         statuses)
     {
         // ToDo add session and security settings!
 
@@ -125,11 +190,14 @@ namespace uaf
         size_t noOfAddresses = addresses.size();
 
         // log a nice message
-        logger_->debug("Resolving the following addresses:");
-        for (size_t i=0; i<noOfAddresses; i++)
+        if (logger_->isEnabled(loglevels::Debug))
         {
-            logger_->debug(" - Address %d", i);
-            logger_->debug(addresses[i].toString("   ", 28));
+            UAF_LOG_DEBUG(logger_, "Resolving the following addresses:");
+            for (size_t i=0; i<noOfAddresses; i++)
+            {
+                UAF_LOG_DEBUG(logger_, " - Address %d", i);
+                UAF_LOG_DEBUG(logger_, addresses[i].toString("   ", 28));
+            }
         }
 
         // prepare the output parameters by resizing them
@@ -149,7 +217,7 @@ namespace uaf
         // log the current status
         if (expandedNodeIdMask.setCount() == 0 && relativePathMask.setCount() == 0)
         {
-            logger_->debug("All addresses were cached, so the resolution is finished");
+            UAF_LOG_DEBUG(logger_, "All addresses were cached, so the resolution is finished");
         }
         else
         {
@@ -177,37 +245,36 @@ namespace uaf
             vector<ExpandedNodeId>& results,
             vector<Status>&         resultStatuses)
     {
-        logger_->debug("Now verifying %d ExpandedNodeIds", addresses.size());
+        UAF_LOG_DEBUG(logger_, "Now verifying %d ExpandedNodeIds", addresses.size());
 
         Status ret(statuscodes::Good);
 
         // verify the 'set' targets
-        for (size_t i = 0; i < addresses.size() && ret.isGood(); i++)
+        for (size_t i = mask.nextSet(0);
+             i < addresses.size() && ret.isGood();
+             i = mask.nextSet(i + 1))
         {
-            if (mask.isSet(i))
-            {
-                // copy the ExpandedNodeId
-                results[i] = addresses[i].getExpandedNodeId();
+            // copy the ExpandedNodeId
+            results[i] = addresses[i].getExpandedNodeId();
 
-                // set the status
-                if (results[i].hasServerUri())
+            // set the status
+            if (results[i].hasServerUri())
+            {
+                if (   results[i].nodeId().hasNameSpaceIndex() \
+                    || results[i].nodeId().hasNameSpaceUri())
                 {
-                    if (   results[i].nodeId().hasNameSpaceIndex() \
-                        || results[i].nodeId().hasNameSpaceUri())
-                    {
-                        database_->addressCache.add(addresses[i], results[i]);
-                        resultStatuses[i] = statuscodes::Good;
-                    }
-                    else
-                    {
-                        ret = NoNamespaceIndexOrUriGivenError();
-                    }
+                    database_->addressCache.add(addresses[i], results[i]);
+                    resultStatuses[i] = statuscodes::Good;
                 }
                 else
                 {
-                    ret = EmptyServerUriError();
+                    ret = NoNamespaceIndexOrUriGivenError();
                 }
             }
+            else
+            {
+                ret = EmptyServerUriError();
+            }
         }
 
         return ret;
@@ -241,16 +308,19 @@ namespace uaf
 
         // now try to resolve the relative paths (essentially browse paths since their starting
         // addresses have been resolved)
+        Mask notFoundMask(addresses.size(), false);
         if (ret.isGood())
-            ret = resolveBrowsePaths(browsePaths, remainingMask, results, statuses);
+            ret = resolveBrowsePaths(browsePaths, remainingMask, results, statuses, notFoundMask);
 
-        // add the resolved addresses to the cache
-        for (size_t i = 0; i < addresses.size() && ret.isGood(); i++)
+        // add the resolved addresses to the cache, as well as the addresses that don't exist
+        for (size_t i = mask.nextSet(0);
+             i < addresses.size() && ret.isGood();
+             i = mask.nextSet(i + 1))
         {
-            if (mask.isSet(i) && statuses[i].isGood())
-            {
+            if (statuses[i].isGood())
                 database_->addressCache.add(addresses[i], results[i], true);
-            }
+            else if (notFoundMask.isSet(i))
+                database_->addressCache.addFailure(addresses[i], statuses[i]);
         }
 
         return ret;
@@ -277,10 +347,11 @@ namespace uaf
 
         // fill a vector containing all starting addresses
         vector<Address> startingAddresses;
-        for (size_t i = 0; i < noOfRelativePaths && ret.isGood(); i++)
+        for (size_t i = mask.nextSet(0);
+             i < noOfRelativePaths && ret.isGood();
+             i = mask.nextSet(i + 1))
         {
-            if (mask.isSet(i))
-                startingAddresses.push_back(*(relativePathAddresses[i].getStartingAddress()));
+            startingAddresses.push_back(*(relativePathAddresses[i].getStartingAddress()));
         }
 
         // resolve them (recursively!)
@@ -289,24 +360,23 @@ namespace uaf
         ret = resolve(startingAddresses, startingAddressesResults, startingAddressesStatuses);
 
         // update the results
-        for (size_t i = 0, j = 0; i < noOfRelativePaths && ret.isGood(); i++)
+        for (size_t i = mask.nextSet(0), j = 0;
+             i < noOfRelativePaths && ret.isGood();
+             i = mask.nextSet(i + 1))
         {
-            if (mask.isSet(i))
-            {
-                // update the results
-                results[i].startingExpandedNodeId = startingAddressesResults[j];
-                results[i].relativePath           = relativePathAddresses[i].getRelativePath();
+            // update the results
+            results[i].startingExpandedNodeId = startingAddressesResults[j];
+            results[i].relativePath           = relativePathAddresses[i].getRelativePath();
 
-                // update the statuses
-                statuses[i] = startingAddressesStatuses[j];
+            // update the statuses
+            statuses[i] = startingAddressesStatuses[j];
 
-                // update the mask (only resolved starting addresses should be processed further!)
-                if (statuses[i].isNotGood())
-                    mask.unset(i);
+            // update the mask (only resolved starting addresses should be processed further!)
+            if (statuses[i].isNotGood())
+                mask.unset(i);
 
-                // increment the index of the startingAddressesResults
-                j++;
-            }
+            // increment the index of the startingAddressesResults
+            j++;
         }
 
         return ret;
@@ -320,9 +390,10 @@ namespace uaf
             vector<BrowsePath>&       browsePaths,
             Mask&                     mask,
             vector<ExpandedNodeId>&   results,
-            vector<Status>&           statuses)
+            vector<Status>&           statuses,
+            Mask&                     notFoundMask)
     {
-        logger_->debug("Resolving %d browse paths", browsePaths.size());
+        UAF_LOG_DEBUG(logger_, "Resolving %d browse paths", browsePaths.size());
 
         // declare the return status
         Status ret;
@@ -341,7 +412,7 @@ namespace uaf
         }
         else if (mask.setCount() == 0)
         {
-            logger_->debug("Nothing to do, no browse paths are marked with the mask");
+            UAF_LOG_DEBUG(logger_, "Nothing to do, no browse paths are marked with the mask");
         }
         else
         {
@@ -349,36 +420,38 @@ namespace uaf
             TranslateBrowsePathsToNodeIdsRequest request;
             TranslateBrowsePathsToNodeIdsResult  result;
 
-            for (size_t i = 0; i < noOfBrowsePaths; i++)
+            for (size_t i = mask.nextSet(0); i < noOfBrowsePaths; i = mask.nextSet(i + 1))
             {
-                if (mask.isSet(i))
-                    request.targets.push_back(
-                            TranslateBrowsePathsToNodeIdsRequestTarget(browsePaths[i]));
+                request.targets.push_back(
+                        TranslateBrowsePathsToNodeIdsRequestTarget(browsePaths[i]));
             }
 
+            // (the browse paths of different servers are translated concurrently, so each level
+            // of the resolution takes about as long as the slowest server)
             ret = sessionFactory_->invokeRequest<TranslateBrowsePathsToNodeIdsService>(
                     request,
                     Mask(request.targets.size(), true),
-                    result);
+                    result,
+                    true);
 
             if (ret.isGood())
             {
                 // fill the remainingBrowsePaths and remainingMask
-                for (size_t i = 0, j = 0; i < noOfBrowsePaths; i++)
+                for (size_t i = mask.nextSet(0), j = 0;
+                     i < noOfBrowsePaths;
+                     i = mask.nextSet(i + 1))
                 {
-                    if (mask.isSet(i))
-                    {
-                        processBrowsePathsResolutionResultTarget(
-                                result.targets[j], i, browsePaths, mask, results, statuses);
+                    processBrowsePathsResolutionResultTarget(
+                            result.targets[j], i, browsePaths, mask, results, statuses,
+                            notFoundMask);
 
-                        // increment the counter for the 'set' results
-                        j++;
-                    }
+                    // increment the counter for the 'set' results
+                    j++;
                 }
 
                 // check if we need to perform another (recursive!) translation
                 if (mask.setCount() > 0)
-                    ret = resolveBrowsePaths(browsePaths, mask, results, statuses);
+                    ret = resolveBrowsePaths(browsePaths, mask, results, statuses, notFoundMask);
             }
         }
 
@@ -393,7 +466,8 @@ namespace uaf
             vector<BrowsePath>&                                 browsePaths,
             Mask&                                               mask,
             vector<ExpandedNodeId>&                             results,
-            vector<Status>&                                     statuses)
+            vector<Status>&                                     statuses,
+            Mask&                                               notFoundMask)
     {
         // check the target status
         if (target.status.isBad())
@@ -401,6 +475,13 @@ namespace uaf
             logger_->error("Target %d could not be resolved: %s",
                            rank, target.status.toString().c_str());
             statuses[rank] = target.status;
+
+            // remember if the server told us that the browse path doesn't exist, since retrying
+            // will not help in this case
+            if (   target.opcUaStatusCode == OpcUa_BadNoMatch
+                || target.opcUaStatusCode == OpcUa_BadNodeIdUnknown
+                || target.opcUaStatusCode == OpcUa_BadBrowseNameInvalid)
+                notFoundMask.set(rank);
             // we're finished with this target (unfortunately, because it failed),
             // so unset the mask item
             mask.unset(rank);
@@ -433,23 +514,23 @@ namespace uaf
                     results[rank]  = target.expandedNodeIds[0];
                     statuses[rank] = statuses[0];
 
-                    logger_->debug("Target %d was successfully resolved to:", rank);
-                    logger_->debug(results[rank].toString());
+                    UAF_LOG_DEBUG(logger_, "Target %d was successfully resolved to:", rank);
+                    UAF_LOG_DEBUG(logger_, results[rank].toString());
 
                     // we're finished with this target, so unset the mask item
                     mask.unset(rank);
                 }
                 else if (target.opcUaStatusCode == OpcUa_UncertainReferenceOutOfServer)
                 {
-                    logger_->debug("Target %d could not be fully resolved, there is an "
-                                   "out-of-server reference", rank);
+                    UAF_LOG_DEBUG(logger_, "Target %d could not be fully resolved, there is an "
+                                           "out-of-server reference", rank);
 
                     // declare the remaining path index
                     uint32_t remainingIndex = target.remainingPathIndexes[0];
                     uint32_t noOfElements   = browsePaths[rank].relativePath.size();
                     uint32_t maxIndex       = noOfElements - 1;
 
-                    logger_->debug("Remaining index: %d (max index: %d)", remainingIndex, maxIndex);
+                    UAF_LOG_DEBUG(logger_, "Remaining index: %d (max index: %d)", remainingIndex, maxIndex);
 
                     if (remainingIndex == 0 || remainingIndex >= maxIndex)
                     {
@@ -475,7 +556,7 @@ namespace uaf
                         // set the new browse path based on the just created elements
                         browsePaths[rank] = BrowsePath(target.expandedNodeIds[0], newElements);
 
-                        logger_->debug("New browse path: %s", browsePaths[rank].toString().c_str());
+                        UAF_LOG_DEBUG(logger_, "New browse path: %s", browsePaths[rank].toString().c_str());
 
                         // we're not finished with this target, so leave the mask item 'set'
                     }
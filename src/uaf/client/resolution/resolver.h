@@ -26,6 +26,7 @@
 #include <vector>
 #include <string>
 #include <map>
+#include <unordered_map>
 // SDK
 #include "uaclientcpp/uaclientsdk.h"
 // UAF
@@ -50,6 +51,12 @@ namespace uaf
     * The uaf::Resolver uses the TranslateBrowsePathsToNodeIds service to resolve the relative
     * addresses, and uses the uaf::AddressCache to cache the resolution results.
     *
+    * Relative addresses are resolved level by level: first all starting addresses (recursively),
+    * then the relative paths themselves. Identical addresses (such as the starting address
+    * shared by many relative paths) are resolved only once, and each level results in one
+    * TranslateBrowsePathsToNodeIds invocation per server, which are invoked concurrently. So the
+    * resolution takes roughly as many round trips as the deepest address is nested.
+    *
     * @ingroup ClientResolution
     ***********************************************************************************************/
     class UAF_EXPORT Resolver
@@ -131,8 +138,8 @@ namespace uaf
             if (ret.isGood())
             {
                 items = getResolvableItems<_Service>(request, mask);
-                logger_->debug("%d resolvable items were extracted from the request",
-                               items.size());
+                UAF_LOG_DEBUG(logger_, "%d resolvable items were extracted from the request",
+                                       items.size());
             }
 
             // resolve all resolvable items at once
@@ -144,7 +151,7 @@ namespace uaf
             // update all 'set' targets
             if (ret.isGood())
             {
-                logger_->debug("Now updating the masked targets");
+                UAF_LOG_DEBUG(logger_, "Now updating the masked targets");
                 ret = setResolvedItems<_Service>(
                         itemExpandedNodeIds,
                         itemStatuses,
@@ -175,6 +182,20 @@ namespace uaf
         DISALLOW_COPY_AND_ASSIGN(Resolver);
 
 
+        /**
+         * Resolve addresses which are all different from each other.
+         *
+         * @param addresses         Addresses to resolve (without duplicates).
+         * @param expandedNodeIds   Results of the resolution.
+         * @param statuses          Statuses of the results of the resolution.
+         * @return                  Good if the resolution went find, bad otherwise.
+         */
+        uaf::Status resolveUnique(
+                const std::vector<uaf::Address>&    addresses,
+                std::vector<uaf::ExpandedNodeId>&   expandedNodeIds,
+                std::vector<uaf::Status>&           statuses);
+
+
         /**
          * Resolve an address by only checking the cache.
          *
@@ -262,6 +283,8 @@ namespace uaf
          * @param mask          The mask that indicates the browse paths that will be resolved.
          * @param results       The resulting ExpandedNodeIds.
          * @param statuses      The resulting resolution statuses.
+         * @param notFoundMask  The mask that will indicate the browse paths which the server
+         *                      reported as nonexistent (so that this failure may be cached).
          * @return              Good if there were no errors on the client side (e.g. malformed
          *                      addresses), Bad otherwise.
          */
@@ -269,7 +292,8 @@ namespace uaf
                 std::vector<uaf::BrowsePath>&       browsePaths,
                 uaf::Mask&                          mask,
                 std::vector<uaf::ExpandedNodeId>&   results,
-                std::vector<uaf::Status>&           statuses);
+                std::vector<uaf::Status>&           statuses,
+                uaf::Mask&                          notFoundMask);
 
 
         /**
@@ -284,6 +308,8 @@ namespace uaf
          *                      the corresponding mask item will be 'unset' (False).
          * @param results       The resulting ExpandedNodeIds.
          * @param statuses      The resulting resolution statuses.
+         * @param notFoundMask  The mask indicating the browse paths which the server reported as
+         *                      nonexistent. This mask will be updated.
          * @return              Good if there were no errors on the client side (e.g. malformed
          *                      addresses), Bad otherwise.
          */
@@ -293,7 +319,8 @@ namespace uaf
                 std::vector<uaf::BrowsePath>&                          browsePaths,
                 uaf::Mask&                                             mask,
                 std::vector<uaf::ExpandedNodeId>&                      results,
-                std::vector<uaf::Status>&                              statuses);
+                std::vector<uaf::Status>&                              statuses,
+                uaf::Mask&                                             notFoundMask);
 
 
         /**
@@ -312,14 +339,13 @@ namespace uaf
                 const uaf::Mask& mask) const
         {
             std::vector<uaf::Address> ret;
-            for (std::size_t i = 0; i < request.targets.size(); i++)
+            for (std::size_t i = mask.nextSet(0);
+                 i < request.targets.size();
+                 i = mask.nextSet(i + 1))
             {
-                if (mask.isSet(i))
-                {
-                    std::vector<uaf::Address> resolvableItems(
-                            request.targets[i].getResolvableItems());
-                    ret.insert(ret.end(), resolvableItems.begin(), resolvableItems.end());
-                }
+                std::vector<uaf::Address> resolvableItems(
+                        request.targets[i].getResolvableItems());
+                ret.insert(ret.end(), resolvableItems.begin(), resolvableItems.end());
             }
             return ret;
         }
@@ -358,56 +384,55 @@ namespace uaf
 
             if (ret.isGood())
             {
-                for (std::size_t i = 0, j = 0; i < request.targets.size() && ret.isGood(); i++)
+                for (std::size_t i = mask.nextSet(0), j = 0;
+                     i < request.targets.size() && ret.isGood();
+                     i = mask.nextSet(i + 1))
                 {
-                    if (mask.isSet(i))
-                    {
-                        // get the number of items of the current target
-                        std::size_t noOfItems = request.targets[i].resolvableItemsCount();
+                    // get the number of items of the current target
+                    std::size_t noOfItems = request.targets[i].resolvableItemsCount();
 
-                        if (noOfItems > 0)
+                    if (noOfItems > 0)
+                    {
+                        // create ExpandedNodeId and Status vectors for the current target
+                        std::vector<uaf::ExpandedNodeId> targetExpandedNodeIds(
+                                expandedNodeIds.begin() + j     * noOfItems,
+                                expandedNodeIds.begin() + (j+1) * noOfItems);
+                        std::vector<uaf::Status> targetStatuses(
+                                statuses.begin() + j     * noOfItems,
+                                statuses.begin() + (j+1) * noOfItems);
+
+                        // set the newly created vectors
+                        ret = request.targets[i].setResolvedItems(
+                                targetExpandedNodeIds,
+                                targetStatuses);
+
+                        // in case of just one item per target, set the status of the first
+                        // item as "resolution status"
+                        if (noOfItems == 1)
+                        {
+                            result.targets[i].status = targetStatuses[0];
+                        }
+                        // in case of multiple items per target, make a summary
+                        else
                         {
-                            // create ExpandedNodeId and Status vectors for the current target
-                            std::vector<uaf::ExpandedNodeId> targetExpandedNodeIds(
-                                    expandedNodeIds.begin() + j     * noOfItems,
-                                    expandedNodeIds.begin() + (j+1) * noOfItems);
-                            std::vector<uaf::Status> targetStatuses(
-                                    statuses.begin() + j     * noOfItems,
-                                    statuses.begin() + (j+1) * noOfItems);
-
-                            // set the newly created vectors
-                            ret = request.targets[i].setResolvedItems(
-                                    targetExpandedNodeIds,
-                                    targetStatuses);
-
-                            // in case of just one item per target, set the status of the first
-                            // item as "resolution status"
-                            if (noOfItems == 1)
+                            std::vector<uint32_t> unresolvedTargetNumbers;
+                            std::stringstream unresolvedStringStream;
+                            for (uint32_t k = 0; k < targetStatuses.size(); k++)
                             {
-                                result.targets[i].status = targetStatuses[0];
+                                if (targetStatuses[k].isNotGood())
+                                    unresolvedTargetNumbers.push_back(k);
                             }
-                            // in case of multiple items per target, make a summary
+
+                            if (unresolvedStringStream.str().size() == 0)
+                                result.targets[i].status = uaf::statuscodes::Good;
                             else
-                            {
-                                std::vector<uint32_t> unresolvedTargetNumbers;
-                                std::stringstream unresolvedStringStream;
-                                for (uint32_t k = 0; k < targetStatuses.size(); k++)
-                                {
-                                    if (targetStatuses[k].isNotGood())
-                                        unresolvedTargetNumbers.push_back(k);
-                                }
-
-                                if (unresolvedStringStream.str().size() == 0)
-                                    result.targets[i].status = uaf::statuscodes::Good;
-                                else
-                                    result.targets[i].status = \
-                                        uaf::NotAllTargetsCouldBeResolvedError(unresolvedTargetNumbers);
-                            }
+                                result.targets[i].status = \
+                                    uaf::NotAllTargetsCouldBeResolvedError(unresolvedTargetNumbers);
                         }
-
-                        // go to the next 'set' item
-                        j++;
                     }
+
+                    // go to the next 'set' item
+                    j++;
                 }
 
                 ret = uaf::statuscodes::Good;
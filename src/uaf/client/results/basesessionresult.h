@@ -358,13 +358,8 @@ namespace uaf
         // if everything is OK, loop through the statuses and update the 'set' targets
         if (ret.isGood())
         {
-            for (std::size_t i = 0; i < noOfTargets; i++)
-            {
-                if (mask.isSet(i))
-                {
-                    targets[i].status = commonStatus;
-                }
-            }
+            for (std::size_t i = mask.nextSet(0); i < noOfTargets; i = mask.nextSet(i + 1))
+                targets[i].status = commonStatus;
         }
 
         return ret;
@@ -397,13 +392,10 @@ namespace uaf
         // if everything is OK, loop through the statuses and update the 'set' targets
         else
         {
-            for (std::size_t i = 0, j = 0; i < noOfTargets; i++)
+            for (std::size_t i = mask.nextSet(0), j = 0; i < noOfTargets; i = mask.nextSet(i + 1))
             {
-                if (mask.isSet(i))
-                {
-                    targets[i].status = statuses[j];
-                    j++;
-                }
+                targets[i].status = statuses[j];
+                j++;
             }
             ret = uaf::statuscodes::Good;
         }
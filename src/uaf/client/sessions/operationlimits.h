@@ -0,0 +1,78 @@
+/* This file is part of the UAF (Unified Architecture Framework) project.
+ *
+ * Copyright (C) 2012 Wim Pessemier (Institute of Astronomy, KULeuven)
+ *
+ * Project website: http://www.ster.kuleuven.be/uaf
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef UAF_OPERATIONLIMITS_H_
+#define UAF_OPERATIONLIMITS_H_
+
+// STD
+#include <string>
+#include <sstream>
+#include <stdint.h>
+// SDK
+// UAF
+#include "uaf/util/stringifiable.h"
+#include "uaf/client/clientexport.h"
+
+namespace uaf
+{
+
+    /*******************************************************************************************//**
+    * An OperationLimits object contains the maximum number of operations that a server accepts
+    * within a single service call (as exposed by the Server/ServerCapabilities/OperationLimits
+    * object of the server).
+    *
+    * A limit of 0 means that the server does not impose a limit (or that it is unknown).
+    *
+    * @ingroup ClientSessions
+    ***********************************************************************************************/
+    class UAF_EXPORT OperationLimits
+    {
+    public:
+
+
+        /**
+         * Create a default OperationLimits object (without any limits).
+         */
+        OperationLimits();
+
+
+        /** The maximum number of nodes per Read call. */
+        uint32_t maxNodesPerRead;
+
+        /** The maximum number of nodes per Write call. */
+        uint32_t maxNodesPerWrite;
+
+        /** The maximum number of methods per Call call. */
+        uint32_t maxNodesPerMethodCall;
+
+        /** The maximum number of monitored items per CreateMonitoredItems call. */
+        uint32_t maxMonitoredItemsPerCall;
+
+
+        /**
+         * Get a string representation of the limits.
+         */
+        std::string toString(const std::string& indent="", std::size_t colon=31) const;
+    };
+
+
+}
+
+
+#endif /* UAF_OPERATIONLIMITS_H_ */
@@ -0,0 +1,265 @@
+/* This file is part of the UAF (Unified Architecture Framework) project.
+ *
+ * Copyright (C) 2012 Wim Pessemier (Institute of Astronomy, KULeuven)
+ *
+ * Project website: http://www.ster.kuleuven.be/uaf
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "uaf/client/sessions/registerednodecache.h"
+
+namespace uaf
+{
+    using namespace uaf;
+    using std::string;
+
+
+    // Constructor
+    // =============================================================================================
+    RegisteredNodeCache::RegisteredNodeCache()
+    : noOfValidEntries_(0)
+    {}
+
+
+    // Get the hash of a NodeId
+    // =============================================================================================
+    uint64_t RegisteredNodeCache::hash(const OpcUa_NodeId& nodeId)
+    {
+        uint64_t ret = FNV1A_OFFSET_BASIS;
+
+        fnv1aInteger(ret, nodeId.NamespaceIndex);
+        fnv1aInteger(ret, nodeId.IdentifierType);
+
+        switch (nodeId.IdentifierType)
+        {
+            case OpcUa_IdentifierType_Numeric:
+                fnv1aInteger(ret, nodeId.Identifier.Numeric);
+                break;
+            case OpcUa_IdentifierType_String:
+                fnv1a(ret,
+                      OpcUa_String_GetRawString(&nodeId.Identifier.String),
+                      OpcUa_String_StrSize(&nodeId.Identifier.String));
+                break;
+            case OpcUa_IdentifierType_Guid:
+                if (nodeId.Identifier.Guid != OpcUa_Null)
+                    fnv1a(ret, nodeId.Identifier.Guid, sizeof(OpcUa_Guid));
+                break;
+            case OpcUa_IdentifierType_Opaque:
+                if (nodeId.Identifier.ByteString.Length > 0)
+                    fnv1a(ret,
+                          nodeId.Identifier.ByteString.Data,
+                          nodeId.Identifier.ByteString.Length);
+                break;
+        }
+
+        return ret;
+    }
+
+
+    // Find the entry of a NodeId
+    // =============================================================================================
+    RegisteredNodeCache::Entries::iterator RegisteredNodeCache::find(const OpcUa_NodeId& nodeId)
+    {
+        std::pair<Entries::iterator, Entries::iterator> range = entries_.equal_range(hash(nodeId));
+
+        for (Entries::iterator it = range.first; it != range.second; ++it)
+        {
+            if (OpcUa_NodeId_Compare(it->second.nodeId.internalHandle(), &nodeId) == 0)
+                return it;
+        }
+
+        return entries_.end();
+    }
+
+
+    // Find the entry of a NodeId
+    // =============================================================================================
+    RegisteredNodeCache::Entries::const_iterator RegisteredNodeCache::find(
+            const OpcUa_NodeId& nodeId) const
+    {
+        std::pair<Entries::const_iterator, Entries::const_iterator> range
+            = entries_.equal_range(hash(nodeId));
+
+        for (Entries::const_iterator it = range.first; it != range.second; ++it)
+        {
+            if (OpcUa_NodeId_Compare(it->second.nodeId.internalHandle(), &nodeId) == 0)
+                return it;
+        }
+
+        return entries_.end();
+    }
+
+
+    // Add a registered node
+    // =============================================================================================
+    void RegisteredNodeCache::add(
+            const UaNodeId&     nodeId,
+            const string&       namespaceUri,
+            const UaNodeId&     registeredNodeId)
+    {
+        UaMutexLocker locker(&mutex_); // auto-unlocks when out of scope
+
+        Entries::iterator it = find(*nodeId.internalHandle());
+
+        if (it == entries_.end())
+            it = entries_.insert(Entries::value_type(hash(*nodeId.internalHandle()), Entry()));
+
+        Entry& entry = it->second;
+
+        if (!entry.valid)
+            noOfValidEntries_++;
+
+        entry.nodeId           = nodeId;
+        entry.namespaceUri     = namespaceUri;
+        entry.registeredNodeId = registeredNodeId;
+        entry.valid            = true;
+    }
+
+
+    // Remove a registered node
+    // =============================================================================================
+    bool RegisteredNodeCache::remove(const UaNodeId& nodeId, UaNodeId& registeredNodeId)
+    {
+        UaMutexLocker locker(&mutex_); // auto-unlocks when out of scope
+
+        Entries::iterator it = find(*nodeId.internalHandle());
+
+        if (it == entries_.end())
+            return false;
+
+        // if the alias is not valid anymore, the server doesn't know it either
+        if (it->second.valid)
+        {
+            registeredNodeId = it->second.registeredNodeId;
+            noOfValidEntries_--;
+        }
+        else
+        {
+            registeredNodeId = it->second.nodeId;
+        }
+
+        entries_.erase(it);
+        return true;
+    }
+
+
+    // Substitute a NodeId by its alias
+    // =============================================================================================
+    bool RegisteredNodeCache::substitute(OpcUa_NodeId& nodeId) const
+    {
+        UaMutexLocker locker(&mutex_); // auto-unlocks when out of scope
+
+        if (noOfValidEntries_ == 0)
+            return false;
+
+        Entries::const_iterator it = find(nodeId);
+
+        if (it == entries_.end() || !it->second.valid)
+            return false;
+
+        OpcUa_NodeId_Clear(&nodeId);
+        it->second.registeredNodeId.copyTo(&nodeId);
+        return true;
+    }
+
+
+    // Get the registered NodeIds
+    // =============================================================================================
+    void RegisteredNodeCache::registeredNodeIds(UaNodeIdArray& nodeIds) const
+    {
+        UaMutexLocker locker(&mutex_); // auto-unlocks when out of scope
+
+        nodeIds.clear();
+        nodeIds.create(entries_.size());
+
+        OpcUa_UInt32 i = 0;
+        for (Entries::const_iterator it = entries_.begin(); it != entries_.end(); ++it, ++i)
+            it->second.nodeId.copyTo(&nodeIds[i]);
+    }
+
+
+    // Invalidate all aliases
+    // =============================================================================================
+    void RegisteredNodeCache::invalidate()
+    {
+        UaMutexLocker locker(&mutex_); // auto-unlocks when out of scope
+
+        for (Entries::iterator it = entries_.begin(); it != entries_.end(); ++it)
+            it->second.valid = false;
+
+        noOfValidEntries_ = 0;
+    }
+
+
+    // Update the NamespaceIndexes
+    // =============================================================================================
+    size_t RegisteredNodeCache::updateNamespaceIndexes(const NamespaceArray& nameSpaceArray)
+    {
+        UaMutexLocker locker(&mutex_); // auto-unlocks when out of scope
+
+        size_t noOfForgottenEntries = 0;
+
+        // the hashes depend on the NamespaceIndexes, so the entries are stored again
+        Entries updatedEntries;
+
+        for (Entries::iterator it = entries_.begin(); it != entries_.end(); ++it)
+        {
+            Entry& entry = it->second;
+
+            // the NamespaceIndex of a node without a known URI cannot be updated
+            if (!entry.namespaceUri.empty())
+            {
+                NameSpaceIndex nameSpaceIndex;
+
+                if (!nameSpaceArray.findNamespaceIndex(entry.namespaceUri, nameSpaceIndex))
+                {
+                    if (entry.valid)
+                        noOfValidEntries_--;
+                    noOfForgottenEntries++;
+                    continue;
+                }
+
+                entry.nodeId.setNamespaceIndex(nameSpaceIndex);
+            }
+
+            updatedEntries.insert(Entries::value_type(hash(*entry.nodeId.internalHandle()), entry));
+        }
+
+        entries_.swap(updatedEntries);
+
+        return noOfForgottenEntries;
+    }
+
+
+    // Clear the cache
+    // =============================================================================================
+    void RegisteredNodeCache::clear()
+    {
+        UaMutexLocker locker(&mutex_); // auto-unlocks when out of scope
+
+        entries_.clear();
+        noOfValidEntries_ = 0;
+    }
+
+
+    // Get the number of registered nodes
+    // =============================================================================================
+    std::size_t RegisteredNodeCache::size() const
+    {
+        UaMutexLocker locker(&mutex_); // auto-unlocks when out of scope
+        return entries_.size();
+    }
+
+}
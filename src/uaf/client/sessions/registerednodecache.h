@@ -0,0 +1,198 @@
+/* This file is part of the UAF (Unified Architecture Framework) project.
+ *
+ * Copyright (C) 2012 Wim Pessemier (Institute of Astronomy, KULeuven)
+ *
+ * Project website: http://www.ster.kuleuven.be/uaf
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UAF_REGISTEREDNODECACHE_H_
+#define UAF_REGISTEREDNODECACHE_H_
+
+// STD
+#include <string>
+#include <unordered_map>
+#include <stdint.h>
+// SDK
+#include "uabasecpp/uaplatformlayer.h"
+#include "uabasecpp/uanodeid.h"
+#include "uabasecpp/uaarraytemplates.h"
+#include "uabasecpp/uamutex.h"
+// UAF
+#include "uaf/util/util.h"
+#include "uaf/util/hashfunctions.h"
+#include "uaf/util/namespacearray.h"
+#include "uaf/client/clientexport.h"
+
+namespace uaf
+{
+
+    /*******************************************************************************************//**
+    * A RegisteredNodeCache stores the NodeIds that were registered (by the RegisterNodes service)
+    * within a session, together with the alias that the server assigned to each of them.
+    *
+    * The services that are invoked within the session (e.g. Read and Write) use this cache to
+    * replace the NodeIds they address by the (typically numeric, and therefore more efficient)
+    * registered aliases.
+    *
+    * Aliases are only valid within the server session for which they were registered, so they
+    * can be invalidated (in which case the original NodeIds are used again) and updated (when
+    * the nodes are registered again after a reconnection). Since the server may expose a
+    * different NamespaceArray after a reconnection, the namespace URI of each registered node
+    * is stored as well, so that its NamespaceIndex can be updated.
+    *
+    * All methods are thread-safe.
+    *
+    * @ingroup ClientSessions
+    ***********************************************************************************************/
+    class UAF_EXPORT RegisteredNodeCache
+    {
+    public:
+
+
+        /**
+         * Create an empty cache.
+         */
+        RegisteredNodeCache();
+
+
+        /**
+         * Store (or update) the alias of a registered node.
+         *
+         * @param nodeId            The NodeId that was registered.
+         * @param namespaceUri      The namespace URI of the NodeId (may be empty if unknown).
+         * @param registeredNodeId  The alias that the server assigned to it.
+         */
+        void add(
+                const UaNodeId&     nodeId,
+                const std::string&  namespaceUri,
+                const UaNodeId&     registeredNodeId);
+
+
+        /**
+         * Remove a registered node.
+         *
+         * @param nodeId            The NodeId that was registered.
+         * @param registeredNodeId  Output parameter: the alias of the node, which must be used
+         *                          to unregister it at the server side.
+         * @return                  True if the node was registered (and has been removed now),
+         *                          false if not.
+         */
+        bool remove(const UaNodeId& nodeId, UaNodeId& registeredNodeId);
+
+
+        /**
+         * Replace the given NodeId by its registered alias, if it has a valid alias.
+         *
+         * @param nodeId    The NodeId to be replaced (in-place).
+         * @return          True if the NodeId was replaced, false if not.
+         */
+        bool substitute(OpcUa_NodeId& nodeId) const;
+
+
+        /**
+         * Get all NodeIds that have been registered (e.g. to register them again).
+         *
+         * @param nodeIds   Output parameter: the registered NodeIds (not their aliases!).
+         */
+        void registeredNodeIds(UaNodeIdArray& nodeIds) const;
+
+
+        /**
+         * Invalidate all aliases, so that the original NodeIds will be used until the nodes are
+         * registered again.
+         */
+        void invalidate();
+
+
+        /**
+         * Update the NamespaceIndexes of the registered NodeIds, after the NamespaceArray of the
+         * server has changed (e.g. after a reconnection).
+         *
+         * Nodes of which the namespace URI is not exposed by the server anymore are forgotten.
+         *
+         * @param nameSpaceArray    The new NamespaceArray of the server.
+         * @return                  The number of nodes that were forgotten.
+         */
+        std::size_t updateNamespaceIndexes(const uaf::NamespaceArray& nameSpaceArray);
+
+
+        /**
+         * Forget all registered nodes.
+         */
+        void clear();
+
+
+        /**
+         * Get the number of registered nodes.
+         */
+        std::size_t size() const;
+
+
+    private:
+        DISALLOW_COPY_AND_ASSIGN(RegisteredNodeCache);
+
+
+        /**
+         * A registered node.
+         */
+        struct Entry
+        {
+            Entry() : valid(false) {}
+
+            // the NodeId that was registered
+            UaNodeId    nodeId;
+            // the namespace URI of the NodeId (empty if unknown)
+            std::string namespaceUri;
+            // the alias that was assigned by the server
+            UaNodeId    registeredNodeId;
+            // false if the alias is not valid (anymore)
+            bool        valid;
+        };
+
+
+        // the registered nodes, mapped by the hash of their NodeId (different NodeIds may
+        // have the same hash, so the NodeIds must be compared as well)
+        typedef std::unordered_multimap<uint64_t, Entry> Entries;
+        Entries entries_;
+
+
+        /**
+         * Get the hash of a NodeId (computed from its fields, so without creating a copy or a
+         * string representation of it).
+         */
+        static uint64_t hash(const OpcUa_NodeId& nodeId);
+
+
+        /**
+         * Find the entry of a NodeId (not locked!).
+         *
+         * @return  The iterator to the entry, or entries_.end() if the NodeId is not registered.
+         */
+        Entries::iterator find(const OpcUa_NodeId& nodeId);
+        Entries::const_iterator find(const OpcUa_NodeId& nodeId) const;
+
+        // the number of entries with a valid alias, so that substitute() can return quickly
+        // if there's nothing to substitute
+        std::size_t noOfValidEntries_;
+
+        // mutex to protect the entries
+        mutable UaMutex mutex_;
+    };
+
+}
+
+
+#endif /* UAF_REGISTEREDNODECACHE_H_ */
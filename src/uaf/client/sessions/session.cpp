@@ -42,6 +42,7 @@ namespace uaf
             Discoverer*                     discoverer,
             Database*                       database)
     : uaSessionCallback_(uaSessionCallback),
+      serverArrayFingerprint_(0),
       sessionState_(uaf::sessionstates::Disconnected),
       lastConnectionAttemptStep_(connectionsteps::NoAttemptYet),
       clientConnectionId_(clientConnectionId),
@@ -49,7 +50,8 @@ namespace uaf
       sessionSettings_(sessionSettings),
       database_(database),
       clientInterface_(clientInterface),
-      discoverer_(discoverer)
+      discoverer_(discoverer),
+      startedConnectionAttempts_(0)
     {
         // build the logger name:
         stringstream loggerName;
@@ -70,10 +72,10 @@ namespace uaf
         updateConnectionInfo(uaSessionConnectInfo_, clientConnectionId, true);
         updateConnectionInfo(uaSessionConnectInfoNoInitialRetry_, clientConnectionId, false);
 
-        logger_->debug("Session %d to %s has been constructed, now waiting for connection",
-                       clientConnectionId_, serverUri_.c_str());
-        logger_->debug("Session settings:");
-        logger_->debug(sessionSettings.toString());
+        UAF_LOG_DEBUG(logger_, "Session %d to %s has been constructed, now waiting for connection",
+                               clientConnectionId_, serverUri_.c_str());
+        UAF_LOG_DEBUG(logger_, "Session settings:");
+        UAF_LOG_DEBUG(logger_, sessionSettings.toString());
     }
 
 
@@ -129,7 +131,7 @@ namespace uaf
     Status Session::initializePkiStore(UaClientSdk::SessionSecurityInfo& uaSecurity)
     {
         Status ret;
-        logger_->debug("Initializing the PKI store");
+        UAF_LOG_DEBUG(logger_, "Initializing the PKI store");
 
         string certificateRevocationListLocation = \
                 database_->clientSettings.certificateRevocationListLocation;
@@ -167,7 +169,7 @@ namespace uaf
 
         if (ret.isGood())
         {
-            logger_->debug("Now initializing the OpenSSL PKI store via the SDK");
+            UAF_LOG_DEBUG(logger_, "Now initializing the OpenSSL PKI store via the SDK");
             SdkStatus sdkStatus = uaSecurity.initializePkiProviderOpenSSL(
                     UaString(certificateRevocationListLocation.c_str()),
                     UaString(certificateTrustListLocation.c_str()),
@@ -175,13 +177,13 @@ namespace uaf
                     UaString(issuersCertificatesLocation.c_str()));
 
             if (sdkStatus.isGood())
-                logger_->debug("The OpenSSL PKI store was initialized successfully");
+                UAF_LOG_DEBUG(logger_, "The OpenSSL PKI store was initialized successfully");
             else
                 ret = OpenSSLStoreInitializationError(sdkStatus);
         }
 
         if (ret.isGood())
-            logger_->debug("The PKI store has been initialized");
+            UAF_LOG_DEBUG(logger_, "The PKI store has been initialized");
         else
             logger_->error(ret.toString());
 
@@ -193,7 +195,7 @@ namespace uaf
     // =============================================================================================
     Status Session::loadClientCertificate(UaClientSdk::SessionSecurityInfo& uaSecurity)
     {
-        logger_->debug("Loading the client certificate and private key");
+        UAF_LOG_DEBUG(logger_, "Loading the client certificate and private key");
 
         string clientCertificate = database_->clientSettings.clientCertificate;
         string clientPrivateKey = database_->clientSettings.clientPrivateKey;
@@ -207,20 +209,20 @@ namespace uaf
 
         if (ret.isGood())
         {
-            logger_->debug("Now loading the client certificate via the SDK");
+            UAF_LOG_DEBUG(logger_, "Now loading the client certificate via the SDK");
             SdkStatus sdkStatus = uaSecurity.loadClientCertificateOpenSSL(
                     UaString(clientCertificate.c_str()),
                     UaString(clientPrivateKey.c_str()));
 
             if (sdkStatus.isGood())
-                logger_->debug("The client certificate was loaded successfully (%s)",
-                               sdkStatus.toString().c_str());
+                UAF_LOG_DEBUG(logger_, "The client certificate was loaded successfully (%s)",
+                                       sdkStatus.toString().c_str());
             else
                 ret = ClientCertificateLoadingError(sdkStatus);
         }
 
         if (ret.isGood())
-            logger_->debug("The client certificate and private key are loaded");
+            UAF_LOG_DEBUG(logger_, "The client certificate and private key are loaded");
         else
             logger_->error(ret.toString());
 
@@ -254,13 +256,13 @@ namespace uaf
                     const EndpointDescription& endpoint)
     {
         Status ret;
-        logger_->debug("Loading the server certificate from the endpoint");
+        UAF_LOG_DEBUG(logger_, "Loading the server certificate from the endpoint");
 
         if (!endpoint.serverCertificate.isNull())
         {
             endpoint.serverCertificate.toSdk(uaSecurity.serverCertificate);
             ret = statuscodes::Good;
-            logger_->debug("OK the server certificate is now loaded");
+            UAF_LOG_DEBUG(logger_, "OK the server certificate is now loaded");
         }
         else
         {
@@ -279,17 +281,17 @@ namespace uaf
             const uaf::SessionSecuritySettings& securitySettings)
     {
         Status ret;
-        logger_->debug("Setting the user identity");
+        UAF_LOG_DEBUG(logger_, "Setting the user identity");
         if (securitySettings.userTokenType == usertokentypes::Anonymous)
         {
-            logger_->debug("User is not authenticating (anonymous log in)");
+            UAF_LOG_DEBUG(logger_, "User is not authenticating (anonymous log in)");
             uaSecurity.setAnonymousUserIdentity();
             ret = statuscodes::Good;
         }
         else if (securitySettings.userTokenType == usertokentypes::UserName)
         {
-            logger_->debug("User is authenticating with UserName=%s Password=(hidden)",
-                    securitySettings.userName.c_str());
+            UAF_LOG_DEBUG(logger_, "User is authenticating with UserName=%s Password=(hidden)",
+                            securitySettings.userName.c_str());
 
             uaSecurity.setUserPasswordUserIdentity(
                     UaString(securitySettings.userName.c_str()),
@@ -299,7 +301,7 @@ namespace uaf
         }
         else if (securitySettings.userTokenType == usertokentypes::Certificate)
         {
-            logger_->debug("User is authenticating with a certificate:");
+            UAF_LOG_DEBUG(logger_, "User is authenticating with a certificate:");
 
             string certificate = replacePathSeparators(replaceVariables(
                     securitySettings.userCertificateFileName));
@@ -307,8 +309,8 @@ namespace uaf
             string privateKey = replacePathSeparators(replaceVariables(
                     securitySettings.userPrivateKeyFileName));
 
-            logger_->debug(" - User certificate : %s", certificate.c_str());
-            logger_->debug(" - User private key : %s", privateKey.c_str());
+            UAF_LOG_DEBUG(logger_, " - User certificate : %s", certificate.c_str());
+            UAF_LOG_DEBUG(logger_, " - User private key : %s", privateKey.c_str());
 
             UaPkiCertificate uaUserCertificate = UaPkiCertificate::fromDERFile(
                                                         certificate.c_str());
@@ -352,19 +354,19 @@ namespace uaf
     {
         Status ret;
 
-        logger_->debug("Now verifying the server certificate");
+        UAF_LOG_DEBUG(logger_, "Now verifying the server certificate");
 
         SdkStatus trustStatus(uaSecurity.verifyServerCertificate());
 
         if (trustStatus.isGood())
         {
-            logger_->debug("The server certificate is trusted");
+            UAF_LOG_DEBUG(logger_, "The server certificate is trusted");
             ret = statuscodes::Good;
         }
         else
         {
-            logger_->debug("The server certificate is NOT trusted");
-            logger_->debug("Therefore we call the untrustedServerCertificateReceived(...) callback:");
+            UAF_LOG_DEBUG(logger_, "The server certificate is NOT trusted");
+            UAF_LOG_DEBUG(logger_, "Therefore we call the untrustedServerCertificateReceived(...) callback:");
 
             ByteString bs;
             bs.fromSdk(uaSecurity.serverCertificate);
@@ -375,29 +377,29 @@ namespace uaf
 
             if (action == PkiCertificate::Action_Reject)
             {
-                logger_->debug("The server certificate was rejected by the user");
+                UAF_LOG_DEBUG(logger_, "The server certificate was rejected by the user");
                 ret = ServerCertificateRejectedByUserError();
             }
             else if (action == PkiCertificate::Action_AcceptTemporarily)
             {
-                logger_->debug("The server certificate was accepted temporarily by the user");
+                UAF_LOG_DEBUG(logger_, "The server certificate was accepted temporarily by the user");
                 uaSecurity.doServerCertificateVerify = false;
                 ret = statuscodes::Good;
             }
             else if (action == PkiCertificate::Action_AcceptPermanently)
             {
-                logger_->debug("The server certificate was accepted permanently by the user");
-                logger_->debug("We therefore try to store the certificate first");
+                UAF_LOG_DEBUG(logger_, "The server certificate was accepted permanently by the user");
+                UAF_LOG_DEBUG(logger_, "We therefore try to store the certificate first");
                 UaPkiCertificate uaCert = UaPkiCertificate::fromDER(uaSecurity.serverCertificate);
                 UaString uaThumbprint = uaCert.thumbPrint().toHex();
 
-                logger_->debug("Name of the certificate (thumbprint): %s", uaThumbprint.toUtf8());
+                UAF_LOG_DEBUG(logger_, "Name of the certificate (thumbprint): %s", uaThumbprint.toUtf8());
 
                 SdkStatus savingStatus = uaSecurity.saveServerCertificate(uaThumbprint);
 
                 if (savingStatus.isGood())
                 {
-                    logger_->debug("Certificate %s was stored", uaThumbprint.toUtf8());
+                    UAF_LOG_DEBUG(logger_, "Certificate %s was stored", uaThumbprint.toUtf8());
                     ret = statuscodes::Good;
                 }
                 else
@@ -416,8 +418,11 @@ namespace uaf
     // =============================================================================================
     Status Session::connect()
     {
+        // only one connection attempt at a time
+        UaMutexLocker connectionAttemptLocker(&connectionAttemptMutex_);
+
         Status ret;
-        logger_->debug("Connecting the session");
+        UAF_LOG_DEBUG(logger_, "Connecting the session");
 
         // reset the last connection attempt step and status
         lastConnectionAttemptStep_ = connectionsteps::NoAttemptYet;
@@ -439,7 +444,7 @@ namespace uaf
              ++it)
         {
             vector<EndpointDescription> tmp;
-            ret = discoverer_->getEndpoints(*it, tmp);
+            ret = discoverer_->getEndpoints(*it, tmp, true);
 
             if (ret.isGood())
                 discoveredEndpoints.insert(discoveredEndpoints.end(), tmp.begin(), tmp.end());
@@ -461,10 +466,10 @@ namespace uaf
 
         if (ret.isGood())
         {
-            logger_->debug("The following SessionSecuritySettings will be used:");
-            logger_->debug(sessionSettings_.securitySettings.toString());
-            logger_->debug("The following endpoint was found suitable:");
-            logger_->debug(suitableEndpoint.toString());
+            UAF_LOG_DEBUG(logger_, "The following SessionSecuritySettings will be used:");
+            UAF_LOG_DEBUG(logger_, sessionSettings_.securitySettings.toString());
+            UAF_LOG_DEBUG(logger_, "The following endpoint was found suitable:");
+            UAF_LOG_DEBUG(logger_, suitableEndpoint.toString());
         }
 
         // initialize the PKI store so that we can verify the server certificate
@@ -486,7 +491,7 @@ namespace uaf
                 || sessionSettings_.securitySettings.messageSecurityMode == messagesecuritymodes::Mode_SignAndEncrypt)
                 ret = loadClientCertificate(uaSecurity);
             else
-                logger_->debug("Security is not needed so we don't need to initialize the PKI store");
+                UAF_LOG_DEBUG(logger_, "Security is not needed so we don't need to initialize the PKI store");
         }
 
         // try to set the user identity, security policy and message security mode
@@ -501,7 +506,7 @@ namespace uaf
         // if everything is OK, we can try to connect!
         if (ret.isGood())
         {
-            logger_->debug("Now connecting the session at the SDK level");
+            UAF_LOG_DEBUG(logger_, "Now connecting the session at the SDK level");
 
             SdkStatus sdkStatus = uaSession_->connect(
                     suitableEndpoint.endpointUrl.c_str(),
@@ -512,8 +517,8 @@ namespace uaf
             if (sdkStatus.isGood())
             {
                 ret = statuscodes::Good;
-                logger_->debug("The session was connected successfully (SDK status: %s)",
-                               sdkStatus.toString().c_str());
+                UAF_LOG_DEBUG(logger_, "The session was connected successfully (SDK status: %s)",
+                                       sdkStatus.toString().c_str());
             }
             else
             {
@@ -523,10 +528,16 @@ namespace uaf
 
         // log the result
         if (ret.isGood())
-            logger_->debug("The connection was finished (%s)", ret.toString().c_str());
+            UAF_LOG_DEBUG(logger_, "The connection was finished (%s)", ret.toString().c_str());
         else
         {
             logger_->error(ret.toString());
+
+            // the (cached) endpoints may be outdated, so they must be fetched again next time
+            for (vector<string>::const_iterator it = discoveryUrls.begin();
+                 it != discoveryUrls.end();
+                 ++it)
+                discoverer_->invalidateEndpoints(*it);
         }
 
         // update the lastConnectionAttemptStatus_ and lastConnectionAttemptStep_ if they
@@ -537,6 +548,8 @@ namespace uaf
             lastConnectionAttemptStatus_ = ret;
         }
 
+        finishConnectionAttempt();
+
         return ret;
     }
 
@@ -547,14 +560,17 @@ namespace uaf
             const string&           endpointUrl,
             const PkiCertificate&   serverCertificate)
     {
+        // only one connection attempt at a time
+        UaMutexLocker connectionAttemptLocker(&connectionAttemptMutex_);
+
         Status ret;
 
-        logger_->debug("Connecting the session to endpoint %s", endpointUrl.c_str());
+        UAF_LOG_DEBUG(logger_, "Connecting the session to endpoint %s", endpointUrl.c_str());
 
 
         // try to connect to the endpoint URL
-        logger_->debug("Trying to connect with the following security settings:");
-        logger_->debug(sessionSettings_.securitySettings.toString());
+        UAF_LOG_DEBUG(logger_, "Trying to connect with the following security settings:");
+        UAF_LOG_DEBUG(logger_, sessionSettings_.securitySettings.toString());
 
         Status connectionAttemptStatus = statuscodes::Good;
 
@@ -581,7 +597,7 @@ namespace uaf
                 || sessionSettings_.securitySettings.messageSecurityMode == messagesecuritymodes::Mode_SignAndEncrypt)
                 ret = loadClientCertificate(uaSecurity);
             else
-                logger_->debug("Security is not needed so we don't need to initialize the PKI store");
+                UAF_LOG_DEBUG(logger_, "Security is not needed so we don't need to initialize the PKI store");
         }
 
         // try to set the user identity, security policy and message security mode
@@ -596,7 +612,7 @@ namespace uaf
         // if everything is OK, we can try to connect!
         if (connectionAttemptStatus.isGood())
         {
-            logger_->debug("Now connecting the session at the SDK level");
+            UAF_LOG_DEBUG(logger_, "Now connecting the session at the SDK level");
 
             SdkStatus sdkStatus = uaSession_->connect(
                     endpointUrl.c_str(),
@@ -608,8 +624,8 @@ namespace uaf
             if (sdkStatus.isGood())
             {
                 ret = uaf::statuscodes::Good;
-                logger_->debug("The session was connected successfully (SDK status: %s)",
-                               sdkStatus.toString().c_str());
+                UAF_LOG_DEBUG(logger_, "The session was connected successfully (SDK status: %s)",
+                                       sdkStatus.toString().c_str());
             }
             else
             {
@@ -622,17 +638,63 @@ namespace uaf
 
         // log the result
         if (ret.isGood())
-            logger_->debug("The session has been connected successfully");
+            UAF_LOG_DEBUG(logger_, "The session has been connected successfully");
         else
         {
             // add some info
             logger_->error("The session could not be connected: %s", ret.toString().c_str());
         }
 
+        finishConnectionAttempt();
+
         return ret;
     }
 
 
+    // Start a connection attempt
+    // =============================================================================================
+    void Session::startConnectionAttempt()
+    {
+        // keep the mutex locked until the connection attempt has finished
+        connectionAttemptMutex_.lock();
+        startedConnectionAttempts_++;
+
+        UaMutexLocker locker(&sessionMutex_); //auto-unlocks when out of scope
+        sessionState_ = uaf::sessionstates::Connecting;
+    }
+
+
+    // Wait for a connection attempt
+    // =============================================================================================
+    void Session::waitForConnectionAttempt()
+    {
+        connectionAttemptMutex_.lock();
+        connectionAttemptMutex_.unlock();
+    }
+
+
+    // Finish a connection attempt
+    // =============================================================================================
+    void Session::finishConnectionAttempt()
+    {
+        {
+            UaMutexLocker locker(&sessionMutex_); //auto-unlocks when out of scope
+
+            // if the SDK didn't report a new state (e.g. because the connection failed), the
+            // session is still disconnected
+            if (sessionState_ == uaf::sessionstates::Connecting)
+                sessionState_ = uaf::sessionstates::Disconnected;
+        }
+
+        // release the locks taken by startConnectionAttempt()
+        while (startedConnectionAttempts_ > 0)
+        {
+            startedConnectionAttempts_--;
+            connectionAttemptMutex_.unlock();
+        }
+    }
+
+
     // Disconnect the session
     // =============================================================================================
     Status Session::disconnect()
@@ -642,8 +704,8 @@ namespace uaf
         // disconnect the session (and delete the subscriptions)
         if (uaSession_->isConnected())
         {
-            logger_->debug("Now disconnecting %s and thereby deleting all subscriptions",
-                           toString().c_str());
+            UAF_LOG_DEBUG(logger_, "Now disconnecting %s and thereby deleting all subscriptions",
+                                   toString().c_str());
 
             // try to disconnect (and delete subscriptions)
             UaClientSdk::ServiceSettings serviceSettings;
@@ -653,7 +715,7 @@ namespace uaf
             if (uaStatus.isGood())
             {
                 ret = statuscodes::Good;
-                logger_->debug("The session has been disconnected successfully");
+                UAF_LOG_DEBUG(logger_, "The session has been disconnected successfully");
             }
             else
             {
@@ -664,7 +726,7 @@ namespace uaf
         }
         else
         {
-            logger_->debug("The session was already disconnected");
+            UAF_LOG_DEBUG(logger_, "The session was already disconnected");
             ret = statuscodes::Good;
         }
 
@@ -684,8 +746,8 @@ namespace uaf
                 sessionSettings_,
                 lastConnectionAttemptStep_,
                 lastConnectionAttemptStatus_);
-        logger_->debug("Fetching session information:");
-        logger_->debug(info.toString());
+        UAF_LOG_DEBUG(logger_, "Fetching session information:");
+        UAF_LOG_DEBUG(logger_, info.toString());
         return info;
     }
 
@@ -698,11 +760,20 @@ namespace uaf
     }
 
 
+    // Get a copy of the namespace array
+    // =============================================================================================
+    NamespaceArray Session::namespaceArraySnapshot()
+    {
+        UaMutexLocker locker(&sessionMutex_); //auto-unlocks when out of scope
+        return namespaceArray_;
+    }
+
+
     // Update the server array and namespace array
     // =============================================================================================
     Status Session::updateArrays()
     {
-        logger_->debug("Updating the ServerArray and NamespaceArray");
+        UAF_LOG_DEBUG(logger_, "Updating the ServerArray and NamespaceArray");
 
         Status ret;
 
@@ -768,8 +839,8 @@ namespace uaf
                         // In this case serverUri_ is an empty string.
                         if (serverUri_.length() == 0)
                         {
-                            logger_->debug("No serverUri was known for this session,"
-                                           "so we can now update it to %s", thisServerUri.c_str());
+                            UAF_LOG_DEBUG(logger_, "No serverUri was known for this session,"
+                                                   "so we can now update it to %s", thisServerUri.c_str());
                             serverUri_ = thisServerUri;
                         }
                         else
@@ -784,14 +855,14 @@ namespace uaf
                                              "the server URI that was found during the discovery "
                                              "process instead");
                             serverArray_.update(0, serverUri_);
-                            logger_->debug("ServerArray with modified ServerArray[0]:");
+                            UAF_LOG_DEBUG(logger_, "ServerArray with modified ServerArray[0]:");
                         }
                     }
                     else
                     {
-                        logger_->debug("ServerArray:");
+                        UAF_LOG_DEBUG(logger_, "ServerArray:");
                     }
-                    logger_->debug(serverArray_.toString());
+                    UAF_LOG_DEBUG(logger_, serverArray_.toString());
                 }
 
                 // 2) namespace array
@@ -805,8 +876,29 @@ namespace uaf
                 }
                 else
                 {
-                    logger_->debug("NamespaceArray:");
-                    logger_->debug(namespaceArray_.toString());
+                    UAF_LOG_DEBUG(logger_, "NamespaceArray:");
+                    UAF_LOG_DEBUG(logger_, namespaceArray_.toString());
+                }
+
+                // let the address cache know which NamespaceArray the server exposes, so that
+                // any addresses restored from a snapshot can be validated, and any cached
+                // addresses are invalidated if the NamespaceArray has changed
+                if (namespaceArrayStatus.isGood() && !serverUri_.empty())
+                {
+                    database_->addressCache.setNamespaceArrayFingerprint(
+                            serverUri_, namespaceArray_.fingerprint());
+                }
+
+                // the cached addresses may also refer to the ServerArray
+                if (serverArrayStatus.isGood() && !serverUri_.empty())
+                {
+                    uint64_t fingerprint = serverArray_.fingerprint();
+                    if (serverArrayFingerprint_ != 0 && serverArrayFingerprint_ != fingerprint)
+                    {
+                        logger_->info("The ServerArray has changed");
+                        database_->addressCache.invalidate(serverUri_);
+                    }
+                    serverArrayFingerprint_ = fingerprint;
                 }
 
                 // update the return status
@@ -823,6 +915,112 @@ namespace uaf
     }
 
 
+    // Update the operation limits
+    // =============================================================================================
+    Status Session::updateOperationLimits()
+    {
+        UAF_LOG_DEBUG(logger_, "Updating the OperationLimits");
+
+        Status ret;
+
+        // the limits are read into a local copy first, since other threads may be reading them
+        OperationLimits operationLimits;
+
+        // forget the previous limits (the session may have been reconnected to another server)
+        {
+            UaMutexLocker locker(&operationLimitsMutex_); //auto-unlocks when out of scope
+            operationLimits_ = OperationLimits();
+        }
+
+        if (!isConnected())
+        {
+            ret = NoConnectedSessionToUpdateArraysError();
+            logger_->error(ret);
+        }
+        else
+        {
+            UaStatus                        uaReadStatus;
+            UaReadValueIds                  uaReadValueIds;
+            UaDataValues                    uaDataValues;
+            UaDiagnosticInfos               uaDiagnosticInfos;
+            UaClientSdk::ServiceSettings    uaServiceSettings;
+
+            // update the SDK service settings
+            sessionSettings_.readServerInfoSettings.toSdk(uaServiceSettings);
+
+            // the limits to read, and the members to store them
+            const OpcUa_UInt32 limitIds[] = {
+                    OpcUaId_Server_ServerCapabilities_OperationLimits_MaxNodesPerRead,
+                    OpcUaId_Server_ServerCapabilities_OperationLimits_MaxNodesPerWrite,
+                    OpcUaId_Server_ServerCapabilities_OperationLimits_MaxNodesPerMethodCall,
+                    OpcUaId_Server_ServerCapabilities_OperationLimits_MaxMonitoredItemsPerCall };
+            uint32_t* limits[] = {
+                    &operationLimits.maxNodesPerRead,
+                    &operationLimits.maxNodesPerWrite,
+                    &operationLimits.maxNodesPerMethodCall,
+                    &operationLimits.maxMonitoredItemsPerCall };
+            const OpcUa_UInt32 noOfLimits = sizeof(limitIds) / sizeof(limitIds[0]);
+
+            uaReadValueIds.create(noOfLimits);
+            for (OpcUa_UInt32 i = 0; i < noOfLimits; i++)
+            {
+                UaNodeId(limitIds[i]).copyTo(&uaReadValueIds[i].NodeId);
+                uaReadValueIds[i].AttributeId = OpcUa_Attributes_Value;
+            }
+
+            // perform the read action
+            uaReadStatus = uaSession_->read(
+                    uaServiceSettings,                  // service settings
+                    0,                                  // max age in milliseconds
+                    OpcUa_TimestampsToReturn_Neither,   // no time stamps necessary
+                    uaReadValueIds,                     // nodes to read
+                    uaDataValues,                       // result
+                    uaDiagnosticInfos);                 // diagnostics
+
+            if (uaReadStatus.isBad())
+            {
+                ret = ReadInvocationError(uaReadStatus);
+                logger_->warning("Could not read the OperationLimits, so no limits will be applied");
+            }
+            else if (uaDataValues.length() != noOfLimits)
+            {
+                ret = UnexpectedError("Number of OperationLimits does not match number of results");
+                logger_->error(ret);
+            }
+            else
+            {
+                // the optional limits that are not exposed by the server keep the value 0
+                for (OpcUa_UInt32 i = 0; i < noOfLimits; i++)
+                {
+                    OpcUa_UInt32 limit;
+                    if (   OpcUa_IsGood(uaDataValues[i].StatusCode)
+                        && OpcUa_IsGood(UaVariant(uaDataValues[i].Value).toUInt32(limit)))
+                        *limits[i] = limit;
+                }
+
+                UAF_LOG_DEBUG(logger_, "OperationLimits:");
+                UAF_LOG_DEBUG(logger_, operationLimits.toString());
+
+                UaMutexLocker locker(&operationLimitsMutex_); //auto-unlocks when out of scope
+                operationLimits_ = operationLimits;
+
+                ret = uaf::statuscodes::Good;
+            }
+        }
+
+        return ret;
+    }
+
+
+    // Get the operation limits
+    // =============================================================================================
+    OperationLimits Session::operationLimits() const
+    {
+        UaMutexLocker locker(&operationLimitsMutex_); //auto-unlocks when out of scope
+        return operationLimits_;
+    }
+
+
     // Get a compact string representation
     // =============================================================================================
     string Session::toString() const
@@ -900,9 +1098,9 @@ namespace uaf
     void Session::setSessionState(uaf::sessionstates::SessionState sessionState)
     {
         // acquire the session lock
-        UaMutexLocker locker(&sessionMutex_); //auto-unlocks when out of scope
+        sessionMutex_.lock();
 
-        logger_->debug(
+        UAF_LOG_DEBUG(logger_,
                 "The session has changed its state from %s to %s",
                 uaf::sessionstates::toString(sessionState_).c_str(),
                 uaf::sessionstates::toString(sessionState).c_str());
@@ -910,18 +1108,36 @@ namespace uaf
         // update the session state member
         sessionState_ = sessionState;
 
-        // if the session became connected, update the arrays
+        // if the session became connected, update the arrays and the operation limits
         if (sessionState == uaf::sessionstates::Connected)
+        {
             updateArrays();
-        // if the session has difficulties, we remove all references to this serverUri from
+            updateOperationLimits();
+        }
+        // if the session has difficulties, we invalidate all references to this serverUri in
         // the address resolution cache (because maybe the node resolution is not valid anymore)
         else if (   (sessionState == uaf::sessionstates::ConnectionErrorApiReconnect)
                  || (sessionState == uaf::sessionstates::ConnectionWarningWatchdogTimeout)
                  || (sessionState == uaf::sessionstates::Disconnected)
                  || (sessionState == uaf::sessionstates::ServerShutdown))
-            database_->addressCache.clear(serverUri_);
+            database_->addressCache.invalidate(serverUri_);
+
+        // the aliases of the registered nodes cannot be trusted until they are registered again
+        if (   (sessionState == uaf::sessionstates::ConnectionErrorApiReconnect)
+            || (sessionState == uaf::sessionstates::Disconnected)
+            || (sessionState == uaf::sessionstates::ServerShutdown)
+            || (sessionState == uaf::sessionstates::NewSessionCreated))
+            registeredNodes_.invalidate();
+
+        sessionMutex_.unlock();
+
+        // register the nodes again, since the aliases are only valid within a server session
+        // (without holding the session lock during the round trip to the server)
+        if (sessionState == uaf::sessionstates::Connected)
+            reregisterNodes();
 
         // call the callback interface
+        UaMutexLocker locker(&sessionMutex_); //auto-unlocks when out of scope
         clientInterface_->connectionStatusChanged(sessionInformation());
     }
 
@@ -994,6 +1210,263 @@ namespace uaf
     }
 
 
+    // Register nodes
+    // =============================================================================================
+    Status Session::registerNodes(
+            const vector<ExpandedNodeId>&   nodeIds,
+            const ServiceSettings*          serviceSettings,
+            vector<Status>&                 results)
+    {
+        UAF_LOG_DEBUG(logger_, "Registering %d nodes", int(nodeIds.size()));
+
+        // make sure the nodes are not being registered again meanwhile (the sessionMutex_ is
+        // not locked, since this lock is held during the round trip to the server)
+        UaMutexLocker locker(&registerNodesMutex_); //auto-unlocks when out of scope
+
+        Status ret;
+
+        results.resize(nodeIds.size());
+
+        if (!isConnected())
+        {
+            ret = SessionNotConnectedError();
+            logger_->error(ret);
+        }
+        else
+        {
+            UaNodeIdArray                   uaNodeIds;
+            UaNodeIdArray                   uaRegisteredNodeIds;
+            UaClientSdk::ServiceSettings    uaServiceSettings;
+            vector<size_t>                  indexes; // indexes of the nodes that are sent
+
+            // convert the nodes and map them back with the same NamespaceArray
+            NamespaceArray namespaceArray = namespaceArraySnapshot();
+
+            // update the SDK service settings
+            if (serviceSettings == NULL)
+                ServiceSettings().toSdk(uaServiceSettings);
+            else
+                serviceSettings->toSdk(uaServiceSettings);
+
+            // convert the nodes to SDK NodeIds
+            uaNodeIds.create(nodeIds.size());
+            for (size_t i = 0; i < nodeIds.size(); i++)
+            {
+                results[i] = namespaceArray.fillOpcUaNodeId(nodeIds[i].nodeId(),
+                                                            uaNodeIds[indexes.size()]);
+                if (results[i].isGood())
+                    indexes.push_back(i);
+                else
+                    OpcUa_NodeId_Clear(&uaNodeIds[indexes.size()]);
+            }
+            uaNodeIds.resize(indexes.size());
+
+            if (indexes.empty())
+            {
+                ret = statuscodes::Good;
+            }
+            else
+            {
+                UaStatus uaStatus = uaSession_->registerNodes(
+                        uaServiceSettings,
+                        uaNodeIds,
+                        uaRegisteredNodeIds);
+
+                if (uaStatus.isBad())
+                    ret = RegisterNodesInvocationError(uaStatus);
+                else if (uaRegisteredNodeIds.length() != uaNodeIds.length())
+                    ret = UnexpectedError("Number of registered nodes does not match number "
+                                          "of nodes to register");
+                else
+                    ret = statuscodes::Good;
+
+                for (size_t j = 0; j < indexes.size(); j++)
+                {
+                    if (ret.isGood())
+                    {
+                        string namespaceUri;
+                        namespaceArray.findNamespaceUri(uaNodeIds[j].NamespaceIndex, namespaceUri);
+                        registeredNodes_.add(UaNodeId(uaNodeIds[j]),
+                                             namespaceUri,
+                                             UaNodeId(uaRegisteredNodeIds[j]));
+                    }
+                    results[indexes[j]] = ret;
+                }
+
+                if (ret.isNotGood())
+                    logger_->error(ret);
+            }
+        }
+
+        return ret;
+    }
+
+
+    // Unregister nodes
+    // =============================================================================================
+    Status Session::unregisterNodes(
+            const vector<ExpandedNodeId>&   nodeIds,
+            const ServiceSettings*          serviceSettings,
+            vector<Status>&                 results)
+    {
+        UAF_LOG_DEBUG(logger_, "Unregistering %d nodes", int(nodeIds.size()));
+
+        // make sure the nodes are not being registered again meanwhile
+        UaMutexLocker locker(&registerNodesMutex_); //auto-unlocks when out of scope
+
+        Status ret;
+
+        UaNodeIdArray                   uaRegisteredNodeIds;
+        UaClientSdk::ServiceSettings    uaServiceSettings;
+        vector<size_t>                  indexes; // indexes of the nodes that are sent
+        NamespaceArray                  namespaceArray = namespaceArraySnapshot();
+
+        results.resize(nodeIds.size());
+
+        // remove the nodes from the cache first: even if the service call fails, the
+        // services should not use the aliases anymore
+        uaRegisteredNodeIds.create(nodeIds.size());
+        for (size_t i = 0; i < nodeIds.size(); i++)
+        {
+            OpcUa_NodeId opcUaNodeId;
+            OpcUa_NodeId_Initialize(&opcUaNodeId);
+
+            UaNodeId registeredNodeId;
+
+            results[i] = namespaceArray.fillOpcUaNodeId(nodeIds[i].nodeId(), opcUaNodeId);
+
+            if (results[i].isGood())
+            {
+                if (registeredNodes_.remove(UaNodeId(opcUaNodeId), registeredNodeId))
+                {
+                    registeredNodeId.copyTo(&uaRegisteredNodeIds[indexes.size()]);
+                    indexes.push_back(i);
+                }
+                else
+                {
+                    results[i] = UnexpectedError(uaf::format("Node %s was not registered",
+                                                             nodeIds[i].toString().c_str()));
+                }
+            }
+
+            OpcUa_NodeId_Clear(&opcUaNodeId);
+        }
+        uaRegisteredNodeIds.resize(indexes.size());
+
+        if (indexes.empty())
+        {
+            ret = statuscodes::Good;
+        }
+        else if (!isConnected())
+        {
+            // the server will forget the aliases anyway when the session is closed
+            UAF_LOG_DEBUG(logger_, "The session is not connected, so the nodes are only forgotten");
+            ret = statuscodes::Good;
+        }
+        else
+        {
+            // update the SDK service settings
+            if (serviceSettings == NULL)
+                ServiceSettings().toSdk(uaServiceSettings);
+            else
+                serviceSettings->toSdk(uaServiceSettings);
+
+            UaStatus uaStatus = uaSession_->unregisterNodes(uaServiceSettings, uaRegisteredNodeIds);
+
+            if (uaStatus.isBad())
+            {
+                ret = UnregisterNodesInvocationError(uaStatus);
+                logger_->error(ret);
+            }
+            else
+            {
+                ret = statuscodes::Good;
+            }
+        }
+
+        for (size_t j = 0; j < indexes.size(); j++)
+            results[indexes[j]] = ret;
+
+        return ret;
+    }
+
+
+    // Register the nodes again
+    // =============================================================================================
+    Status Session::reregisterNodes()
+    {
+        // make sure the nodes are not being (un)registered by the user meanwhile
+        UaMutexLocker locker(&registerNodesMutex_); //auto-unlocks when out of scope
+
+        Status ret;
+
+        // the server may expose a different NamespaceArray than before the reconnection
+        // (the nodes are mapped back with the same NamespaceArray as they are updated with)
+        NamespaceArray namespaceArray = namespaceArraySnapshot();
+        size_t noOfForgottenNodes = registeredNodes_.updateNamespaceIndexes(namespaceArray);
+        if (noOfForgottenNodes > 0)
+            logger_->warning("%d registered nodes are forgotten, since their namespace is not "
+                             "exposed by the server anymore", int(noOfForgottenNodes));
+
+        UaNodeIdArray uaNodeIds;
+        registeredNodes_.registeredNodeIds(uaNodeIds);
+
+        if (uaNodeIds.length() == 0)
+        {
+            ret = statuscodes::Good;
+        }
+        else if (!isConnected())
+        {
+            ret = SessionNotConnectedError();
+            logger_->error(ret);
+        }
+        else
+        {
+            UAF_LOG_DEBUG(logger_, "Registering %d nodes again", int(uaNodeIds.length()));
+
+            UaNodeIdArray                   uaRegisteredNodeIds;
+            UaClientSdk::ServiceSettings    uaServiceSettings;
+
+            // the nodes are registered in the background, like the server info is read
+            sessionSettings_.readServerInfoSettings.toSdk(uaServiceSettings);
+
+            UaStatus uaStatus = uaSession_->registerNodes(
+                    uaServiceSettings,
+                    uaNodeIds,
+                    uaRegisteredNodeIds);
+
+            if (uaStatus.isBad())
+            {
+                ret = RegisterNodesInvocationError(uaStatus);
+            }
+            else if (uaRegisteredNodeIds.length() != uaNodeIds.length())
+            {
+                ret = UnexpectedError("Number of registered nodes does not match number "
+                                      "of nodes to register");
+            }
+            else
+            {
+                for (OpcUa_UInt32 i = 0; i < uaNodeIds.length(); i++)
+                {
+                    string namespaceUri;
+                    namespaceArray.findNamespaceUri(uaNodeIds[i].NamespaceIndex, namespaceUri);
+                    registeredNodes_.add(UaNodeId(uaNodeIds[i]),
+                                         namespaceUri,
+                                         UaNodeId(uaRegisteredNodeIds[i]));
+                }
+                ret = statuscodes::Good;
+            }
+
+            // the original NodeIds will be used as long as the aliases are invalid
+            if (ret.isNotGood())
+                logger_->warning("Could not register the nodes again, so their original NodeIds "
+                                 "will be used");
+        }
+
+        return ret;
+    }
+
+
     // Set the publishing mode.
     // =============================================================================================
     Status Session::checkOrCreatePath(
@@ -1001,12 +1474,12 @@ namespace uaf
     {
         Status ret;
 
-        logger_->debug("Checking %s: %s", description.c_str(), path.c_str());
+        UAF_LOG_DEBUG(logger_, "Checking %s: %s", description.c_str(), path.c_str());
         UaDir helperDir(UaUniString(""));
         if (helperDir.exists(UaUniString(path.c_str())))
         {
             ret = statuscodes::Good;
-            logger_->debug("OK, the %s exists", description.c_str());
+            UAF_LOG_DEBUG(logger_, "OK, the %s exists", description.c_str());
         }
         else
         {
@@ -1017,11 +1490,11 @@ namespace uaf
             }
             else
             {
-                logger_->debug("The path does not exist so we try to create it");
+                UAF_LOG_DEBUG(logger_, "The path does not exist so we try to create it");
                 if (helperDir.mkpath(UaUniString(path.c_str())))
                 {
                     ret = statuscodes::Good;
-                    logger_->debug("The %s has been created", path.c_str());
+                    UAF_LOG_DEBUG(logger_, "The %s has been created", path.c_str());
                 }
                 else
                 {
@@ -44,6 +44,8 @@
 #include "uaf/client/clientexport.h"
 #include "uaf/client/sessions/sessionstates.h"
 #include "uaf/client/sessions/sessioninformation.h"
+#include "uaf/client/sessions/operationlimits.h"
+#include "uaf/client/sessions/registerednodecache.h"
 #include "uaf/client/settings/sessionsettings.h"
 #include "uaf/client/subscriptions/subscriptionfactory.h"
 #include "uaf/client/discovery/discoverer.h"
@@ -127,6 +129,26 @@ namespace uaf
         uaf::Status disconnect();
 
 
+        /**
+         * Announce that the calling thread is going to connect the session.
+         *
+         * The state of the session becomes Connecting, and other threads that call
+         * waitForConnectionAttempt() will block until the next connect() or
+         * connectToSpecificEndpoint() of the calling thread has finished.
+         *
+         * This allows to share the session (e.g. by storing it in a map) before it is connected.
+         */
+        void startConnectionAttempt();
+
+
+        /**
+         * Wait until an ongoing connection attempt of another thread has finished.
+         *
+         * Returns immediately if the session is not being connected.
+         */
+        void waitForConnectionAttempt();
+
+
         ///@} //////////////////////////////////////////////////////////////////////////////////////
         /**
          *  @name SessionInfo
@@ -171,6 +193,11 @@ namespace uaf
          */
         uaf::sessionstates::SessionState sessionState()    const { return sessionState_; };
 
+        /**
+         * Get the operation limits of the server (as read when the session was connected).
+         */
+        uaf::OperationLimits operationLimits() const;
+
 
         ///@} //////////////////////////////////////////////////////////////////////////////////////
         /**
@@ -283,6 +310,47 @@ namespace uaf
 				 uaf::StructureDefinition& 	definition);
 
 
+        ///@} //////////////////////////////////////////////////////////////////////////////////////
+        /**
+         *  @name RegisteredNodes
+         *  Register and unregister nodes.
+         */
+        ///@{
+
+
+        /**
+         * Register nodes (by the RegisterNodes service), so that all subsequent services of
+         * this session (such as Read and Write) automatically use the more efficient aliases
+         * that the server assigned to them.
+         *
+         * The nodes are registered again automatically if the session is reconnected.
+         *
+         * @param nodeIds           The nodes to register (all hosted by the server of this
+         *                          session).
+         * @param serviceSettings   The service settings to be used (NULL for the default ones).
+         * @param results           Output parameter: a status for each node.
+         * @return                  The immediate result of the service call.
+         */
+        uaf::Status registerNodes(
+                const std::vector<uaf::ExpandedNodeId>& nodeIds,
+                const uaf::ServiceSettings*             serviceSettings,
+                std::vector<uaf::Status>&               results);
+
+
+        /**
+         * Unregister nodes that were registered before by registerNodes().
+         *
+         * @param nodeIds           The nodes to unregister.
+         * @param serviceSettings   The service settings to be used (NULL for the default ones).
+         * @param results           Output parameter: a status for each node.
+         * @return                  The immediate result of the service call.
+         */
+        uaf::Status unregisterNodes(
+                const std::vector<uaf::ExpandedNodeId>& nodeIds,
+                const uaf::ServiceSettings*             serviceSettings,
+                std::vector<uaf::Status>&               results);
+
+
 
         ///@} //////////////////////////////////////////////////////////////////////////////////////
         /**
@@ -304,6 +372,8 @@ namespace uaf
                                                _Service::asynchronous>& request,
                 typename _Service::Invocation& invocation)
         {
+            invocation.setOperationLimits(operationLimits());
+            invocation.setRegisteredNodes(&registeredNodes_);
             return invocation.invoke(uaSession_, namespaceArray_, serverArray_, logger_);
         }
 
@@ -322,6 +392,7 @@ namespace uaf
                                                     _Service::asynchronous>& request,
                 typename _Service::Invocation& invocation)
         {
+            invocation.setOperationLimits(operationLimits());
             return subscriptionFactory_->invokeService<_Service>(
                     invocation,
                     request,
@@ -381,6 +452,48 @@ namespace uaf
         uaf::Status updateArrays();
 
 
+        /**
+         * Get a copy of the current NamespaceArray (locks the sessionMutex_).
+         *
+         * The copy shares the contents of the NamespaceArray, so it is cheap, and it is not
+         * affected when updateArrays() is called meanwhile (e.g. after a reconnection).
+         *
+         * @return  A copy of the NamespaceArray.
+         */
+        uaf::NamespaceArray namespaceArraySnapshot();
+
+
+        /**
+         * Update the OperationLimits of the server (not locked!).
+         *
+         * Limits that cannot be read (e.g. because the server doesn't expose them) are set to 0,
+         * meaning "no limit".
+         *
+         * @return  Good if the limits could be read, false if not.
+         */
+        uaf::Status updateOperationLimits();
+
+
+        /**
+         * Register all nodes of the registeredNodes_ cache again (locks the registerNodesMutex_,
+         * but not the sessionMutex_).
+         *
+         * The NamespaceIndexes of the nodes are updated first, in case the server exposes a
+         * different NamespaceArray now. Nodes that cannot be registered are addressed by their
+         * original NodeId.
+         *
+         * @return  Good if the nodes could be registered, false if not.
+         */
+        uaf::Status reregisterNodes();
+
+
+        /**
+         * Finish a connection attempt (to be called at the end of connect() and
+         * connectToSpecificEndpoint(), while the connectionAttemptMutex_ is locked).
+         */
+        void finishConnectionAttempt();
+
+
         /**
          * Update the connection info.
          */
@@ -441,6 +554,17 @@ namespace uaf
         uaf::ServerArray                    serverArray_;
         uaf::NamespaceArray                 namespaceArray_;
 
+        // the fingerprint of the ServerArray when it was last read (0 if never read)
+        uint64_t                            serverArrayFingerprint_;
+
+        // the operation limits of the server, and the mutex to protect them (they are updated
+        // by the connecting thread while other threads may be invoking services)
+        uaf::OperationLimits                operationLimits_;
+        mutable UaMutex                     operationLimitsMutex_;
+
+        // the nodes that were registered within this session
+        uaf::RegisteredNodeCache            registeredNodes_;
+
         // the current session state:
         uaf::sessionstates::SessionState   sessionState_;
 
@@ -464,6 +588,13 @@ namespace uaf
         UaClientSdk::SessionConnectInfo     uaSessionConnectInfoNoInitialRetry_;
         // mutex for critical sections
         UaMutex                             sessionMutex_;
+        // mutex that serializes the registration of nodes (which involves a round trip to the
+        // server, so the sessionMutex_ is not held meanwhile)
+        UaMutex                             registerNodesMutex_;
+        // mutex that is locked as long as a connection attempt is ongoing, and the number of
+        // times it was locked by startConnectionAttempt() (only accessed while holding the mutex)
+        UaMutex                             connectionAttemptMutex_;
+        uint32_t                            startedConnectionAttempts_;
         // the RequesterInterface to call when asynchronous messages are received
         uaf::ClientInterface*              clientInterface_;
         // the Discoverer to use
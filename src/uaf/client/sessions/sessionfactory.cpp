@@ -43,7 +43,7 @@ namespace uaf
 
         transactionId_ = 0;
 
-        logger_->debug("The SessionFactory has been constructed");
+        UAF_LOG_DEBUG(logger_, "The SessionFactory has been constructed");
     }
 
 
@@ -51,10 +51,12 @@ namespace uaf
     // =============================================================================================
     SessionFactory::~SessionFactory()
     {
-        logger_->debug("Destructing the SessionFactory");
+        UAF_LOG_DEBUG(logger_, "Destructing the SessionFactory");
 
         deleteAllSessions();
 
+        invocationPool_.reset();
+
         delete logger_;
         logger_ = 0;
 
@@ -65,7 +67,7 @@ namespace uaf
     // =============================================================================================
     void SessionFactory::deleteAllSessions()
     {
-        logger_->debug("Deleting all sessions and their subscriptions and monitored items");
+        UAF_LOG_DEBUG(logger_, "Deleting all sessions and their subscriptions and monitored items");
 
         // lock the mutex to make sure the sessionMap is not being manipulated
         UaMutexLocker sessionMapLocker(&sessionMapMutex_);
@@ -76,20 +78,22 @@ namespace uaf
         SessionMap::iterator iter;
         for (iter = sessionMap_.begin(); iter != sessionMap_.end() ; ++iter)
         {
-            logger_->debug("Now deleting session %d - %s",
-                            iter->second->clientConnectionId(),
-                            iter->second->serverUri().c_str());
+            UAF_LOG_DEBUG(logger_, "Now deleting session %d - %s",
+                                    iter->second->clientConnectionId(),
+                                    iter->second->serverUri().c_str());
 
             delete iter->second;
             iter->second = 0;
 
-            logger_->debug("The session has been deleted");
+            UAF_LOG_DEBUG(logger_, "The session has been deleted");
         }
 
         sessionMap_.clear();
+        sessionIndex_.clear();
+        unindexedSessions_.clear();
         activityMap_.clear();
 
-        logger_->debug("All sessions have been deleted");
+        UAF_LOG_DEBUG(logger_, "All sessions have been deleted");
     }
 
 
@@ -108,19 +112,9 @@ namespace uaf
         SessionSettings settings;
 
         if (settingsPtr == NULL)
-        {
-            std::map<std::string, uaf::SessionSettings>::const_iterator it;
-            it = database_->clientSettings.specificSessionSettings.find(serverUri);
-
-            if (it != database_->clientSettings.specificSessionSettings.end())
-                settings = it->second;
-            else
-                settings = database_->clientSettings.defaultSessionSettings;
-        }
+            settings = configuredSessionSettings(serverUri);
         else
-        {
             settings = *settingsPtr;
-        }
 
         ret = acquireSession(serverUri, settings, session);
 
@@ -137,7 +131,7 @@ namespace uaf
             activityMap_[clientConnectionId] = activity + 1;
             activityMapMutex_.unlock();
 
-            logger_->debug("#activities has been incremented to %d", activity+1);
+            UAF_LOG_DEBUG(logger_, "#activities has been incremented to %d", activity+1);
 
             ret = releaseSession(session);
         }
@@ -162,7 +156,7 @@ namespace uaf
     {
         Status ret;
 
-        logger_->debug("Manually connecting to endpoint %s", endpointUrl.c_str());
+        UAF_LOG_DEBUG(logger_, "Manually connecting to endpoint %s", endpointUrl.c_str());
 
         SessionSettings settings;
         if (settingsPtr == NULL)
@@ -174,27 +168,41 @@ namespace uaf
             settings = *settingsPtr;
         }
 
-        // lock the mutex to make sure the sessionMap_ is not being manipulated
-        UaMutexLocker locker(&sessionMapMutex_);
+        Session* session = 0;
+
+        {
+            // lock the mutex to make sure the sessionMap_ is not being manipulated
+            UaMutexLocker locker(&sessionMapMutex_);
+
+            clientConnectionId = database_->createUniqueClientConnectionId();
+            UAF_LOG_DEBUG(logger_, "ClientConnectionId %d was assigned to the session", clientConnectionId);
 
-        clientConnectionId = database_->createUniqueClientConnectionId();
-        logger_->debug("ClientConnectionId %d was assigned to the session", clientConnectionId);
+            // create a new session instance
+            session = new Session(
+                    logger_->loggerFactory(),
+                    settings,
+                    string(), // empty string as we don't know the serverUri at this point yet!
+                    clientConnectionId,
+                    this,
+                    clientInterface_,
+                    discoverer_,
+                    database_);
 
-        // create a new session instance
-        Session* session = new Session(
-                logger_->loggerFactory(),
-                settings,
-                string(), // empty string as we don't know the serverUri at this point yet!
-                clientConnectionId,
-                this,
-                clientInterface_,
-                discoverer_,
-                database_);
+            // other threads that acquire the session will have to wait until we've tried
+            // to connect it
+            session->startConnectionAttempt();
 
-        // store the new session instance in the sessionMap
-        sessionMap_[clientConnectionId] = session;
+            // store the new session instance in the sessionMap
+            addSession(session);
 
-        // connect to the session to the specific endpoint
+            // create an activity count for the session
+            activityMapMutex_.lock();
+            activityMap_[clientConnectionId] = 1;
+            activityMapMutex_.unlock();
+        }
+
+        // connect to the session to the specific endpoint (without holding the lock of the
+        // sessionMap_)
         if (serverCertificatePtr != NULL)
             ret = session->connectToSpecificEndpoint(endpointUrl, *serverCertificatePtr);
         else
@@ -203,18 +211,16 @@ namespace uaf
         // add some diagnostics
         if (ret.isGood())
         {
-            // create an activity count for the session
             activityMapMutex_.lock();
-            activityMap_[clientConnectionId] = 1;
-            logger_->debug("The requested session is created (#activities: %d)",
-                           activityMap_[clientConnectionId]);
+            UAF_LOG_DEBUG(logger_, "The requested session is created (#activities: %d)",
+                                   activityMap_[clientConnectionId]);
             activityMapMutex_.unlock();
         }
         else
         {
-            delete session;
-            session = 0;
-            sessionMap_.erase(clientConnectionId);
+            // release the session, so that it is deleted (unless another thread is still
+            // using it, in which case that thread will delete it when releasing it)
+            releaseSession(session);
             logger_->error("The requested session could not be created");
         }
 
@@ -243,7 +249,7 @@ namespace uaf
             activityMap_[clientConnectionId] = activity - 1;
             activityMapMutex_.unlock();
 
-            logger_->debug("#activities has been decremented to %d", activity-1);
+            UAF_LOG_DEBUG(logger_, "#activities has been decremented to %d", activity-1);
 
             ret = session->disconnect();
             releaseSession(session);
@@ -255,38 +261,44 @@ namespace uaf
 
 
 
-    // Manually disconnect a session
+    // Do the housekeeping of all sessions
     // =============================================================================================
     void SessionFactory::doHouseKeeping()
     {
         vector<SessionInformation> infos = allSessionInformations();
 
-        Session* session = 0;
-        Status acquisitionStatus;
-        bool tryToReconnect;
         for (vector<SessionInformation>::const_iterator it = infos.begin();
                 it != infos.end();
                 ++it)
         {
-            acquisitionStatus = acquireExistingSession(it->clientConnectionId, session);
+            doHouseKeeping(it->clientConnectionId);
+        }
 
-            if (acquisitionStatus.isGood())
-            {
-                if (session->sessionState() == uaf::sessionstates::Disconnected)
-                {
-                    // if other activities are going on besides the house keeping,
-                    // then try to reconnect the session
-                    activityMapMutex_.lock();
-                    tryToReconnect = (activityMap_[it->clientConnectionId] > 1);
-                    activityMapMutex_.unlock();
+    }
 
-                    if (tryToReconnect)
-                        session->connect();
-                }
-                releaseSession(session);
+
+    // Do the housekeeping of a single session
+    // =============================================================================================
+    void SessionFactory::doHouseKeeping(ClientConnectionId clientConnectionId)
+    {
+        Session* session = 0;
+        Status acquisitionStatus = acquireExistingSession(clientConnectionId, session);
+
+        if (acquisitionStatus.isGood())
+        {
+            if (session->sessionState() == uaf::sessionstates::Disconnected)
+            {
+                // if other activities are going on besides the house keeping,
+                // then try to reconnect the session
+                activityMapMutex_.lock();
+                bool tryToReconnect = (activityMap_[clientConnectionId] > 1);
+                activityMapMutex_.unlock();
+
+                if (tryToReconnect)
+                    session->connect();
             }
+            releaseSession(session);
         }
-
     }
 
 
@@ -419,7 +431,7 @@ namespace uaf
     // =============================================================================================
     vector<SessionInformation> SessionFactory::allSessionInformations()
     {
-        logger_->debug("Getting the session information for all sessions");
+        UAF_LOG_DEBUG(logger_, "Getting the session information for all sessions");
 
         vector<SessionInformation> ret;
 
@@ -440,7 +452,7 @@ namespace uaf
     // =============================================================================================
     vector<SubscriptionInformation> SessionFactory::allSubscriptionInformations()
     {
-        logger_->debug("Getting the subscription information for all sessions");
+        UAF_LOG_DEBUG(logger_, "Getting the subscription information for all sessions");
 
         vector<SubscriptionInformation> ret;
 
@@ -545,6 +557,115 @@ namespace uaf
 
 
 
+    // Register nodes
+    // =============================================================================================
+    Status SessionFactory::registerNodes(
+            const vector<ExpandedNodeId>&   nodeIds,
+            const ServiceSettings*          serviceSettings,
+            vector<Status>&                 results)
+    {
+        return changeNodeRegistrations(true, nodeIds, serviceSettings, results);
+    }
+
+
+    // Unregister nodes
+    // =============================================================================================
+    Status SessionFactory::unregisterNodes(
+            const vector<ExpandedNodeId>&   nodeIds,
+            const ServiceSettings*          serviceSettings,
+            vector<Status>&                 results)
+    {
+        return changeNodeRegistrations(false, nodeIds, serviceSettings, results);
+    }
+
+
+    // Register or unregister nodes
+    // =============================================================================================
+    Status SessionFactory::changeNodeRegistrations(
+            bool                            registering,
+            const vector<ExpandedNodeId>&   nodeIds,
+            const ServiceSettings*          serviceSettings,
+            vector<Status>&                 results)
+    {
+        Status ret(statuscodes::Good);
+
+        results.resize(nodeIds.size());
+
+        // group the nodes per server
+        typedef map<string, vector<std::size_t> > IndexMap;
+        IndexMap indexMap;
+        for (std::size_t i = 0; i < nodeIds.size(); i++)
+        {
+            if (nodeIds[i].hasServerUri())
+                indexMap[nodeIds[i].serverUri()].push_back(i);
+            else
+                results[i] = EmptyServerUriError();
+        }
+
+        // process the nodes of each server within the session that is configured for that
+        // server, since this is the session in which the Read and Write services are invoked
+        for (IndexMap::const_iterator it = indexMap.begin(); it != indexMap.end(); ++it)
+        {
+            const vector<std::size_t>& indexes = it->second;
+            Status serverStatus;
+            Session* session = 0;
+
+            serverStatus = acquireSession(it->first, configuredSessionSettings(it->first), session);
+
+            if (serverStatus.isGood())
+            {
+                vector<ExpandedNodeId> serverNodeIds;
+                vector<Status>         serverResults;
+
+                serverNodeIds.reserve(indexes.size());
+                for (std::size_t j = 0; j < indexes.size(); j++)
+                    serverNodeIds.push_back(nodeIds[indexes[j]]);
+
+                if (registering)
+                    serverStatus = session->registerNodes(serverNodeIds, serviceSettings, serverResults);
+                else
+                    serverStatus = session->unregisterNodes(serverNodeIds, serviceSettings, serverResults);
+
+                for (std::size_t j = 0; j < indexes.size() && j < serverResults.size(); j++)
+                    results[indexes[j]] = serverResults[j];
+
+                releaseSession(session);
+            }
+            else
+            {
+                for (std::size_t j = 0; j < indexes.size(); j++)
+                    results[indexes[j]] = serverStatus;
+            }
+
+            if (ret.isGood() && serverStatus.isNotGood())
+                ret = serverStatus;
+        }
+
+        // also report the nodes without server URI
+        for (std::size_t i = 0; i < results.size() && ret.isGood(); i++)
+        {
+            if (results[i].isNotGood())
+                ret = results[i];
+        }
+
+        return ret;
+    }
+
+
+    // Get the configured session settings of a server
+    // =============================================================================================
+    SessionSettings SessionFactory::configuredSessionSettings(const string& serverUri) const
+    {
+        map<string, SessionSettings>::const_iterator it;
+        it = database_->clientSettings.specificSessionSettings.find(serverUri);
+
+        if (it != database_->clientSettings.specificSessionSettings.end())
+            return it->second;
+        else
+            return database_->clientSettings.defaultSessionSettings;
+    }
+
+
     // Construct a session if needed, without connecting
     // =============================================================================================
     Status SessionFactory::acquireSession(
@@ -552,33 +673,34 @@ namespace uaf
             const SessionSettings&  sessionSettings,
             Session*&               session)
     {
-        logger_->debug("Acquiring Session to %s with the following settings:", serverUri.c_str());
-        logger_->debug(sessionSettings.toString());
+        UAF_LOG_DEBUG(logger_, "Acquiring Session to %s with the following settings:", serverUri.c_str());
+        UAF_LOG_DEBUG(logger_, sessionSettings.toString());
 
         Status ret;
 
         session = 0;
 
-        // lock the mutex to make sure the sessionMap_ is not being manipulated
-        UaMutexLocker locker(&sessionMapMutex_);
+        // true if this thread created the session, and therefore needs to connect it
+        bool mustConnect = false;
 
-        // first check if we need to create a new session in any case:
-        if (sessionSettings.unique)
         {
-            logger_->debug("The session must be unique");
-        }
-        else
-        {
-            // loop trough the sessions ...
-            for (SessionMap::const_iterator it = sessionMap_.begin(); it != sessionMap_.end(); ++it)
+            // lock the mutex to make sure the sessionMap_ is not being manipulated
+            UaMutexLocker locker(&sessionMapMutex_);
+
+            // first check if we need to create a new session in any case:
+            if (sessionSettings.unique)
+            {
+                UAF_LOG_DEBUG(logger_, "The session must be unique");
+            }
+            else
             {
-                // ... until a suitable one is found
-                if (    it->second->serverUri() == serverUri
-                    &&  it->second->sessionSettings() == sessionSettings )
+                // look up a suitable session in the index
+                session = findSession(serverUri, sessionSettings);
+
+                if (session != 0)
                 {
-                    session = it->second;
-                    logger_->debug("A suitable session (ClientConnectionId=%d) already exists",
-                                   session->clientConnectionId());
+                    UAF_LOG_DEBUG(logger_, "A suitable session (ClientConnectionId=%d) already exists",
+                                           session->clientConnectionId());
 
                     // get the ClientConnectionId of the session
                     ClientConnectionId id = session->clientConnectionId();
@@ -589,55 +711,63 @@ namespace uaf
                     activityMapMutex_.unlock();
 
                     ret = statuscodes::Good;
-
-                    break;
                 }
             }
-        }
 
-        // if no session exists (because none was found, or because it was just deleted),
-        // then we create a new one
-        if (ret.isUncertain())
-        {
-            ClientConnectionId clientConnectionId = database_->createUniqueClientConnectionId();
-
-            logger_->debug("No suitable session exists yet, so we create a new one with "
-                           "clientConnectionId %d",
-                           clientConnectionId);
-
-            // create a new session instance
-            session = new Session(
-                    logger_->loggerFactory(),
-                    sessionSettings,
-                    serverUri,
-                    clientConnectionId,
-                    this,
-                    clientInterface_,
-                    discoverer_,
-                    database_);
-
-            // store the new session instance in the sessionMap
-            sessionMap_[clientConnectionId] = session;
-
-            // create an activity count for the session
-            activityMapMutex_.lock();
-            activityMap_[clientConnectionId] = 1;
-            activityMapMutex_.unlock();
+            // if no session exists (because none was found, or because it was just deleted),
+            // then we create a new one
+            if (ret.isUncertain())
+            {
+                ClientConnectionId clientConnectionId = database_->createUniqueClientConnectionId();
+
+                UAF_LOG_DEBUG(logger_, "No suitable session exists yet, so we create a new one with "
+                                       "clientConnectionId %d",
+                                       clientConnectionId);
+
+                // create a new session instance
+                session = new Session(
+                        logger_->loggerFactory(),
+                        sessionSettings,
+                        serverUri,
+                        clientConnectionId,
+                        this,
+                        clientInterface_,
+                        discoverer_,
+                        database_);
+
+                // other threads that acquire the session will have to wait until we've tried
+                // to connect it
+                session->startConnectionAttempt();
+
+                // store the new session instance in the sessionMap
+                addSession(session);
+
+                // create an activity count for the session
+                activityMapMutex_.lock();
+                activityMap_[clientConnectionId] = 1;
+                activityMapMutex_.unlock();
+
+                mustConnect = true;
+
+                // regardless of whether the connection will succeed or fail, set the return
+                // status to 'good'
+                ret = statuscodes::Good;
+            }
+        }
 
-            // connect to the session
+        // connect the session or wait for the connection attempt, without holding the lock of
+        // the sessionMap_ (so that the other sessions can still be used in the meantime)
+        if (mustConnect)
             session->connect();
-
-            // regardless of whether the connection succeeded or failed, set the return status
-            // to 'good'
-            ret = statuscodes::Good;
-        }
+        else if (session != 0)
+            session->waitForConnectionAttempt();
 
         // add some diagnostics
         if (ret.isGood())
         {
             activityMapMutex_.lock();
-            logger_->debug("The requested session is acquired (#activities: %d)",
-                           activityMap_[session->clientConnectionId()]);
+            UAF_LOG_DEBUG(logger_, "The requested session is acquired (#activities: %d)",
+                                   activityMap_[session->clientConnectionId()]);
             activityMapMutex_.unlock();
         }
         else
@@ -650,13 +780,92 @@ namespace uaf
     }
 
 
+    // Add a session to the session map and the index
+    // =============================================================================================
+    void SessionFactory::addSession(Session* session)
+    {
+        sessionMap_[session->clientConnectionId()] = session;
+
+        // sessions that are manually connected to an endpoint don't know their server URI yet,
+        // so they can only be indexed once they're connected
+        std::string serverUri = session->serverUri();
+        if (serverUri.empty())
+            unindexedSessions_.insert(session);
+        else
+            sessionIndex_.insert(SessionIndex::value_type(
+                    SessionKey(serverUri, session->sessionSettings().fingerprint()),
+                    session));
+    }
+
+
+    // Remove a session from the session map and the index
+    // =============================================================================================
+    void SessionFactory::removeSession(Session* session)
+    {
+        sessionMap_.erase(session->clientConnectionId());
+
+        if (unindexedSessions_.erase(session) == 0)
+        {
+            std::pair<SessionIndex::iterator, SessionIndex::iterator> range = sessionIndex_.equal_range(
+                    SessionKey(session->serverUri(), session->sessionSettings().fingerprint()));
+
+            for (SessionIndex::iterator it = range.first; it != range.second; ++it)
+            {
+                if (it->second == session)
+                {
+                    sessionIndex_.erase(it);
+                    break;
+                }
+            }
+        }
+    }
+
+
+    // Find a session with the given server URI and settings
+    // =============================================================================================
+    Session* SessionFactory::findSession(
+            const string&           serverUri,
+            const SessionSettings&  sessionSettings)
+    {
+        // first index the sessions of which the server URI has become known in the meantime
+        for (std::set<Session*>::iterator it = unindexedSessions_.begin();
+             it != unindexedSessions_.end(); )
+        {
+            std::string sessionServerUri = (*it)->serverUri();
+            if (sessionServerUri.empty())
+            {
+                ++it;
+            }
+            else
+            {
+                sessionIndex_.insert(SessionIndex::value_type(
+                        SessionKey(sessionServerUri, (*it)->sessionSettings().fingerprint()),
+                        *it));
+                unindexedSessions_.erase(it++);
+            }
+        }
+
+        // then look up the session (and verify the settings, since fingerprints may collide)
+        std::pair<SessionIndex::iterator, SessionIndex::iterator> range = sessionIndex_.equal_range(
+                SessionKey(serverUri, sessionSettings.fingerprint()));
+
+        for (SessionIndex::iterator it = range.first; it != range.second; ++it)
+        {
+            if (it->second->sessionSettings() == sessionSettings)
+                return it->second;
+        }
+
+        return 0;
+    }
+
+
     // Acquire an existing session, if one is available.
     // =============================================================================================
     Status SessionFactory::acquireExistingSession(
             ClientConnectionId  clientConnectionId,
             Session*&           session)
     {
-        logger_->debug("Acquiring existing session %d if available", clientConnectionId);
+        UAF_LOG_DEBUG(logger_, "Acquiring existing session %d if available", clientConnectionId);
 
         Status ret;
 
@@ -687,8 +896,8 @@ namespace uaf
             // an existing session was acquired, so set the status to Good
             ret = statuscodes::Good;
 
-            logger_->debug("Session %d was acquired (#activities: %d)",
-                           clientConnectionId, newActivityCount);
+            UAF_LOG_DEBUG(logger_, "Session %d was acquired (#activities: %d)",
+                                   clientConnectionId, newActivityCount);
         }
 
         return ret;
@@ -725,7 +934,7 @@ namespace uaf
             activityMap_[id] = activityMap_[id] - 1;
             ret = statuscodes::Good;
 
-            logger_->debug("Session %d is now released (#activities: %d)", id, activityMap_[id]);
+            UAF_LOG_DEBUG(logger_, "Session %d is now released (#activities: %d)", id, activityMap_[id]);
 
             // check if the session is disconnected
             if (session->sessionState() == uaf::sessionstates::Disconnected)
@@ -734,14 +943,14 @@ namespace uaf
                 // pointer to this session being used), we may delete it!
                 if (activityMap_[id] == 0 && allowGarbageCollection)
                 {
-                    logger_->debug("There's no ongoing activity of this disconnected session, so "
-                                   "we may delete it");
+                    UAF_LOG_DEBUG(logger_, "There's no ongoing activity of this disconnected session, so "
+                                           "we may delete it");
+                    removeSession(session);
                     delete session;
                     session = 0;
                     activityMap_.erase(id);
-                    sessionMap_.erase(id);
 
-                    logger_->debug("The session has been deleted");
+                    UAF_LOG_DEBUG(logger_, "The session has been deleted");
                 }
             }
         }
@@ -751,6 +960,34 @@ namespace uaf
 
 
 
+    // Get the pool to invoke services concurrently
+    // =============================================================================================
+    std::shared_ptr<ThreadPool> SessionFactory::invocationPool()
+    {
+        UaMutexLocker locker(&invocationPoolMutex_);
+
+        std::size_t maxSessions = database_->clientSettings.parallelInvocationsMaxSessions;
+        if (maxSessions == 0)
+            maxSessions = 1;
+
+        if (invocationPool_ && invocationPool_->noOfThreads() != maxSessions)
+        {
+            UAF_LOG_DEBUG(logger_, "The maximum number of parallel sessions has changed, so we create a "
+                                   "new invocation pool");
+            // the old pool is deleted by the last request that releases it
+            invocationPool_.reset();
+        }
+
+        if (!invocationPool_)
+        {
+            UAF_LOG_DEBUG(logger_, "Creating an invocation pool with %d threads", int(maxSessions));
+            invocationPool_.reset(new ThreadPool(maxSessions, maxSessions));
+        }
+
+        return invocationPool_;
+    }
+
+
     // Get a new transaction id
     // =============================================================================================
     uaf::TransactionId SessionFactory::getNewTransactionId()
@@ -790,11 +1027,11 @@ namespace uaf
         connectionsteps::ConnectionStep step = connectionsteps::fromSdk(serviceType);
         SdkStatus sdkStatus(uaStatus);
 
-        logger_->debug("Received a connectError event:");
-        logger_->debug(" - clientConnectionId : %d", clientConnectionId);
-        logger_->debug(" - serviceType        : %s", connectionsteps::toString(step).c_str());
-        logger_->debug(" - error              : %s", uaStatus.toString().toUtf8());
-        logger_->debug(" - clientSideError    : %s", (clientSideError ? "true" : "false") );
+        UAF_LOG_DEBUG(logger_, "Received a connectError event:");
+        UAF_LOG_DEBUG(logger_, " - clientConnectionId : %d", clientConnectionId);
+        UAF_LOG_DEBUG(logger_, " - serviceType        : %s", connectionsteps::toString(step).c_str());
+        UAF_LOG_DEBUG(logger_, " - error              : %s", uaStatus.toString().toUtf8());
+        UAF_LOG_DEBUG(logger_, " - clientSideError    : %s", (clientSideError ? "true" : "false") );
 
         // acquire the session for which the event was meant:
         Session* session = 0;
@@ -827,10 +1064,10 @@ namespace uaf
         // convert the serverStatus to the Session::SessionStatus enum
         sessionstates::SessionState state = sessionstates::toUaf(serverStatus);
 
-        logger_->debug("Received a ConnectionStatusChanged event for clientConnectionId %d "
-                       "(new state: %s)",
-                       clientConnectionId,
-                       sessionstates::toString(state).c_str());
+        UAF_LOG_DEBUG(logger_, "Received a ConnectionStatusChanged event for clientConnectionId %d "
+                               "(new state: %s)",
+                               clientConnectionId,
+                               sessionstates::toString(state).c_str());
 
         // acquire the session for which the event was meant:
         Session* session = 0;
@@ -838,11 +1075,38 @@ namespace uaf
 
         if (acquireStatus.isGood())
         {
+            sessionstates::SessionState previousState = session->sessionState();
+            std::string serverUri = session->serverUri();
+
             // update the session state
             session->setSessionState(state);
 
             // release the acquired session
             releaseSession(session, false);
+
+            // don't wait for the next periodic housekeeping if the session needs attention:
+            // a session that was lost is reconnected, and the persisted requests (e.g. monitored
+            // items) are created again as soon as the session is (re)connected.
+            // Only real transitions count, so a reconnection attempt that fails doesn't
+            // immediately trigger another attempt.
+            if (state != previousState)
+            {
+                if (   (state == sessionstates::Disconnected)
+                    || (state == sessionstates::ServerShutdown))
+                {
+                    database_->backgroundTasks.schedule(backgroundtasks::toTaskId(
+                            backgroundtasks::SessionHouseKeeping, clientConnectionId));
+                }
+                else if (   (state == sessionstates::Connected)
+                         || (state == sessionstates::NewSessionCreated))
+                {
+                    // the server is reachable again, so don't wait for the backoff
+                    database_->createMonitoredDataRequestStore.resetBackoff(serverUri);
+                    database_->createMonitoredEventsRequestStore.resetBackoff(serverUri);
+                    database_->backgroundTasks.schedule(backgroundtasks::toTaskId(
+                            backgroundtasks::PersistedRequests));
+                }
+            }
         }
     }
 
@@ -854,7 +1118,7 @@ namespace uaf
         const UaStatus&             uaStatus,
         const UaClientSdk::CallOut& callResponse)
     {
-        logger_->debug("Call complete: transactionId %d", transactionId);
+        UAF_LOG_DEBUG(logger_, "Call complete: transactionId %d", transactionId);
 
         // find the request handle for the given transaction id
         RequestHandle handle = 0;
@@ -910,8 +1174,8 @@ namespace uaf
         // if the transaction id was found, put the result in the correct cache
         if (transactionIdFound)
         {
-            logger_->debug("Transaction id %d corresponds to the asynchronous handle %d",
-                           transactionId, handle);
+            UAF_LOG_DEBUG(logger_, "Transaction id %d corresponds to the asynchronous handle %d",
+                                   transactionId, handle);
 
             // remove the transaction id : request handle pair
             transactionMapMutex_.lock();      // lock the map
@@ -938,7 +1202,7 @@ namespace uaf
         const UaDiagnosticInfos& diagnosticInfos    //!< [in] List of diagnostic information
         )
     {
-        logger_->debug("Read complete: transactionId %d", transactionId);
+        UAF_LOG_DEBUG(logger_, "Read complete: transactionId %d", transactionId);
 
 
         // find the request handle for the given transaction id
@@ -982,8 +1246,8 @@ namespace uaf
             // set the data
             result.targets[i].data = Variant(values[i].Value);
         }
-        logger_->debug("ReadResult for request %d (transaction %d):", handle, transactionId);
-        logger_->debug(result.toString());
+        UAF_LOG_DEBUG(logger_, "ReadResult for request %d (transaction %d):", handle, transactionId);
+        UAF_LOG_DEBUG(logger_, result.toString());
 
 //        // if the transaction id was found, put the result in the correct cache
 //        if (transactionIdFound)
@@ -1019,7 +1283,7 @@ namespace uaf
         const UaDiagnosticInfos& diagnosticInfos    //!< [in] List of diagnostic information
         )
     {
-        logger_->debug("Write complete: transactionId %d", transactionId);
+        UAF_LOG_DEBUG(logger_, "Write complete: transactionId %d", transactionId);
 
 
         // find the request handle for the given transaction id
@@ -1058,8 +1322,8 @@ namespace uaf
 
             result.targets[i].opcUaStatusCode = results[i];
         }
-        logger_->debug("WriteResult for request %d (transaction %d):", handle, transactionId);
-        logger_->debug(result.toString());
+        UAF_LOG_DEBUG(logger_, "WriteResult for request %d (transaction %d):", handle, transactionId);
+        UAF_LOG_DEBUG(logger_, result.toString());
 
 //        // if the transaction id was found, put the result in the correct cache
 //        if (transactionIdFound)
@@ -25,11 +25,17 @@
 #include <vector>
 #include <string>
 #include <sstream>
+#include <set>
+#include <utility>
+#include <unordered_map>
+#include <memory>
 // SDK
 #include "uabasecpp/uasemaphore.h"
 #include "uaclientcpp/uaclientsdk.h"
 // UAF
 #include "uaf/util/logger.h"
+#include "uaf/util/threadpool.h"
+#include "uaf/util/hashfunctions.h"
 #include "uaf/client/clientexport.h"
 #include "uaf/client/database/database.h"
 #include "uaf/client/sessions/session.h"
@@ -143,6 +149,15 @@ namespace uaf
         void doHouseKeeping();
 
 
+        /**
+         * Do the housekeeping of a single session, e.g. reconnect it if it was disconnected but
+         * had activities going on.
+         *
+         * @param clientConnectionId    The id of the session.
+         */
+        void doHouseKeeping(uaf::ClientConnectionId clientConnectionId);
+
+
         /**
          * Get some information about a particular session.
          *
@@ -275,6 +290,35 @@ namespace uaf
 				 uaf::StructureDefinition& 	definition);
 
 
+        /**
+         * Register nodes within the sessions to their servers, so that all subsequent services
+         * of these sessions use the aliases of the nodes.
+         *
+         * @param nodeIds           The (fully resolved) nodes to register.
+         * @param serviceSettings   The service settings to be used (NULL for the default ones).
+         * @param results           Output parameter: a status for each node.
+         * @return                  Good if all nodes could be registered, bad if not.
+         */
+        uaf::Status registerNodes(
+                const std::vector<uaf::ExpandedNodeId>& nodeIds,
+                const uaf::ServiceSettings*             serviceSettings,
+                std::vector<uaf::Status>&               results);
+
+
+        /**
+         * Unregister nodes that were registered before by registerNodes().
+         *
+         * @param nodeIds           The (fully resolved) nodes to unregister.
+         * @param serviceSettings   The service settings to be used (NULL for the default ones).
+         * @param results           Output parameter: a status for each node.
+         * @return                  Good if all nodes could be unregistered, bad if not.
+         */
+        uaf::Status unregisterNodes(
+                const std::vector<uaf::ExpandedNodeId>& nodeIds,
+                const uaf::ServiceSettings*             serviceSettings,
+                std::vector<uaf::Status>&               results);
+
+
         template<typename _Service>
         typename _Service::Settings getServiceSettings(const typename _Service::Request&  request)
         {
@@ -292,7 +336,7 @@ namespace uaf
         {
             if (request.sessionSettingsGiven)
             {
-                logger_->debug("Using the SessionSettings from the request");
+                UAF_LOG_DEBUG(logger_, "Using the SessionSettings from the request");
                 return request.sessionSettings;
             }
             else
@@ -302,12 +346,12 @@ namespace uaf
 
                 if (it != database_->clientSettings.specificSessionSettings.end())
                 {
-                    logger_->debug("Using clientSettings::specificSessionSettings[%s]", serverUri.c_str());
+                    UAF_LOG_DEBUG(logger_, "Using clientSettings::specificSessionSettings[%s]", serverUri.c_str());
                     return it->second;
                 }
                 else
                 {
-                    logger_->debug("Using clientSettings::defaultSessionSettings");
+                    UAF_LOG_DEBUG(logger_, "Using clientSettings::defaultSessionSettings");
                     return database_->clientSettings.defaultSessionSettings;
                 }
             }
@@ -323,16 +367,19 @@ namespace uaf
          * @param mask      The mask identifying the targets of the request that need to be included
          *                  in the invocation.
          * @param result    Output parameter: the result of the invocation.
+         * @param concurrently  True to invoke the services of multiple sessions concurrently,
+         *                      even if ClientSettings::parallelInvocationsEnable is false.
          * @return          Good if the invocation went fine, bad if not.
          */
         template<typename _Service>
         uaf::Status invokeRequest(
                 const typename _Service::Request&  request,
                 const uaf::Mask&                   mask,
-                typename _Service::Result&         result)
+                typename _Service::Result&         result,
+                bool                               concurrently = false)
         {
-            logger_->debug("Invoking %sRequest %d", _Service::name().c_str(), request.requestHandle());
-            logger_->debug("Mask is %s", mask.toString().c_str());
+            UAF_LOG_DEBUG(logger_, "Invoking %sRequest %d", _Service::name().c_str(), request.requestHandle());
+            UAF_LOG_DEBUG(logger_, "Mask is %s", mask.toString().c_str());
 
             // Invocation details
             typedef typename _Service::Invocation Invocation;
@@ -362,102 +409,107 @@ namespace uaf
             typedef std::map<uaf::Session*, Invocation*> InvocationMap;
             InvocationMap invocations;
 
-            logger_->debug("Building the invocations");
-            for (std::size_t i = 0; i < request.targets.size() && ret.isGood(); i++)
+            // create an index to quickly find the sessions that are already scheduled
+            SessionIndex scheduledSessions;
+
+            UAF_LOG_DEBUG(logger_, "Building the invocations");
+            for (std::size_t i = mask.nextSet(0);
+                 i < request.targets.size() && ret.isGood();
+                 i = mask.nextSet(i + 1))
             {
-                if (mask.isSet(i))
+                if (request.clientConnectionIdGiven)
                 {
-                    if (request.clientConnectionIdGiven)
-                    {
-                        logger_->debug("ClientConnectionId %d is given", request.clientConnectionId);
+                    UAF_LOG_DEBUG(logger_, "ClientConnectionId %d is given", request.clientConnectionId);
 
-                        // we'll only have 0 or 1 invocations in this case
-                        if (invocations.size() == 0)
+                    // we'll only have 0 or 1 invocations in this case
+                    if (invocations.size() == 0)
+                    {
+                        Session* session;
+                        ret = acquireExistingSession(request.clientConnectionId, session);
+                        if (ret.isGood())
                         {
-                            Session* session;
-                            ret = acquireExistingSession(request.clientConnectionId, session);
-                            if (ret.isGood())
-                            {
-                                invocations[session] = new Invocation;
-                                invocations[session]->setAsynchronous(async);
-                                invocations[session]->setRequestHandle(requestHandle);
-                                invocations[session]->setServiceSettings(getServiceSettings<_Service>(request));
-                            }
+                            invocations[session] = new Invocation;
+                            invocations[session]->setAsynchronous(async);
+                            invocations[session]->setRequestHandle(requestHandle);
+                            invocations[session]->setServiceSettings(getServiceSettings<_Service>(request));
                         }
+                    }
 
-                        // check if we're indeed having just one invocation scheduled
-                        if (ret.isGood() && invocations.size() != 1)
-                            ret = UnexpectedError("Bug in SessionFactory::invokeRequest: #invocations != 1");
+                    // check if we're indeed having just one invocation scheduled
+                    if (ret.isGood() && invocations.size() != 1)
+                        ret = UnexpectedError("Bug in SessionFactory::invokeRequest: #invocations != 1");
 
-                        if (ret.isGood())
+                    if (ret.isGood())
+                    {
+                        for (typename InvocationMap::const_iterator it = invocations.begin(); it != invocations.end(); ++it)
                         {
-                            for (typename InvocationMap::const_iterator it = invocations.begin(); it != invocations.end(); ++it)
-                            {
-                                logger_->debug("Adding target %d", i);
-                                it->second->addTarget(i, request.targets[i], result.targets[i]);
-                            }
+                            UAF_LOG_DEBUG(logger_, "Adding target %d", i);
+                            it->second->addTarget(i, request.targets[i], result.targets[i]);
                         }
-
                     }
-                    else
-                    {
-                        logger_->debug("Trying to get the serverUri from the target");
 
-                        // we first need to determine the server which hosts the target
-                        std::string serverUri;
-                        if (getServerUriFromTarget(request.targets[i], serverUri).isGood())
-                        {
-                            logger_->debug("ServerUri was found: %s", serverUri.c_str());
+                }
+                else
+                {
+                    UAF_LOG_DEBUG(logger_, "Trying to get the serverUri from the target");
 
-                            Session* session = NULL;
-                            uaf::SessionSettings sessionSettings = getSessionSettings<_Service>(request, serverUri);
+                    // we first need to determine the server which hosts the target
+                    std::string serverUri;
+                    if (getServerUriFromTarget(request.targets[i], serverUri).isGood())
+                    {
+                        UAF_LOG_DEBUG(logger_, "ServerUri was found: %s", serverUri.c_str());
 
-                            logger_->debug("Trying to find a scheduled session");
+                        Session* session = NULL;
+                        uaf::SessionSettings sessionSettings = getSessionSettings<_Service>(request, serverUri);
 
-                            // check if the session we need is already scheduled for an invocation
-                            for (typename InvocationMap::const_iterator it = invocations.begin();
-                                    it != invocations.end(); ++it)
-                            {
-                                if (   it->first->serverUri() == serverUri
-                                    && it->first->sessionSettings() == sessionSettings)
-                                {
-                                    logger_->debug("Found a scheduled session");
-                                    session = it->first;
-                                }
-                            }
+                        UAF_LOG_DEBUG(logger_, "Trying to find a scheduled session");
 
-                            // if the session is not already scheduled, we acquire it first
-                            if (session == NULL)
+                        // check if the session we need is already scheduled for an invocation
+                        SessionKey key(serverUri, sessionSettings.fingerprint());
+                        std::pair<SessionIndex::iterator, SessionIndex::iterator> range
+                            = scheduledSessions.equal_range(key);
+                        for (SessionIndex::iterator it = range.first; it != range.second; ++it)
+                        {
+                            if (it->second->sessionSettings() == sessionSettings)
                             {
-                                logger_->debug("No session was scheduled, so we acquire one");
-
-                                ret = acquireSession(serverUri, sessionSettings, session);
-
-                                if (ret.isGood())
-                                {
-                                    logger_->debug("Scheduling an invocation for this session");
-                                    invocations[session] = new Invocation;
-                                    invocations[session]->setAsynchronous(async);
-                                    invocations[session]->setRequestHandle(requestHandle);
-                                    invocations[session]->setServiceSettings(getServiceSettings<_Service>(request));
-                                }
+                                UAF_LOG_DEBUG(logger_, "Found a scheduled session");
+                                session = it->second;
+                                break;
                             }
+                        }
+
+                        // if the session is not already scheduled, we acquire it first
+                        if (session == NULL)
+                        {
+                            UAF_LOG_DEBUG(logger_, "No session was scheduled, so we acquire one");
+
+                            ret = acquireSession(serverUri, sessionSettings, session);
 
                             if (ret.isGood())
                             {
-                                logger_->debug("Adding the target");
-                                invocations[session]->addTarget(i, request.targets[i], result.targets[i]);
+                                UAF_LOG_DEBUG(logger_, "Scheduling an invocation for this session");
+                                scheduledSessions.insert(SessionIndex::value_type(key, session));
+                                invocations[session] = new Invocation;
+                                invocations[session]->setAsynchronous(async);
+                                invocations[session]->setRequestHandle(requestHandle);
+                                invocations[session]->setServiceSettings(getServiceSettings<_Service>(request));
                             }
                         }
-                        else
+
+                        if (ret.isGood())
                         {
-                            ret = uaf::InvalidServerUriError(serverUri);
+                            UAF_LOG_DEBUG(logger_, "Adding the target");
+                            invocations[session]->addTarget(i, request.targets[i], result.targets[i]);
                         }
                     }
+                    else
+                    {
+                        ret = uaf::InvalidServerUriError(serverUri);
+                    }
                 }
             }
 
-            logger_->debug("A total of %d invocations were built", invocations.size());
+            UAF_LOG_DEBUG(logger_, "A total of %d invocations were built", invocations.size());
 
             // the UAF currently does NOT support asynchronous communication to multiple sessions
             // in one request (because the logic to reconstruct the result from multiple
@@ -471,53 +523,62 @@ namespace uaf
             }
 
 
-            // loop through the invocations (while the return Status is good)
-            int invocationIndex = 0; // index to keep track of the number of processed invocations
+            // set the transaction id and session information of all invocations
             for (typename InvocationMap::iterator it = invocations.begin();
                  it != invocations.end() && ret.isGood();
                  ++it)
             {
-                logger_->debug("Processing invocation %d", invocationIndex);
-
-                // create a pointer to the current invocation
-                uaf::Session* session = it->first;
-                Invocation*   invocation = it->second;
-
                 // set the transactionId if necessary
                 if (handleStored)
                 {
-                    logger_->debug("Copying the transaction id %d to the invocation",transactionId);
-                    invocation->setTransactionId(transactionId);
+                    UAF_LOG_DEBUG(logger_, "Copying the transaction id %d to the invocation",transactionId);
+                    it->second->setTransactionId(transactionId);
                 }
 
                 // copy the session information to the invocation
-                logger_->debug("Copying the session information to the invocation");
-                invocation->setSessionInformation(session->sessionInformation());
+                UAF_LOG_DEBUG(logger_, "Copying the session information to the invocation");
+                it->second->setSessionInformation(it->first->sessionInformation());
+            }
 
-                // if the session is connected, invoke the service
-                if (session->isConnected())
+            // invoke the services of multiple sessions concurrently, if configured
+            // (asynchronous requests have one invocation only, so they are never concerned)
+            if (   ret.isGood()
+                && invocations.size() > 1
+                && (concurrently || database_->clientSettings.parallelInvocationsEnable))
+            {
+                ret = invokeConcurrently<_Service>(request, invocations, result);
+            }
+            else
+            {
+                // loop through the invocations (while the return Status is good)
+                int invocationIndex = 0; // index to keep track of the number of processed invocations
+                for (typename InvocationMap::iterator it = invocations.begin();
+                     it != invocations.end() && ret.isGood();
+                     ++it)
                 {
-                    logger_->debug("Forwarding the invocation to session %d",
-                                   session->clientConnectionId());
-                    ret = session->invokeService<_Service>(request, *invocation);
-                }
-                else
-                    ret = session->sessionInformation().lastConnectionAttemptStatus;
+                    UAF_LOG_DEBUG(logger_, "Processing invocation %d", invocationIndex);
 
-                // copy all data to the result
-                if (ret.isGood())
-                {
-                    logger_->debug("Copying the invocation data to the result");
-                    ret = invocation->copyToResult(result);
-                }
+                    // create a pointer to the current invocation
+                    uaf::Session* session = it->first;
+                    Invocation*   invocation = it->second;
 
-                releaseSession(session);
+                    ret = invokeOnSession<_Service>(session, request, *invocation);
+
+                    // copy all data to the result
+                    if (ret.isGood())
+                    {
+                        UAF_LOG_DEBUG(logger_, "Copying the invocation data to the result");
+                        ret = invocation->copyToResult(result);
+                    }
+
+                    releaseSession(session);
 
-                // don't forget to delete the invocation!!!
-                // (see bugfix https://github.com/uaf/uaf/issues/86)
-                delete invocation;
+                    // don't forget to delete the invocation!!!
+                    // (see bugfix https://github.com/uaf/uaf/issues/86)
+                    delete invocation;
 
-                invocationIndex++;
+                    invocationIndex++;
+                }
             }
 
             // clear the InvocationMap
@@ -526,7 +587,7 @@ namespace uaf
             // remove the handle if one was stored, and if there was an unexpected error
             if (ret.isNotGood() && handleStored)
             {
-                logger_->debug("Removing the transaction id");
+                UAF_LOG_DEBUG(logger_, "Removing the transaction id");
                 // remove the transaction id : request handle pair
                 transactionMapMutex_.lock();            // lock the map
                 transactionMap_.erase(transactionId);   // erase the key
@@ -546,6 +607,174 @@ namespace uaf
         // define a dataype for the number of activities associated with a specific session
         typedef uint32_t Activity;
 
+        // define a key (server URI and session settings fingerprint) and an index to quickly
+        // find the sessions with a particular server URI and particular session settings
+        typedef std::pair<std::string, std::size_t> SessionKey;
+        typedef std::unordered_multimap<SessionKey,
+                                        uaf::Session*,
+                                        uaf::PairHash<std::string, std::size_t> > SessionIndex;
+
+
+        /**
+         * A job to invoke a service on a particular session, by a thread of the invocation pool.
+         */
+        template<typename _Service>
+        class InvocationJob : public uaf::ThreadPoolJob
+        {
+        public:
+            InvocationJob(
+                    uaf::SessionFactory*                sessionFactory,
+                    uaf::Session*                       session,
+                    const typename _Service::Request&   request,
+                    typename _Service::Invocation*      invocation)
+            : sessionFactory_(sessionFactory),
+              session_(session),
+              request_(request),
+              invocation_(invocation)
+            {}
+
+            void execute()
+            {
+                status = sessionFactory_->invokeOnSession<_Service>(session_, request_, *invocation_);
+            }
+
+            /** The status of the invocation (only valid after the job has finished). */
+            uaf::Status status;
+
+        private:
+            uaf::SessionFactory*                sessionFactory_;
+            uaf::Session*                       session_;
+            const typename _Service::Request&   request_;
+            typename _Service::Invocation*      invocation_;
+        };
+
+
+        /**
+         * Invoke the service of a single invocation on the given (acquired) session.
+         *
+         * @return  The status of the invocation, or the last connection attempt status if the
+         *          session is not connected.
+         */
+        template<typename _Service>
+        uaf::Status invokeOnSession(
+                uaf::Session*                       session,
+                const typename _Service::Request&   request,
+                typename _Service::Invocation&      invocation)
+        {
+            // if the session is connected, invoke the service
+            if (session->isConnected())
+            {
+                UAF_LOG_DEBUG(logger_, "Forwarding the invocation to session %d",
+                                       session->clientConnectionId());
+                return session->invokeService<_Service>(request, invocation);
+            }
+            else
+            {
+                return session->sessionInformation().lastConnectionAttemptStatus;
+            }
+        }
+
+
+        /**
+         * Invoke the services of the given invocations concurrently, on the invocation pool,
+         * and merge the results by rank.
+         *
+         * All sessions are released and all invocations are deleted afterwards.
+         *
+         * @return  Good if all invocations went fine, otherwise the status of the first failed
+         *          invocation (in the order of the map).
+         */
+        template<typename _Service>
+        uaf::Status invokeConcurrently(
+                const typename _Service::Request&                                   request,
+                std::map<uaf::Session*, typename _Service::Invocation*>&            invocations,
+                typename _Service::Result&                                          result)
+        {
+            typedef std::map<uaf::Session*, typename _Service::Invocation*> InvocationMap;
+            typedef InvocationJob<_Service> Job;
+
+            uaf::Status ret(uaf::statuscodes::Good);
+
+            // the pool stays alive while it is used, even if it is replaced in the meantime
+            std::shared_ptr<uaf::ThreadPool> pool = invocationPool();
+
+            UAF_LOG_DEBUG(logger_, "Processing %d invocations concurrently (at most %d at a time)",
+                                   int(invocations.size()), int(pool->noOfThreads()));
+
+            // dispatch one job per session
+            std::vector<Job*> jobs;
+            jobs.reserve(invocations.size());
+            for (typename InvocationMap::iterator it = invocations.begin();
+                 it != invocations.end();
+                 ++it)
+            {
+                jobs.push_back(new Job(this, it->first, request, it->second));
+                pool->addJob(jobs.back());
+            }
+
+            // wait for the jobs in order, and merge their results into the result
+            std::size_t i = 0;
+            for (typename InvocationMap::iterator it = invocations.begin();
+                 it != invocations.end();
+                 ++it, ++i)
+            {
+                uaf::Session* session = it->first;
+                jobs[i]->waitUntilFinished();
+
+                uaf::Status status = jobs[i]->status;
+                if (status.isGood())
+                {
+                    UAF_LOG_DEBUG(logger_, "Copying the invocation data to the result");
+                    status = it->second->copyToResult(result);
+                }
+
+                if (ret.isGood() && status.isNotGood())
+                    ret = status;
+
+                releaseSession(session);
+                delete it->second;
+                delete jobs[i];
+            }
+
+            return ret;
+        }
+
+
+        /**
+         * Get the pool to invoke the services of multiple sessions concurrently.
+         *
+         * The pool is (re)created when the number of threads doesn't match
+         * ClientSettings::parallelInvocationsMaxSessions anymore. A replaced pool is deleted
+         * (i.e. its threads are joined) as soon as the requests that still use it release it.
+         */
+        std::shared_ptr<uaf::ThreadPool> invocationPool();
+
+
+        /**
+         * Get the session settings that are configured for the given server (i.e. the specific
+         * session settings of the server if there are any, or the default ones otherwise).
+         *
+         * @param serverUri The URI of the server.
+         * @return          The configured session settings.
+         */
+        uaf::SessionSettings configuredSessionSettings(const std::string& serverUri) const;
+
+
+        /**
+         * Register or unregister nodes, on the sessions of their servers.
+         *
+         * @param registering       True to register the nodes, false to unregister them.
+         * @param nodeIds           The (fully resolved) nodes.
+         * @param serviceSettings   The service settings to be used (NULL for the default ones).
+         * @param results           Output parameter: a status for each node.
+         * @return                  Good if all nodes could be processed, bad if not.
+         */
+        uaf::Status changeNodeRegistrations(
+                bool                                    registering,
+                const std::vector<uaf::ExpandedNodeId>& nodeIds,
+                const uaf::ServiceSettings*             serviceSettings,
+                std::vector<uaf::Status>&               results);
+
         // define a map to store all sessions, and their number of running activities
         typedef std::map<uaf::ClientConnectionId, uaf::Session*>   SessionMap;
         typedef std::map<uaf::ClientConnectionId, Activity>         ActivityMap;
@@ -554,6 +783,36 @@ namespace uaf
         typedef std::map<uaf::TransactionId, uaf::RequestHandle>  TransactionMap;
 
 
+        /**
+         * Add a session to the sessionMap_ and to the index (sessionMapMutex_ must be locked!).
+         *
+         * @param session   The session to add.
+         */
+        void addSession(uaf::Session* session);
+
+
+        /**
+         * Remove a session from the sessionMap_ and from the index, without deleting it
+         * (sessionMapMutex_ must be locked!).
+         *
+         * @param session   The session to remove.
+         */
+        void removeSession(uaf::Session* session);
+
+
+        /**
+         * Find a session with the given server URI and session settings in the index
+         * (sessionMapMutex_ must be locked!).
+         *
+         * @param serverUri         Server URI of the session.
+         * @param sessionSettings   Settings of the session.
+         * @return                  The session, or NULL if no suitable session exists.
+         */
+        uaf::Session* findSession(
+                const std::string&          serverUri,
+                const uaf::SessionSettings& sessionSettings);
+
+
         /**
          * Acquire a session with the given properties (by getting an existing one, or creating
          * a new one if a suitable one doesn't exist already).
@@ -704,13 +963,13 @@ namespace uaf
                 transactionMap_[transactionId] = request.requestHandle();
                 transactionMapMutex_.unlock();
                 stored = true;
-                logger_->debug("A new transaction id %d was stored for request %d",
-                               transactionId, request.requestHandle());
+                UAF_LOG_DEBUG(logger_, "A new transaction id %d was stored for request %d",
+                                       transactionId, request.requestHandle());
             }
             else
             {
                 stored = false;
-                logger_->debug("Synchronous request, no transaction id needed");
+                UAF_LOG_DEBUG(logger_, "Synchronous request, no transaction id needed");
             }
 
             return stored;
@@ -730,8 +989,8 @@ namespace uaf
         {
             // nothing to do
             bool stored = false;
-            logger_->debug("Request must be handled at the subscription level, no transaction id "
-                           "must be assigned at the session level");
+            UAF_LOG_DEBUG(logger_, "Request must be handled at the subscription level, no transaction id "
+                                   "must be assigned at the session level");
             return stored;
         }
 
@@ -758,11 +1017,22 @@ namespace uaf
         // mutex to safely manipulate the sessionMap_
         UaMutex  sessionMapMutex_;
 
+        // index of the sessions in the sessionMap_ (by server URI and session settings
+        // fingerprint), and the sessions that cannot be indexed yet because their server URI is
+        // not known yet
+        SessionIndex sessionIndex_;
+        std::set<uaf::Session*> unindexedSessions_;
+
         // map storing all activity counts
         ActivityMap activityMap_;
         // mutex to safely manipulate the activity map
         UaMutex activityMapMutex_;
 
+        // the pool to invoke services on multiple sessions concurrently (created when needed,
+        // and shared with the requests that are using it), and a mutex to safely replace it
+        std::shared_ptr<uaf::ThreadPool>    invocationPool_;
+        UaMutex                             invocationPoolMutex_;
+
 
 
     };
@@ -44,6 +44,8 @@ namespace uaf
                     return "NewSessionCreated";
                 case uaf::sessionstates::ServerShutdown:
                     return "ServerShutdown";
+                case uaf::sessionstates::Connecting:
+                    return "Connecting";
                 default:
                     return "UNKNOWN";
             }
@@ -49,7 +49,8 @@ namespace uaf
             ConnectionWarningWatchdogTimeout = 2, /**< There was a watchdog timeout, indicating a potential connection problem. */
             ConnectionErrorApiReconnect      = 3, /**< The client is trying to reconnect after a connection problem. */
             ServerShutdown                   = 4, /**< The client is trying to reconnect after the server announced its shutdown. */
-            NewSessionCreated                = 5  /**< A new session has been created since the old one could not be reused. */
+            NewSessionCreated                = 5, /**< A new session has been created since the old one could not be reused. */
+            Connecting                       = 6  /**< The session is being connected for the first time by the client. */
         };
 
 
@@ -46,8 +46,12 @@ namespace uaf
     ClientSettings::ClientSettings()
     : logToStdOutLevel(uaf::loglevels::Disabled),
       logToCallbackLevel(uaf::loglevels::Disabled),
+      logAsynchronously(false),
+      logBufferSize(1024),
+      logOverflowPolicy(uaf::logoverflowpolicies::Drop),
       discoveryFindServersTimeoutSec(2.0),
       discoveryGetEndpointsTimeoutSec(1.0),
+      discoveryEndpointsCacheTimeoutSec(60.0),
       discoveryIntervalSec(30.0),
       discoveryOnNetworkEnable(false),
       discoveryOnNetworkTimeoutSec(30.0),
@@ -60,7 +64,20 @@ namespace uaf
       issuersRevocationListLocation("PKI/issuers/crl/"),
       createSecurityLocationsIfNeeded(true),
       clientPrivateKey("PKI/client/private/client.pem"),
-      clientCertificate("PKI/client/certs/client.der")
+      clientCertificate("PKI/client/certs/client.der"),
+      parallelInvocationsEnable(false),
+      parallelInvocationsMaxSessions(8),
+      addressCacheMaxSize(100000),
+      addressCacheSnapshotPath(""),
+      addressCacheAutosaveIntervalSec(300.0),
+      addressCacheNegativeTtlSec(10.0),
+      persistedRequestsRetryMinSec(1.0),
+      persistedRequestsRetryMaxSec(60.0),
+      notificationQueueEnable(false),
+      notificationQueueSize(1024),
+      notificationDispatcherThreads(2),
+      latestValueCacheEnable(false),
+      subscriptionMaxMonitoredItems(0)
     {}
 
     // Constructor
@@ -69,8 +86,12 @@ namespace uaf
     : applicationName(applicationName),
       logToStdOutLevel(uaf::loglevels::Disabled),
       logToCallbackLevel(uaf::loglevels::Disabled),
+      logAsynchronously(false),
+      logBufferSize(1024),
+      logOverflowPolicy(uaf::logoverflowpolicies::Drop),
       discoveryFindServersTimeoutSec(2.0),
       discoveryGetEndpointsTimeoutSec(1.0),
+      discoveryEndpointsCacheTimeoutSec(60.0),
       discoveryIntervalSec(30.0),
       discoveryOnNetworkEnable(false),
       discoveryOnNetworkTimeoutSec(30.0),
@@ -83,7 +104,20 @@ namespace uaf
       issuersRevocationListLocation("PKI/issuers/crl/"),
       createSecurityLocationsIfNeeded(true),
       clientPrivateKey("PKI/client/private/client.pem"),
-      clientCertificate("PKI/client/certs/client.der")
+      clientCertificate("PKI/client/certs/client.der"),
+      parallelInvocationsEnable(false),
+      parallelInvocationsMaxSessions(8),
+      addressCacheMaxSize(100000),
+      addressCacheSnapshotPath(""),
+      addressCacheAutosaveIntervalSec(300.0),
+      addressCacheNegativeTtlSec(10.0),
+      persistedRequestsRetryMinSec(1.0),
+      persistedRequestsRetryMaxSec(60.0),
+      notificationQueueEnable(false),
+      notificationQueueSize(1024),
+      notificationDispatcherThreads(2),
+      latestValueCacheEnable(false),
+      subscriptionMaxMonitoredItems(0)
     {}
 
     // Constructor
@@ -94,9 +128,13 @@ namespace uaf
     : applicationName(applicationName),
       logToStdOutLevel(uaf::loglevels::Disabled),
       logToCallbackLevel(uaf::loglevels::Disabled),
+      logAsynchronously(false),
+      logBufferSize(1024),
+      logOverflowPolicy(uaf::logoverflowpolicies::Drop),
       discoveryUrls(discoveryUrls),
       discoveryFindServersTimeoutSec(2.0),
       discoveryGetEndpointsTimeoutSec(1.0),
+      discoveryEndpointsCacheTimeoutSec(60.0),
       discoveryIntervalSec(30.0),
       discoveryOnNetworkEnable(false),
       discoveryOnNetworkTimeoutSec(30.0),
@@ -109,7 +147,20 @@ namespace uaf
       issuersRevocationListLocation("PKI/issuers/crl/"),
       createSecurityLocationsIfNeeded(true),
       clientPrivateKey("PKI/client/private/client.pem"),
-      clientCertificate("PKI/client/certs/client.der")
+      clientCertificate("PKI/client/certs/client.der"),
+      parallelInvocationsEnable(false),
+      parallelInvocationsMaxSessions(8),
+      addressCacheMaxSize(100000),
+      addressCacheSnapshotPath(""),
+      addressCacheAutosaveIntervalSec(300.0),
+      addressCacheNegativeTtlSec(10.0),
+      persistedRequestsRetryMinSec(1.0),
+      persistedRequestsRetryMaxSec(60.0),
+      notificationQueueEnable(false),
+      notificationQueueSize(1024),
+      notificationDispatcherThreads(2),
+      latestValueCacheEnable(false),
+      subscriptionMaxMonitoredItems(0)
     {}
 
 
@@ -234,6 +285,19 @@ namespace uaf
         ss << ": "  << logToCallbackLevel
                     << "(" << uaf::loglevels::toString(logToCallbackLevel) << ")" << "\n";
 
+        ss << indent << " - logAsynchronously";
+        ss << fillToPos(ss, colon);
+        ss << ": " << (logAsynchronously ? "true" : "false") << "\n";
+
+        ss << indent << " - logBufferSize";
+        ss << fillToPos(ss, colon);
+        ss << ": " << logBufferSize << "\n";
+
+        ss << indent << " - logOverflowPolicy";
+        ss << fillToPos(ss, colon);
+        ss << ": "  << logOverflowPolicy
+                    << "(" << uaf::logoverflowpolicies::toString(logOverflowPolicy) << ")" << "\n";
+
         ss << indent << " - discoveryUrls[]";
 
         if (discoveryUrls.size() == 0)
@@ -265,6 +329,10 @@ namespace uaf
         ss << fillToPos(ss, colon);
         ss << ": " << discoveryGetEndpointsTimeoutSec << "\n";
 
+        ss << indent << " - discoveryEndpointsCacheTimeoutSec";
+        ss << fillToPos(ss, colon);
+        ss << ": " << discoveryEndpointsCacheTimeoutSec << "\n";
+
         ss << indent << " - discoveryOnNetworkEnable";
         ss << fillToPos(ss, colon);
         ss << ": " << (discoveryOnNetworkEnable ? "true" : "false") << "\n";
@@ -332,6 +400,58 @@ namespace uaf
         ss << fillToPos(ss, colon);
         ss << ": " << clientCertificate << "\n";
 
+        ss << indent << " - parallelInvocationsEnable";
+        ss << fillToPos(ss, colon);
+        ss << ": " << (parallelInvocationsEnable ? "true" : "false") << "\n";
+
+        ss << indent << " - parallelInvocationsMaxSessions";
+        ss << fillToPos(ss, colon);
+        ss << ": " << parallelInvocationsMaxSessions << "\n";
+
+        ss << indent << " - addressCacheMaxSize";
+        ss << fillToPos(ss, colon);
+        ss << ": " << addressCacheMaxSize << "\n";
+
+        ss << indent << " - addressCacheSnapshotPath";
+        ss << fillToPos(ss, colon);
+        ss << ": " << addressCacheSnapshotPath << "\n";
+
+        ss << indent << " - addressCacheAutosaveIntervalSec";
+        ss << fillToPos(ss, colon);
+        ss << ": " << addressCacheAutosaveIntervalSec << "\n";
+
+        ss << indent << " - addressCacheNegativeTtlSec";
+        ss << fillToPos(ss, colon);
+        ss << ": " << addressCacheNegativeTtlSec << "\n";
+
+        ss << indent << " - persistedRequestsRetryMinSec";
+        ss << fillToPos(ss, colon);
+        ss << ": " << persistedRequestsRetryMinSec << "\n";
+
+        ss << indent << " - persistedRequestsRetryMaxSec";
+        ss << fillToPos(ss, colon);
+        ss << ": " << persistedRequestsRetryMaxSec << "\n";
+
+        ss << indent << " - notificationQueueEnable";
+        ss << fillToPos(ss, colon);
+        ss << ": " << (notificationQueueEnable ? "true" : "false") << "\n";
+
+        ss << indent << " - notificationQueueSize";
+        ss << fillToPos(ss, colon);
+        ss << ": " << notificationQueueSize << "\n";
+
+        ss << indent << " - notificationDispatcherThreads";
+        ss << fillToPos(ss, colon);
+        ss << ": " << notificationDispatcherThreads << "\n";
+
+        ss << indent << " - latestValueCacheEnable";
+        ss << fillToPos(ss, colon);
+        ss << ": " << (latestValueCacheEnable ? "true" : "false") << "\n";
+
+        ss << indent << " - subscriptionMaxMonitoredItems";
+        ss << fillToPos(ss, colon);
+        ss << ": " << subscriptionMaxMonitoredItems << "\n";
+
         ss << indent << " - defaultSessionSettings\n";
         ss << defaultSessionSettings.toString(indent + "   ", colon) << "\n";
 
@@ -402,8 +522,12 @@ namespace uaf
                && object1.discoveryUrls == object2.discoveryUrls
                && object1.logToStdOutLevel == object2.logToStdOutLevel
                && object1.logToCallbackLevel == object2.logToCallbackLevel
+               && object1.logAsynchronously == object2.logAsynchronously
+               && object1.logBufferSize == object2.logBufferSize
+               && object1.logOverflowPolicy == object2.logOverflowPolicy
                && object1.discoveryFindServersTimeoutSec == object2.discoveryFindServersTimeoutSec
                && object1.discoveryGetEndpointsTimeoutSec == object2.discoveryGetEndpointsTimeoutSec
+               && object1.discoveryEndpointsCacheTimeoutSec == object2.discoveryEndpointsCacheTimeoutSec
                && object1.discoveryOnNetworkEnable == object2.discoveryOnNetworkEnable
                && object1.discoveryOnNetworkTimeoutSec == object2.discoveryOnNetworkTimeoutSec
                && object1.discoveryOnNetworkDiscoveryServer == object2.discoveryOnNetworkDiscoveryServer
@@ -416,7 +540,20 @@ namespace uaf
                && object1.issuersRevocationListLocation == object2.issuersRevocationListLocation
                && object1.createSecurityLocationsIfNeeded == object2.createSecurityLocationsIfNeeded
                && object1.clientPrivateKey == object2.clientPrivateKey
-               && object1.clientCertificate == object2.clientCertificate;
+               && object1.clientCertificate == object2.clientCertificate
+               && object1.parallelInvocationsEnable == object2.parallelInvocationsEnable
+               && object1.parallelInvocationsMaxSessions == object2.parallelInvocationsMaxSessions
+               && object1.addressCacheMaxSize == object2.addressCacheMaxSize
+               && object1.addressCacheSnapshotPath == object2.addressCacheSnapshotPath
+               && object1.addressCacheAutosaveIntervalSec == object2.addressCacheAutosaveIntervalSec
+               && object1.addressCacheNegativeTtlSec == object2.addressCacheNegativeTtlSec
+               && object1.persistedRequestsRetryMinSec == object2.persistedRequestsRetryMinSec
+               && object1.persistedRequestsRetryMaxSec == object2.persistedRequestsRetryMaxSec
+               && object1.notificationQueueEnable == object2.notificationQueueEnable
+               && object1.notificationQueueSize == object2.notificationQueueSize
+               && object1.notificationDispatcherThreads == object2.notificationDispatcherThreads
+               && object1.latestValueCacheEnable == object2.latestValueCacheEnable
+               && object1.subscriptionMaxMonitoredItems == object2.subscriptionMaxMonitoredItems;
     }
 
 
@@ -446,10 +583,18 @@ namespace uaf
             return object1.logToStdOutLevel < object2.logToStdOutLevel;
         else if (object1.logToCallbackLevel != object2.logToCallbackLevel)
             return object1.logToCallbackLevel < object2.logToCallbackLevel;
+        else if (object1.logAsynchronously != object2.logAsynchronously)
+            return object1.logAsynchronously < object2.logAsynchronously;
+        else if (object1.logBufferSize != object2.logBufferSize)
+            return object1.logBufferSize < object2.logBufferSize;
+        else if (object1.logOverflowPolicy != object2.logOverflowPolicy)
+            return object1.logOverflowPolicy < object2.logOverflowPolicy;
         else if (object1.discoveryFindServersTimeoutSec != object2.discoveryFindServersTimeoutSec)
             return object1.discoveryFindServersTimeoutSec < object2.discoveryFindServersTimeoutSec;
         else if (object1.discoveryGetEndpointsTimeoutSec != object2.discoveryGetEndpointsTimeoutSec)
             return object1.discoveryGetEndpointsTimeoutSec < object2.discoveryGetEndpointsTimeoutSec;
+        else if (object1.discoveryEndpointsCacheTimeoutSec != object2.discoveryEndpointsCacheTimeoutSec)
+            return object1.discoveryEndpointsCacheTimeoutSec < object2.discoveryEndpointsCacheTimeoutSec;
         else if (object1.discoveryOnNetworkEnable != object2.discoveryOnNetworkEnable)
             return object1.discoveryOnNetworkEnable < object2.discoveryOnNetworkEnable;
         else if (object1.discoveryOnNetworkTimeoutSec != object2.discoveryOnNetworkTimeoutSec)
@@ -472,8 +617,34 @@ namespace uaf
             return object1.createSecurityLocationsIfNeeded < object2.createSecurityLocationsIfNeeded;
         else if (object1.clientPrivateKey != object2.clientPrivateKey)
             return object1.clientPrivateKey < object2.clientPrivateKey;
-        else
+        else if (object1.clientCertificate != object2.clientCertificate)
             return object1.clientCertificate < object2.clientCertificate;
+        else if (object1.parallelInvocationsEnable != object2.parallelInvocationsEnable)
+            return object1.parallelInvocationsEnable < object2.parallelInvocationsEnable;
+        else if (object1.parallelInvocationsMaxSessions != object2.parallelInvocationsMaxSessions)
+            return object1.parallelInvocationsMaxSessions < object2.parallelInvocationsMaxSessions;
+        else if (object1.addressCacheMaxSize != object2.addressCacheMaxSize)
+            return object1.addressCacheMaxSize < object2.addressCacheMaxSize;
+        else if (object1.addressCacheSnapshotPath != object2.addressCacheSnapshotPath)
+            return object1.addressCacheSnapshotPath < object2.addressCacheSnapshotPath;
+        else if (object1.addressCacheAutosaveIntervalSec != object2.addressCacheAutosaveIntervalSec)
+            return object1.addressCacheAutosaveIntervalSec < object2.addressCacheAutosaveIntervalSec;
+        else if (object1.addressCacheNegativeTtlSec != object2.addressCacheNegativeTtlSec)
+            return object1.addressCacheNegativeTtlSec < object2.addressCacheNegativeTtlSec;
+        else if (object1.persistedRequestsRetryMinSec != object2.persistedRequestsRetryMinSec)
+            return object1.persistedRequestsRetryMinSec < object2.persistedRequestsRetryMinSec;
+        else if (object1.persistedRequestsRetryMaxSec != object2.persistedRequestsRetryMaxSec)
+            return object1.persistedRequestsRetryMaxSec < object2.persistedRequestsRetryMaxSec;
+        else if (object1.notificationQueueEnable != object2.notificationQueueEnable)
+            return object1.notificationQueueEnable < object2.notificationQueueEnable;
+        else if (object1.notificationQueueSize != object2.notificationQueueSize)
+            return object1.notificationQueueSize < object2.notificationQueueSize;
+        else if (object1.notificationDispatcherThreads != object2.notificationDispatcherThreads)
+            return object1.notificationDispatcherThreads < object2.notificationDispatcherThreads;
+        else if (object1.latestValueCacheEnable != object2.latestValueCacheEnable)
+            return object1.latestValueCacheEnable < object2.latestValueCacheEnable;
+        else
+            return object1.subscriptionMaxMonitoredItems < object2.subscriptionMaxMonitoredItems;
     }
 
 }
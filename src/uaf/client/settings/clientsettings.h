@@ -30,6 +30,7 @@
 // UAF
 #include "uaf/util/util.h"
 #include "uaf/util/loglevels.h"
+#include "uaf/util/logoverflowpolicies.h"
 #include "uaf/util/status.h"
 #include "uaf/util/stringifiable.h"
 #include "uaf/client/clientexport.h"
@@ -69,6 +70,7 @@ namespace uaf
          *  - localeId : ""
          *  - discoveryFindServersTimeoutSec : 2.0
          *  - discoveryGetEndpointsTimeoutSec : 1.0
+         *  - discoveryEndpointsCacheTimeoutSec : 60.0
          *  - discoveryIntervalSec : 30.0
          *  - discoveryOnNetworkEnable: false,
          *  - discoveryOnNetworkTimeoutSec: 30.0
@@ -78,6 +80,9 @@ namespace uaf
          *  - discoveryOnNetworkMaxRecordsToReturn: 0
          *  - logToStdOutLevel : uaf::loglevels::Disabled
          *  - logToCallbackLevel : uaf::loglevels::Disabled
+         *  - logAsynchronously : false
+         *  - logBufferSize : 1024
+         *  - logOverflowPolicy : uaf::logoverflowpolicies::Drop
          *  - certificateTrustListLocation : "PKI/trusted/certs/"
          *  - certificateRevocationListLocation : "PKI/trusted/crl/"
          *  - issuersCertificatesLocation : "PKI/issuers/certs/"
@@ -85,6 +90,19 @@ namespace uaf
          *  - createSecurityLocationsIfNeeded : true
          *  - clientPrivateKey : "PKI/client/private/client.pem"
          *  - clientCertificate : "PKI/client/certs/client.der"
+         *  - parallelInvocationsEnable : false
+         *  - parallelInvocationsMaxSessions : 8
+         *  - addressCacheMaxSize : 100000
+         *  - addressCacheSnapshotPath : ""
+         *  - addressCacheAutosaveIntervalSec : 300.0
+         *  - addressCacheNegativeTtlSec : 10.0
+         *  - persistedRequestsRetryMinSec : 1.0
+         *  - persistedRequestsRetryMaxSec : 60.0
+         *  - notificationQueueEnable : false
+         *  - notificationQueueSize : 1024
+         *  - notificationDispatcherThreads : 2
+         *  - latestValueCacheEnable : false
+         *  - subscriptionMaxMonitoredItems : 0
          */
         ClientSettings();
 
@@ -127,6 +145,19 @@ namespace uaf
         /** When logging to the callback interface, only log messages from at least this loglevel.*/
         uaf::loglevels::LogLevel logToCallbackLevel;
 
+        /**
+         * Log asynchronously: the threads that log messages (e.g. the threads processing the
+         * publish responses) only copy them to a buffer, and a background thread formats and
+         * writes them to the stdout and/or the callback interface.
+         */
+        bool logAsynchronously;
+
+        /** The number of messages that the buffer of the asynchronous logging can hold. */
+        uint32_t logBufferSize;
+
+        /** What to do with a message if the buffer of the asynchronous logging is full. */
+        uaf::logoverflowpolicies::LogOverflowPolicy logOverflowPolicy;
+
 
         /////// Discovery ///////
 
@@ -140,8 +171,13 @@ namespace uaf
         /** The timeout value for the GetEndpoints discovery service, in seconds. */
         float discoveryGetEndpointsTimeoutSec;
 
+        /** The time during which the endpoints that were fetched by the GetEndpoints discovery
+         *  service are reused (e.g. to reconnect sessions), in seconds. 0 to always fetch them. */
+        float discoveryEndpointsCacheTimeoutSec;
+
         /** The interval between discovery attempts which are continuously running in the
-         *  background, in seconds. */
+         *  background, in seconds. The sessions are checked (and reconnected if needed) at the
+         *  same interval, although a session that is lost is reconnected right away. */
         float discoveryIntervalSec;
 
         /** If true, the FindServersOnNetwork service will be called automatically, on every
@@ -234,6 +270,121 @@ namespace uaf
          *  Default: "PKI/client/certs/client.der". */
         std::string clientCertificate;
 
+
+        /////// Invocations ///////
+
+        /** If true, requests that need to be sent to multiple servers will be invoked on all these
+         *  servers at the same time, instead of one server after the other.
+         *
+         *  Only synchronous requests are concerned.
+         *
+         *  Default: false. */
+        bool parallelInvocationsEnable;
+
+        /** The maximum number of sessions that may be invoked at the same time, if
+         *  parallelInvocationsEnable is true.
+         *
+         *  Default: 8. */
+        uint32_t parallelInvocationsMaxSessions;
+
+
+        /////// Address resolution ///////
+
+        /** The maximum number of resolved addresses (i.e. ExpandedNodeIds and relative paths
+         *  translated into ExpandedNodeIds) that are cached. When the cache is full, the least
+         *  recently used addresses are evicted. 0 for no limit.
+         *
+         *  Default: 100000. */
+        uint32_t addressCacheMaxSize;
+
+        /** The path of the file to which the address cache is saved (when the client is destroyed,
+         *  and every addressCacheAutosaveIntervalSec seconds), and from which it is restored (when
+         *  this setting is changed). This avoids having to resolve all relative paths again after
+         *  the client has been restarted. An empty string means that no snapshot is used.
+         *
+         *  Default: "" (no snapshot). */
+        std::string addressCacheSnapshotPath;
+
+        /** The interval in seconds at which the address cache is saved to the
+         *  addressCacheSnapshotPath. 0 means that the cache is only saved when the client is
+         *  destroyed.
+         *
+         *  Default: 300.0. */
+        float addressCacheAutosaveIntervalSec;
+
+        /** The time in seconds that addresses which could not be resolved (because the server
+         *  reported that they don't exist, e.g. BadNoMatch) are cached, so that they are not
+         *  retried against the server for every request. 0 means that such failures are not
+         *  cached.
+         *
+         *  Default: 10.0. */
+        float addressCacheNegativeTtlSec;
+
+
+        /////// Persisted requests ///////
+
+        /** The delay in seconds before the persisted requests (e.g. monitored items) that
+         *  failed for a server are retried for the first time. Each subsequent failure doubles
+         *  the delay, up to persistedRequestsRetryMaxSec. When the session to the server is
+         *  (re)connected, the failed requests are retried immediately.
+         *
+         *  Default: 1.0. */
+        float persistedRequestsRetryMinSec;
+
+        /** The maximum delay in seconds between two retries of the persisted requests that
+         *  failed for a server.
+         *
+         *  Default: 60.0. */
+        float persistedRequestsRetryMaxSec;
+
+
+        /////// Notifications ///////
+
+        /** True to deliver the notifications of the subscriptions (data changes and events) on
+         *  dedicated dispatcher threads, instead of on the SDK thread that received them.
+         *  This way, a slow callback doesn't delay the next publish request of the subscription.
+         *
+         *  Default: false. */
+        bool notificationQueueEnable;
+
+        /** The maximum number of publish responses that can be queued per subscription, if
+         *  notificationQueueEnable is true. The notifications of a publish response that
+         *  doesn't fit anymore are dropped. Only applies to subscriptions that are created
+         *  after the setting was changed.
+         *
+         *  Default: 1024. */
+        uint32_t notificationQueueSize;
+
+        /** The number of threads that deliver the queued notifications (the notifications of
+         *  a single subscription are always delivered in order, by one thread at a time).
+         *
+         *  Default: 2. */
+        uint32_t notificationDispatcherThreads;
+
+
+        /////// Latest value cache ///////
+
+        /** If true, the latest value of each monitored data item is kept in a cache, from which
+         *  Client::readCached() can read it without a round trip to the server. Only the
+         *  monitored items that are created while this setting is true are cached.
+         *
+         *  Default: false. */
+        bool latestValueCacheEnable;
+
+
+        /////// Partitioning of monitored items ///////
+
+        /** The maximum number of monitored items per subscription, or 0 for no maximum. If
+         *  non-zero, the monitored items that are created without a ClientSubscriptionHandle
+         *  are spread over as many subscriptions (with the same subscription settings) as
+         *  needed, and the monitored items of such a subscription all have the same sampling
+         *  interval. Asynchronous requests are not spread. If one of the subscriptions fails,
+         *  only the targets that belong to it get the error as their status.
+         *
+         *  Default: 0. */
+        uint32_t subscriptionMaxMonitoredItems;
+
+
         /**
          * The Default service settings
          */
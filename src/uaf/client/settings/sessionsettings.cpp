@@ -71,6 +71,29 @@ namespace uaf
     }
 
 
+    // Get a fingerprint
+    // =============================================================================================
+    size_t SessionSettings::fingerprint() const
+    {
+        // only hash what is compared by operator==, in the same way (e.g. floats in ms)
+        size_t seed = 0;
+        hashCombine(seed, int(sessionTimeoutSec*1000));
+        hashCombine(seed, int(connectTimeoutSec*1000));
+        hashCombine(seed, int(watchdogTimeoutSec*1000));
+        hashCombine(seed, int(watchdogTimeSec*1000));
+        hashCombine(seed, unique);
+        hashCombine(seed, int(readServerInfoSettings.callTimeoutSec*1000));
+        hashCombine(seed, securitySettings.securityPolicy);
+        hashCombine(seed, int(securitySettings.messageSecurityMode));
+        hashCombine(seed, int(securitySettings.userTokenType));
+        hashCombine(seed, securitySettings.userName);
+        hashCombine(seed, securitySettings.userPassword);
+        hashCombine(seed, securitySettings.userCertificateFileName);
+        hashCombine(seed, securitySettings.userPrivateKeyFileName);
+        return seed;
+    }
+
+
     // operator<
     // =============================================================================================
     bool operator<(
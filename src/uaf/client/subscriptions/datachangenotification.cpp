@@ -39,7 +39,8 @@ namespace uaf
     // Constructor
     // =============================================================================================
     DataChangeNotification::DataChangeNotification()
-    : MonitoredItemNotification()
+    : MonitoredItemNotification(),
+      DataValue()
     {}
 
 
@@ -54,9 +55,7 @@ namespace uaf
         ss << indent << " - status";
         ss << fillToPos(ss, colon);
         ss << ": " << status.toString() << "\n";
-        ss << indent << " - data";
-        ss << fillToPos(ss, colon);
-        ss << ": " << data.toString();
+        ss << DataValue::toString(indent, colon);
         return ss.str();
     }
 
@@ -67,7 +66,8 @@ namespace uaf
     {
         return    object1.clientHandle == object2.clientHandle
                && object1.status == object2.status
-               && object1.data == object2.data;
+               &&    static_cast<const DataValue&>(object1)
+                  == static_cast<const DataValue&>(object2);
     }
 
 
@@ -88,7 +88,7 @@ namespace uaf
         else if (object1.status != object2.status)
             return object1.status < object2.status;
         else
-            return object1.data < object2.data;
+            return static_cast<const DataValue&>(object1) < static_cast<const DataValue&>(object2);
     }
 
 
@@ -30,6 +30,7 @@
 // UAF
 #include "uaf/util/status.h"
 #include "uaf/util/variant.h"
+#include "uaf/util/datavalue.h"
 #include "uaf/util/logger.h"
 #include "uaf/util/address.h"
 #include "uaf/util/stringifiable.h"
@@ -46,9 +47,13 @@ namespace uaf
     /*******************************************************************************************//**
     * A uaf::DataChangeNotification is a notification for a monitored data item.
     *
+    * Besides the new data, it holds the full DataValue that was received (i.e. also the status
+    * code, the timestamps and picoseconds).
+    *
     * @ingroup ClientSubscriptions
     ***********************************************************************************************/
-    class UAF_EXPORT DataChangeNotification : public MonitoredItemNotification
+    class UAF_EXPORT DataChangeNotification : public MonitoredItemNotification,
+                                              public uaf::DataValue
     {
     public:
 
@@ -62,10 +67,6 @@ namespace uaf
         uaf::Status status;
 
 
-        /** The new data value. */
-        uaf::Variant data;
-
-
         /**
          * Get a string representation of the data notification.
          */
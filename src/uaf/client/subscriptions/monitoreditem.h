@@ -72,6 +72,10 @@ namespace uaf
 
         /** The revised queue size on the server side. */
         uint32_t revisedQueueSize;
+
+        /** True if the server has created the monitored item (as far as the client knows, i.e.
+         * according to the result of the synchronous request that tried to create it). */
+        bool created;
     };
 }
 
@@ -0,0 +1,145 @@
+/* This file is part of the UAF (Unified Architecture Framework) project.
+ *
+ * Copyright (C) 2012 Wim Pessemier (Institute of Astronomy, KULeuven)
+ *
+ * Project website: http://www.ster.kuleuven.be/uaf
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef UAF_NOTIFICATIONBATCH_H_
+#define UAF_NOTIFICATIONBATCH_H_
+
+
+// STD
+#include <vector>
+#include <utility>
+// SDK
+// UAF
+#include "uaf/util/util.h"
+#include "uaf/client/clientexport.h"
+#include "uaf/client/clientinterface.h"
+#include "uaf/client/subscriptions/datachangenotification.h"
+#include "uaf/client/subscriptions/eventnotification.h"
+
+
+namespace uaf
+{
+
+
+    /*******************************************************************************************//**
+    * A uaf::NotificationBatch holds the notifications of a single publish response.
+    *
+    * A batch is filled once (by the thread that receives the publish response), and from then on
+    * it is only moved (e.g. into and out of a uaf::NotificationQueue) until it is delivered to
+    * the client interface by const reference. It cannot be copied, so the notifications are never
+    * copied on their way to the callbacks.
+    *
+    * @ingroup ClientSubscriptions
+    ***********************************************************************************************/
+    class UAF_EXPORT NotificationBatch
+    {
+    public:
+
+
+        /**
+         * Construct an empty batch.
+         */
+        NotificationBatch() {}
+
+
+        /**
+         * Move constructor.
+         *
+         * @param other The batch to take the notifications from (it will be empty afterwards).
+         */
+        NotificationBatch(NotificationBatch&& other)
+        : dataNotifications(std::move(other.dataNotifications)),
+          eventNotifications(std::move(other.eventNotifications))
+        {
+            other.clear();
+        }
+
+
+        /**
+         * Move assignment operator.
+         *
+         * @param other The batch to take the notifications from (it will be empty afterwards).
+         * @return      Reference to this instance.
+         */
+        NotificationBatch& operator=(NotificationBatch&& other)
+        {
+            if (this != &other)
+            {
+                dataNotifications  = std::move(other.dataNotifications);
+                eventNotifications = std::move(other.eventNotifications);
+                other.clear();
+            }
+            return *this;
+        }
+
+
+        /** The data change notifications (if the batch contains data changes). */
+        std::vector<uaf::DataChangeNotification> dataNotifications;
+
+        /** The event notifications (if the batch contains events). */
+        std::vector<uaf::EventNotification> eventNotifications;
+
+
+        /**
+         * Get the number of notifications of the batch.
+         */
+        std::size_t size() const { return dataNotifications.size() + eventNotifications.size(); }
+
+
+        /**
+         * Check if the batch contains no notifications.
+         */
+        bool empty() const { return dataNotifications.empty() && eventNotifications.empty(); }
+
+
+        /**
+         * Remove all notifications from the batch.
+         */
+        void clear()
+        {
+            dataNotifications.clear();
+            eventNotifications.clear();
+        }
+
+
+        /**
+         * Deliver the notifications to a client interface (by const reference).
+         *
+         * @param clientInterface   The interface to deliver the notifications to.
+         */
+        void deliverTo(uaf::ClientInterface* clientInterface) const
+        {
+            if (!dataNotifications.empty())
+                clientInterface->dataChangeBatchReceived(dataNotifications);
+            if (!eventNotifications.empty())
+                clientInterface->eventBatchReceived(eventNotifications);
+        }
+
+
+    private:
+
+        DISALLOW_COPY_AND_ASSIGN(NotificationBatch);
+    };
+
+}
+
+
+#endif /* UAF_NOTIFICATIONBATCH_H_ */
@@ -0,0 +1,201 @@
+/* This file is part of the UAF (Unified Architecture Framework) project.
+ *
+ * Copyright (C) 2012 Wim Pessemier (Institute of Astronomy, KULeuven)
+ *
+ * Project website: http://www.ster.kuleuven.be/uaf
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "uaf/client/subscriptions/notificationdispatcher.h"
+
+
+namespace uaf
+{
+    using namespace uaf;
+    using std::size_t;
+    using std::shared_ptr;
+
+
+    // the maximum number of queues waiting for a thread of the pool
+    static const size_t DISPATCHER_QUEUE_SIZE = 4096;
+
+
+    // A job to drain a queue
+    // =============================================================================================
+    class NotificationDispatcher::DrainJob : public ThreadPoolJob
+    {
+    public:
+        DrainJob(NotificationDispatcher*            dispatcher,
+                 Pool*                              pool,
+                 const shared_ptr<NotificationQueue>& queue)
+        : ThreadPoolJob(true),
+          dispatcher_(dispatcher),
+          pool_(pool),
+          queue_(queue)
+        {
+            pool_->noOfPendingJobs.fetch_add(1);
+        }
+
+        void execute()
+        {
+            dispatcher_->drain(queue_);
+
+            // from now on, the pool may be deleted (after this job has returned)
+            pool_->noOfPendingJobs.fetch_sub(1);
+        }
+
+    private:
+        NotificationDispatcher*         dispatcher_;
+        Pool*                           pool_;
+        shared_ptr<NotificationQueue>   queue_;
+    };
+
+
+    // Constructor
+    // =============================================================================================
+    NotificationDispatcher::NotificationDispatcher()
+    : noOfThreads_(1),
+      pool_(0),
+      queueDepth_(0),
+      maxQueueDepth_(0),
+      noOfDroppedNotifications_(0)
+    {}
+
+
+    // Destructor
+    // =============================================================================================
+    NotificationDispatcher::~NotificationDispatcher()
+    {
+        UaMutexLocker locker(&poolMutex_); // unlocks when out of scope
+
+        // the pools finish their jobs before they are deleted
+        delete pool_;
+        pool_ = 0;
+
+        for (size_t i = 0; i < retiredPools_.size(); i++)
+            delete retiredPools_[i];
+        retiredPools_.clear();
+    }
+
+
+    // Set the number of threads
+    // =============================================================================================
+    void NotificationDispatcher::setNoOfThreads(size_t noOfThreads)
+    {
+        UaMutexLocker locker(&poolMutex_); // unlocks when out of scope
+        noOfThreads_ = noOfThreads > 0 ? noOfThreads : 1;
+
+        deleteIdleRetiredPools();
+    }
+
+
+    // Get the pool
+    // =============================================================================================
+    NotificationDispatcher::Pool* NotificationDispatcher::pool()
+    {
+        UaMutexLocker locker(&poolMutex_); // unlocks when out of scope
+
+        if (pool_ != 0 && pool_->threadPool.noOfThreads() != noOfThreads_)
+        {
+            retiredPools_.push_back(pool_);
+            pool_ = 0;
+        }
+
+        if (pool_ == 0)
+            pool_ = new Pool(noOfThreads_, DISPATCHER_QUEUE_SIZE);
+
+        deleteIdleRetiredPools();
+
+        return pool_;
+    }
+
+
+    // Delete the replaced pools that are idle
+    // =============================================================================================
+    void NotificationDispatcher::deleteIdleRetiredPools()
+    {
+        // a pool without pending jobs has only idle threads (or threads that are just returning
+        // from their last job), so it can be deleted without waiting for a callback of the user
+        // (and the calling thread can't be one of its threads, since it would be a pending job)
+        for (size_t i = 0; i < retiredPools_.size(); )
+        {
+            if (retiredPools_[i]->noOfPendingJobs.load() == 0)
+            {
+                delete retiredPools_[i];
+                retiredPools_.erase(retiredPools_.begin() + i);
+            }
+            else
+            {
+                i++;
+            }
+        }
+    }
+
+
+    // Queue a batch
+    // =============================================================================================
+    bool NotificationDispatcher::dispatch(
+            const shared_ptr<NotificationQueue>&    queue,
+            NotificationBatch&&                     batch)
+    {
+        uint64_t size = batch.size();
+
+        // update the depth before the batch can be delivered (and subtracted again)
+        uint64_t depth = queueDepth_.fetch_add(size) + size;
+
+        if (!queue->push(std::move(batch)))
+        {
+            queueDepth_.fetch_sub(size);
+            noOfDroppedNotifications_.fetch_add(size);
+            return false;
+        }
+
+        uint64_t maxDepth = maxQueueDepth_.load();
+        while (depth > maxDepth && !maxQueueDepth_.compare_exchange_weak(maxDepth, depth)) {}
+
+        // if no thread is draining the queue yet, let a thread of the pool do it
+        if (queue->tryStartDraining())
+        {
+            // if even the pool is full (which is very unlikely, since a queue is never waiting
+            // more than once), the notifications are delivered by the calling thread
+            Pool* currentPool = pool();
+            DrainJob* job = new DrainJob(this, currentPool, queue);
+
+            if (!currentPool->threadPool.addJob(job, false))
+            {
+                // the job was refused, so it is neither executed nor deleted by the pool
+                currentPool->noOfPendingJobs.fetch_sub(1);
+                delete job;
+                drain(queue);
+            }
+        }
+
+        return true;
+    }
+
+
+    // Drain a queue
+    // =============================================================================================
+    void NotificationDispatcher::drain(const shared_ptr<NotificationQueue>& queue)
+    {
+        do
+        {
+            queueDepth_.fetch_sub(queue->drain());
+        }
+        while (queue->stopDraining());
+    }
+
+}
@@ -0,0 +1,152 @@
+/* This file is part of the UAF (Unified Architecture Framework) project.
+ *
+ * Copyright (C) 2012 Wim Pessemier (Institute of Astronomy, KULeuven)
+ *
+ * Project website: http://www.ster.kuleuven.be/uaf
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef UAF_NOTIFICATIONDISPATCHER_H_
+#define UAF_NOTIFICATIONDISPATCHER_H_
+
+
+// STD
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <stdint.h>
+// SDK
+#include "uabasecpp/uamutex.h"
+// UAF
+#include "uaf/util/util.h"
+#include "uaf/util/threadpool.h"
+#include "uaf/client/clientexport.h"
+#include "uaf/client/subscriptions/notificationqueue.h"
+
+
+namespace uaf
+{
+
+
+    /*******************************************************************************************//**
+    * A uaf::NotificationDispatcher delivers the notifications of the subscriptions to the client
+    * interface, on a pool of dedicated threads instead of on the SDK thread that received them.
+    *
+    * This way, a slow callback of the user doesn't delay the next publish request of the
+    * subscription (which could cause notifications to be lost on the server side). Each
+    * subscription has its own uaf::NotificationQueue: when it is full, the new notifications are
+    * dropped (and counted) rather than blocking the SDK thread.
+    *
+    * @ingroup ClientSubscriptions
+    ***********************************************************************************************/
+    class UAF_EXPORT NotificationDispatcher
+    {
+    public:
+
+
+        /**
+         * Construct a dispatcher (the threads are only started when needed).
+         */
+        NotificationDispatcher();
+
+
+        /**
+         * Destruct the dispatcher, after the queues that are being drained have been delivered.
+         */
+        ~NotificationDispatcher();
+
+
+        /**
+         * Set the number of threads that deliver the notifications.
+         *
+         * @param noOfThreads   The number of threads (at least 1).
+         */
+        void setNoOfThreads(std::size_t noOfThreads);
+
+
+        /**
+         * Add a batch of notifications to a queue, and make sure it will be delivered.
+         *
+         * @param queue The queue of the subscription that received the notifications.
+         * @param batch The batch to move into the queue (it is dropped if the queue is full).
+         * @return      True if the batch was queued, false if it was dropped.
+         */
+        bool dispatch(const std::shared_ptr<uaf::NotificationQueue>& queue,
+                      uaf::NotificationBatch&& batch);
+
+
+        /**
+         * Get the number of notifications that are queued, but not delivered yet.
+         */
+        uint64_t queueDepth() const { return queueDepth_.load(); }
+
+
+        /**
+         * Get the highest number of notifications that were queued at the same time.
+         */
+        uint64_t maxQueueDepth() const { return maxQueueDepth_.load(); }
+
+
+        /**
+         * Get the number of notifications that were dropped because a queue was full.
+         */
+        uint64_t noOfDroppedNotifications() const { return noOfDroppedNotifications_.load(); }
+
+
+    private:
+
+        DISALLOW_COPY_AND_ASSIGN(NotificationDispatcher);
+
+        // a job that drains a queue
+        class DrainJob;
+
+        // a pool of threads, and the number of its drain jobs that are not finished yet
+        struct Pool
+        {
+            Pool(std::size_t noOfThreads, std::size_t maxQueueSize)
+            : threadPool(noOfThreads, maxQueueSize), noOfPendingJobs(0) {}
+
+            uaf::ThreadPool         threadPool;
+            std::atomic<uint32_t>   noOfPendingJobs;
+        };
+
+        // drain a queue until it's empty (and no other thread needs to drain it)
+        void drain(const std::shared_ptr<uaf::NotificationQueue>& queue);
+
+        // get the pool, and (re)create it if the number of threads has changed
+        Pool* pool();
+
+        // delete the replaced pools that have no pending jobs anymore (poolMutex_ must be locked)
+        void deleteIdleRetiredPools();
+
+        // the number of threads of the pool
+        std::size_t                     noOfThreads_;
+        // the pool, and the pools that were replaced because the number of threads was changed
+        // (they are deleted as soon as they have finished their drain jobs)
+        Pool*                           pool_;
+        std::vector<Pool*>              retiredPools_;
+        // mutex to protect the members above
+        UaMutex                         poolMutex_;
+        // the metrics
+        std::atomic<uint64_t>           queueDepth_;
+        std::atomic<uint64_t>           maxQueueDepth_;
+        std::atomic<uint64_t>           noOfDroppedNotifications_;
+    };
+
+}
+
+
+#endif /* UAF_NOTIFICATIONDISPATCHER_H_ */
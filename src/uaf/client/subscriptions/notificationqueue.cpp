@@ -0,0 +1,125 @@
+/* This file is part of the UAF (Unified Architecture Framework) project.
+ *
+ * Copyright (C) 2012 Wim Pessemier (Institute of Astronomy, KULeuven)
+ *
+ * Project website: http://www.ster.kuleuven.be/uaf
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "uaf/client/subscriptions/notificationqueue.h"
+
+
+namespace uaf
+{
+    using namespace uaf;
+
+
+    // Constructor
+    // =============================================================================================
+    NotificationQueue::NotificationQueue(ClientInterface* clientInterface, uint32_t capacity)
+    : clientInterface_(clientInterface),
+      buffer_(capacity),
+      draining_(false),
+      closed_(false)
+    {}
+
+
+    // Destructor
+    // =============================================================================================
+    NotificationQueue::~NotificationQueue()
+    {
+        // the batches that were not delivered are destroyed together with the buffer
+    }
+
+
+    // Add a batch
+    // =============================================================================================
+    bool NotificationQueue::push(NotificationBatch&& batch)
+    {
+        uint64_t position;
+        NotificationBatch* element = buffer_.claim(position);
+
+        // the queue is full
+        if (element == 0)
+            return false;
+
+        *element = std::move(batch);
+
+        // publish the batch to the draining thread (sequentially consistent, so that either
+        // stopDraining() sees the batch, or the producer sees that nobody is draining the queue)
+        buffer_.publish(position);
+
+        return true;
+    }
+
+
+    // Take the next batch
+    // =============================================================================================
+    bool NotificationQueue::pop(NotificationBatch& batch)
+    {
+        NotificationBatch* element = buffer_.front();
+
+        if (element == 0)
+            return false;
+
+        batch = std::move(*element);
+
+        // free the element for the next rotation of the buffer
+        buffer_.pop();
+
+        return true;
+    }
+
+
+    // Try to start draining
+    // =============================================================================================
+    bool NotificationQueue::tryStartDraining()
+    {
+        return !draining_.exchange(true);
+    }
+
+
+    // Stop draining
+    // =============================================================================================
+    bool NotificationQueue::stopDraining()
+    {
+        draining_.store(false);
+
+        // a producer may have added a batch just before we stopped, while still believing that
+        // we would deliver it
+        return !isEmpty() && tryStartDraining();
+    }
+
+
+    // Deliver the queued batches
+    // =============================================================================================
+    uint64_t NotificationQueue::drain()
+    {
+        uint64_t ret = 0;
+
+        NotificationBatch batch;
+        while (pop(batch))
+        {
+            ret += batch.size();
+
+            if (!closed_.load())
+                batch.deliverTo(clientInterface_);
+        }
+
+        return ret;
+    }
+
+}
@@ -0,0 +1,160 @@
+/* This file is part of the UAF (Unified Architecture Framework) project.
+ *
+ * Copyright (C) 2012 Wim Pessemier (Institute of Astronomy, KULeuven)
+ *
+ * Project website: http://www.ster.kuleuven.be/uaf
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef UAF_NOTIFICATIONQUEUE_H_
+#define UAF_NOTIFICATIONQUEUE_H_
+
+
+// STD
+#include <vector>
+#include <atomic>
+#include <stdint.h>
+// SDK
+// UAF
+#include "uaf/util/util.h"
+#include "uaf/util/boundedringbuffer.h"
+#include "uaf/client/clientexport.h"
+#include "uaf/client/clientinterface.h"
+#include "uaf/client/subscriptions/notificationbatch.h"
+
+
+namespace uaf
+{
+
+
+    /*******************************************************************************************//**
+    * A uaf::NotificationQueue holds the notifications of a single subscription that still need to
+    * be delivered to the client interface.
+    *
+    * The SDK thread that receives a publish response moves the notifications of the response (a
+    * uaf::NotificationBatch) into a uaf::BoundedRingBuffer, and a thread of the uaf::NotificationDispatcher
+    * takes them from the buffer and calls the client interface. Only one thread drains the queue
+    * at a time, so the notifications of a subscription are always delivered in order.
+    *
+    * @ingroup ClientSubscriptions
+    ***********************************************************************************************/
+    class UAF_EXPORT NotificationQueue
+    {
+    public:
+
+
+        /**
+         * Construct a queue.
+         *
+         * @param clientInterface   The interface to deliver the notifications to.
+         * @param capacity          The maximum number of queued batches (will be rounded up to
+         *                          the next power of two, with a minimum of 2).
+         */
+        NotificationQueue(uaf::ClientInterface* clientInterface, uint32_t capacity);
+
+
+        /**
+         * Destruct the queue, and discard the batches that were not delivered yet.
+         */
+        ~NotificationQueue();
+
+
+        /**
+         * Add a batch to the queue (this method can be called by any thread).
+         *
+         * @param batch The batch to move into the queue. It is left untouched if the queue is
+         *              full.
+         * @return      True if the batch was added, false if the queue was full.
+         */
+        bool push(uaf::NotificationBatch&& batch);
+
+
+        /**
+         * Deliver the queued batches to the client interface, until the queue is empty.
+         *
+         * Must only be called by the thread that successfully called tryStartDraining().
+         *
+         * @return  The number of notifications that were delivered (or discarded, if the queue
+         *          was closed).
+         */
+        uint64_t drain();
+
+
+        /**
+         * Try to become the (only) thread that drains the queue.
+         *
+         * @return True if the calling thread must drain the queue (and call stopDraining()
+         *         afterwards), false if another thread is already draining it.
+         */
+        bool tryStartDraining();
+
+
+        /**
+         * Stop draining the queue.
+         *
+         * @return True if batches were added in the meantime, and the calling thread is still
+         *         the one that must drain the queue. False if the calling thread is done.
+         */
+        bool stopDraining();
+
+
+        /**
+         * Check if the queue is empty.
+         */
+        bool isEmpty() const { return buffer_.isEmpty(); }
+
+
+        /**
+         * Check if the queue is idle, i.e. if it is empty and no thread is draining it (a
+         * draining thread may still be delivering a batch that it took from the queue already).
+         */
+        bool isIdle() const { return !draining_.load() && isEmpty(); }
+
+
+        /**
+         * Close the queue: batches that are still queued or added later will be discarded
+         * instead of delivered (e.g. because the subscription has been deleted).
+         */
+        void close() { closed_.store(true); }
+
+
+        /**
+         * Get the number of batches that the queue can hold.
+         */
+        uint32_t capacity() const { return buffer_.capacity(); }
+
+
+    private:
+
+        DISALLOW_COPY_AND_ASSIGN(NotificationQueue);
+
+        // move the next batch out of the buffer (false if the buffer is empty)
+        bool pop(uaf::NotificationBatch& batch);
+
+        // the interface to deliver the notifications to
+        uaf::ClientInterface*                           clientInterface_;
+        // the ring buffer (only the draining thread takes batches from it)
+        uaf::BoundedRingBuffer<uaf::NotificationBatch>  buffer_;
+        // true if a thread is draining the queue (or has been asked to)
+        std::atomic<bool>                               draining_;
+        // true if the batches must be discarded
+        std::atomic<bool>                               closed_;
+    };
+
+}
+
+
+#endif /* UAF_NOTIFICATIONQUEUE_H_ */
@@ -28,6 +28,7 @@ namespace uaf
     using std::vector;
     using std::map;
     using std::size_t;
+    using std::shared_ptr;
 
 
     // Constructor
@@ -59,9 +60,9 @@ namespace uaf
 
         uaSubscription_ = 0;
 
-        logger_->debug("Subscription %d has been constructed", clientSubscriptionHandle);
-        logger_->debug("Subscription settings:");
-        logger_->debug(subscriptionSettings.toString());
+        UAF_LOG_DEBUG(logger_, "Subscription %d has been constructed", clientSubscriptionHandle);
+        UAF_LOG_DEBUG(logger_, "Subscription settings:");
+        UAF_LOG_DEBUG(logger_, subscriptionSettings.toString());
     }
 
 
@@ -69,11 +70,16 @@ namespace uaf
     // =============================================================================================
     Subscription::~Subscription()
     {
-        logger_->debug("Now destructing the subscription");
+        UAF_LOG_DEBUG(logger_, "Now destructing the subscription");
 
         // try to delete the subscription
         Status status = deleteSubscription();
 
+        // notifications that are still queued are not delivered anymore
+        shared_ptr<NotificationQueue> queue = std::atomic_load(&notificationQueue_);
+        if (queue)
+            queue->close();
+
         // Don't delete the uaSubscription_, it is owned by uaSession_!
         // And also don't delete the uaSession_ here, it is owned by uaf::Session!
 
@@ -86,7 +92,7 @@ namespace uaf
     Status Subscription::createSubscription()
     {
 
-        logger_->debug("Creating the subscription to the server");
+        UAF_LOG_DEBUG(logger_, "Creating the subscription to the server");
 
         Status ret;
 
@@ -112,7 +118,7 @@ namespace uaf
         if (ret.isGood())
         {
             setSubscriptionState(uaf::subscriptionstates::Created);
-            logger_->debug("The subscription has been successfully created to the server");
+            UAF_LOG_DEBUG(logger_, "The subscription has been successfully created to the server");
         }
         else
         {
@@ -133,8 +139,8 @@ namespace uaf
 
             if (isCreated())
             {
-                logger_->debug("Now deleting subscription %d and thereby deleting all monitored items",
-                               clientSubscriptionHandle_);
+                UAF_LOG_DEBUG(logger_, "Now deleting subscription %d and thereby deleting all monitored items",
+                                       clientSubscriptionHandle_);
                 UaClientSdk::ServiceSettings serviceSettings;
                 SdkStatus sdkStatus = uaSession_->deleteSubscription(serviceSettings, &uaSubscription_);
 
@@ -145,8 +151,8 @@ namespace uaf
             }
             else
             {
-                logger_->debug("No need to delete subscription %d on the server side, as it was " \
-                               "already deleted", clientSubscriptionHandle_);
+                UAF_LOG_DEBUG(logger_, "No need to delete subscription %d on the server side, as it was " \
+                                       "already deleted", clientSubscriptionHandle_);
                 ret = statuscodes::Good;
             }
         }
@@ -155,13 +161,26 @@ namespace uaf
             ret = SessionNotConnectedError();
         }
 
+        // the monitored data items, of which the cached values must be removed
+        vector<ClientHandle> dataClientHandles;
+
+        // take the monitored items out of the map (while it's locked), so that the persistent
+        // requests can be updated without holding the lock
+        MonitoredItemsMap monitoredItems;
+        monitoredItemsMapMutex_.lock();
+        monitoredItems.swap(monitoredItemsMap_);
+        monitoredItemsMapMutex_.unlock();
+
         // now update the persistent requests
-        MonitoredItemsMap::iterator it = monitoredItemsMap_.begin();
-        while (it != monitoredItemsMap_.end())
+        for (MonitoredItemsMap::const_iterator it = monitoredItems.begin();
+             it != monitoredItems.end();
+             ++it)
         {
             // remove the notification buffer according to the kind
             if (it->second.settings.kind() == MonitoredItemSettings::Data)
             {
+                dataClientHandles.push_back(it->first);
+
                 if (deletePersistentRequest)
                     database_->createMonitoredDataRequestStore.remove(
                             it->second.requestHandle);
@@ -182,15 +201,14 @@ namespace uaf
                             it->second.targetRank,
                             SubscriptionHasBeenDeletedError());
             }
-
-            // remove the monitoredItemsMap_ entry
-            monitoredItemsMap_.erase(it++);
         }
 
+        database_->latestValueCache.remove(dataClientHandles);
+
         // log the result
         if (ret.isGood())
         {
-            logger_->debug("The subscription has been deleted successfully");
+            UAF_LOG_DEBUG(logger_, "The subscription has been deleted successfully");
             setSubscriptionState(uaf::subscriptionstates::Deleted);
         } else
         {
@@ -234,8 +252,8 @@ namespace uaf
             const ServiceSettings&          serviceSettings,
             vector<Status>&                 results)
     {
-        logger_->debug("Setting the monitored item mode to %s",
-                       uaf::monitoringmodes::toString(monitoringMode).c_str());
+        UAF_LOG_DEBUG(logger_, "Setting the monitored item mode to %s",
+                               uaf::monitoringmodes::toString(monitoringMode).c_str());
 
         Status ret;
 
@@ -270,8 +288,8 @@ namespace uaf
 
         if (realSize > 0)
         {
-            logger_->debug("The following client handles were found: [%s]",
-                           uaf::uint32ArrayToString(handlesToChange).c_str());
+            UAF_LOG_DEBUG(logger_, "The following client handles were found: [%s]",
+                                   uaf::uint32ArrayToString(handlesToChange).c_str());
 
             // don't forget to resize the ranks and ids now to their real size:
             ranks.resize(realSize);
@@ -295,7 +313,7 @@ namespace uaf
                 ret = SetMonitoringModeInvocationError(sdkStatus);
 
 
-            logger_->debug("Result of OPC UA service call: %s", ret.toString().c_str());
+            UAF_LOG_DEBUG(logger_, "Result of OPC UA service call: %s", ret.toString().c_str());
 
             if (ret.isGood())
             {
@@ -313,7 +331,7 @@ namespace uaf
         }
         else
         {
-            logger_->debug("The client handles do not belong to this subscription, skipping");
+            UAF_LOG_DEBUG(logger_, "The client handles do not belong to this subscription, skipping");
             // ret remains Uncertain
         }
 
@@ -327,8 +345,8 @@ namespace uaf
     void Subscription::setSubscriptionState(
             uaf::subscriptionstates::SubscriptionState subscriptionState)
     {
-        logger_->debug("The subscription status has changed to %s",
-                       uaf::subscriptionstates::toString(subscriptionState).c_str());
+        UAF_LOG_DEBUG(logger_, "The subscription status has changed to %s",
+                               uaf::subscriptionstates::toString(subscriptionState).c_str());
         Subscription::subscriptionState_ = subscriptionState;
 
         // call the callback interface
@@ -374,11 +392,29 @@ namespace uaf
     }
 
 
+    // Get the number of monitored items
+    // =============================================================================================
+    size_t Subscription::noOfMonitoredItems()
+    {
+        UaMutexLocker locker(&monitoredItemsMapMutex_); // unlocks when locker goes out of scope
+
+        size_t ret = 0;
+        for (MonitoredItemsMap::const_iterator it = monitoredItemsMap_.begin();
+             it != monitoredItemsMap_.end();
+             ++it)
+        {
+            if (it->second.created)
+                ret++;
+        }
+        return ret;
+    }
+
+
     // keep the subscription alive
     // =============================================================================================
     void Subscription::keepAlive()
     {
-        logger_->debug("The subscription is still alive");
+        UAF_LOG_DEBUG(logger_, "The subscription is still alive");
 
         // create the notification
         KeepAliveNotification notification;
@@ -395,6 +431,10 @@ namespace uaf
                 it != monitoredItemsMap_.end(); ++it)
             notification.clientHandles.push_back(it->first);
 
+        // the cached values of the monitored items are still the latest ones
+        if (database_->clientSettings.latestValueCacheEnable)
+            database_->latestValueCache.confirm(notification.clientHandles);
+
         // call the callback interface
         clientInterface_->keepAliveReceived(notification);
     }
@@ -410,41 +450,52 @@ namespace uaf
         uint32_t noOfNotifications = dataNotifications.length();
 
         // create the notifications
-        vector<DataChangeNotification> notifications;
+        NotificationBatch batch;
+        vector<DataChangeNotification>& notifications = batch.dataNotifications;
+        notifications.reserve(noOfNotifications);
 
-        logger_->debug("A total of %d data notifications were received", noOfNotifications);
+        UAF_LOG_DEBUG(logger_, "A total of %d data notifications were received", noOfNotifications);
 
-        // fill the notifications
-        for (uint32_t i=0; i < noOfNotifications; i++)
+        // fill the notifications (while the monitored items can't be deleted meanwhile)
         {
-            ClientHandle clientHandle = dataNotifications[i].ClientHandle;
+            UaMutexLocker locker(&monitoredItemsMapMutex_); // unlocks when locker goes out of scope
 
-            MonitoredItemsMap::const_iterator it = monitoredItemsMap_.find(clientHandle);
-
-            // update the contents of the notification
-            if (it != monitoredItemsMap_.end())
+            for (uint32_t i=0; i < noOfNotifications; i++)
             {
-                DataChangeNotification notification;
+                ClientHandle clientHandle = dataNotifications[i].ClientHandle;
 
-                notification.clientHandle       = clientHandle;
-                notification.data               = dataNotifications[i].Value.Value;
+                MonitoredItemsMap::const_iterator it = monitoredItemsMap_.find(clientHandle);
 
-                if (OpcUa_IsGood(dataNotifications[i].Value.StatusCode))
-                    notification.status = statuscodes::Good;
-                else
-                    notification.status = BadDataReceivedError(SdkStatus(dataNotifications[i].Value.StatusCode));
+                // update the contents of the notification
+                if (it != monitoredItemsMap_.end())
+                {
+                    // add a notification to the vector of notifications for the callback, and fill
+                    // it in place (directly from the SDK DataValue)
+                    notifications.push_back(DataChangeNotification());
+                    DataChangeNotification& notification = notifications.back();
 
-                // add it to the vector of notifications for the callback
-                notifications.push_back(notification);
+                    notification.clientHandle = clientHandle;
+                    notification.fromSdk(dataNotifications[i].Value);
 
-                // log the notification
-                logger_->debug(" - Notification %d:", int(i));
-                logger_->debug(notification.toString("   ", 25));
+                    if (OpcUa_IsGood(dataNotifications[i].Value.StatusCode))
+                        notification.status = statuscodes::Good;
+                    else
+                        notification.status = BadDataReceivedError(
+                                SdkStatus(dataNotifications[i].Value.StatusCode));
+
+                    // log the notification
+                    UAF_LOG_DEBUG(logger_, " - Notification %d:", int(i));
+                    UAF_LOG_DEBUG(logger_, notification.toString("   ", 25));
+                }
             }
         }
 
+        // update the cached values in place
+        if (database_->clientSettings.latestValueCacheEnable && !notifications.empty())
+            database_->latestValueCache.update(clientConnectionId_, notifications);
+
         // call the callback interface
-        clientInterface_->dataChangesReceived(notifications);
+        deliver(std::move(batch));
     }
 
 
@@ -455,40 +506,78 @@ namespace uaf
         // get the number of notifications
         uint32_t noOfNotifications = uaEventFieldList.length();
 
-        logger_->debug("A total of %d notifications were received", noOfNotifications);
+        UAF_LOG_DEBUG(logger_, "A total of %d notifications were received", noOfNotifications);
 
         // create the notifications
-        vector<EventNotification> notifications;
+        NotificationBatch batch;
+        vector<EventNotification>& notifications = batch.eventNotifications;
+        notifications.reserve(noOfNotifications);
 
-        // fill the notifications
-        for (uint32_t i=0; i < noOfNotifications; i++)
+        // fill the notifications (while the monitored items can't be deleted meanwhile)
         {
-            ClientHandle clientHandle = uaEventFieldList[i].ClientHandle;
+            UaMutexLocker locker(&monitoredItemsMapMutex_); // unlocks when locker goes out of scope
 
-            MonitoredItemsMap::const_iterator it = monitoredItemsMap_.find(clientHandle);
-
-            // update the contents of the notification
-            if (it != monitoredItemsMap_.end())
+            for (uint32_t i=0; i < noOfNotifications; i++)
             {
-                EventNotification notification;
+                ClientHandle clientHandle = uaEventFieldList[i].ClientHandle;
 
-                notification.clientHandle       = clientHandle;
+                MonitoredItemsMap::const_iterator it = monitoredItemsMap_.find(clientHandle);
 
-                // update the event fields
-                for (int32_t j=0; j < uaEventFieldList[i].NoOfEventFields; j++)
-                    notification.fields.push_back(Variant(uaEventFieldList[i].EventFields[j]));
+                // update the contents of the notification
+                if (it != monitoredItemsMap_.end())
+                {
+                    // add a notification to the vector of notifications for the callback, and fill
+                    // it in place
+                    notifications.push_back(EventNotification());
+                    EventNotification& notification = notifications.back();
 
-                // add it to the vector of notifications for the callback
-                notifications.push_back(notification);
+                    notification.clientHandle       = clientHandle;
 
-                // log the notification
-                logger_->debug(" - Notification %d:", int(i));
-                logger_->debug(notification.toString("   ", 25));
+                    // update the event fields
+                    notification.fields.reserve(uaEventFieldList[i].NoOfEventFields);
+                    for (int32_t j=0; j < uaEventFieldList[i].NoOfEventFields; j++)
+                        notification.fields.push_back(Variant(uaEventFieldList[i].EventFields[j]));
+
+                    // log the notification
+                    UAF_LOG_DEBUG(logger_, " - Notification %d:", int(i));
+                    UAF_LOG_DEBUG(logger_, notification.toString("   ", 25));
+                }
             }
         }
 
         // call the callback interface
-        clientInterface_->eventsReceived(notifications);
+        deliver(std::move(batch));
+    }
+
+
+    // Deliver a batch of notifications
+    // =============================================================================================
+    void Subscription::deliver(NotificationBatch&& batch)
+    {
+        shared_ptr<NotificationQueue> queue = std::atomic_load(&notificationQueue_);
+
+        // if the queue was enabled before, it may still contain notifications (or a dispatcher
+        // thread may still be delivering them), so the queue must be used until it is idle,
+        // to keep the notifications in order
+        if (database_->clientSettings.notificationQueueEnable || (queue && !queue->isIdle()))
+        {
+            // the queue is only created when it's needed for the first time
+            if (!queue)
+            {
+                queue.reset(new NotificationQueue(clientInterface_,
+                                                  database_->clientSettings.notificationQueueSize));
+                std::atomic_store(&notificationQueue_, queue);
+            }
+
+            size_t size = batch.size();
+
+            if (!database_->notificationDispatcher.dispatch(queue, std::move(batch)))
+                logger_->warning("The notification queue is full, so %d notifications were "
+                                 "dropped", int(size));
+            return;
+        }
+
+        batch.deliverTo(clientInterface_);
     }
 
 }
@@ -25,6 +25,7 @@
 #include <string>
 #include <sstream>
 #include <vector>
+#include <memory>
 // SDK
 #include "uaclientcpp/uaclientsdk.h"
 #include "uaclientcpp/uasession.h"
@@ -43,6 +44,7 @@
 #include "uaf/client/subscriptions/subscriptioninformation.h"
 #include "uaf/client/subscriptions/monitorediteminformation.h"
 #include "uaf/client/subscriptions/keepalivenotification.h"
+#include "uaf/client/subscriptions/notificationqueue.h"
 #include "uaf/client/database/database.h"
 #include "uaf/client/invocations/invocations.h"
 
@@ -146,6 +148,15 @@ namespace uaf
                 uaf::MonitoredItemInformation& monitoredItemInformation);
 
 
+        /**
+         * Get the number of monitored items of the subscription.
+         *
+         * @return  The number of monitored items that the server has created (so without the
+         *          ones that it could not create).
+         */
+        std::size_t noOfMonitoredItems();
+
+
         /**
          * Called every time a monitored item has changed,
          * overridden from UaSubscriptionCallback.
@@ -208,6 +219,9 @@ namespace uaf
             // create a vector to store the ClientHandles
             std::vector<uaf::ClientHandle> clientHandles;
 
+            // the monitored items may be counted by other threads while they're being stored
+            monitoredItemsMapMutex_.lock();
+
             for (std::size_t i = 0; i < invocation.requestTargets().size(); i++)
             {
                 uaf::ClientHandle clientHandle = invocation.resultTargets()[i].clientHandle;
@@ -229,16 +243,28 @@ namespace uaf
                 clientHandles.push_back(clientHandle);
             }
 
+            monitoredItemsMapMutex_.unlock();
+
             // provide the clientHandles to the invocation
             invocation.setHandles(clientHandles);
 
             // create the monitored items on the server side, by invoking the service
             ret = invocation.invoke(uaSubscription_, nameSpaceArray, serverArray, logger_);
 
+            // the monitored items of which the latest value will be cached
+            std::vector<uaf::Address>      cachedAddresses;
+            std::vector<uaf::ClientHandle> cachedClientHandles;
+
             // store the MonitoredItemId, revised sampling interval etc.
-            for (std::size_t i = 0; i < invocation.resultTargets().size(); i++)
+            monitoredItemsMapMutex_.lock();
+            for (std::size_t i = 0;
+                 i < invocation.resultTargets().size() && i < clientHandles.size();
+                 i++)
             {
-                uaf::ClientHandle clientHandle = invocation.resultTargets()[i].clientHandle;
+                // use the handle that was assigned above, since the result targets of the
+                // chunks that could not be invoked do not have a client handle yet
+                uaf::ClientHandle clientHandle = clientHandles[i];
+                invocation.resultTargets()[i].clientHandle = clientHandle;
 
                 monitoredItemsMap_[clientHandle].revisedQueueSize \
                     = invocation.resultTargets()[i].revisedQueueSize;
@@ -246,7 +272,24 @@ namespace uaf
                     = invocation.resultTargets()[i].revisedSamplingIntervalSec;
                 monitoredItemsMap_[clientHandle].monitoredItemId \
                     = invocation.resultTargets()[i].monitoredItemId;
+                monitoredItemsMap_[clientHandle].created \
+                    = invocation.resultTargets()[i].status.isGood();
+
+                // only complete values can be cached, since readCached() reads complete values
+                // (the data encoding can't be chosen by a request target, so it's the default one)
+                if (database_->clientSettings.latestValueCacheEnable
+                        && invocation.resultTargets()[i].status.isGood()
+                        && invocation.requestTargets()[i].attributeId == uaf::attributeids::Value
+                        && invocation.requestTargets()[i].indexRange.empty())
+                {
+                    cachedAddresses.push_back(invocation.requestTargets()[i].address);
+                    cachedClientHandles.push_back(clientHandle);
+                }
             }
+            monitoredItemsMapMutex_.unlock();
+
+            if (!cachedAddresses.empty())
+                database_->latestValueCache.add(cachedAddresses, cachedClientHandles);
 
 
             return ret;
@@ -271,6 +314,9 @@ namespace uaf
             // create a vector to store the ClientHandles
             std::vector<uaf::ClientHandle> clientHandles;
 
+            // the monitored items may be counted by other threads while they're being stored
+            monitoredItemsMapMutex_.lock();
+
             for (std::size_t i = 0; i < invocation.requestTargets().size(); i++)
             {
                 uaf::ClientHandle clientHandle = invocation.resultTargets()[i].clientHandle;
@@ -292,6 +338,8 @@ namespace uaf
                 clientHandles.push_back(clientHandle);
             }
 
+            monitoredItemsMapMutex_.unlock();
+
             // provide the clientHandles to the invocation
             invocation.setHandles(clientHandles);
 
@@ -299,9 +347,15 @@ namespace uaf
             ret = invocation.invoke(uaSubscription_, nameSpaceArray, serverArray, logger_);
 
             // store the MonitoredItemId, revised sampling interval etc.
-            for (std::size_t i = 0; i < invocation.resultTargets().size(); i++)
+            monitoredItemsMapMutex_.lock();
+            for (std::size_t i = 0;
+                 i < invocation.resultTargets().size() && i < clientHandles.size();
+                 i++)
             {
-                uaf::ClientHandle clientHandle = invocation.resultTargets()[i].clientHandle;
+                // use the handle that was assigned above, since the result targets of the
+                // chunks that could not be invoked do not have a client handle yet
+                uaf::ClientHandle clientHandle = clientHandles[i];
+                invocation.resultTargets()[i].clientHandle = clientHandle;
 
                 monitoredItemsMap_[clientHandle].revisedQueueSize \
                     = invocation.resultTargets()[i].revisedQueueSize;
@@ -309,7 +363,10 @@ namespace uaf
                     = invocation.resultTargets()[i].revisedSamplingIntervalSec;
                 monitoredItemsMap_[clientHandle].monitoredItemId \
                     = invocation.resultTargets()[i].monitoredItemId;
+                monitoredItemsMap_[clientHandle].created \
+                    = invocation.resultTargets()[i].status.isGood();
             }
+            monitoredItemsMapMutex_.unlock();
 
             return ret;
         }
@@ -383,6 +440,16 @@ namespace uaf
         // the RequesterInterface to call when asynchronous messages are received
         uaf::ClientInterface*                      clientInterface_;
 
+        // the queue of the notifications that still need to be delivered to the clientInterface_
+        // (shared with the dispatcher threads, since they may still be delivering notifications
+        // when the subscription is destroyed; it's only created once the queue is enabled, and
+        // must be accessed via std::atomic_load and std::atomic_store)
+        std::shared_ptr<uaf::NotificationQueue>     notificationQueue_;
+
+        // deliver a batch of notifications to the clientInterface_, either immediately or via
+        // the notification queue (depending on the client settings)
+        void deliver(uaf::NotificationBatch&& batch);
+
         // the current monitored item handle (gets incremented every time!) and its mutex.
         uaf::ClientHandle                           clientHandle_;
         UaMutex                                     clientHandleMutex_;
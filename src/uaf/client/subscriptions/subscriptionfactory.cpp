@@ -47,8 +47,8 @@ namespace uaf
         loggerName << "SubFactory-" << clientConnectionId;
         logger_ = new Logger(loggerFactory, loggerName.str());
 
-        logger_->debug("SubscriptionFactory for session %d has been constructed",
-                       clientConnectionId);
+        UAF_LOG_DEBUG(logger_, "SubscriptionFactory for session %d has been constructed",
+                               clientConnectionId);
     }
 
 
@@ -56,7 +56,7 @@ namespace uaf
     // =============================================================================================
     SubscriptionFactory::~SubscriptionFactory()
     {
-        logger_->debug("Destructing the subscription factory");
+        UAF_LOG_DEBUG(logger_, "Destructing the subscription factory");
 
         // delete the logger
         delete logger_;
@@ -176,7 +176,7 @@ namespace uaf
     // =============================================================================================
     vector<SubscriptionInformation> SubscriptionFactory::allSubscriptionInformations()
     {
-        logger_->debug("Getting the subscription information for all subscription");
+        UAF_LOG_DEBUG(logger_, "Getting the subscription information for all subscription");
 
         vector<SubscriptionInformation> ret;
 
@@ -295,8 +295,8 @@ namespace uaf
             const SubscriptionSettings& subscriptionSettings,
             Subscription*&              subscription)
     {
-        logger_->debug("Acquiring subscription with the following settings:");
-        logger_->debug(subscriptionSettings.toString());
+        UAF_LOG_DEBUG(logger_, "Acquiring subscription with the following settings:");
+        UAF_LOG_DEBUG(logger_, subscriptionSettings.toString());
 
         Status ret;
 
@@ -310,7 +310,7 @@ namespace uaf
         // (one that is only created for -and used by- the current request)
         if (subscriptionSettings.unique)
         {
-            logger_->debug("The requested subscription must be unique");
+            UAF_LOG_DEBUG(logger_, "The requested subscription must be unique");
         }
         else
         {
@@ -323,8 +323,8 @@ namespace uaf
                 if (it->second->subscriptionSettings() == subscriptionSettings)
                 {
                     subscription = it->second;
-                    logger_->debug("A suitable subscription (ClientSubscriptionHandle=%d) already exists",
-                                   subscription->clientSubscriptionHandle());
+                    UAF_LOG_DEBUG(logger_, "A suitable subscription (ClientSubscriptionHandle=%d) already exists",
+                                           subscription->clientSubscriptionHandle());
 
                     // get the ClientSubscriptionHandle of the subscription
                     ClientSubscriptionHandle handle = subscription->clientSubscriptionHandle();
@@ -343,37 +343,7 @@ namespace uaf
 
         // if no subscription exists yet, we create one
         if (subscription == 0)
-        {
-            ClientSubscriptionHandle clientSubscriptionHandle;
-            clientSubscriptionHandle = database_->createUniqueClientSubscriptionHandle();
-
-            logger_->debug("We create a new subscription with clientSubscriptionHandle %d",
-                           clientSubscriptionHandle);
-
-            // create a new subscription instance
-            subscription = new Subscription(
-                    logger_->loggerFactory(),
-                    subscriptionSettings,
-                    clientSubscriptionHandle,
-                    clientConnectionId_,
-                    uaSession_,
-                    this,
-                    clientInterface_,
-                    database_);
-
-            // store the new subscription instance in the subscriptionMap
-            subscriptionMap_[clientSubscriptionHandle] = subscription;
-
-            logger_->debug("The new subscription has been created");
-
-            // create an activity count for the subscription
-            activityMapMutex_.lock();
-            activityMap_[clientSubscriptionHandle] = 1;
-            activityMapMutex_.unlock();
-
-            // create the subscription on the server
-            ret = subscription->createSubscription();
-        }
+            ret = constructSubscription(subscriptionSettings, subscription);
 
         // 'subscription' now points to an existing Subscription instance
         // (i.e. a valid memory location)
@@ -382,8 +352,8 @@ namespace uaf
         if (ret.isGood())
         {
             activityMapMutex_.lock();
-            logger_->debug("The requested subscription is acquired (#activities: %d)",
-                           activityMap_[subscription->clientSubscriptionHandle()]);
+            UAF_LOG_DEBUG(logger_, "The requested subscription is acquired (#activities: %d)",
+                                   activityMap_[subscription->clientSubscriptionHandle()]);
             activityMapMutex_.unlock();
         }
         else
@@ -396,13 +366,182 @@ namespace uaf
 
 
 
+    // Construct a new subscription
+    // =============================================================================================
+    Status SubscriptionFactory::constructSubscription(
+            const SubscriptionSettings& subscriptionSettings,
+            Subscription*&              subscription)
+    {
+        ClientSubscriptionHandle clientSubscriptionHandle;
+        clientSubscriptionHandle = database_->createUniqueClientSubscriptionHandle();
+
+        UAF_LOG_DEBUG(logger_, "We create a new subscription with clientSubscriptionHandle %d",
+                               clientSubscriptionHandle);
+
+        // create a new subscription instance
+        subscription = new Subscription(
+                logger_->loggerFactory(),
+                subscriptionSettings,
+                clientSubscriptionHandle,
+                clientConnectionId_,
+                uaSession_,
+                this,
+                clientInterface_,
+                database_);
+
+        // store the new subscription instance in the subscriptionMap
+        subscriptionMap_[clientSubscriptionHandle] = subscription;
+
+        UAF_LOG_DEBUG(logger_, "The new subscription has been created");
+
+        // create an activity count for the subscription
+        activityMapMutex_.lock();
+        activityMap_[clientSubscriptionHandle] = 1;
+        activityMapMutex_.unlock();
+
+        // create the subscription on the server
+        return subscription->createSubscription();
+    }
+
+
+    // Acquire the subscriptions to spread the targets over
+    // =============================================================================================
+    Status SubscriptionFactory::acquirePartitions(
+            const SubscriptionSettings& subscriptionSettings,
+            const vector<double>&       samplingIntervals,
+            uint32_t                    maxNoOfItems,
+            vector<Partition>&          partitions)
+    {
+        UAF_LOG_DEBUG(logger_, "Spreading %d targets over subscriptions with at most %d "
+                               "monitored items", int(samplingIntervals.size()), maxNoOfItems);
+
+        Status ret(statuscodes::Good);
+
+        partitions.clear();
+
+        // group the targets by sampling interval
+        typedef std::map<double, vector<size_t> > GroupMap;
+        GroupMap groups;
+        for (size_t i = 0; i < samplingIntervals.size(); i++)
+            groups[samplingIntervals[i]].push_back(i);
+
+        // lock the mutex to make sure the subscriptionMap_ is not being manipulated
+        UaMutexLocker locker(&subscriptionMapMutex_);
+
+        for (GroupMap::const_iterator group = groups.begin();
+             group != groups.end() && ret.isGood();
+             ++group)
+        {
+            double samplingIntervalSec = group->first;
+            const vector<size_t>& indexes = group->second;
+            size_t noOfPlacedTargets = 0;
+
+            // first fill up the existing subscriptions of this sampling interval (unless we're
+            // creating "unique" subscriptions)
+            for (SubscriptionMap::const_iterator it = subscriptionMap_.begin();
+                 it != subscriptionMap_.end()
+                     && noOfPlacedTargets < indexes.size()
+                     && !subscriptionSettings.unique;
+                 ++it)
+            {
+                PartitionedSubscriptionMap::iterator partitioned
+                    = partitionedSubscriptions_.find(it->first);
+
+                if (   partitioned == partitionedSubscriptions_.end()
+                    || partitioned->second.samplingIntervalSec != samplingIntervalSec
+                    || !it->second->isCreated()
+                    || !(it->second->subscriptionSettings() == subscriptionSettings))
+                    continue;
+
+                size_t noOfItems = it->second->noOfMonitoredItems()
+                                   + partitioned->second.noOfReservedItems;
+                if (noOfItems >= maxNoOfItems)
+                    continue;
+
+                size_t count = std::min(size_t(maxNoOfItems) - noOfItems,
+                                        indexes.size() - noOfPlacedTargets);
+
+                UAF_LOG_DEBUG(logger_, "Adding %d targets to subscription %d", int(count),
+                                       it->first);
+
+                Partition partition;
+                partition.subscription = it->second;
+                partition.indexes.assign(indexes.begin() + noOfPlacedTargets,
+                                         indexes.begin() + noOfPlacedTargets + count);
+                partitions.push_back(partition);
+
+                partitioned->second.noOfReservedItems += count;
+                noOfPlacedTargets += count;
+
+                activityMapMutex_.lock();
+                activityMap_[it->first] = activityMap_[it->first] + 1;
+                activityMapMutex_.unlock();
+            }
+
+            // then create new subscriptions for the remaining targets
+            while (noOfPlacedTargets < indexes.size() && ret.isGood())
+            {
+                size_t count = std::min(size_t(maxNoOfItems), indexes.size() - noOfPlacedTargets);
+
+                Partition partition;
+                ret = constructSubscription(subscriptionSettings, partition.subscription);
+                partition.indexes.assign(indexes.begin() + noOfPlacedTargets,
+                                         indexes.begin() + noOfPlacedTargets + count);
+                partitions.push_back(partition);
+
+                PartitionedSubscription partitioned;
+                partitioned.samplingIntervalSec = samplingIntervalSec;
+                partitioned.noOfReservedItems   = count;
+                partitionedSubscriptions_[partition.subscription->clientSubscriptionHandle()]
+                    = partitioned;
+
+                noOfPlacedTargets += count;
+            }
+        }
+
+        if (ret.isGood())
+            UAF_LOG_DEBUG(logger_, "The targets are spread over %d subscriptions",
+                                   int(partitions.size()));
+        else
+            logger_->error("The subscriptions to spread the targets over could not be acquired");
+
+        return ret;
+    }
+
+
+    // Release the subscriptions that were acquired to spread the targets over
+    // =============================================================================================
+    void SubscriptionFactory::releasePartitions(vector<Partition>& partitions)
+    {
+        // the monitored items are now stored by the subscriptions, so they don't need to be
+        // reserved anymore
+        {
+            UaMutexLocker locker(&subscriptionMapMutex_); // unlocks when out of scope
+
+            for (size_t p = 0; p < partitions.size(); p++)
+            {
+                PartitionedSubscriptionMap::iterator partitioned = partitionedSubscriptions_.find(
+                        partitions[p].subscription->clientSubscriptionHandle());
+
+                if (partitioned != partitionedSubscriptions_.end())
+                    partitioned->second.noOfReservedItems -= partitions[p].indexes.size();
+            }
+        }
+
+        for (size_t p = 0; p < partitions.size(); p++)
+            releaseSubscription(partitions[p].subscription);
+
+        partitions.clear();
+    }
+
+
     // Acquire an existing session, if one is available.
     // =============================================================================================
     Status SubscriptionFactory::acquireExistingSubscription(
             ClientSubscriptionHandle    clientSubscriptionHandle,
             Subscription*&              subscription)
     {
-        logger_->debug("Acquiring existing subscription %d if available", clientSubscriptionHandle);
+        UAF_LOG_DEBUG(logger_, "Acquiring existing subscription %d if available", clientSubscriptionHandle);
 
         Status ret;
 
@@ -432,8 +571,8 @@ namespace uaf
             // an existing session was acquired, so set the status to Good
             ret = statuscodes::Good;
 
-            logger_->debug("Subscription %d was acquired (#activities: %d)",
-                           clientSubscriptionHandle, newActivityCount);
+            UAF_LOG_DEBUG(logger_, "Subscription %d was acquired (#activities: %d)",
+                                   clientSubscriptionHandle, newActivityCount);
         }
 
         return ret;
@@ -474,8 +613,8 @@ namespace uaf
             activityMap_[handle] = activityMap_[handle] - 1;
             ret = statuscodes::Good;
 
-            logger_->debug("Subscription %d is now released (#activities: %d)",
-                           handle, activityMap_[handle]);
+            UAF_LOG_DEBUG(logger_, "Subscription %d is now released (#activities: %d)",
+                                   handle, activityMap_[handle]);
 
             // check if the subscription is closed
             if (!subscription->isCreated() && allowGarbageCollection)
@@ -484,14 +623,15 @@ namespace uaf
                 // pointer to this session being used), we may delete it!
                 if (activityMap_[handle] == 0)
                 {
-                    logger_->debug("There's no ongoing activity of this deleted subscription, so "
-                                   "we may delete it");
+                    UAF_LOG_DEBUG(logger_, "There's no ongoing activity of this deleted subscription, so "
+                                           "we may delete it");
                     delete subscription;
                     subscription = 0;
                     activityMap_.erase(handle);
                     subscriptionMap_.erase(handle);
+                    partitionedSubscriptions_.erase(handle);
 
-                    logger_->debug("The subscription has been deleted");
+                    UAF_LOG_DEBUG(logger_, "The subscription has been deleted");
                 }
             }
         }
@@ -506,8 +646,8 @@ namespace uaf
                     OpcUa_UInt32    clientSubscriptionHandle,
                     const UaStatus& uaStatus)
     {
-        logger_->debug("Subscription status for clientSubscriptionHandle %d has changed: %s",
-                clientSubscriptionHandle, uaStatus.toString().toUtf8());
+        UAF_LOG_DEBUG(logger_, "Subscription status for clientSubscriptionHandle %d has changed: %s",
+                        clientSubscriptionHandle, uaStatus.toString().toUtf8());
 
         // acquire the subscription for which the event was meant:
         Subscription* subscription = 0;
@@ -515,11 +655,20 @@ namespace uaf
 
         if (acquireStatus.isGood())
         {
+            subscriptionstates::SubscriptionState previousState = subscription->subscriptionState();
+            subscriptionstates::SubscriptionState state = subscriptionstates::toUaf(uaStatus);
+
             // update the session state
-            subscription->setSubscriptionState(uaf::subscriptionstates::toUaf(uaStatus));
+            subscription->setSubscriptionState(state);
 
             // release the acquired session
             releaseSubscription(subscription);
+
+            // if the subscription was lost, let the client create the persisted monitored items
+            // again right away, instead of at the next periodic housekeeping
+            if (state == subscriptionstates::Deleted && previousState != state)
+                database_->backgroundTasks.schedule(backgroundtasks::toTaskId(
+                        backgroundtasks::PersistedRequests));
         }
     }
 
@@ -528,7 +677,7 @@ namespace uaf
     // =============================================================================================
     void SubscriptionFactory::keepAlive(OpcUa_UInt32 clientSubscriptionHandle)
     {
-        logger_->debug("Subscription %d received a keep alive message", clientSubscriptionHandle);
+        UAF_LOG_DEBUG(logger_, "Subscription %d received a keep alive message", clientSubscriptionHandle);
 
         // acquire the subscription for which the event was meant:
         Subscription* subscription = 0;
@@ -556,10 +705,10 @@ namespace uaf
             OpcUa_UInt32 previousSequenceNumber,
             OpcUa_UInt32 newSequenceNumber)
     {
-        logger_->debug("Notifications are missing for subscription %d! (%d + 1 != %d)",
-                clientSubscriptionHandle,
-                previousSequenceNumber,
-                newSequenceNumber);
+        UAF_LOG_DEBUG(logger_, "Notifications are missing for subscription %d! (%d + 1 != %d)",
+                        clientSubscriptionHandle,
+                        previousSequenceNumber,
+                        newSequenceNumber);
 
         // acquire the subscription:
         Subscription* subscription = 0;
@@ -591,7 +740,7 @@ namespace uaf
             const UaDataNotifications&  dataNotifications,
             const UaDiagnosticInfos &   diagnosticInfos)
     {
-        logger_->debug("New data change event for subscription %d", clientSubscriptionHandle);
+        UAF_LOG_DEBUG(logger_, "New data change event for subscription %d", clientSubscriptionHandle);
 
 
         // acquire the subscription for which the event was meant:
@@ -620,8 +769,8 @@ namespace uaf
             OpcUa_UInt32        clientSubscriptionHandle,
             UaEventFieldLists&  uaEventFieldList)
     {
-        logger_->debug("Subscription %d received %d new events",
-                       clientSubscriptionHandle, uaEventFieldList.length());
+        UAF_LOG_DEBUG(logger_, "Subscription %d received %d new events",
+                               clientSubscriptionHandle, uaEventFieldList.length());
 
         // acquire the subscription for which the event was meant:
         Subscription* subscription = 0;
@@ -650,7 +799,7 @@ namespace uaf
                     const UaMonitoredItemCreateResults &createResults,
                     const UaDiagnosticInfos &diagnosticInfos)
     {
-        logger_->debug("Create monitored items complete (transaction %d)", transactionId);
+        UAF_LOG_DEBUG(logger_, "Create monitored items complete (transaction %d)", transactionId);
     }
 
 
@@ -662,7 +811,7 @@ namespace uaf
                     const UaMonitoredItemModifyResults &modifyResults,
                     const UaDiagnosticInfos &diagnosticInfos)
     {
-        logger_->debug("Modifying monitored items complete (transaction %d)", transactionId);
+        UAF_LOG_DEBUG(logger_, "Modifying monitored items complete (transaction %d)", transactionId);
     }
 
 
@@ -674,7 +823,7 @@ namespace uaf
                     const UaStatusCodeArray &setModeResults,
                     const UaDiagnosticInfos &diagnosticInfos)
     {
-        logger_->debug("Set monitoring mode complete (transaction %d)", transactionId);
+        UAF_LOG_DEBUG(logger_, "Set monitoring mode complete (transaction %d)", transactionId);
     }
 
 
@@ -686,7 +835,7 @@ namespace uaf
             const UaStatusCodeArray &deleteResults,
             const UaDiagnosticInfos &diagnosticInfos)
     {
-        logger_->debug("Delete monitored items complete (transaction %d)", transactionId);
+        UAF_LOG_DEBUG(logger_, "Delete monitored items complete (transaction %d)", transactionId);
     }
 
 
@@ -25,7 +25,9 @@
 // STD
 #include <string>
 #include <sstream>
+#include <algorithm>
 #include <map>
+#include <vector>
 // SDK
 #include "uaclientcpp/uaclientsdk.h"
 #include "uaclientcpp/uasession.h"
@@ -193,8 +195,8 @@ namespace uaf
                 const uaf::NamespaceArray&      nameSpaceArray,
                 const uaf::ServerArray&         serverArray)
         {
-            logger_->debug("Processing %sInvocation %d",
-                           _Service::name().c_str(), invocation.requestHandle());
+            UAF_LOG_DEBUG(logger_, "Processing %sInvocation %d",
+                                   _Service::name().c_str(), invocation.requestHandle());
 
             uaf::Status ret;
 
@@ -203,6 +205,24 @@ namespace uaf
             if (invocation.asynchronous())
                 storeRequestHandle(invocation.requestHandle());
 
+            // spread the monitored items over several subscriptions, if configured
+            // (asynchronous invocations are never spread, since the logic to reconstruct the
+            // result from multiple asynchronous invocations is not implemented)
+            uint32_t maxNoOfItems = database_->clientSettings.subscriptionMaxMonitoredItems;
+            if (   maxNoOfItems > 0
+                && !invocation.asynchronous()
+                && !request.clientSubscriptionHandleGiven)
+            {
+                return invokePartitioned<_Service>(
+                        invocation,
+                        request.subscriptionSettingsGiven
+                            ? request.subscriptionSettings
+                            : database_->clientSettings.defaultSubscriptionSettings,
+                        maxNoOfItems,
+                        nameSpaceArray,
+                        serverArray);
+            }
+
             // try to acquire a subscription for the given subscription settings
             uaf::Subscription* subscription = 0;
 
@@ -225,13 +245,13 @@ namespace uaf
             if (ret.isGood())
             {
                 // copy the subscription information to the invocation
-                logger_->debug("Copying the subscription information to the invocation");
+                UAF_LOG_DEBUG(logger_, "Copying the subscription information to the invocation");
                 invocation.setSubscriptionInformation(subscription->subscriptionInformation());
 
                 if (subscription->isCreated())
                 {
-                    logger_->debug("Forwarding the invocation to subscription %d",
-                                   subscription->clientSubscriptionHandle());
+                    UAF_LOG_DEBUG(logger_, "Forwarding the invocation to subscription %d",
+                                           subscription->clientSubscriptionHandle());
                     ret = subscription->invokeService(invocation, nameSpaceArray, serverArray);
                 }
                 else
@@ -264,6 +284,246 @@ namespace uaf
         // private typedef: a map to relate transaction ids with request handles
         typedef std::map<uaf::TransactionId, uaf::RequestHandle> TransactionMap;
 
+        // private struct: a subscription that holds monitored items of a single sampling
+        // interval (see ClientSettings::subscriptionMaxMonitoredItems)
+        struct PartitionedSubscription
+        {
+            // the sampling interval of the monitored items
+            double      samplingIntervalSec;
+            // the number of monitored items that are being added to the subscription
+            std::size_t noOfReservedItems;
+        };
+
+        // private typedef: a map to store the partitioned subscriptions
+        typedef std::map<uaf::ClientSubscriptionHandle, PartitionedSubscription>
+                PartitionedSubscriptionMap;
+
+        // private struct: the targets of an invocation that are handled by one subscription
+        struct Partition
+        {
+            // the acquired subscription
+            uaf::Subscription*          subscription;
+            // the indexes of the targets within the invocation
+            std::vector<std::size_t>    indexes;
+        };
+
+
+        /**
+         * Execute a synchronous service invocation that creates monitored items, by spreading
+         * its targets over as many subscriptions (with the given settings) as needed.
+         *
+         * The targets are grouped by sampling interval, and each group is added to the
+         * subscriptions of that sampling interval that have less than maxNoOfItems monitored
+         * items, or to new ones. The result targets are merged back into the invocation, and
+         * the handle of the subscription of each target is provided to it.
+         *
+         * If some subscriptions can't be acquired or invoked, the other ones are still invoked
+         * (so that the monitored items they create are reported, and can be deleted by the
+         * user), and the targets of the failed ones get the error as their status.
+         *
+         * @tparam _Service             The service to be invoked (CreateMonitoredDataService
+         *                              or CreateMonitoredEventsService).
+         * @param invocation            The invocation to be executed.
+         * @param subscriptionSettings  The settings of the subscriptions.
+         * @param maxNoOfItems          The maximum number of monitored items per subscription.
+         * @param nameSpaceArray        The name space array as fetched by the client.
+         * @param serverArray           The server array as fetched by the client.
+         * @return                      Good if at least one subscription was invoked, otherwise
+         *                              the first error.
+         */
+        template<typename _Service>
+        uaf::Status invokePartitioned(
+                typename _Service::Invocation&      invocation,
+                const uaf::SubscriptionSettings&    subscriptionSettings,
+                uint32_t                            maxNoOfItems,
+                const uaf::NamespaceArray&          nameSpaceArray,
+                const uaf::ServerArray&             serverArray)
+        {
+            typedef typename _Service::Invocation Invocation;
+
+            std::size_t noOfTargets = invocation.requestTargets().size();
+
+            std::vector<double> samplingIntervals(noOfTargets);
+            for (std::size_t i = 0; i < noOfTargets; i++)
+                samplingIntervals[i] = invocation.requestTargets()[i].samplingIntervalSec;
+
+            // acquire the subscriptions (if not all of them could be acquired, the targets of
+            // the others still need to be invoked)
+            std::vector<Partition> partitions;
+            uaf::Status acquireStatus = acquirePartitions(
+                    subscriptionSettings,
+                    samplingIntervals,
+                    maxNoOfItems,
+                    partitions);
+
+            // the targets that were handled by a subscription (successfully or not)
+            std::vector<bool> handled(noOfTargets, false);
+
+            std::vector<uaf::ClientSubscriptionHandle> clientSubscriptionHandles(noOfTargets);
+
+            // the first error, and the first subscription that was invoked successfully
+            uaf::Status firstError(acquireStatus);
+            uaf::Subscription* firstInvokedSubscription = 0;
+
+            // invoke the targets of each partition on its own subscription
+            for (std::size_t p = 0; p < partitions.size(); p++)
+            {
+                uaf::Subscription* subscription = partitions[p].subscription;
+                const std::vector<std::size_t>& indexes = partitions[p].indexes;
+
+                uaf::Status ret;
+
+                if (!subscription->isCreated())
+                {
+                    ret = uaf::SubscriptionNotCreatedError();
+                    setStatus(invocation, indexes, ret);
+                    if (firstError.isGood())
+                        firstError = ret;
+                    markHandled(indexes, handled);
+                    continue;
+                }
+
+                Invocation part;
+                part.copyContextFrom(invocation);
+                part.setSubscriptionInformation(subscription->subscriptionInformation());
+                for (std::size_t j = 0; j < indexes.size(); j++)
+                {
+                    part.addTarget(invocation.ranks()[indexes[j]],
+                                   invocation.requestTargets()[indexes[j]],
+                                   invocation.resultTargets()[indexes[j]]);
+                }
+
+                UAF_LOG_DEBUG(logger_, "Forwarding %d targets to subscription %d",
+                                       int(indexes.size()), subscription->clientSubscriptionHandle());
+                ret = subscription->invokeService(part, nameSpaceArray, serverArray);
+
+                // copy the result targets back to the invocation
+                if (ret.isGood() && part.resultTargets().size() != indexes.size())
+                    ret = uaf::UnexpectedError(
+                            "Bug in SubscriptionFactory: the number of partitioned results "
+                            "doesn't match the number of partitioned targets");
+
+                if (ret.isGood())
+                {
+                    for (std::size_t j = 0; j < indexes.size(); j++)
+                    {
+                        invocation.resultTargets()[indexes[j]] = part.resultTargets()[j];
+                        clientSubscriptionHandles[indexes[j]]
+                            = subscription->clientSubscriptionHandle();
+                    }
+
+                    if (firstInvokedSubscription == 0)
+                        firstInvokedSubscription = subscription;
+                }
+                else
+                {
+                    logger_->error("Subscription %d could not be invoked, continuing with the "
+                                   "other subscriptions", subscription->clientSubscriptionHandle());
+                    setStatus(invocation, indexes, ret);
+                    if (firstError.isGood())
+                        firstError = ret;
+                }
+
+                markHandled(indexes, handled);
+            }
+
+            // the targets that were not placed in any subscription get the error of the
+            // acquisition
+            for (std::size_t i = 0; i < noOfTargets; i++)
+            {
+                if (!handled[i])
+                    invocation.resultTargets()[i].status = firstError.isGood()
+                            ? uaf::Status(uaf::SubscriptionNotCreatedError())
+                            : firstError;
+            }
+
+            releasePartitions(partitions);
+
+            if (firstInvokedSubscription == 0)
+                return firstError.isGood() ? uaf::Status(uaf::SubscriptionNotCreatedError())
+                                           : firstError;
+
+            invocation.setSubscriptionInformation(
+                    firstInvokedSubscription->subscriptionInformation());
+            invocation.setClientSubscriptionHandles(clientSubscriptionHandles);
+
+            return uaf::Status(uaf::statuscodes::Good);
+        }
+
+
+        /**
+         * Set the status of some result targets of an invocation.
+         *
+         * @param invocation    The invocation.
+         * @param indexes       The indexes of the result targets.
+         * @param status        The status to set.
+         */
+        template<typename _Invocation>
+        static void setStatus(
+                _Invocation&                        invocation,
+                const std::vector<std::size_t>&     indexes,
+                const uaf::Status&                  status)
+        {
+            for (std::size_t j = 0; j < indexes.size(); j++)
+                invocation.resultTargets()[indexes[j]].status = status;
+        }
+
+
+        /**
+         * Mark some targets as handled.
+         *
+         * @param indexes       The indexes of the targets.
+         * @param handled       The flags to update.
+         */
+        static void markHandled(const std::vector<std::size_t>& indexes, std::vector<bool>& handled)
+        {
+            for (std::size_t j = 0; j < indexes.size(); j++)
+                handled[indexes[j]] = true;
+        }
+
+
+        /**
+         * Acquire the subscriptions to spread the given targets over (by getting existing ones
+         * that have room for more monitored items, or creating new ones if needed).
+         *
+         * The acquired subscriptions must be released by releasePartitions(), also when the
+         * returned status is not good.
+         *
+         * @param subscriptionSettings  Settings of the subscriptions to be acquired.
+         * @param samplingIntervals     The sampling interval of each target.
+         * @param maxNoOfItems          The maximum number of monitored items per subscription.
+         * @param partitions            Output parameter: the targets per acquired subscription.
+         * @return                      Bad if not all subscriptions could be acquired.
+         */
+        uaf::Status acquirePartitions(
+                const uaf::SubscriptionSettings&    subscriptionSettings,
+                const std::vector<double>&          samplingIntervals,
+                uint32_t                            maxNoOfItems,
+                std::vector<Partition>&             partitions);
+
+
+        /**
+         * Release the subscriptions that were acquired by acquirePartitions().
+         *
+         * @param partitions    The partitions to be released (the vector will be cleared).
+         */
+        void releasePartitions(std::vector<Partition>& partitions);
+
+
+        /**
+         * Construct a new subscription, and create it on the server.
+         *
+         * The subscriptionMapMutex_ must be locked by the caller. The subscription is acquired
+         * (its activity count is 1), also if it couldn't be created on the server.
+         *
+         * @param subscriptionSettings  Settings of the subscription to be constructed.
+         * @param subscription          Output parameter: pointer to the new subscription.
+         * @return                      Bad if the subscription could not be created.
+         */
+        uaf::Status constructSubscription(
+                const uaf::SubscriptionSettings&    subscriptionSettings,
+                uaf::Subscription*&                 subscription);
+
 
         /**
          * Acquire a subscription with the given properties (by getting an existing one, or creating
@@ -333,6 +593,8 @@ namespace uaf
         // map storing all activity counts, and its mutex
         ActivityMap activityMap_;
         UaMutex     activityMapMutex_;
+        // the partitioned subscriptions (guarded by the subscriptionMapMutex_)
+        PartitionedSubscriptionMap partitionedSubscriptions_;
         // the mutex to safeguard the critical sections
         UaMutex subscriptionMutex_;
         // the RequesterInterface to call when asynchronous messages are received
@@ -19,6 +19,7 @@
  */
 
 #include "uaf/util/address.h"
+#include "uaf/util/hashfunctions.h"
 
 
 namespace uaf
@@ -37,7 +38,8 @@ namespace uaf
       isStartingAddressOwned_(false),
       relativePath_(0),
       startingAddress_(0),
-      expandedNodeId_(new ExpandedNodeId)
+      expandedNodeId_(new ExpandedNodeId),
+      hash_(0)
     {}
 
 
@@ -48,7 +50,8 @@ namespace uaf
       isStartingAddressOwned_(true),
       relativePath_(new vector<RelativePathElement>(relativePath)),
       startingAddress_(new Address(*startingAddress)),
-      expandedNodeId_(0)
+      expandedNodeId_(0),
+      hash_(0)
     {}
 
 
@@ -58,7 +61,8 @@ namespace uaf
     : isRelativePath_(true),
       isStartingAddressOwned_(true),
       startingAddress_(new Address(*startingAddress)),
-      expandedNodeId_(0)
+      expandedNodeId_(0),
+      hash_(0)
     {
         relativePath_ = new vector<RelativePathElement>();
         relativePath_->push_back(relativePath);
@@ -73,7 +77,8 @@ namespace uaf
       isStartingAddressOwned_(true),
       relativePath_(new vector<RelativePathElement>(browsePath.relativePath)),
       startingAddress_(new Address(browsePath.startingExpandedNodeId)),
-      expandedNodeId_(0)
+      expandedNodeId_(0),
+      hash_(0)
     {}
 
 
@@ -84,7 +89,8 @@ namespace uaf
       isStartingAddressOwned_(false),
       relativePath_(0),
       startingAddress_(0),
-      expandedNodeId_(new ExpandedNodeId(expandedNodeId))
+      expandedNodeId_(new ExpandedNodeId(expandedNodeId)),
+      hash_(0)
     {}
 
 
@@ -95,13 +101,15 @@ namespace uaf
       isStartingAddressOwned_(false),
       relativePath_(0),
       startingAddress_(0),
-      expandedNodeId_(new ExpandedNodeId(nodeId, serverUri))
+      expandedNodeId_(new ExpandedNodeId(nodeId, serverUri)),
+      hash_(0)
     {}
 
 
     // Constructor
     // =============================================================================================
     Address::Address(const Address& other)
+    : hash_(other.hash_.load(std::memory_order_relaxed))
     {
         isRelativePath_ = other.isRelativePath_;
         isStartingAddressOwned_ = other.isStartingAddressOwned_;
@@ -133,6 +141,7 @@ namespace uaf
 
             isRelativePath_ = other.isRelativePath_;
             isStartingAddressOwned_ = other.isStartingAddressOwned_;
+            hash_.store(other.hash_.load(std::memory_order_relaxed), std::memory_order_relaxed);
             if (isRelativePath_)
             {
                 relativePath_    = new vector<RelativePathElement>(*other.relativePath_);
@@ -164,6 +173,8 @@ namespace uaf
     // =============================================================================================
     void Address::clear()
     {
+        hash_.store(0, std::memory_order_relaxed);
+
         if (isRelativePath_)
         {
             delete relativePath_;
@@ -199,7 +210,7 @@ namespace uaf
 
     // Get the starting address
     // =============================================================================================
-    Address* Address::getStartingAddress() const
+    const Address* Address::getStartingAddress() const
     {
         if (isRelativePath_)
             return startingAddress_;
@@ -312,6 +323,70 @@ namespace uaf
 
 
 
+    // Get the (memoized) hash
+    // =============================================================================================
+    size_t Address::hash() const
+    {
+        // concurrent threads may compute the hash at the same time, but they store the same value
+        size_t ret = hash_.load(std::memory_order_relaxed);
+        if (ret == 0)
+        {
+            ret = computeHash();
+            hash_.store(ret, std::memory_order_relaxed);
+        }
+        return ret;
+    }
+
+
+    // Helper function to hash a NodeId (only the fields that are cheap to hash, equal NodeIds
+    // still have equal hashes)
+    // =============================================================================================
+    static void hashCombineNodeId(size_t& seed, const NodeId& nodeId)
+    {
+        NodeIdIdentifier identifier = nodeId.identifier();
+        hashCombine(seed, size_t(identifier.type));
+        hashCombine(seed, size_t(identifier.idNumeric));
+        hashCombine(seed, identifier.idString);
+        hashCombine(seed, size_t(nodeId.nameSpaceIndex()));
+        hashCombine(seed, nodeId.nameSpaceUri());
+    }
+
+
+    // Compute the hash
+    // =============================================================================================
+    size_t Address::computeHash() const
+    {
+        size_t ret = 0;
+
+        if (isRelativePath_)
+        {
+            hashCombine(ret, size_t(1));
+
+            for (size_t i = 0; i < relativePath_->size(); i++)
+            {
+                const RelativePathElement& element = (*relativePath_)[i];
+                hashCombine(ret, element.targetName.name());
+                hashCombine(ret, size_t(element.targetName.nameSpaceIndex()));
+                hashCombine(ret, element.targetName.nameSpaceUri());
+                hashCombineNodeId(ret, element.referenceType);
+                hashCombine(ret, size_t(element.isInverse));
+                hashCombine(ret, size_t(element.includeSubtypes));
+            }
+
+            hashCombine(ret, startingAddress_->hash());
+        }
+        else
+        {
+            hashCombineNodeId(ret, expandedNodeId_->nodeId());
+            hashCombine(ret, size_t(expandedNodeId_->serverIndex()));
+            hashCombine(ret, expandedNodeId_->serverUri());
+        }
+
+        // 0 means "not computed yet"
+        return (ret == 0) ? 1 : ret;
+    }
+
+
     // operator==
     // =============================================================================================
     bool operator==(const Address& object1, const Address& object2)
@@ -24,6 +24,9 @@
 // STD
 #include <string>
 #include <sstream>
+#ifndef SWIG
+#include <atomic>
+#endif
 // UAF
 #include "uaf/util/util.h"
 #include "uaf/util/status.h"
@@ -158,9 +161,12 @@ namespace uaf
          * Get a pointer to the starting Address of a relative path, in case isRelativePath()
          * is true.
          *
+         * The starting address cannot be modified via this pointer, since that would make the
+         * memoized hash of this address stale.
+         *
          * @return  A pointer to the starting Address.
          */
-        uaf::Address* getStartingAddress() const;
+        const uaf::Address* getStartingAddress() const;
 
 
         /**
@@ -200,6 +206,17 @@ namespace uaf
         uaf::Status toSdk(OpcUa_NodeId* uaNodeId) const;
 
 
+        /**
+         * Get a hash of the address (e.g. to store addresses in a hash map).
+         *
+         * The hash is computed only once, and then memoized by the address.
+         * Equal addresses have equal hashes.
+         *
+         * @return The hash.
+         */
+        std::size_t hash() const;
+
+
 
         /**
          * Get the serverUri of the address, in case isExpandedNodeId() is true and in case the
@@ -233,6 +250,14 @@ namespace uaf
         // The ExpandedNodeId in case the address is absolute.
         uaf::ExpandedNodeId* expandedNodeId_;
 
+#ifndef SWIG
+        // The memoized hash (0 if it has not been computed yet).
+        mutable std::atomic<std::size_t> hash_;
+#endif
+
+        // Compute the hash.
+        std::size_t computeHash() const;
+
     };
 
 
@@ -0,0 +1,288 @@
+/* This file is part of the UAF (Unified Architecture Framework) project.
+ *
+ * Copyright (C) 2012 Wim Pessemier (Institute of Astronomy, KULeuven)
+ *
+ * Project website: http://www.ster.kuleuven.be/uaf
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// STD
+#include <cstdio>
+#include <cstring>
+// SDK
+// UAF
+#include "uaf/util/asynclogsink.h"
+#include "uaf/util/logger.h"
+
+
+namespace uaf
+{
+    using namespace uaf;
+    using std::string;
+
+
+    // the maximum time the background thread waits for new messages, in milliseconds
+    static const uint32_t CONSUMER_WAIT_TIMEOUT_MS = 100;
+
+    // the maximum time a producer waits for space in a full buffer before checking again, in
+    // milliseconds (a wake up is normally received much sooner)
+    static const uint32_t PRODUCER_WAIT_TIMEOUT_MS = 100;
+
+    // the maximum number of wake ups that can be pending for the waiting producers
+    static const uint32_t MAX_PRODUCER_WAKE_UPS = 0xFFFF;
+
+
+    // Copy a string into a fixed-size buffer, truncating it if needed
+    // =============================================================================================
+    static void copyTruncated(char* destination, size_t destinationSize, const char* source)
+    {
+        size_t length = strlen(source);
+        if (length >= destinationSize)
+            length = destinationSize - 1;
+        memcpy(destination, source, length);
+        destination[length] = '\0';
+    }
+
+
+    // Constructor
+    // =============================================================================================
+    AsyncLogSink::AsyncLogSink(
+            LoggerFactory*                          loggerFactory,
+            const string&                           applicationName,
+            uint32_t                                capacity,
+            logoverflowpolicies::LogOverflowPolicy  overflowPolicy)
+    : loggerFactory_(loggerFactory),
+      applicationName_(applicationName),
+      overflowPolicy_(overflowPolicy),
+      records_(capacity),
+      noOfDroppedMessages_(0),
+      noOfReportedDroppedMessages_(0),
+      consumerThreadId_(0),
+      consumerWaiting_(false),
+      consumerWakeUp_(0, 1),
+      noOfWaitingProducers_(0),
+      producersWakeUp_(0, MAX_PRODUCER_WAKE_UPS),
+      stopRequested_(false),
+      stopped_(false)
+    {
+        start();
+    }
+
+
+    // Round the capacity up to a power of 2
+    // =============================================================================================
+    uint32_t AsyncLogSink::roundUpCapacity(uint32_t capacity)
+    {
+        return BoundedRingBuffer<Record>::roundUpCapacity(capacity);
+    }
+
+
+    // Destructor
+    // =============================================================================================
+    AsyncLogSink::~AsyncLogSink()
+    {
+        stop();
+
+        // write the messages that may have been pushed after the thread was stopped
+        drain();
+    }
+
+
+    // Stop the background thread
+    // =============================================================================================
+    void AsyncLogSink::stop()
+    {
+        if (!stopped_)
+        {
+            stopRequested_.store(true);
+            consumerWakeUp_.post(1);
+            wakeUpProducers();
+            wait();
+            stopped_ = true;
+        }
+    }
+
+
+    // Add a message to the buffer
+    // =============================================================================================
+    bool AsyncLogSink::push(
+            loglevels::LogLevel level,
+            const string&       loggerName,
+            const char*         msg)
+    {
+        // messages logged by the background thread itself (e.g. by the callback interface) are
+        // written immediately, since the background thread must never block on its own buffer
+        if (UaThread::currentThreadId() == consumerThreadId_.load())
+        {
+            loggerFactory_->write(LogMessage(level, applicationName_, loggerName, msg));
+            return true;
+        }
+
+        if (tryPush(level, loggerName, msg))
+            return true;
+
+        if (overflowPolicy_ == logoverflowpolicies::Block)
+        {
+            bool pushed = false;
+
+            // wait until the consumer made some space in the buffer, or until the sink is stopped
+            noOfWaitingProducers_.fetch_add(1);
+            while (!stopRequested_.load() && !(pushed = tryPush(level, loggerName, msg)))
+            {
+                wakeUpConsumer();
+                producersWakeUp_.timedWait(PRODUCER_WAIT_TIMEOUT_MS);
+            }
+            noOfWaitingProducers_.fetch_sub(1);
+
+            if (pushed)
+                return true;
+        }
+
+        noOfDroppedMessages_.fetch_add(1);
+        return false;
+    }
+
+
+    // Try to add a message to the buffer
+    // =============================================================================================
+    bool AsyncLogSink::tryPush(
+            loglevels::LogLevel level,
+            const string&       loggerName,
+            const char*         msg)
+    {
+        // claim a free record
+        uint64_t position;
+        Record* record = records_.claim(position);
+
+        // the buffer is full
+        if (record == 0)
+            return false;
+
+        // fill the record (the timestamp is the one of the moment of logging, not of writing)
+        LogMessage::currentTime(record->ctime, record->msec);
+        record->level = level;
+        copyTruncated(record->loggerName, sizeof(record->loggerName), loggerName.c_str());
+
+        size_t length = strlen(msg);
+        if (length < sizeof(record->inlineMessage))
+        {
+            memcpy(record->inlineMessage, msg, length + 1);
+        }
+        else
+        {
+            record->heapMessage = new char[length + 1];
+            memcpy(record->heapMessage, msg, length + 1);
+        }
+
+        // publish the record to the consumer
+        records_.publish(position);
+
+        wakeUpConsumer();
+
+        return true;
+    }
+
+
+    // Wake up the consumer
+    // =============================================================================================
+    void AsyncLogSink::wakeUpConsumer()
+    {
+        if (consumerWaiting_.exchange(false))
+            consumerWakeUp_.post(1);
+    }
+
+
+    // Wake up the producers
+    // =============================================================================================
+    void AsyncLogSink::wakeUpProducers()
+    {
+        uint32_t noOfWaitingProducers = noOfWaitingProducers_.load();
+        if (noOfWaitingProducers > 0)
+            producersWakeUp_.post(noOfWaitingProducers);
+    }
+
+
+    // Write all messages that are currently in the buffer
+    // =============================================================================================
+    uint32_t AsyncLogSink::drain()
+    {
+        uint32_t noOfMessages = 0;
+
+        // take the records until the buffer is empty (or the next one was not published yet)
+        for (Record* record = records_.front(); record != 0; record = records_.front())
+        {
+            LogMessage message(
+                    record->level,
+                    applicationName_,
+                    record->loggerName,
+                    record->heapMessage != 0 ? record->heapMessage : record->inlineMessage);
+            message.ctime = record->ctime;
+            message.msec  = record->msec;
+
+            delete[] record->heapMessage;
+            record->heapMessage = 0;
+
+            // release the record for the producers
+            records_.pop();
+
+            loggerFactory_->write(message);
+            noOfMessages++;
+        }
+
+        // there's space in the buffer again
+        if (noOfMessages > 0)
+            wakeUpProducers();
+
+        // report any dropped messages
+        uint64_t noOfDroppedMessages = noOfDroppedMessages_.load();
+        if (noOfDroppedMessages != noOfReportedDroppedMessages_)
+        {
+            char buffer[128];
+            snprintf(buffer, sizeof(buffer),
+                     "%llu log message(s) were dropped since the log buffer was full",
+                     (unsigned long long)(noOfDroppedMessages - noOfReportedDroppedMessages_));
+            noOfReportedDroppedMessages_ = noOfDroppedMessages;
+            loggerFactory_->write(LogMessage(loglevels::Warning, applicationName_, "AsyncLogSink", buffer));
+        }
+
+        return noOfMessages;
+    }
+
+
+    // Run the background thread
+    // =============================================================================================
+    void AsyncLogSink::run()
+    {
+        consumerThreadId_.store(UaThread::currentThreadId());
+
+        while (!stopRequested_.load())
+        {
+            if (drain() == 0)
+            {
+                // announce that we will wait, and check again to avoid missing a wake up
+                consumerWaiting_.store(true);
+                if (drain() == 0 && !stopRequested_.load())
+                    consumerWakeUp_.timedWait(CONSUMER_WAIT_TIMEOUT_MS);
+                consumerWaiting_.store(false);
+            }
+        }
+
+        // write the messages that are still pending
+        drain();
+    }
+
+
+}
+
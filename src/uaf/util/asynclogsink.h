@@ -0,0 +1,217 @@
+/* This file is part of the UAF (Unified Architecture Framework) project.
+ *
+ * Copyright (C) 2012 Wim Pessemier (Institute of Astronomy, KULeuven)
+ *
+ * Project website: http://www.ster.kuleuven.be/uaf
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UAF_ASYNCLOGSINK_H_
+#define UAF_ASYNCLOGSINK_H_
+
+
+#define UAF_ASYNCLOGSINK_MAX_LOGGERNAME_SIZE 64
+#define UAF_ASYNCLOGSINK_INLINE_MESSAGE_SIZE 256
+
+
+// STD
+#include <string>
+#include <atomic>
+#include <stdint.h>
+// SDK
+#include "uabasecpp/uathread.h"
+#include "uabasecpp/uasemaphore.h"
+// UAF
+#include "uaf/util/util.h"
+#include "uaf/util/boundedringbuffer.h"
+#include "uaf/util/loglevels.h"
+#include "uaf/util/logmessage.h"
+#include "uaf/util/logoverflowpolicies.h"
+
+
+namespace uaf
+{
+
+    // forward declaration of the LoggerFactory class
+    class LoggerFactory;
+
+
+    /*******************************************************************************************//**
+     * An AsyncLogSink decouples the threads that log messages from the formatting and writing of
+     * these messages.
+     *
+     * Producers (any thread that logs a message) copy the message into a record of a
+     * uaf::BoundedRingBuffer. A background thread takes the records from the
+     * buffer, and hands them over to the LoggerFactory which will format and write them (to the
+     * stdout and/or the callback interface).
+     *
+     * When the buffer is full, the overflow policy determines whether the message is dropped
+     * (and counted), or whether the producer is blocked until there is space in the buffer.
+     *
+     * The records are kept small: messages that don't fit in a record are copied to the heap
+     * instead (so they are not truncated), while logger names that don't fit are truncated.
+     *
+     * @ingroup Util
+     **********************************************************************************************/
+    class UAF_EXPORT AsyncLogSink : private UaThread
+    {
+    public:
+
+
+        /**
+         * Construct the sink and start its background thread.
+         *
+         * @param loggerFactory     The LoggerFactory that will eventually write the messages.
+         * @param applicationName   The name of the application (to be added to the messages).
+         * @param capacity          The number of records in the ring buffer (will be rounded up
+         *                          to the next power of two, with a minimum of 2).
+         * @param overflowPolicy    What to do with a message if the buffer is full.
+         */
+        AsyncLogSink(
+                uaf::LoggerFactory*                         loggerFactory,
+                const std::string&                          applicationName,
+                uint32_t                                    capacity,
+                uaf::logoverflowpolicies::LogOverflowPolicy overflowPolicy);
+
+
+        /**
+         * Destruct the sink: stop the background thread after all pending messages were written.
+         */
+        virtual ~AsyncLogSink();
+
+
+        /**
+         * Stop the background thread after all pending messages were written.
+         *
+         * Messages that are pushed after the sink was stopped, are only written when the sink is
+         * destructed. Producers that are blocked because the buffer is full, are released (and
+         * their messages are dropped).
+         */
+        void stop();
+
+
+        /**
+         * Add a message to the buffer (this method can be called by any thread).
+         *
+         * @param level         The level of the message.
+         * @param loggerName    The name of the logger.
+         * @param msg           The message.
+         * @return              True if the message was added (or written immediately), false
+         *                      if it was dropped.
+         */
+        bool push(
+                uaf::loglevels::LogLevel    level,
+                const std::string&          loggerName,
+                const char*                 msg);
+
+
+        /**
+         * Get the total number of messages that were dropped because the buffer was full.
+         */
+        uint64_t noOfDroppedMessages() const { return noOfDroppedMessages_.load(); }
+
+
+        /**
+         * Get the number of records that a ring buffer for the requested capacity will have.
+         */
+        static uint32_t roundUpCapacity(uint32_t capacity);
+
+
+        /**
+         * Get the number of records in the ring buffer.
+         */
+        uint32_t capacity() const { return records_.capacity(); }
+
+
+        /**
+         * Get the overflow policy.
+         */
+        uaf::logoverflowpolicies::LogOverflowPolicy overflowPolicy() const { return overflowPolicy_; }
+
+
+    private:
+        DISALLOW_COPY_AND_ASSIGN(AsyncLogSink);
+
+
+        // a record of the ring buffer
+        struct Record
+        {
+            Record() : heapMessage(0) {}
+            ~Record() { delete[] heapMessage; }
+
+            // the time when the message was logged
+            int64_t                     ctime;
+            int16_t                     msec;
+            // the level of the message
+            uaf::loglevels::LogLevel    level;
+            // the (truncated) logger name and the message, as null-terminated strings (the
+            // message is stored on the heap if it doesn't fit in the record)
+            char                        loggerName[UAF_ASYNCLOGSINK_MAX_LOGGERNAME_SIZE];
+            char                        inlineMessage[UAF_ASYNCLOGSINK_INLINE_MESSAGE_SIZE];
+            char*                       heapMessage;
+        };
+
+
+        // try to add a message to the buffer, without blocking
+        bool tryPush(
+                uaf::loglevels::LogLevel    level,
+                const std::string&          loggerName,
+                const char*                 msg);
+
+        // write all messages that are currently in the buffer, returns the number of messages
+        uint32_t drain();
+
+        // the background thread
+        virtual void run();
+
+        // wake up the background thread if it's waiting for messages
+        void wakeUpConsumer();
+
+        // wake up the producers that are waiting for space in the buffer
+        void wakeUpProducers();
+
+
+        // the logger factory that will write the messages
+        uaf::LoggerFactory*                         loggerFactory_;
+        // the name of the application
+        std::string                                 applicationName_;
+        // the overflow policy
+        uaf::logoverflowpolicies::LogOverflowPolicy overflowPolicy_;
+        // the ring buffer (only the background thread takes records from it)
+        uaf::BoundedRingBuffer<Record>              records_;
+        // the number of dropped messages, and the number that was already reported
+        std::atomic<uint64_t>                       noOfDroppedMessages_;
+        uint64_t                                    noOfReportedDroppedMessages_;
+        // the id of the background thread (0 as long as it's not running)
+        std::atomic<OpcUa_UInt32>                   consumerThreadId_;
+        // true if the consumer is waiting (or about to wait) for new messages
+        std::atomic<bool>                           consumerWaiting_;
+        // semaphore to wake up the consumer
+        UaSemaphore                                 consumerWakeUp_;
+        // the number of producers that are waiting for space in the buffer (Block policy)
+        std::atomic<uint32_t>                       noOfWaitingProducers_;
+        // semaphore to wake up the producers that are waiting for space in the buffer
+        UaSemaphore                                 producersWakeUp_;
+        // true if the background thread must stop, and true if it has been stopped
+        std::atomic<bool>                           stopRequested_;
+        bool                                        stopped_;
+    };
+
+
+}
+
+
+
+#endif /* UAF_ASYNCLOGSINK_H_ */
@@ -0,0 +1,93 @@
+/* This file is part of the UAF (Unified Architecture Framework) project.
+ *
+ * Copyright (C) 2012 Wim Pessemier (Institute of Astronomy, KULeuven)
+ *
+ * Project website: http://www.ster.kuleuven.be/uaf
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef UAF_BACKOFF_H_
+#define UAF_BACKOFF_H_
+
+
+// STD
+#include <thread>
+#include <stdint.h>
+// SDK
+#include "uabasecpp/uathread.h"
+// UAF
+#include "uaf/util/util.h"
+
+
+namespace uaf
+{
+
+
+    /*******************************************************************************************//**
+    * A uaf::Backoff lets a thread wait for a condition that is usually fulfilled very soon,
+    * without burning a CPU core when it isn't.
+    *
+    * The first calls to pause() only yield the processor, the later calls put the thread to
+    * sleep for a millisecond. Create a new instance for every wait.
+    *
+    * @ingroup Util
+    ***********************************************************************************************/
+    class Backoff
+    {
+    public:
+
+        /** The number of times that pause() yields, before it starts sleeping. */
+        static const uint32_t MAX_YIELDS = 64;
+
+        /** The number of milliseconds that pause() sleeps, once it doesn't yield anymore. */
+        static const uint32_t SLEEP_MS = 1;
+
+
+        /**
+         * Construct a backoff.
+         */
+        Backoff() : noOfPauses_(0) {}
+
+
+        /**
+         * Wait a little while before checking the condition again.
+         */
+        void pause()
+        {
+            if (noOfPauses_ < MAX_YIELDS)
+            {
+                noOfPauses_++;
+                std::this_thread::yield();
+            }
+            else
+            {
+                UaThread::msleep(SLEEP_MS);
+            }
+        }
+
+
+    private:
+        DISALLOW_COPY_AND_ASSIGN(Backoff);
+
+        // the number of times that pause() has been called (up to MAX_YIELDS)
+        uint32_t noOfPauses_;
+    };
+
+
+}
+
+
+#endif /* UAF_BACKOFF_H_ */
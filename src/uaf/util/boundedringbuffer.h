@@ -0,0 +1,224 @@
+/* This file is part of the UAF (Unified Architecture Framework) project.
+ *
+ * Copyright (C) 2012 Wim Pessemier (Institute of Astronomy, KULeuven)
+ *
+ * Project website: http://www.ster.kuleuven.be/uaf
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UAF_BOUNDEDRINGBUFFER_H_
+#define UAF_BOUNDEDRINGBUFFER_H_
+
+
+// STD
+#include <atomic>
+#include <stdint.h>
+// SDK
+// UAF
+#include "uaf/util/util.h"
+
+
+namespace uaf
+{
+
+
+    /*******************************************************************************************//**
+    * A uaf::BoundedRingBuffer is a lock-free ring buffer for multiple producers and a single
+    * consumer (the bounded queue of D. Vyukov).
+    *
+    * The elements are stored in the buffer itself, and are reused for every rotation of the
+    * buffer: a producer claims a free element, fills it and publishes it, after which the consumer
+    * can take it from the front of the buffer, and release it again.
+    *
+    * Any thread may call claim(), publish() and isEmpty(), but only one thread at a time may call
+    * front() and pop().
+    *
+    * @ingroup Util
+    ***********************************************************************************************/
+    template<typename T>
+    class BoundedRingBuffer
+    {
+    public:
+
+
+        /**
+         * Construct a buffer.
+         *
+         * @param capacity  The number of elements (will be rounded up to the next power of two,
+         *                  with a minimum of 2).
+         */
+        BoundedRingBuffer(uint32_t capacity)
+        : slots_(0),
+          capacity_(roundUpCapacity(capacity)),
+          enqueuePosition_(0),
+          dequeuePosition_(0)
+        {
+            slots_ = new Slot[capacity_];
+            for (uint32_t i = 0; i < capacity_; i++)
+                slots_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+
+
+        /**
+         * Destruct the buffer, and all of its elements.
+         */
+        ~BoundedRingBuffer()
+        {
+            delete[] slots_;
+            slots_ = 0;
+        }
+
+
+        /**
+         * Get the number of elements that a buffer for the requested capacity will have.
+         */
+        static uint32_t roundUpCapacity(uint32_t capacity)
+        {
+            uint32_t ret = 2;
+            while (ret < capacity && ret < (1u << 31))
+                ret <<= 1;
+            return ret;
+        }
+
+
+        /**
+         * Get the number of elements of the buffer.
+         */
+        uint32_t capacity() const { return capacity_; }
+
+
+        /**
+         * Claim a free element, which must be published afterwards (any thread).
+         *
+         * @param position  Output parameter: the position of the element, to be published.
+         * @return          The element to fill, or NULL if the buffer is full.
+         */
+        T* claim(uint64_t& position)
+        {
+            const uint64_t mask = capacity_ - 1;
+            position = enqueuePosition_.load(std::memory_order_relaxed);
+
+            for (;;)
+            {
+                Slot* slot = &slots_[position & mask];
+                uint64_t sequence = slot->sequence.load(std::memory_order_acquire);
+                int64_t difference = int64_t(sequence) - int64_t(position);
+
+                if (difference == 0)
+                {
+                    if (enqueuePosition_.compare_exchange_weak(position, position + 1,
+                                                               std::memory_order_relaxed))
+                        return &slot->value;
+                }
+                else if (difference < 0)
+                {
+                    // the buffer is full
+                    return 0;
+                }
+                else
+                {
+                    // another producer claimed this element, so try the next one
+                    position = enqueuePosition_.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+
+        /**
+         * Publish an element that was claimed and filled, to the consumer.
+         *
+         * The store is sequentially consistent, so that a producer and a consumer that both
+         * check each other's state afterwards (e.g. "is the buffer empty" versus "is anyone
+         * consuming") cannot both miss the other.
+         *
+         * @param position  The position of the element, as returned by claim().
+         */
+        void publish(uint64_t position)
+        {
+            slots_[position & (capacity_ - 1)].sequence.store(position + 1);
+        }
+
+
+        /**
+         * Get the element at the front of the buffer (consumer only).
+         *
+         * @return  The element, or NULL if the buffer is empty (or if the front element was
+         *          claimed, but not published yet).
+         */
+        T* front()
+        {
+            uint64_t position = dequeuePosition_.load(std::memory_order_relaxed);
+            Slot* slot = &slots_[position & (capacity_ - 1)];
+
+            if (slot->sequence.load(std::memory_order_acquire) != position + 1)
+                return 0;
+
+            return &slot->value;
+        }
+
+
+        /**
+         * Release the element at the front of the buffer, so that it can be claimed again
+         * (consumer only, after front() returned an element).
+         */
+        void pop()
+        {
+            uint64_t position = dequeuePosition_.load(std::memory_order_relaxed);
+
+            slots_[position & (capacity_ - 1)].sequence.store(position + capacity_,
+                                                              std::memory_order_release);
+            dequeuePosition_.store(position + 1, std::memory_order_relaxed);
+        }
+
+
+        /**
+         * Check if the buffer is empty (any thread).
+         */
+        bool isEmpty() const
+        {
+            uint64_t position = dequeuePosition_.load(std::memory_order_relaxed);
+            return slots_[position & (capacity_ - 1)].sequence.load() != position + 1;
+        }
+
+
+    private:
+        DISALLOW_COPY_AND_ASSIGN(BoundedRingBuffer);
+
+
+        // an element of the buffer
+        struct Slot
+        {
+            // the sequence number of the slot, which tells the producers and the consumer
+            // whether the element is free or filled
+            std::atomic<uint64_t>   sequence;
+            // the element
+            T                       value;
+        };
+
+
+        // the slots, and their number (a power of 2)
+        Slot*                   slots_;
+        uint32_t                capacity_;
+        // the position where the next element will be added (shared by the producers)
+        std::atomic<uint64_t>   enqueuePosition_;
+        // the position of the next element to be consumed (only changed by the consumer)
+        std::atomic<uint64_t>   dequeuePosition_;
+    };
+
+
+}
+
+
+#endif /* UAF_BOUNDEDRINGBUFFER_H_ */
@@ -5,11 +5,44 @@ namespace uaf
     using namespace uaf;
 
 
+    // Directory constructor
+    // =============================================================================================
+    template<class NotificationType> CallbackRegistry<NotificationType>::Directory::Directory(std::size_t noOfChunks)
+    : noOfChunks(noOfChunks),
+      chunks(new Slot*[noOfChunks])
+    {
+        for (std::size_t i = 0; i < noOfChunks; i++)
+            chunks[i] = 0;
+    }
+
+    // Directory destructor (does not delete the chunks, since they are shared by the directories)
+    // =============================================================================================
+    template<class NotificationType> CallbackRegistry<NotificationType>::Directory::~Directory()
+    {
+        delete[] chunks;
+    }
+
     // Constructor
     // =============================================================================================
     template<class NotificationType> CallbackRegistry<NotificationType>::CallbackRegistry()
+    : directory_(new Directory(0)),
+      overflowMap_(new OverflowMap()),
+      catchAllCallback_(0)
     {}
 
+    // Destructor
+    // =============================================================================================
+    template<class NotificationType> CallbackRegistry<NotificationType>::~CallbackRegistry()
+    {
+        synchronize();
+
+        Directory* directory = directory_.load();
+        for (std::size_t i = 0; i < directory->noOfChunks; i++)
+            delete[] directory->chunks[i];
+        delete directory;
+        delete overflowMap_.load();
+    }
+
     // Register a catchall Callback
     // =============================================================================================
     template<class NotificationType> void CallbackRegistry<NotificationType>::RegisterCallback(uaf::Callback<NotificationType>* pCallback)
@@ -21,16 +54,42 @@ namespace uaf
     // =============================================================================================
     template<class NotificationType> void CallbackRegistry<NotificationType>::RegisterCallback(uaf::ClientHandle clientHandle, uaf::Callback<NotificationType>* pCallback)
     {
-        UaMutexLocker locker(&mapMutex_);
-        callbackMap_[clientHandle] = pCallback;
+        bool mustSynchronize;
+
+        {
+            UaMutexLocker locker(&writeMutex_); // unlocks when out of scope
+            mustSynchronize = storeCallback(clientHandle, pCallback) != 0
+                              || !retiredDirectories_.empty() || !retiredOverflowMaps_.empty();
+        }
+
+        // wait until a replaced Callback isn't called anymore, and release the replaced memory
+        if (mustSynchronize)
+            synchronize();
     }
 
     // Unregister all Callbacks
     // =============================================================================================
     template<class NotificationType> void CallbackRegistry<NotificationType>::UnregisterAllCallbacks()
     {
-        UaMutexLocker locker(&mapMutex_);
-        callbackMap_.clear();
+        {
+            UaMutexLocker locker(&writeMutex_); // unlocks when out of scope
+
+            catchAllCallback_.store(0);
+
+            Directory* directory = directory_.load();
+            for (std::size_t i = 0; i < directory->noOfChunks; i++)
+            {
+                if (directory->chunks[i] != 0)
+                {
+                    for (std::size_t j = 0; j < CHUNK_SIZE; j++)
+                        directory->chunks[i][j].store(0);
+                }
+            }
+
+            retiredOverflowMaps_.push_back(overflowMap_.exchange(new OverflowMap()));
+        }
+
+        synchronize();
     }
 
     // Unregister all catchall Callbacks
@@ -44,8 +103,17 @@ namespace uaf
     // =============================================================================================
     template<class NotificationType> void CallbackRegistry<NotificationType>::UnregisterCallbacks(uaf::ClientHandle clientHandle)
     {
-        UaMutexLocker locker(&mapMutex_);
-        callbackMap_.erase(clientHandle);
+        bool mustSynchronize;
+
+        {
+            UaMutexLocker locker(&writeMutex_); // unlocks when out of scope
+            mustSynchronize = storeCallback(clientHandle, 0) != 0
+                              || !retiredDirectories_.empty() || !retiredOverflowMaps_.empty();
+        }
+
+        // wait until the unregistered Callback isn't called anymore
+        if (mustSynchronize)
+            synchronize();
     }
 
     // Call all Callbacks associated with the clientHandle of notification or
@@ -53,17 +121,166 @@ namespace uaf
     // =============================================================================================
     template<class NotificationType> void CallbackRegistry<NotificationType>::CallCallback(const NotificationType& notification)
     {
-        UaMutexLocker locker(&mapMutex_);
+        GracePeriod::ReadSection readSection(gracePeriod_); // leaves the section when out of scope
+        callCallbacks(directory_.load(), notification, catchAllCallback_.load());
+    }
+
+    // Call the Callbacks for a batch of notifications
+    // =============================================================================================
+    template<class NotificationType> void CallbackRegistry<NotificationType>::CallCallbacks(const std::vector<NotificationType>& notifications)
+    {
+        GracePeriod::ReadSection readSection(gracePeriod_); // leaves the section when out of scope
 
-        typename std::map<uaf::ClientHandle, uaf::Callback<NotificationType>* >::const_iterator iter;
+        // the directory and the catchall Callback are the same for all notifications of the batch
+        const Directory* directory = directory_.load();
+        CallbackType* catchAllCallback = catchAllCallback_.load();
+
+        typename std::vector<NotificationType>::const_iterator iter;
+        for (iter = notifications.begin(); iter != notifications.end(); ++iter)
+        {
+            callCallbacks(directory, *iter, catchAllCallback);
+        }
+    }
 
-        for (iter = callbackMap_.begin(); iter != callbackMap_.end(); ++iter)
+    // Call the Callbacks for a single notification
+    // =============================================================================================
+    template<class NotificationType> void CallbackRegistry<NotificationType>::callCallbacks(
+            const Directory*            directory,
+            const NotificationType&     notification,
+            CallbackType*               catchAllCallback)
+    {
+        // the associated Callback is called before the catchall Callback
+        if (notification.clientHandle != uaf::constants::CLIENTHANDLE_NOT_ASSIGNED)
         {
-            if (iter->first == uaf::constants::CLIENTHANDLE_NOT_ASSIGNED || iter->first == notification.clientHandle)
+            CallbackType* callback = findCallback(directory, notification.clientHandle);
+            if (callback != 0)
+                callback->operator()(notification);
+        }
+
+        if (catchAllCallback != 0)
+            catchAllCallback->operator()(notification);
+    }
+
+    // Get the slot of a client handle
+    // =============================================================================================
+    template<class NotificationType> typename CallbackRegistry<NotificationType>::Slot* CallbackRegistry<NotificationType>::findSlot(
+            const Directory*    directory,
+            uaf::ClientHandle   clientHandle) const
+    {
+        std::size_t chunk = clientHandle / CHUNK_SIZE;
+        if (chunk >= directory->noOfChunks || directory->chunks[chunk] == 0)
+            return 0;
+        return &directory->chunks[chunk][clientHandle % CHUNK_SIZE];
+    }
+
+    // Get the Callback of a client handle
+    // =============================================================================================
+    template<class NotificationType> typename CallbackRegistry<NotificationType>::CallbackType* CallbackRegistry<NotificationType>::findCallback(
+            const Directory*    directory,
+            uaf::ClientHandle   clientHandle) const
+    {
+        if (clientHandle < DENSE_LIMIT)
+        {
+            Slot* slot = findSlot(directory, clientHandle);
+            return (slot != 0) ? slot->load() : 0;
+        }
+
+        const OverflowMap* overflowMap = overflowMap_.load();
+        typename OverflowMap::const_iterator iter = overflowMap->find(clientHandle);
+        return (iter != overflowMap->end()) ? iter->second : 0;
+    }
+
+    // Store the Callback of a client handle
+    // =============================================================================================
+    template<class NotificationType> typename CallbackRegistry<NotificationType>::CallbackType* CallbackRegistry<NotificationType>::storeCallback(
+            uaf::ClientHandle   clientHandle,
+            CallbackType*       pCallback)
+    {
+        CallbackType* previousCallback = 0;
+
+        if (clientHandle == uaf::constants::CLIENTHANDLE_NOT_ASSIGNED)
+        {
+            previousCallback = catchAllCallback_.exchange(pCallback);
+        }
+        else if (clientHandle >= DENSE_LIMIT)
+        {
+            // copy the overflow map, and publish the copy
+            OverflowMap* overflowMap = new OverflowMap(*overflowMap_.load());
+            typename OverflowMap::const_iterator iter = overflowMap->find(clientHandle);
+            if (iter != overflowMap->end())
+                previousCallback = iter->second;
+            if (pCallback != 0)
+                (*overflowMap)[clientHandle] = pCallback;
+            else
+                overflowMap->erase(clientHandle);
+            retiredOverflowMaps_.push_back(overflowMap_.exchange(overflowMap));
+        }
+        else
+        {
+            Directory* directory = directory_.load();
+            Slot* slot = findSlot(directory, clientHandle);
+
+            if (slot == 0)
             {
-                iter->second->operator()(notification);
+                // nothing to unregister
+                if (pCallback == 0)
+                    return 0;
+
+                // the chunk doesn't exist yet: since the published directory can't be changed,
+                // a new one is published (if needed with more chunks: at least twice as many,
+                // to have few directories to retire)
+                std::size_t chunk = clientHandle / CHUNK_SIZE;
+                std::size_t noOfChunks = directory->noOfChunks;
+                if (chunk >= noOfChunks)
+                    noOfChunks = (2 * noOfChunks > chunk) ? 2 * noOfChunks : chunk + 1;
+
+                Directory* newDirectory = new Directory(noOfChunks);
+                for (std::size_t i = 0; i < directory->noOfChunks; i++)
+                    newDirectory->chunks[i] = directory->chunks[i];
+
+                // the new chunk is filled before the directory is published
+                newDirectory->chunks[chunk] = new Slot[CHUNK_SIZE];
+                for (std::size_t j = 0; j < CHUNK_SIZE; j++)
+                    newDirectory->chunks[chunk][j].store(0, std::memory_order_relaxed);
+                newDirectory->chunks[chunk][clientHandle % CHUNK_SIZE].store(pCallback, std::memory_order_relaxed);
+
+                directory_.store(newDirectory);
+                retiredDirectories_.push_back(directory);
+                return 0;
             }
+
+            previousCallback = slot->exchange(pCallback);
         }
+
+        return previousCallback;
+    }
+
+    // Wait for a grace period, and release the retired memory
+    // =============================================================================================
+    template<class NotificationType> void CallbackRegistry<NotificationType>::synchronize()
+    {
+        // a callback that unregisters callbacks can't wait for itself to finish: the retired
+        // memory will be released by a later call
+        if (GracePeriod::isInReadSection())
+            return;
+
+        // take the memory that was retired until now (i.e. that was replaced by memory that is
+        // already published)
+        std::vector<Directory*>     retiredDirectories;
+        std::vector<OverflowMap*>   retiredOverflowMaps;
+        {
+            UaMutexLocker locker(&writeMutex_); // unlocks when out of scope
+            retiredDirectories.swap(retiredDirectories_);
+            retiredOverflowMaps.swap(retiredOverflowMaps_);
+        }
+
+        gracePeriod_.wait();
+
+        for (std::size_t i = 0; i < retiredDirectories.size(); i++)
+            delete retiredDirectories[i];
+
+        for (std::size_t i = 0; i < retiredOverflowMaps.size(); i++)
+            delete retiredOverflowMaps[i];
     }
 
     template class CallbackRegistry<uaf::DataChangeNotification>;
@@ -4,8 +4,10 @@
 
 // STD
 #include <map>
+#include <vector>
 #include <string>
 #include <sstream>
+#include <atomic>
 // SDK
 #include "uabasecpp/uamutex.h"
 // UAF
@@ -14,6 +16,7 @@
 #include "uaf/util/handles.h"
 #include "uaf/util/constants.h"
 #include "uaf/util/callbacks.h"
+#include "uaf/util/graceperiod.h"
 #include "uaf/client/subscriptions/datachangenotification.h"
 #include "uaf/client/subscriptions/eventnotification.h"
 
@@ -25,6 +28,15 @@ namespace uaf
     /*******************************************************************************************//**
     * A uaf::CallbackRegistry is a registry for notification callbacks.
     *
+    * The callbacks are stored in an array that is indexed by the (dense) client handles, so that
+    * emitting a notification costs a single array access. Emitting notifications never locks:
+    * the registering and unregistering threads publish their changes atomically, and memory
+    * that may still be read by an emitting thread is only released after a uaf::GracePeriod.
+    *
+    * When an unregister method returns, the unregistered callbacks will not be called anymore,
+    * unless the method was called from within a callback (then the notifications that are being
+    * emitted at that moment may still be delivered to them).
+    *
     * @ingroup Util
     ***********************************************************************************************/
     template<class NotificationType> class UAF_EXPORT CallbackRegistry
@@ -36,6 +48,11 @@ namespace uaf
          */
         CallbackRegistry();
 
+        /**
+         * Destruct the callback registry.
+         */
+        ~CallbackRegistry();
+
         /**
          * Register a callback for all notifications.
          */
@@ -66,10 +83,72 @@ namespace uaf
          */
         void CallCallback(const NotificationType& notification);
 
-    private:
-        std::map<uaf::ClientHandle, uaf::Callback<NotificationType>* > callbackMap_;
+        /**
+         * Emit a batch of notifications to registered callbacks.
+         *
+         * The grace period of the registry is entered only once for the whole batch, and the
+         * callback that is registered for all notifications is looked up only once.
+         */
+        void CallCallbacks(const std::vector<NotificationType>& notifications);
 
-        UaMutex mapMutex_;
+    private:
+        DISALLOW_COPY_AND_ASSIGN(CallbackRegistry);
+
+        typedef uaf::Callback<NotificationType>                 CallbackType;
+        typedef std::atomic<CallbackType*>                      Slot;
+        typedef std::map<uaf::ClientHandle, CallbackType*>      OverflowMap;
+
+        // the number of client handles per chunk of the array
+        static const std::size_t CHUNK_SIZE = 1024;
+        // the client handles from this one onwards are not stored in the array (since it would
+        // become too large), but in the (much slower) overflow map
+        static const uaf::ClientHandle DENSE_LIMIT = 1u << 22;
+
+        // the chunks of the array (a chunk is never moved or released until destruction, only
+        // the directory pointing to them is replaced when it grows)
+        struct Directory
+        {
+            Directory(std::size_t noOfChunks);
+            ~Directory();
+            std::size_t     noOfChunks;
+            Slot**          chunks;
+        };
+
+        // the currently published directory and overflow map (both only read by the emitters)
+        std::atomic<Directory*>     directory_;
+        std::atomic<OverflowMap*>   overflowMap_;
+        // the callback for all notifications
+        std::atomic<CallbackType*>  catchAllCallback_;
+
+        // the grace period that the emitters read the published memory in
+        uaf::GracePeriod            gracePeriod_;
+
+        // the replaced directories and overflow maps, to be deleted after the next grace period
+        std::vector<Directory*>     retiredDirectories_;
+        std::vector<OverflowMap*>   retiredOverflowMaps_;
+
+        // the mutex to lock when (un)registering (only locked by an emitter if a callback
+        // (un)registers callbacks, so never to be locked while waiting for a grace period)
+        UaMutex writeMutex_;
+
+        // get the slot of a client handle (0 if the slot doesn't exist)
+        Slot* findSlot(const Directory* directory, uaf::ClientHandle clientHandle) const;
+
+        // get the callback registered for a client handle (0 if there is none)
+        CallbackType* findCallback(const Directory* directory, uaf::ClientHandle clientHandle) const;
+
+        // store the callback for a client handle, and return the previous one (writeMutex_ must
+        // be locked)
+        CallbackType* storeCallback(uaf::ClientHandle clientHandle, CallbackType* pCallback);
+
+        // wait until all emitters that may use the retired memory have finished, and delete
+        // it (writeMutex_ must not be locked)
+        void synchronize();
+
+        // call the callbacks for a single notification
+        void callCallbacks(const Directory*     directory,
+                           const NotificationType&  notification,
+                           CallbackType*        catchAllCallback);
     };
 
 
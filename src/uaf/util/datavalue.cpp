@@ -132,6 +132,19 @@ namespace uaf
     }
 
 
+    // Get the contents from a OpcUa_DataValue instance
+    // =============================================================================================
+    void DataValue::fromSdk(const OpcUa_DataValue& dataValue)
+    {
+        opcUaStatusCode = dataValue.StatusCode;
+        data.fromSdk(dataValue.Value);
+        sourceTimestamp.fromSdk(UaDateTime(dataValue.SourceTimestamp));
+        serverTimestamp.fromSdk(UaDateTime(dataValue.ServerTimestamp));
+        sourcePicoseconds = dataValue.SourcePicoseconds;
+        serverPicoseconds = dataValue.ServerPicoseconds;
+    }
+
+
     // Copy the contents to a UaDataValue instance
     // =============================================================================================
     void DataValue::toSdk(UaDataValue& uaDataValue) const
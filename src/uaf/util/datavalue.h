@@ -115,6 +115,15 @@ namespace uaf
         void fromSdk(const UaDataValue& uaDataValue);
 
 
+        /**
+         * Get the contents of the DataValue directly from a stack OpcUa_DataValue instance
+         * (without creating a temporary SDK UaDataValue instance).
+         *
+         * @param dataValue  Stack OpcUa_DataValue instance.
+         */
+        void fromSdk(const OpcUa_DataValue& dataValue);
+
+
         /**
          * Copy the contents to an SDK instance.
          *
@@ -252,6 +252,38 @@ namespace uaf
         uaf::SdkStatus sdkStatus;
     };
 
+    class UAF_EXPORT RegisterNodesInvocationError : public uaf::ServiceError
+    {
+    public:
+        RegisterNodesInvocationError()
+        : uaf::ServiceError("Could not invoke the RegisterNodes service")
+        {}
+
+        RegisterNodesInvocationError(const uaf::SdkStatus& sdkStatus)
+        : uaf::ServiceError(uaf::format("Could not invoke the RegisterNodes service: %s",
+                            sdkStatus.toString().c_str())),
+          sdkStatus(sdkStatus)
+        {}
+
+        uaf::SdkStatus sdkStatus;
+    };
+
+    class UAF_EXPORT UnregisterNodesInvocationError : public uaf::ServiceError
+    {
+    public:
+        UnregisterNodesInvocationError()
+        : uaf::ServiceError("Could not invoke the UnregisterNodes service")
+        {}
+
+        UnregisterNodesInvocationError(const uaf::SdkStatus& sdkStatus)
+        : uaf::ServiceError(uaf::format("Could not invoke the UnregisterNodes service: %s",
+                            sdkStatus.toString().c_str())),
+          sdkStatus(sdkStatus)
+        {}
+
+        uaf::SdkStatus sdkStatus;
+    };
+
     class UAF_EXPORT TranslateBrowsePathsToNodeIdsInvocationError : public uaf::ServiceError
     {
     public:
@@ -0,0 +1,99 @@
+/* This file is part of the UAF (Unified Architecture Framework) project.
+ *
+ * Copyright (C) 2012 Wim Pessemier (Institute of Astronomy, KULeuven)
+ *
+ * Project website: http://www.ster.kuleuven.be/uaf
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "uaf/util/graceperiod.h"
+
+
+namespace uaf
+{
+    using namespace uaf;
+
+
+    // the number of read sections that the calling thread is in
+    static thread_local int noOfReadSectionsOfThisThread = 0;
+
+
+    // Enter a read section
+    // =============================================================================================
+    GracePeriod::ReadSection::ReadSection(GracePeriod& gracePeriod)
+    : gracePeriod_(gracePeriod)
+    {
+        noOfReadSectionsOfThisThread++;
+
+        parity_ = gracePeriod_.epoch_.load() & 1;
+        gracePeriod_.noOfReaders_[parity_].fetch_add(1);
+    }
+
+
+    // Leave a read section
+    // =============================================================================================
+    GracePeriod::ReadSection::~ReadSection()
+    {
+        gracePeriod_.noOfReaders_[parity_].fetch_sub(1);
+
+        noOfReadSectionsOfThisThread--;
+    }
+
+
+    // Constructor
+    // =============================================================================================
+    GracePeriod::GracePeriod()
+    : epoch_(0)
+    {
+        noOfReaders_[0].store(0);
+        noOfReaders_[1].store(0);
+    }
+
+
+    // Check if the calling thread is reading
+    // =============================================================================================
+    bool GracePeriod::isInReadSection()
+    {
+        return noOfReadSectionsOfThisThread > 0;
+    }
+
+
+    // Wait for the readers
+    // =============================================================================================
+    bool GracePeriod::wait()
+    {
+        if (isInReadSection())
+            return false;
+
+        UaMutexLocker locker(&waitMutex_); // unlocks when out of scope
+
+        // flip the epoch twice, and wait each time until the readers of the previous parity have
+        // left (flipping only once is not enough, since a reader may have read the epoch before
+        // the flip, but only registered itself after the wait)
+        for (int i = 0; i < 2; i++)
+        {
+            uint64_t parity = epoch_.fetch_add(1) & 1;
+
+            // readers may take long (e.g. when they call callbacks of the user), so back off
+            Backoff backoff;
+            while (noOfReaders_[parity].load() != 0)
+                backoff.pause();
+        }
+
+        return true;
+    }
+
+}
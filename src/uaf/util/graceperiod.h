@@ -0,0 +1,128 @@
+/* This file is part of the UAF (Unified Architecture Framework) project.
+ *
+ * Copyright (C) 2012 Wim Pessemier (Institute of Astronomy, KULeuven)
+ *
+ * Project website: http://www.ster.kuleuven.be/uaf
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef UAF_GRACEPERIOD_H_
+#define UAF_GRACEPERIOD_H_
+
+
+// STD
+#include <atomic>
+#include <stdint.h>
+// SDK
+#include "uabasecpp/uamutex.h"
+// UAF
+#include "uaf/util/util.h"
+#include "uaf/util/backoff.h"
+
+
+namespace uaf
+{
+
+
+    /*******************************************************************************************//**
+    * A uaf::GracePeriod lets readers access shared memory without locking, while the writers can
+    * still find out when replaced memory is not being read anymore (like in "RCU").
+    *
+    * A reader accesses the memory only within a uaf::GracePeriod::ReadSection, which costs a
+    * single atomic increment and decrement. A writer publishes the new memory (e.g. by storing
+    * a pointer atomically), and then calls wait(): when it returns, no reader can still be using
+    * the memory that was replaced, so it can be deleted.
+    *
+    * All accesses to the published memory must be sequentially consistent (i.e. the default
+    * memory order of std::atomic), so that a writer either sees a reader, or the reader sees what
+    * the writer published.
+    *
+    * @ingroup Util
+    ***********************************************************************************************/
+    class UAF_EXPORT GracePeriod
+    {
+    public:
+
+
+        /**
+         * A read-side critical section, from construction until destruction.
+         */
+        class UAF_EXPORT ReadSection
+        {
+        public:
+
+            /**
+             * Enter the read-side critical section.
+             *
+             * @param gracePeriod   The grace period protecting the memory that will be read.
+             */
+            ReadSection(uaf::GracePeriod& gracePeriod);
+
+            /**
+             * Leave the read-side critical section.
+             */
+            ~ReadSection();
+
+        private:
+            DISALLOW_COPY_AND_ASSIGN(ReadSection);
+
+            uaf::GracePeriod&   gracePeriod_;
+            uint64_t            parity_;
+        };
+
+
+        /**
+         * Construct a grace period.
+         */
+        GracePeriod();
+
+
+        /**
+         * Wait until all readers that were in a read section when this method was called, have
+         * left it.
+         *
+         * Must not be called while holding a lock that the readers may need. The calling thread
+         * yields while the readers are short, and sleeps (see uaf::Backoff) when they aren't.
+         *
+         * @return True if the wait succeeded, false if the calling thread is in a read section
+         *         itself (of any grace period), in which case it can't wait for itself, and the
+         *         replaced memory must be deleted by a later call.
+         */
+        bool wait();
+
+
+        /**
+         * Check if the calling thread is in a read section (of any grace period).
+         */
+        static bool isInReadSection();
+
+
+    private:
+        DISALLOW_COPY_AND_ASSIGN(GracePeriod);
+
+        // the number of readers in their read section, for both parities of the epoch
+        std::atomic<uint64_t>   epoch_;
+        std::atomic<uint32_t>   noOfReaders_[2];
+
+        // the mutex to lock while waiting (never locked by the readers)
+        UaMutex                 waitMutex_;
+    };
+
+
+}
+
+
+#endif /* UAF_GRACEPERIOD_H_ */
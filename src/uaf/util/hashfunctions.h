@@ -0,0 +1,136 @@
+/* This file is part of the UAF (Unified Architecture Framework) project.
+ *
+ * Copyright (C) 2012 Wim Pessemier (Institute of Astronomy, KULeuven)
+ *
+ * Project website: http://www.ster.kuleuven.be/uaf
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef UAF_HASHFUNCTIONS_H_
+#define UAF_HASHFUNCTIONS_H_
+
+
+// STD
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <utility>
+#include <stdint.h>
+// SDK
+// UAF
+
+
+
+namespace uaf
+{
+
+
+    /**
+     * Mix the hash of a value into a seed (e.g. to compute the hash of an object that consists
+     * of multiple members).
+     *
+     * @param seed      The seed, which will be updated.
+     * @param value     The value to mix in.
+     *
+     * @ingroup Util
+     */
+    template<typename T>
+    inline void hashCombine(std::size_t& seed, const T& value)
+    {
+        seed ^= std::hash<T>()(value) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    }
+
+
+    /**
+     * Hash functor for a pair of hashable values (e.g. to use a pair as the key of an
+     * unordered container).
+     *
+     * @ingroup Util
+     */
+    template<typename T1, typename T2>
+    struct PairHash
+    {
+        std::size_t operator()(const std::pair<T1, T2>& pair) const
+        {
+            std::size_t seed = std::hash<T1>()(pair.first);
+            hashCombine(seed, pair.second);
+            return seed;
+        }
+    };
+
+
+    /**
+     * The initial value of a 64-bit FNV-1a hash.
+     *
+     * @ingroup Util
+     */
+    static const uint64_t FNV1A_OFFSET_BASIS = 14695981039346656037ULL;
+
+
+    /**
+     * Mix a number of bytes into a 64-bit FNV-1a hash.
+     *
+     * Contrary to std::hash, the result does not depend on the platform or the run, so it can
+     * be used for fingerprints that are stored (e.g. in a snapshot of the address cache).
+     *
+     * @param hash      The hash (initially FNV1A_OFFSET_BASIS), which will be updated.
+     * @param data      The bytes to mix in.
+     * @param size      The number of bytes.
+     *
+     * @ingroup Util
+     */
+    inline void fnv1a(uint64_t& hash, const void* data, std::size_t size)
+    {
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        for (std::size_t i = 0; i < size; i++)
+        {
+            hash ^= bytes[i];
+            hash *= 1099511628211ULL;
+        }
+    }
+
+
+    /**
+     * Mix a string, followed by a 0 byte (so that "ab","c" differs from "a","bc"), into a
+     * 64-bit FNV-1a hash.
+     *
+     * @ingroup Util
+     */
+    inline void fnv1a(uint64_t& hash, const std::string& s)
+    {
+        fnv1a(hash, s.c_str(), s.size() + 1);
+    }
+
+
+    /**
+     * Mix an unsigned integer into a 64-bit FNV-1a hash, least significant byte first (so that
+     * the result does not depend on the endianness of the platform).
+     *
+     * @ingroup Util
+     */
+    template<typename T>
+    inline void fnv1aInteger(uint64_t& hash, T value)
+    {
+        for (std::size_t i = 0; i < sizeof(T); i++)
+        {
+            hash ^= uint8_t(value >> (8 * i));
+            hash *= 1099511628211ULL;
+        }
+    }
+
+
+}
+
+
+#endif /* UAF_HASHFUNCTIONS_H_ */
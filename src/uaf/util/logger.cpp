@@ -40,7 +40,9 @@ namespace uaf
     : stdOutLevel_(loglevels::Disabled),
       callbackLevel_(loglevels::Disabled),
       callbackInterface_(0),
-      callbackInterfaceRegistered_(false)
+      callbackInterfaceRegistered_(false),
+      asyncSink_(0),
+      noOfDroppedMessagesOfDeletedSinks_(0)
     {}
 
 
@@ -51,7 +53,9 @@ namespace uaf
       stdOutLevel_(loglevels::Disabled),
       callbackLevel_(loglevels::Disabled),
       callbackInterface_(0),
-      callbackInterfaceRegistered_(false)
+      callbackInterfaceRegistered_(false),
+      asyncSink_(0),
+      noOfDroppedMessagesOfDeletedSinks_(0)
     {}
 
 
@@ -59,6 +63,14 @@ namespace uaf
     // =============================================================================================
     LoggerFactory::~LoggerFactory()
     {
+        // write all pending messages, and delete the asynchronous sinks
+        setAsyncLogging(false, 0, logoverflowpolicies::Drop);
+
+        // no other thread can be logging via a destructed factory
+        for (size_t i = 0; i < stoppedAsyncSinks_.size(); i++)
+            delete stoppedAsyncSinks_[i];
+        stoppedAsyncSinks_.clear();
+
         log("LoggerFactory", loglevels::Info, "The logger factory was destructed");
     }
 
@@ -89,6 +101,106 @@ namespace uaf
     }
 
 
+    // Enable or disable asynchronous logging
+    // =============================================================================================
+    void LoggerFactory::setAsyncLogging(
+            bool                                    enabled,
+            uint32_t                                capacity,
+            logoverflowpolicies::LogOverflowPolicy  overflowPolicy)
+    {
+        AsyncLogSink* currentSink;
+
+        {
+            UaMutexLocker locker(&asyncSinkMutex_); // unlocks when locker goes out of scope
+
+            currentSink = asyncSink_.load();
+
+            // nothing to do if the current configuration is already fine
+            if (!enabled && currentSink == 0)
+                return;
+
+            if (   enabled
+                && currentSink != 0
+                && currentSink->capacity() == AsyncLogSink::roundUpCapacity(capacity)
+                && currentSink->overflowPolicy() == overflowPolicy)
+                return;
+
+            // swap the sinks
+            AsyncLogSink* newSink = 0;
+            if (enabled)
+                newSink = new AsyncLogSink(this, name_, capacity, overflowPolicy);
+
+            asyncSink_.store(newSink);
+        }
+
+        // stop the previous sink (which writes its pending messages) and delete it (without
+        // holding the lock, since a logging callback may need it)
+        deleteAsyncSink(currentSink);
+
+        log("LoggerFactory", loglevels::Info,
+            (enabled ? "Logging asynchronously now" : "Logging synchronously now"));
+    }
+
+
+    // Delete a replaced asynchronous sink
+    // =============================================================================================
+    void LoggerFactory::deleteAsyncSink(AsyncLogSink* sink)
+    {
+        std::vector<AsyncLogSink*> sinks;
+
+        {
+            UaMutexLocker locker(&asyncSinkMutex_); // unlocks when locker goes out of scope
+            sinks.swap(stoppedAsyncSinks_);
+        }
+
+        if (sink != 0)
+        {
+            // stopping the sink also releases the threads that are blocked by a full buffer
+            sink->stop();
+            sinks.push_back(sink);
+        }
+
+        if (sinks.empty())
+            return;
+
+        // after the grace period, no thread can still be pushing messages to the sinks
+        if (asyncSinkGracePeriod_.wait())
+        {
+            for (size_t i = 0; i < sinks.size(); i++)
+            {
+                // the destructor writes the messages that were pushed after the sink was stopped
+                noOfDroppedMessagesOfDeletedSinks_.fetch_add(sinks[i]->noOfDroppedMessages());
+                delete sinks[i];
+            }
+        }
+        else
+        {
+            // this thread is logging itself, so the sinks will be deleted by a later call
+            UaMutexLocker locker(&asyncSinkMutex_); // unlocks when locker goes out of scope
+            stoppedAsyncSinks_.insert(stoppedAsyncSinks_.end(), sinks.begin(), sinks.end());
+        }
+    }
+
+
+    // Get the number of dropped messages
+    // =============================================================================================
+    uint64_t LoggerFactory::noOfDroppedMessages() const
+    {
+        UaMutexLocker locker(&asyncSinkMutex_); // unlocks when locker goes out of scope
+
+        uint64_t ret = noOfDroppedMessagesOfDeletedSinks_.load();
+
+        for (size_t i = 0; i < stoppedAsyncSinks_.size(); i++)
+            ret += stoppedAsyncSinks_[i]->noOfDroppedMessages();
+
+        AsyncLogSink* currentSink = asyncSink_.load();
+        if (currentSink != 0)
+            ret += currentSink->noOfDroppedMessages();
+
+        return ret;
+    }
+
+
     // Log the message
     // =============================================================================================
     void LoggerFactory::log(
@@ -96,7 +208,23 @@ namespace uaf
             loglevels::LogLevel level,
             const char*         msg)
     {
-        LogMessage message(level, name_, loggerName, msg);
+        // the sink cannot be deleted as long as we're in the read section
+        GracePeriod::ReadSection readSection(asyncSinkGracePeriod_);
+
+        AsyncLogSink* sink = asyncSink_.load();
+
+        if (sink != 0)
+            sink->push(level, loggerName, msg);
+        else
+            write(LogMessage(level, name_, loggerName, msg));
+    }
+
+
+    // Write the message
+    // =============================================================================================
+    void LoggerFactory::write(const LogMessage& message)
+    {
+        loglevels::LogLevel level = message.level;
 
         if (level <= stdOutLevel_)
             logToStdOut(message);
@@ -199,7 +327,7 @@ namespace uaf
     void Logger::log(const SdkStatus& sdkStatus)
     {
         if (sdkStatus.isGood())
-            debug(sdkStatus.toString());
+            UAF_LOG_DEBUG(this, sdkStatus.toString());
         else if (sdkStatus.isUncertain())
             warning(sdkStatus.toString());
         else
@@ -211,7 +339,7 @@ namespace uaf
     void Logger::log(const std::string& prefix, const SdkStatus& sdkStatus)
     {
         if (sdkStatus.isGood())
-            debug(prefix + sdkStatus.toString());
+            UAF_LOG_DEBUG(this, prefix + sdkStatus.toString());
         else if (sdkStatus.isUncertain())
             warning(prefix + sdkStatus.toString());
         else
@@ -230,7 +358,7 @@ namespace uaf
     //==============================================================================================
     void Logger::error(const char* msg, ...)
     {
-        if (loggerFactory_->checkLevel(loglevels::Error))
+        if (isEnabled(loglevels::Error))
         {
             va_list args;
             va_start(args, msg);
@@ -246,7 +374,7 @@ namespace uaf
     //==============================================================================================
     void Logger::error(const std::string& msg)
     {
-        if (loggerFactory_->checkLevel(loglevels::Error))
+        if (isEnabled(loglevels::Error))
             loggerFactory_->log(name_, loglevels::Error, msg.c_str());
     }
 
@@ -255,7 +383,7 @@ namespace uaf
     //==============================================================================================
     void Logger::warning(const char* msg, ...)
     {
-        if (loggerFactory_->checkLevel(loglevels::Warning))
+        if (isEnabled(loglevels::Warning))
         {
             va_list args;
             va_start(args, msg);
@@ -271,7 +399,7 @@ namespace uaf
     //==============================================================================================
     void Logger::warning(const std::string& msg)
     {
-        if (loggerFactory_->checkLevel(loglevels::Warning))
+        if (isEnabled(loglevels::Warning))
             loggerFactory_->log(name_, loglevels::Warning, msg.c_str());
     }
 
@@ -280,7 +408,7 @@ namespace uaf
     //==============================================================================================
     void Logger::info(const char* msg, ...)
     {
-        if (loggerFactory_->checkLevel(loglevels::Info))
+        if (isEnabled(loglevels::Info))
         {
             va_list args;
             va_start(args, msg);
@@ -296,7 +424,7 @@ namespace uaf
     //==============================================================================================
     void Logger::info(const std::string& msg)
     {
-        if (loggerFactory_->checkLevel(loglevels::Info))
+        if (isEnabled(loglevels::Info))
             loggerFactory_->log(name_, loglevels::Info, msg.c_str());
     }
 
@@ -305,7 +433,7 @@ namespace uaf
     //==============================================================================================
     void Logger::debug(const char* msg, ...)
     {
-        if (loggerFactory_->checkLevel(loglevels::Debug))
+        if (isEnabled(loglevels::Debug))
         {
             va_list args;
             va_start(args, msg);
@@ -321,7 +449,7 @@ namespace uaf
     //==============================================================================================
     void Logger::debug(const std::string& msg)
     {
-        if (loggerFactory_->checkLevel(loglevels::Debug))
+        if (isEnabled(loglevels::Debug))
             loggerFactory_->log(name_, loglevels::Debug, msg.c_str());
     }
 
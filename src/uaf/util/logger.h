@@ -25,14 +25,61 @@
 #define UAF_LOGGER_MAX_BUFFER_SIZE 4096
 
 
+/**
+ * Log a debug message lazily: the arguments (e.g. a costly toString() call) are only evaluated
+ * if debug messages are effectively logged by the given logger.
+ *
+ * Usage: UAF_LOG_DEBUG(logger_, request.toString());
+ *        UAF_LOG_DEBUG(logger_, "Request %d: %s", handle, request.toString().c_str());
+ *
+ * When the UAF is compiled with UAF_NO_DEBUG_LOGGING defined (CMake option
+ * UAF_WITH_DEBUG_LOGGING=OFF), debug logging is stripped entirely at compile time (the arguments
+ * are still type-checked, but never evaluated).
+ *
+ * @ingroup util
+ */
+#ifdef UAF_NO_DEBUG_LOGGING
+#define UAF_LOG_DEBUG(logger, ...)                                                                  \
+    do                                                                                              \
+    {                                                                                               \
+        if (false)                                                                                  \
+            (logger)->debug(__VA_ARGS__);                                                           \
+    } while (false)
+#else
+#define UAF_LOG_DEBUG(logger, ...)                                                                  \
+    do                                                                                              \
+    {                                                                                               \
+        if ((logger)->isEnabled(uaf::loglevels::Debug))                                             \
+            (logger)->debug(__VA_ARGS__);                                                           \
+    } while (false)
+#endif
+
+
+/**
+ * Log an info message lazily: the arguments are only evaluated if info messages are effectively
+ * logged by the given logger.
+ *
+ * @ingroup util
+ */
+#define UAF_LOG_INFO(logger, ...)                                                                   \
+    do                                                                                              \
+    {                                                                                               \
+        if ((logger)->isEnabled(uaf::loglevels::Info))                                              \
+            (logger)->info(__VA_ARGS__);                                                            \
+    } while (false)
+
+
 // STD
 #include <sstream>
 #include <string>
 #include <stdio.h>
 #include <cstdio>
 #include <stdarg.h>
+#include <atomic>
+#include <vector>
 
 // SDK
+#include "uabasecpp/uamutex.h"
 // UAF
 #include "uaf/util/util.h"
 #include "uaf/util/loglevels.h"
@@ -40,6 +87,9 @@
 #include "uaf/util/sdkstatus.h"
 #include "uaf/util/logmessage.h"
 #include "uaf/util/logginginterface.h"
+#include "uaf/util/logoverflowpolicies.h"
+#include "uaf/util/asynclogsink.h"
+#include "uaf/util/graceperiod.h"
 
 namespace uaf
 {
@@ -88,7 +138,10 @@ namespace uaf
 
 
         /**
-         * Format and send the final message to the std::out.
+         * Format and send the final message to the std::out and/or the callback interface.
+         *
+         * If asynchronous logging is enabled, the message is only copied to the buffer of the
+         * asynchronous sink, and it will be formatted and sent by a background thread.
          *
          * @param loggerName    The name of the logger.
          * @param level         The loglevel.
@@ -170,6 +223,40 @@ namespace uaf
         uaf::loglevels::LogLevel callbackLevel() const { return callbackLevel_; }
 
 
+        /**
+         * Enable or disable asynchronous logging.
+         *
+         * When enabled, the threads that log messages only copy them to a lock-free ring buffer,
+         * and a background thread formats and writes them (to the stdout and/or the callback
+         * interface). This way, slow output (or a slow logging callback) does not stall the
+         * threads that log, e.g. the threads that process the publish responses.
+         *
+         * Changing the capacity or overflow policy creates a new buffer (after the pending
+         * messages of the previous buffer have been written).
+         *
+         * @param enabled           True to log asynchronously, false to log synchronously.
+         * @param capacity          The number of messages the buffer can hold.
+         * @param overflowPolicy    What to do with a message if the buffer is full.
+         */
+        void setAsyncLogging(
+                bool                                        enabled,
+                uint32_t                                    capacity,
+                uaf::logoverflowpolicies::LogOverflowPolicy overflowPolicy);
+
+
+        /**
+         * Check if messages are logged asynchronously.
+         */
+        bool isLoggingAsynchronously() const { return asyncSink_.load() != 0; }
+
+
+        /**
+         * Get the total number of messages that were dropped because the buffer of the
+         * asynchronous sink was full.
+         */
+        uint64_t noOfDroppedMessages() const;
+
+
         /**
          * Factory to create loggers. Destruction of these Loggers is the responsibility of the
          * caller!
@@ -182,6 +269,16 @@ namespace uaf
     private:
         DISALLOW_COPY_AND_ASSIGN(LoggerFactory);
 
+        // the asynchronous sink writes the messages from its background thread
+        friend class AsyncLogSink;
+
+        /**
+         * Send the message to the stdout and/or the callback interface (if its level allows it).
+         *
+         * @param message   The log message.
+         */
+        void write(const uaf::LogMessage& message);
+
         // name of the logger factory
         std::string name_;
 
@@ -194,6 +291,36 @@ namespace uaf
         uaf::LoggingInterface* callbackInterface_;
 
         bool callbackInterfaceRegistered_;
+
+        /** The asynchronous sink, or NULL if messages are logged synchronously. */
+        std::atomic<uaf::AsyncLogSink*> asyncSink_;
+
+        /**
+         * The threads that push messages to the asynchronous sink do so within a read section
+         * of this grace period, so that a replaced sink can be deleted once they have left it.
+         */
+        uaf::GracePeriod asyncSinkGracePeriod_;
+
+        /**
+         * Previous sinks that could not be deleted yet (because they were replaced by a thread
+         * that was logging itself, so it could not wait for the grace period).
+         */
+        std::vector<uaf::AsyncLogSink*> stoppedAsyncSinks_;
+
+        /** The number of messages that were dropped by the sinks that have been deleted. */
+        std::atomic<uint64_t> noOfDroppedMessagesOfDeletedSinks_;
+
+        /** Mutex to protect the (re)configuration of the asynchronous sink. */
+        mutable UaMutex asyncSinkMutex_;
+
+        /**
+         * Stop the given sink (which must have been replaced already), and delete it once no
+         * thread is pushing messages to it anymore (together with the sinks that could not be
+         * deleted before).
+         *
+         * @param sink  The sink that was replaced (may be NULL).
+         */
+        void deleteAsyncSink(uaf::AsyncLogSink* sink);
     };
 
 
@@ -251,6 +378,26 @@ namespace uaf
         LoggerFactory* loggerFactory();
 
 
+        /**
+         * Check if messages of the given level will effectively be logged (to the stdout or to
+         * the callback interface).
+         *
+         * Use this check (or the UAF_LOG_DEBUG macro) before building costly log messages.
+         * If the UAF was compiled with UAF_NO_DEBUG_LOGGING, Debug messages are never logged.
+         *
+         * @param level     The log level to check.
+         * @return          True if messages of this level will be logged.
+         */
+        bool isEnabled(uaf::loglevels::LogLevel level) const
+        {
+#ifdef UAF_NO_DEBUG_LOGGING
+            if (level >= uaf::loglevels::Debug)
+                return false;
+#endif
+            return loggerFactory_->checkLevel(level);
+        }
+
+
         /**
          * Destructor.
          *
@@ -38,6 +38,14 @@ namespace uaf
       applicationName(applicationName),
       loggerName(loggerName),
       message(message)
+    {
+        currentTime(ctime, msec);
+    }
+
+
+    // Get the current time
+    // =============================================================================================
+    void LogMessage::currentTime(int64_t& ctime, int16_t& msec)
     {
         // update the ctime
         time_t t;
@@ -54,7 +62,6 @@ namespace uaf
         gettimeofday(&tv, 0);
         msec = (int16_t) (tv.tv_usec / 1000);
 #endif
-
     }
 
 
@@ -92,6 +92,15 @@ namespace uaf
         std::string toString() const;
 
 
+        /**
+         * Get the current time, in the same representation as the ctime and msec attributes.
+         *
+         * @param ctime     Output parameter: the number of seconds past the epoch.
+         * @param msec      Output parameter: the number of milliseconds past the 'ctime'.
+         */
+        static void currentTime(int64_t& ctime, int16_t& msec);
+
+
     private:
 
         /**
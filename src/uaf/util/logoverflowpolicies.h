@@ -0,0 +1,69 @@
+/* This file is part of the UAF (Unified Architecture Framework) project.
+ *
+ * Copyright (C) 2012 Wim Pessemier (Institute of Astronomy, KULeuven)
+ *
+ * Project website: http://www.ster.kuleuven.be/uaf
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UAF_LOGOVERFLOWPOLICIES_H_
+#define UAF_LOGOVERFLOWPOLICIES_H_
+
+// STD
+#include <string>
+// SDK
+// UAF
+#include "uaf/util/util.h"
+
+
+/** @file */
+
+
+namespace uaf
+{
+
+    namespace logoverflowpolicies
+    {
+
+        /**
+         * The policies that determine what happens with a log message if the buffer of the
+         * asynchronous log sink is full.
+         *
+         * @ingroup Util
+         */
+        enum LogOverflowPolicy
+        {
+            Drop  = 0, /**< Drop the message (and increment the counter of dropped messages). */
+            Block = 1  /**< Block the logging thread until there is space in the buffer (or
+                            until the buffer is stopped, in which case the message is dropped). */
+        };
+
+        /**
+         * Get a string representation of the LogOverflowPolicy.
+         *
+         * @param policy    The policy as a numerical value (e.g. 0).
+         * @return          The corresponding name of the policy (e.g. "Drop").
+         *
+         * @ingroup Util
+         */
+        std::string UAF_EXPORT toString(LogOverflowPolicy policy);
+    }
+
+
+
+}
+
+
+#endif /* UAF_LOGOVERFLOWPOLICIES_H_ */
@@ -17,13 +17,11 @@
  * You should have received a copy of the GNU Lesser General Public License
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
-
 #ifndef UAF_MASK_H_
 #define UAF_MASK_H_
 
 // STD
-#include <deque>
-#include <algorithm>
+#include <vector>
 #include <string>
 #include <sstream>
 // SDK
@@ -40,6 +38,10 @@ namespace uaf
      * The mask keeps track of the number of 'set' (boolean true) and 'unset' (boolean false)
      * values. This means you can very efficiently call countSet() and countUnset().
      *
+     * The items are stored as bits in 64-bit words, so logical operations between masks are
+     * performed a word at a time, and nextSet() / nextUnset() skip entire words of unset / set
+     * items.
+     *
      * @ingroup Util
      */
     class UAF_EXPORT Mask
@@ -51,7 +53,8 @@ namespace uaf
          * Create a new empty mask.
          */
         Mask()
-        : noOfTrue(0)
+        : noOfTrue(0),
+          size_(0)
         {}
 
 
@@ -60,7 +63,8 @@ namespace uaf
          */
         Mask(std::size_t initialSize)
         : noOfTrue(0),
-          deq_(initialSize, false)
+          size_(initialSize),
+          words_(noOfWords(initialSize), 0)
         {}
 
 
@@ -71,12 +75,11 @@ namespace uaf
          * @param initialValue  Initial value of the items of the mask ('set'=true or 'unset'=false).
          */
         Mask(std::size_t initialSize, bool initialValue)
-        : deq_(initialSize, initialValue)
+        : noOfTrue(initialValue ? initialSize : 0),
+          size_(initialSize),
+          words_(noOfWords(initialSize), initialValue ? ~uint64_t(0) : uint64_t(0))
         {
-              if (initialValue)
-                  noOfTrue = initialSize;
-              else
-                  noOfTrue = 0;
+            clearUnusedBits();
         }
 
 
@@ -89,10 +92,18 @@ namespace uaf
          */
         void resize(std::size_t n)
         {
-            bool setCountMayChange = (n < deq_.size());
-            deq_.resize(n, false);
-            if (setCountMayChange)
-                noOfTrue = std::count(deq_.begin(), deq_.end(), true);
+            if (n < size_)
+            {
+                size_ = n;
+                words_.resize(noOfWords(n));
+                clearUnusedBits();
+                recount();
+            }
+            else
+            {
+                size_ = n;
+                words_.resize(noOfWords(n), 0);
+            }
         }
 
 
@@ -101,7 +112,7 @@ namespace uaf
          *
          * @return The actual number of items of the mask.
          */
-        std::size_t size() const { return deq_.size(); }
+        std::size_t size() const { return size_; }
 
 
         /**
@@ -126,7 +137,7 @@ namespace uaf
          * @param i The index of the item.
          * @return  True if the item is 'set' (true), false if not.
          */
-        bool isSet(std::size_t i)   const   { return deq_[i]; }
+        bool isSet(std::size_t i)   const   { return (words_[i / 64] & bit(i)) != 0; }
 
 
         /**
@@ -135,7 +146,7 @@ namespace uaf
          * @param i The index of the item.
          * @return  True if the item is 'unset' (false), false if not.
          */
-        bool isUnset(std::size_t i) const   { return !deq_[i]; }
+        bool isUnset(std::size_t i) const   { return !isSet(i); }
 
 
         /**
@@ -145,18 +156,13 @@ namespace uaf
          */
         void set(std::size_t i)
         {
-            if (i >= deq_.size())
-            {
+            if (i >= size_)
                 resize(i+1);
-                set(i);
-            }
-            else
+
+            if (isUnset(i))
             {
-                if (isUnset(i))
-                {
-                    deq_[i] = 1;
-                    noOfTrue++;
-                }
+                words_[i / 64] |= bit(i);
+                noOfTrue++;
             }
         }
 
@@ -168,22 +174,40 @@ namespace uaf
          */
         void unset(std::size_t i)
         {
-            if (i >= deq_.size())
-            {
+            if (i >= size_)
                 resize(i+1);
-                unset(i);
-            }
-            else
+
+            if (isSet(i))
             {
-                if (isSet(i))
-                {
-                    deq_[i] = 0;
-                    noOfTrue--;
-                }
+                words_[i / 64] &= ~bit(i);
+                noOfTrue--;
             }
         }
 
 
+        /**
+         * Get the index of the first 'set' (true) item, starting from the given index.
+         *
+         * To iterate over all 'set' items:
+         * <tt>for (i = mask.nextSet(0); i < mask.size(); i = mask.nextSet(i+1)) { ... }</tt>
+         *
+         * @param i The index to start searching from (the item at this index is included).
+         * @return  The index of the first 'set' item with an index >= i, or size() if there is
+         *          no such item.
+         */
+        std::size_t nextSet(std::size_t i) const { return find(i, uint64_t(0)); }
+
+
+        /**
+         * Get the index of the first 'unset' (false) item, starting from the given index.
+         *
+         * @param i The index to start searching from (the item at this index is included).
+         * @return  The index of the first 'unset' item with an index >= i, or size() if there is
+         *          no such item.
+         */
+        std::size_t nextUnset(std::size_t i) const { return find(i, ~uint64_t(0)); }
+
+
         /**
          * Get a string representation of the mask.
          *
@@ -193,12 +217,12 @@ namespace uaf
          */
         std::string toString() const
         {
-            std::stringstream ss;
-            ss << "[";
-            for (std::deque<bool>::const_iterator it = deq_.begin(); it != deq_.end(); ++it)
-                ss << *it;
-            ss << "]";
-            return ss.str();
+            std::string s(size_ + 2, '0');
+            s[0] = '[';
+            for (std::size_t i = nextSet(0); i < size_; i = nextSet(i + 1))
+                s[i + 1] = '1';
+            s[size_ + 1] = ']';
+            return s;
         }
 
 
@@ -206,34 +230,69 @@ namespace uaf
          * Perform a logical AND between this mask and the other.
          *
          * @param other Other mask.
-         * @return      Resulting mask = (this mask) AND (other mask).
+         * @return      Resulting mask = (this mask) AND (other mask), having the size of the
+         *              smallest of both masks.
          */
         Mask operator&& (const Mask& other) const
         {
-            // we don't use std::min because it interferes with the 'min' macro in <windows.h>
-            std::size_t minSize;
-            if (size() < other.size())
-                minSize = size();
-            else
-                minSize = other.size();
+            const Mask& smallest = (size() < other.size()) ? *this : other;
+            const Mask& largest  = (size() < other.size()) ? other : *this;
 
-            Mask ret(minSize);
+            Mask ret(smallest);
+            for (std::size_t w = 0; w < ret.words_.size(); w++)
+                ret.words_[w] &= largest.words_[w];
+            ret.recount();
 
-            for(std::size_t i = 0; i < minSize; i++)
-                ret.deq_[i] = deq_[i] && other.deq_[i];
+            return ret;
+        }
+
+
+        /**
+         * Perform a logical OR between this mask and the other.
+         *
+         * @param other Other mask.
+         * @return      Resulting mask = (this mask) OR (other mask), having the size of the
+         *              largest of both masks (the missing items of the smallest mask count
+         *              as unset).
+         */
+        Mask operator|| (const Mask& other) const
+        {
+            const Mask& smallest = (size() < other.size()) ? *this : other;
+            const Mask& largest  = (size() < other.size()) ? other : *this;
+
+            Mask ret(largest);
+            for (std::size_t w = 0; w < smallest.words_.size(); w++)
+                ret.words_[w] |= smallest.words_[w];
+            ret.recount();
 
             return ret;
         }
 
         // comparison operators
         friend UAF_EXPORT bool operator==(const Mask& object1, const Mask& object2)
-        { return object1.deq_ == object2.deq_; }
+        { return object1.size_ == object2.size_ && object1.words_ == object2.words_; }
 
         friend UAF_EXPORT bool operator!=(const Mask& object1, const Mask& object2)
         { return !(object1 == object2);}
 
         friend UAF_EXPORT bool operator<(const Mask& object1, const Mask& object2)
-        { return object1.deq_ < object2.deq_; }
+        {
+            // lexicographical comparison of the items, like for any other container of booleans
+            std::size_t minSize = (object1.size_ < object2.size_) ? object1.size_ : object2.size_;
+            for (std::size_t w = 0; w < noOfWords(minSize); w++)
+            {
+                uint64_t difference = object1.words_[w] ^ object2.words_[w];
+                if (difference != 0)
+                {
+                    std::size_t i = w * 64 + lowestSetBit(difference);
+                    if (i < minSize)
+                        return object2.isSet(i);
+                    else
+                        break;
+                }
+            }
+            return object1.size_ < object2.size_;
+        }
 
 
     private:
@@ -241,8 +300,75 @@ namespace uaf
         /** The number of 'set' (true) items. */
         std::size_t noOfTrue;
 
-        /** The deque to store the boolean mask items. */
-        std::deque<bool> deq_;
+        /** The number of items. */
+        std::size_t size_;
+
+        /** The words to store the boolean mask items (the bits beyond size_ are always 0). */
+        std::vector<uint64_t> words_;
+
+
+        // the number of words needed to store n items
+        static std::size_t noOfWords(std::size_t n) { return (n + 63) / 64; }
+
+        // the bit of item i within its word
+        static uint64_t bit(std::size_t i) { return uint64_t(1) << (i % 64); }
+
+        // the number of 1-bits of a word
+        static std::size_t popCount(uint64_t word)
+        {
+#if defined(__GNUC__)
+            return __builtin_popcountll(word);
+#else
+            word = word - ((word >> 1) & 0x5555555555555555ULL);
+            word = (word & 0x3333333333333333ULL) + ((word >> 2) & 0x3333333333333333ULL);
+            word = (word + (word >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+            return std::size_t((word * 0x0101010101010101ULL) >> 56);
+#endif
+        }
+
+        // the index of the lowest 1-bit of a (non-zero!) word
+        static std::size_t lowestSetBit(uint64_t word)
+        {
+#if defined(__GNUC__)
+            return __builtin_ctzll(word);
+#else
+            return popCount((word & (~word + 1)) - 1);
+#endif
+        }
+
+        // find the first item >= i that differs from the given word pattern (all 0s or all 1s)
+        std::size_t find(std::size_t i, uint64_t pattern) const
+        {
+            if (i >= size_)
+                return size_;
+
+            std::size_t w = i / 64;
+            uint64_t word = (words_[w] ^ pattern) & (~uint64_t(0) << (i % 64));
+            while (word == 0)
+            {
+                if (++w == words_.size())
+                    return size_;
+                word = words_[w] ^ pattern;
+            }
+
+            std::size_t found = w * 64 + lowestSetBit(word);
+            return (found < size_) ? found : size_;
+        }
+
+        // reset the bits beyond size_ of the last word
+        void clearUnusedBits()
+        {
+            if (size_ % 64 != 0)
+                words_.back() &= (bit(size_) - 1);
+        }
+
+        // recount the number of 'set' items
+        void recount()
+        {
+            noOfTrue = 0;
+            for (std::size_t w = 0; w < words_.size(); w++)
+                noOfTrue += popCount(words_[w]);
+        }
 
     };
 
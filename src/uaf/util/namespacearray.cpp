@@ -27,11 +27,21 @@ namespace uaf
     using std::string;
     using std::stringstream;
     using std::vector;
+    using std::shared_ptr;
 
 
     // Constructor
     // =============================================================================================
-    NamespaceArray::NamespaceArray() {}
+    NamespaceArray::NamespaceArray()
+    : contents_(new Contents)
+    {}
+
+
+    // Copy constructor
+    // =============================================================================================
+    NamespaceArray::NamespaceArray(const NamespaceArray& other)
+    : contents_(other.contents())
+    {}
 
 
     // Destructor
@@ -39,6 +49,23 @@ namespace uaf
     NamespaceArray::~NamespaceArray() {}
 
 
+    // Assignment operator
+    // =============================================================================================
+    NamespaceArray& NamespaceArray::operator=(const NamespaceArray& other)
+    {
+        std::atomic_store(&contents_, other.contents());
+        return *this;
+    }
+
+
+    // Get the fingerprint
+    // =============================================================================================
+    uint64_t NamespaceArray::fingerprint() const
+    {
+        return contents()->fingerprint;
+    }
+
+
     // Read the contents of a data value as returned when a client reads the NamespaceArray NodeId.
     // =============================================================================================
     Status NamespaceArray::fromSdk(const OpcUa_DataValue& value)
@@ -50,17 +77,44 @@ namespace uaf
         {
             OpcUa_StatusCode uaConversionStatusCode;
 
+            // build the new contents aside, so readers keep using the current ones meanwhile
+            shared_ptr<Contents> contents(new Contents);
+            UaStringArray& namespaceArray = contents->namespaceArray;
+
             // convert the value to a StringArray
-            uaConversionStatusCode = UaVariant(value.Value).toStringArray(namespaceArray_);
+            uaConversionStatusCode = UaVariant(value.Value).toStringArray(namespaceArray);
 
-            // if the conversion succeeded, fill the map with simplified URIs
+            // if the conversion succeeded, fill the maps with simplified URIs
             if (OpcUa_IsGood(uaConversionStatusCode))
             {
-                for (uint16_t i=0; i<namespaceArray_.length(); i++)
+                contents->uris.resize(namespaceArray.length());
+
+                for (uint16_t i=0; i<namespaceArray.length(); i++)
+                {
+                    contents->uris[i] = NamespaceArray::getSimplifiedUri(
+                            string(UaString(&namespaceArray[i]).toUtf8()));
+                    contents->nameSpaceMap[i] = contents->uris[i];
+
+                    // in case of duplicates, the lowest index wins
+                    contents->indexes.insert(IndexMap::value_type(contents->uris[i], i));
+                }
+
+                // also add the original URIs (mapped to the index of their simplified URI), so
+                // that URIs spelled like the server spells them can be found without simplifying
+                for (uint16_t i=0; i<namespaceArray.length(); i++)
                 {
-                    nameSpaceMap_[i] = NamespaceArray::getSimplifiedUri(
-                            string(UaString(&namespaceArray_[i]).toUtf8()));
+                    contents->indexes.insert(IndexMap::value_type(
+                            string(UaString(&namespaceArray[i]).toUtf8()),
+                            contents->indexes[contents->uris[i]]));
                 }
+
+                // update the fingerprint (FNV-1a of the original URIs, each followed by a 0 byte)
+                contents->fingerprint = FNV1A_OFFSET_BASIS;
+                for (uint16_t i=0; i<namespaceArray.length(); i++)
+                    fnv1a(contents->fingerprint, string(UaString(&namespaceArray[i]).toUtf8()));
+
+                // publish the new contents (they start with an empty memo of lookups)
+                std::atomic_store(&contents_, shared_ptr<const Contents>(contents));
             }
             else
             {
@@ -82,14 +136,13 @@ namespace uaf
     // =============================================================================================
     bool NamespaceArray::findNamespaceUri(NameSpaceIndex namespaceIndex, string& namespaceUri) const
     {
-        // find the NamespaceIndex
-        NameSpaceMap::const_iterator iter = nameSpaceMap_.find(namespaceIndex);
+        shared_ptr<const Contents> contents = this->contents();
 
-        bool found = (iter != nameSpaceMap_.end());
+        bool found = (namespaceIndex < contents->uris.size());
 
         // if the NamespaceIndex was found, assign the URI
         if (found)
-            namespaceUri = iter->second;
+            namespaceUri = contents->uris[namespaceIndex];
 
         return found;
     }
@@ -101,29 +154,39 @@ namespace uaf
             const string&   namespaceUri,
             NameSpaceIndex& namespaceIndex) const
     {
-        // We need to do a "reverse" lookup, by iterating over the key:value pairs until we have
-        // found the correct value.
+        shared_ptr<const Contents> contents = this->contents();
 
-        // get a simplified URI
-        string simplifiedUri = NamespaceArray::getSimplifiedUri(namespaceUri);
+        // most URIs are given in simplified form or spelled like the server spells them,
+        // so try to find them directly first
+        IndexMap::const_iterator iter = contents->indexes.find(namespaceUri);
+        if (iter != contents->indexes.end())
+        {
+            namespaceIndex = iter->second;
+            return true;
+        }
 
-        // iterate over the key:value pairs
-        NameSpaceMap::const_iterator iter;
-        for (iter = nameSpaceMap_.begin(); iter != nameSpaceMap_.end(); ++iter)
+        // if not, we need to simplify the URI, but we only do that once per distinct URI
+        UaMutexLocker locker(&contents->lookupsMutex); // unlocks when locker goes out of scope
+
+        LookupMap::const_iterator lookup = contents->lookups.find(namespaceUri);
+        if (lookup == contents->lookups.end())
         {
-            // if the NamespaceURI was found, assign the NamespaceIndex, update the status,
-            // and return
-            if (iter->second == simplifiedUri)
-            {
-                namespaceIndex = iter->first;
+            if (contents->lookups.size() >= maxLookups)
+                contents->lookups.clear();
 
-                // we found the URI, so we can return!
-                return true;
-            }
+            iter = contents->indexes.find(NamespaceArray::getSimplifiedUri(namespaceUri));
+
+            int32_t result = (iter != contents->indexes.end())
+                             ? int32_t(iter->second)
+                             : int32_t(-1);
+            lookup = contents->lookups.insert(LookupMap::value_type(namespaceUri, result)).first;
         }
 
-        // we haven't returned yet, so the URI was not found...
-        return false;
+        if (lookup->second < 0)
+            return false;
+
+        namespaceIndex = NameSpaceIndex(lookup->second);
+        return true;
     }
 
 
@@ -131,11 +194,13 @@ namespace uaf
     // =============================================================================================
     string NamespaceArray::toString() const
     {
+        shared_ptr<const Contents> contents = this->contents();
+
         stringstream ss;
 
         // iterate over the map to print each key:value pair
         NameSpaceMap::const_iterator iter;
-        for (iter = nameSpaceMap_.begin(); iter != nameSpaceMap_.end(); ++iter)
+        for (iter = contents->nameSpaceMap.begin(); iter != contents->nameSpaceMap.end(); ++iter)
         {
             ss << " " << iter->first << ": " << iter->second << "\n";
         }
@@ -196,10 +261,13 @@ namespace uaf
             if (findNamespaceIndex(nodeId.nameSpaceUri(), nameSpaceIndex))
                 ret = statuscodes::Good;
             else
+            {
+                shared_ptr<const Contents> contents = this->contents();
                 ret = UnknownNamespaceUriError(
                         nodeId.nameSpaceUri(),
-                        nameSpaceMap_,
-                        toString(nameSpaceMap_));
+                        contents->nameSpaceMap,
+                        toString(contents->nameSpaceMap));
+            }
         }
         else if (nodeId.hasNameSpaceIndex())
         {
@@ -448,7 +516,7 @@ namespace uaf
 
         if (uaExtensionObject.dataTypeId().isNull())
         {
-        	uaExtensionObject.dataTypeId(namespaceArray_).copyTo(&opcUaNodeId);
+        	uaExtensionObject.dataTypeId(contents()->namespaceArray).copyTo(&opcUaNodeId);
         }
         else
         {
@@ -26,9 +26,13 @@
 #include <string>
 #include <sstream>
 #include <map>
+#include <vector>
+#include <unordered_map>
 #include <algorithm>
+#include <memory>
 #include <stdint.h>
 // SDK
+#include "uabasecpp/uamutex.h"
 #include "uabasecpp/uaarraytemplates.h"
 #include "uabasecpp/uastring.h"
 #include "uabasecpp/uavariant.h"
@@ -37,6 +41,7 @@
 #include "uaf/util/status.h"
 #include "uaf/util/variant.h"
 #include "uaf/util/address.h"
+#include "uaf/util/hashfunctions.h"
 
 
 namespace uaf
@@ -52,6 +57,16 @@ namespace uaf
      * NamespaceArrays are exposed by servers, so that clients can look up the URI of a namespace
      * for a given namespace index.
      *
+     * Both lookup directions take constant time: the URIs are stored in a vector (indexed by
+     * namespace index), and the namespace indexes are stored in a hash map (keyed by the
+     * simplified URI as well as the URI as exposed by the server). URIs given by the user in any
+     * other form are simplified only once, after which the result is memoized.
+     *
+     * The contents are an immutable snapshot, which is replaced atomically by fromSdk(). So a
+     * NamespaceArray can be read by several threads while it is being updated, and copying it is
+     * cheap (the copy shares the snapshot). Use a copy if several lookups must be consistent with
+     * each other (e.g. a conversion to an OpcUa_NodeId and back).
+     *
      * @ingroup Util
      **********************************************************************************************/
     class UAF_EXPORT NamespaceArray
@@ -65,12 +80,24 @@ namespace uaf
         NamespaceArray();
 
 
+        /**
+         * Copy the NamespaceArray (the copy shares the current snapshot of the contents).
+         */
+        NamespaceArray(const NamespaceArray& other);
+
+
         /**
          * Destruct the NamespaceArray.
          */
         ~NamespaceArray();
 
 
+        /**
+         * Assign another NamespaceArray (this instance will share its current snapshot).
+         */
+        NamespaceArray& operator=(const NamespaceArray& other);
+
+
         /**
          * Fill the NamespaceArray with the information contained by the given OpcUa_DataValue
          * from the stack.
@@ -89,6 +116,18 @@ namespace uaf
         std::string toString() const;
 
 
+        /**
+         * Get a fingerprint of the NamespaceArray.
+         *
+         * The fingerprint is a hash of the namespace URIs (as exposed by the server, and in the
+         * order of their namespace index). It changes whenever the server changes its
+         * NamespaceArray, so it can be used to detect information that may be stale.
+         *
+         * @return  The fingerprint, or 0 if the NamespaceArray has not been read yet.
+         */
+        uint64_t fingerprint() const;
+
+
         /**
          * Find the NamespaceURI for a given NamespaceIndex.
          *
@@ -261,11 +300,45 @@ namespace uaf
 
     private:
 
-        // the internal NameSpaceIndex:NameSpaceURI map
-        NameSpaceMap nameSpaceMap_;
+        typedef std::unordered_map<std::string, NameSpaceIndex> IndexMap;
+        typedef std::unordered_map<std::string, int32_t> LookupMap;
+
+        // the contents of the NamespaceArray, which are never changed once they are published
+        // (except for the memoized lookups, which have their own lock)
+        struct Contents
+        {
+            Contents() : fingerprint(0) {}
+
+            // the internal NameSpaceIndex:NameSpaceURI map
+            NameSpaceMap nameSpaceMap;
+
+            // the original array
+            UaStringArray namespaceArray;
+
+            // the simplified NameSpaceURIs, indexed by NameSpaceIndex
+            std::vector<std::string> uris;
+
+            // the NameSpaceIndexes, keyed by simplified NameSpaceURI and by original NameSpaceURI
+            IndexMap indexes;
+
+            // the memoized lookups of NameSpaceURIs that are not a key of indexes
+            // (value = the NameSpaceIndex, or -1 if the URI is not known)
+            mutable LookupMap lookups;
+            mutable UaMutex lookupsMutex;
+
+            // the fingerprint of the original array
+            uint64_t fingerprint;
+        };
+
+        // the current snapshot of the contents (never NULL, and must be accessed via
+        // std::atomic_load and std::atomic_store)
+        std::shared_ptr<const Contents> contents_;
+
+        // get the current snapshot of the contents
+        std::shared_ptr<const Contents> contents() const { return std::atomic_load(&contents_); }
 
-        // the original array
-        UaStringArray namespaceArray_;
+        // the maximum number of memoized lookups (the memo is cleared when it is full)
+        static const std::size_t maxLookups = 1024;
 
         /**
          * A static function to convert the URI to a "plain" one (no trailing forward slash,
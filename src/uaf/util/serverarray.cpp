@@ -166,6 +166,24 @@ namespace uaf
     }
 
 
+    // Get a fingerprint of the Server Array (FNV-1a of the ServerIndex:ServerURI pairs)
+    // =============================================================================================
+    uint64_t ServerArray::fingerprint() const
+    {
+        uint64_t ret = FNV1A_OFFSET_BASIS;
+
+        for (ServerArrayMap::const_iterator iter = serverArrayMap_.begin();
+                iter != serverArrayMap_.end();
+                iter++)
+        {
+            fnv1aInteger(ret, iter->first);
+            fnv1a(ret, iter->second);
+        }
+
+        return ret;
+    }
+
+
 #define FILL_OPCUA_VARIANT_SERVERURI(TYPE)                                                          \
         if (variant.isArray())                                                                      \
         {                                                                                           \
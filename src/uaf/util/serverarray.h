@@ -34,6 +34,7 @@
 #include "uaf/util/util.h"
 #include "uaf/util/status.h"
 #include "uaf/util/variant.h"
+#include "uaf/util/hashfunctions.h"
 
 
 namespace uaf
@@ -76,6 +77,17 @@ namespace uaf
         std::string toString() const;
 
 
+        /**
+         * Get a fingerprint of the ServerArray.
+         *
+         * The fingerprint is a hash of the server indexes and URIs, so it changes whenever the
+         * server changes its ServerArray.
+         *
+         * @return  The fingerprint.
+         */
+        uint64_t fingerprint() const;
+
+
         /**
          * Find the ServerURI for a given ServerIndex.
          *
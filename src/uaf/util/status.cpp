@@ -28,21 +28,51 @@ namespace uaf
     using std::vector;
 
 
-    // Constructor
+    // Details copy constructor
     // =============================================================================================
-    Status::Status(const Status& other)
+    Status::Details::Details(const Details& other)
+    : errors(NULL),
+      raisedBy(other.raisedBy == NULL ? NULL : new Status(*other.raisedBy))
     {
-        copyErrors(other);
-        statusCode = other.statusCode;
-
-        if (other.isRaisedBy())
+        // copy the errors, in the same order
+        Error** last = &errors;
+        for (const Error* error = other.errors; error != NULL; error = error->next)
         {
-            raisedBy_ = new Status(*other.raisedBy_);
+            *last = error->clone();
+            last = &(*last)->next;
         }
-        else
+    }
+
+
+    // Details destructor
+    // =============================================================================================
+    Status::Details::~Details()
+    {
+        while (errors != NULL)
         {
-            raisedBy_ = NULL;
+            Error* next = errors->next;
+            delete errors;
+            errors = next;
         }
+        delete raisedBy;
+    }
+
+
+    // Copy constructor
+    // =============================================================================================
+    Status::Status(const Status& other)
+    : statusCode(other.statusCode),
+      details_(other.details_ == NULL ? NULL : new Details(*other.details_))
+    {}
+
+
+    // Move constructor
+    // =============================================================================================
+    Status::Status(Status&& other)
+    : statusCode(other.statusCode),
+      details_(other.details_)
+    {
+        other.details_ = NULL;
     }
 
 
@@ -53,17 +83,28 @@ namespace uaf
         // protect for self-assignment
         if (&other != this)
         {
-            clearRaisedBy();
-            copyErrors(other);
+            // copy the details first, in case the other status is (part of) them
+            Details* details = (other.details_ == NULL ? NULL : new Details(*other.details_));
+            delete details_;
+            statusCode = other.statusCode;
+            details_ = details;
+        }
+        return *this;
+    }
+
+
+    // Move assignment operator
+    // =============================================================================================
+    Status& Status::operator=(Status&& other)
+    {
+        if (&other != this)
+        {
+            // take the details first, in case the other status is (part of) them
+            Details* details = other.details_;
+            other.details_ = NULL;
+            delete details_;
             statusCode = other.statusCode;
-            if (other.isRaisedBy())
-            {
-                raisedBy_ = new Status(*other.raisedBy_);
-            }
-            else
-            {
-                raisedBy_ = NULL;
-            }
+            details_ = details;
         }
         return *this;
     }
@@ -73,7 +114,7 @@ namespace uaf
     // =============================================================================================
     Status::~Status()
     {
-        clearRaisedBy();
+        delete details_;
     }
 
 
@@ -83,8 +124,21 @@ namespace uaf
     {
         if (isRaisedBy())
         {
-            delete raisedBy_;
-            raisedBy_ = NULL;
+            delete details_->raisedBy;
+            details_->raisedBy = NULL;
+            deleteDetailsIfEmpty();
+        }
+    }
+
+
+    // Delete the details if they don't contain anything anymore
+    // =============================================================================================
+    void Status::deleteDetailsIfEmpty()
+    {
+        if (details_ != NULL && details_->errors == NULL && details_->raisedBy == NULL)
+        {
+            delete details_;
+            details_ = NULL;
         }
     }
 
@@ -104,17 +158,15 @@ namespace uaf
 
         if (statuses.size() == 0)
         {
-            statusCode = uaf::statuscodes::NoStatusesGivenError;
-            raisedBy_NoStatusesGivenError = NoStatusesGivenError();
+            *this = NoStatusesGivenError();
         }
         else if (noOfGood == statuses.size())
-            statusCode = uaf::statuscodes::Good;
+            setGood();
         else if (noOfUncertain > 0 && noOfBad == 0)
-            statusCode = uaf::statuscodes::Uncertain;
+            setUncertain();
         else
         {
-            statusCode = uaf::statuscodes::BadStatusesPresentError;
-            raisedBy_BadStatusesPresentError = BadStatusesPresentError(noOfGood, noOfUncertain, noOfBad);
+            *this = BadStatusesPresentError(noOfGood, noOfUncertain, noOfBad);
         }
     }
 
@@ -123,7 +175,8 @@ namespace uaf
     // =============================================================================================
     void Status::setGood()
     {
-        clearRaisedBy();
+        delete details_;
+        details_ = NULL;
         statusCode = uaf::statuscodes::Good;
     }
 
@@ -131,7 +184,8 @@ namespace uaf
     // =============================================================================================
     void Status::setUncertain()
     {
-        clearRaisedBy();
+        delete details_;
+        details_ = NULL;
         statusCode = uaf::statuscodes::Uncertain;
     }
 
@@ -140,14 +194,20 @@ namespace uaf
     // =============================================================================================
     void Status::setRaisedBy(const Status& status)
     {
-        raisedBy_ = new uaf::Status(status);
+        // copy the status first, in case it is (part of) this instance
+        Status* raisedBy = new uaf::Status(status);
+        if (details_ == NULL)
+            details_ = new Details;
+        else
+            delete details_->raisedBy;
+        details_->raisedBy = raisedBy;
     }
 
     // Check if this status is raised by some other status.
     // =============================================================================================
     bool Status::isRaisedBy() const
     {
-        return raisedBy_ != NULL;
+        return details_ != NULL && details_->raisedBy != NULL;
     }
 
     // If this status is raised by some other status, get a copy of this other status.
@@ -155,7 +215,7 @@ namespace uaf
     Status Status::raisedBy() const
     {
         if (isRaisedBy())
-            return *raisedBy_;
+            return *details_->raisedBy;
         else
             return Status();
     }
@@ -169,125 +229,8 @@ namespace uaf
 
 
 
-#define UAF_STATUS_COPY_ERROR(ERROR)       \
-        raisedBy_##ERROR = from.raisedBy_##ERROR;
-
-    void Status::copyErrors(const Status& from)
-    {
-        UAF_STATUS_COPY_ERROR(FindServersError)
-        UAF_STATUS_COPY_ERROR(UnknownServerError)
-        UAF_STATUS_COPY_ERROR(EmptyUrlError)
-        UAF_STATUS_COPY_ERROR(NoParallelFindServersAllowedError)
-        UAF_STATUS_COPY_ERROR(NoDiscoveryUrlsFoundError)
-        UAF_STATUS_COPY_ERROR(ServerCertificateRejectedByUserError)
-        UAF_STATUS_COPY_ERROR(ServerCertificateSavingError)
-        UAF_STATUS_COPY_ERROR(OpenSSLStoreInitializationError)
-        UAF_STATUS_COPY_ERROR(ClientCertificateLoadingError)
-        UAF_STATUS_COPY_ERROR(ServerDidNotProvideCertificateError)
-        UAF_STATUS_COPY_ERROR(PathNotExistsError)
-        UAF_STATUS_COPY_ERROR(NoSecuritySettingsGivenError)
-        UAF_STATUS_COPY_ERROR(PathCreationError)
-        UAF_STATUS_COPY_ERROR(SecuritySettingsMatchError)
-        UAF_STATUS_COPY_ERROR(WrongTypeError)
-        UAF_STATUS_COPY_ERROR(UnexpectedError)
-        UAF_STATUS_COPY_ERROR(ServerArrayConversionError)
-        UAF_STATUS_COPY_ERROR(NamespaceArrayConversionError)
-        UAF_STATUS_COPY_ERROR(BadNamespaceArrayError)
-        UAF_STATUS_COPY_ERROR(BadServerArrayError)
-        UAF_STATUS_COPY_ERROR(UnknownServerIndexError)
-        UAF_STATUS_COPY_ERROR(InvalidAddressError)
-        UAF_STATUS_COPY_ERROR(UnknownNamespaceUriError)
-        UAF_STATUS_COPY_ERROR(NoNamespaceIndexOrUriGivenError)
-        UAF_STATUS_COPY_ERROR(UnknownNamespaceIndexError)
-        UAF_STATUS_COPY_ERROR(EmptyServerUriAndUnknownNamespaceIndexError)
-        UAF_STATUS_COPY_ERROR(ExpandedNodeIdAddressExpectedError)
-        UAF_STATUS_COPY_ERROR(EmptyServerUriError)
-        UAF_STATUS_COPY_ERROR(UnsupportedError)
-        UAF_STATUS_COPY_ERROR(UnsupportedNodeIdIdentifierTypeError)
-        UAF_STATUS_COPY_ERROR(SyncInvocationNotSupportedError)
-        UAF_STATUS_COPY_ERROR(AsyncInvocationNotSupportedError)
-        UAF_STATUS_COPY_ERROR(NoStatusesGivenError)
-        UAF_STATUS_COPY_ERROR(BadStatusesPresentError)
-        UAF_STATUS_COPY_ERROR(NotAllTargetsCouldBeResolvedError)
-        UAF_STATUS_COPY_ERROR(InvalidServerUriError)
-        UAF_STATUS_COPY_ERROR(SubscriptionNotCreatedError)
-        UAF_STATUS_COPY_ERROR(NoTargetsGivenError)
-        UAF_STATUS_COPY_ERROR(DataDontMatchAddressesError)
-        UAF_STATUS_COPY_ERROR(ItemNotFoundForTheGivenHandleError)
-        UAF_STATUS_COPY_ERROR(TargetRankOutOfBoundsError)
-        UAF_STATUS_COPY_ERROR(NoItemFoundForTheGivenRequestHandleError)
-        UAF_STATUS_COPY_ERROR(ContinuationPointsDontMatchAddressesError)
-        UAF_STATUS_COPY_ERROR(UnknownNamespaceIndexAndServerIndexError)
-        UAF_STATUS_COPY_ERROR(AsyncMultiMethodCallNotSupportedError)
-        UAF_STATUS_COPY_ERROR(EmptyAddressError)
-        UAF_STATUS_COPY_ERROR(MultipleTranslationResultsError)
-        UAF_STATUS_COPY_ERROR(UnknownClientSubscriptionHandleError)
-        UAF_STATUS_COPY_ERROR(UnknownClientHandleError)
-        UAF_STATUS_COPY_ERROR(UnknownClientConnectionIdError)
-        UAF_STATUS_COPY_ERROR(AsyncConnectionFailedError)
-        UAF_STATUS_COPY_ERROR(ConnectionFailedError)
-        UAF_STATUS_COPY_ERROR(SessionSecuritySettingsDontMatchEndpointError)
-        UAF_STATUS_COPY_ERROR(CouldNotManuallyUnsubscribeError)
-        UAF_STATUS_COPY_ERROR(CouldNotManuallySubscribeError)
-        UAF_STATUS_COPY_ERROR(SessionNotConnectedError)
-        UAF_STATUS_COPY_ERROR(ServerCouldNotSetMonitoringModeError)
-        UAF_STATUS_COPY_ERROR(CreateSubscriptionError)
-        UAF_STATUS_COPY_ERROR(DeleteSubscriptionError)
-        UAF_STATUS_COPY_ERROR(SubscriptionHasBeenDeletedError)
-        UAF_STATUS_COPY_ERROR(SetMonitoringModeInvocationError)
-        UAF_STATUS_COPY_ERROR(NoDiscoveryUrlsExposedByServerError)
-        UAF_STATUS_COPY_ERROR(GetEndpointsError)
-        UAF_STATUS_COPY_ERROR(NoEndpointsProvidedByServerError)
-        UAF_STATUS_COPY_ERROR(DisconnectionFailedError)
-        UAF_STATUS_COPY_ERROR(NoConnectedSessionToUpdateArraysError)
-        UAF_STATUS_COPY_ERROR(BadDataReceivedError)
-
-
-        // service errors
-        UAF_STATUS_COPY_ERROR(CouldNotReadArraysError)
-        UAF_STATUS_COPY_ERROR(CreateMonitoredItemsError)
-        UAF_STATUS_COPY_ERROR(CreateMonitoredItemsInvocationError)
-        UAF_STATUS_COPY_ERROR(BeginCreateMonitoredItemsInvocationError)
-        UAF_STATUS_COPY_ERROR(ServerCouldNotCreateMonitoredItemsError)
-        UAF_STATUS_COPY_ERROR(ServerCouldNotBrowseNextError)
-        UAF_STATUS_COPY_ERROR(BrowseNextInvocationError)
-        UAF_STATUS_COPY_ERROR(ReadInvocationError)
-        UAF_STATUS_COPY_ERROR(BeginReadInvocationError)
-        UAF_STATUS_COPY_ERROR(ServerCouldNotReadError)
-        UAF_STATUS_COPY_ERROR(TranslateBrowsePathsToNodeIdsInvocationError)
-        UAF_STATUS_COPY_ERROR(ServerCouldNotTranslateBrowsePathsToNodeIdsError)
-        UAF_STATUS_COPY_ERROR(HistoryReadInvocationError)
-        UAF_STATUS_COPY_ERROR(HistoryReadRawModifiedInvocationError)
-        UAF_STATUS_COPY_ERROR(ServerCouldNotHistoryReadError)
-        UAF_STATUS_COPY_ERROR(MethodCallInvocationError)
-        UAF_STATUS_COPY_ERROR(AsyncMethodCallInvocationError)
-        UAF_STATUS_COPY_ERROR(ServerCouldNotCallMethodError)
-        UAF_STATUS_COPY_ERROR(ServerCouldNotBrowseError)
-        UAF_STATUS_COPY_ERROR(BrowseInvocationError)
-        UAF_STATUS_COPY_ERROR(WriteInvocationError)
-        UAF_STATUS_COPY_ERROR(AsyncWriteInvocationError)
-        UAF_STATUS_COPY_ERROR(ServerCouldNotWriteError)
-        UAF_STATUS_COPY_ERROR(CallCompleteError)
-        UAF_STATUS_COPY_ERROR(InputArgumentError)
-        UAF_STATUS_COPY_ERROR(ReadCompleteError)
-        UAF_STATUS_COPY_ERROR(WriteCompleteError)
-        UAF_STATUS_COPY_ERROR(EmptyUserCertificateError)
-        UAF_STATUS_COPY_ERROR(InvalidPrivateKeyError)
-        UAF_STATUS_COPY_ERROR(SetPublishingModeInvocationError)
-        UAF_STATUS_COPY_ERROR(DefinitionNotFoundError)
-
-        // configuration errors
-        UAF_STATUS_COPY_ERROR(ConfigurationError)
-        UAF_STATUS_COPY_ERROR(CouldNotCreateCertificateTrustListLocationError)
-        UAF_STATUS_COPY_ERROR(CouldNotCreateCertificateRevocationListLocationError)
-        UAF_STATUS_COPY_ERROR(CouldNotCreateIssuersCertificateLocationError)
-        UAF_STATUS_COPY_ERROR(CouldNotCreateIssuersRevocationListLocationError)
-        UAF_STATUS_COPY_ERROR(CouldNotCreateClientPrivateKeyLocationError)
-        UAF_STATUS_COPY_ERROR(CouldNotCreateClientCertificateLocationError)
-    }
-
 #define UAF_STATUS_TOSTRING_IF(ERROR)       \
-        if (statusCode == uaf::statuscodes::ERROR) return raisedBy_##ERROR.message;
+        if (statusCode == uaf::statuscodes::ERROR) return errorMessage<uaf::ERROR>(statusCode);
 #define UAF_STATUS_TOSTRING_ELSE_IF(ERROR)       \
         else UAF_STATUS_TOSTRING_IF(ERROR)
 
@@ -376,6 +319,8 @@ namespace uaf
         UAF_STATUS_TOSTRING_ELSE_IF(ReadInvocationError)
         UAF_STATUS_TOSTRING_ELSE_IF(BeginReadInvocationError)
         UAF_STATUS_TOSTRING_ELSE_IF(ServerCouldNotReadError)
+        UAF_STATUS_TOSTRING_ELSE_IF(RegisterNodesInvocationError)
+        UAF_STATUS_TOSTRING_ELSE_IF(UnregisterNodesInvocationError)
         UAF_STATUS_TOSTRING_ELSE_IF(TranslateBrowsePathsToNodeIdsInvocationError)
         UAF_STATUS_TOSTRING_ELSE_IF(ServerCouldNotTranslateBrowsePathsToNodeIdsError)
         UAF_STATUS_TOSTRING_ELSE_IF(HistoryReadInvocationError)
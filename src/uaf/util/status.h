@@ -24,6 +24,7 @@
 // STD
 #include <string>
 #include <vector>
+#include <utility>
 #include <iostream>
 // SDK
 // UAF
@@ -42,37 +43,160 @@
 #include "uaf/util/errors/backwardscompatibilityerrors.h"
 
 
-#define UAF_STATUS_CONSTRUCTOR(ERROR)           \
-        Status(const uaf::ERROR& error)         \
-        : raisedBy_##ERROR(error),              \
-          statusCode(uaf::statuscodes::ERROR),  \
-          raisedBy_(NULL)                       \
-        {}                                      \
-                                                \
-        uaf::ERROR raisedBy_##ERROR;
+#define UAF_STATUS_CONSTRUCTOR(ERROR)                                                      \
+        Status(const uaf::ERROR& error)                                                    \
+        : statusCode(uaf::statuscodes::ERROR),                                             \
+          details_(new Details(new TypedError<uaf::ERROR>(uaf::statuscodes::ERROR, error))) \
+        {}                                                                                 \
+                                                                                           \
+        uaf::ERROR& raisedBy_##ERROR()                                                     \
+        { return materializeError<uaf::ERROR>(uaf::statuscodes::ERROR); }                  \
+                                                                                           \
+        uaf::ERROR raisedBy_##ERROR() const                                                \
+        { return errorOrDefault<uaf::ERROR>(uaf::statuscodes::ERROR); }
 
 
 namespace uaf
 {
 
+    /*******************************************************************************************//**
+    * A uaf::Status holds a status code, and optionally the diagnostics of it.
+    *
+    * The diagnostics (the typed errors, accessible via raisedBy_<ErrorName>(), and the status that
+    * raised this status) are stored behind a single pointer, which is NULL for Good statuses and
+    * for statuses that were created from a status code only. Such statuses are therefore copied
+    * without allocating any memory.
+    *
+    * @ingroup Util
+    ***********************************************************************************************/
     class UAF_EXPORT Status
     {
+
+#ifndef SWIG /* The private details below do not need to be seen by SWIG. */
+
+    private:
+
+        // a typed error, stored in the details of a status
+        class Error
+        {
+        public:
+            Error(uaf::statuscodes::StatusCode code) : code(code), next(NULL) {}
+            virtual ~Error() {}
+
+            // get a copy of the error only (not of the next ones)
+            virtual Error* clone() const = 0;
+
+            // the status code that belongs to the error
+            uaf::statuscodes::StatusCode code;
+            // the next error (only used if errors of other types are accessed as well)
+            Error* next;
+        };
+
+        template<typename _Error>
+        class TypedError : public Error
+        {
+        public:
+            TypedError(uaf::statuscodes::StatusCode code, const _Error& error)
+            : Error(code),
+              error(error)
+            {}
+
+            virtual Error* clone() const { return new TypedError<_Error>(code, error); }
+
+            _Error error;
+        };
+
+        // the diagnostics of a status
+        class Details
+        {
+        public:
+            Details(Error* error = NULL) : errors(error), raisedBy(NULL) {}
+            Details(const Details& other);
+            ~Details();
+
+            // the errors (the first one normally belongs to the status code)
+            Error* errors;
+            // the status that caused the status holding these details (may be NULL)
+            Status* raisedBy;
+
+        private:
+            Details& operator=(const Details&);
+        };
+
+        // find the error that belongs to the given code (or NULL if there is none)
+        template<typename _Error>
+        const _Error* findError(uaf::statuscodes::StatusCode code) const
+        {
+            if (details_ != NULL)
+            {
+                for (const Error* error = details_->errors; error != NULL; error = error->next)
+                {
+                    if (error->code == code)
+                        return &static_cast<const TypedError<_Error>*>(error)->error;
+                }
+            }
+            return NULL;
+        }
+
+        // get a copy of the error that belongs to the given code, or a default one
+        template<typename _Error>
+        _Error errorOrDefault(uaf::statuscodes::StatusCode code) const
+        {
+            const _Error* error = findError<_Error>(code);
+            return error != NULL ? *error : _Error();
+        }
+
+        // get the error that belongs to the given code, and store a default one if needed
+        template<typename _Error>
+        _Error& materializeError(uaf::statuscodes::StatusCode code)
+        {
+            const _Error* error = findError<_Error>(code);
+            if (error != NULL)
+                return *const_cast<_Error*>(error);
+
+            if (details_ == NULL)
+                details_ = new Details;
+
+            TypedError<_Error>* typedError = new TypedError<_Error>(code, _Error());
+            typedError->next = details_->errors;
+            details_->errors = typedError;
+            return typedError->error;
+        }
+
+        // get the message of the error that belongs to the given code, or the default one
+        template<typename _Error>
+        std::string errorMessage(uaf::statuscodes::StatusCode code) const
+        {
+            const _Error* error = findError<_Error>(code);
+            return error != NULL ? error->message : _Error().message;
+        }
+
+#endif  /* SWIG */
+
     public:
 
         Status()
         : statusCode(uaf::statuscodes::Uncertain),
-          raisedBy_(NULL)
+          details_(NULL)
         {}
 
         Status(uaf::statuscodes::StatusCode statusCode)
         : statusCode(statusCode),
-          raisedBy_(NULL)
+          details_(NULL)
         {}
 
 
         /** Copy constructor.*/
         Status(const Status& other);
 
+#ifndef SWIG
+        /** Move constructor. */
+        Status(Status&& other);
+
+        /** Move assignment operator. */
+        Status& operator=(Status&& other);
+#endif
+
         /**
          * Destructor.
          */
@@ -194,6 +318,8 @@ namespace uaf
         UAF_STATUS_CONSTRUCTOR(CouldNotCreateIssuersRevocationListLocationError)
         UAF_STATUS_CONSTRUCTOR(CouldNotCreateClientPrivateKeyLocationError)
         UAF_STATUS_CONSTRUCTOR(CouldNotCreateClientCertificateLocationError)
+        UAF_STATUS_CONSTRUCTOR(RegisterNodesInvocationError)
+        UAF_STATUS_CONSTRUCTOR(UnregisterNodesInvocationError)
 
         /** The UAF status code */
         uaf::statuscodes::StatusCode statusCode;
@@ -243,6 +369,13 @@ namespace uaf
         Status raisedBy() const;
 
 
+        /**
+         * Check if the status holds diagnostics (a typed error or a raisedBy status), i.e. if
+         * copying it allocates memory.
+         */
+        bool hasDetails() const { return details_ != NULL; }
+
+
         /** Get the name of the status code. */
         std::string statusCodeName() const;
 
@@ -253,10 +386,18 @@ namespace uaf
         friend UAF_EXPORT bool operator<(const Status& object1, const Status& object2);
 
     private:
-        Status* raisedBy_;
 
-        void copyErrors(const Status& from);
+#ifndef SWIG /* The private details below do not need to be seen by SWIG. */
+
+        // the diagnostics, or NULL if there are none
+        Details* details_;
+
+        // delete the details if they are empty
+        void deleteDetailsIfEmpty();
+
+#endif  /* SWIG */
     };
+
 }
 
 
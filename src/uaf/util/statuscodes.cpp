@@ -159,6 +159,9 @@ namespace uaf
                 UAF_STATUSCODES_TOSTRING(TimeoutError)
                 UAF_STATUSCODES_TOSTRING(NoResultReceivedError)
                 UAF_STATUSCODES_TOSTRING(UnknownHandleError)
+                // status codes added later:
+                UAF_STATUSCODES_TOSTRING(RegisterNodesInvocationError)
+                UAF_STATUSCODES_TOSTRING(UnregisterNodesInvocationError)
                 default:
                     return "UNKNOWN!";
             }
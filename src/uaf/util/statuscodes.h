@@ -169,7 +169,10 @@ namespace uaf
             OtherError,
             TimeoutError,
             NoResultReceivedError,
-            UnknownHandleError
+            UnknownHandleError,
+            // status codes added later (appended, so the values of the codes above don't change):
+            RegisterNodesInvocationError,
+            UnregisterNodesInvocationError
         };
 
 
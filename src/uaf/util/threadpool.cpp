@@ -0,0 +1,165 @@
+/* This file is part of the UAF (Unified Architecture Framework) project.
+ *
+ * Copyright (C) 2012 Wim Pessemier (Institute of Astronomy, KULeuven)
+ *
+ * Project website: http://www.ster.kuleuven.be/uaf
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "uaf/util/threadpool.h"
+
+
+namespace uaf
+{
+    using namespace uaf;
+    using std::size_t;
+
+
+    // Constructor
+    // =============================================================================================
+    ThreadPoolJob::ThreadPoolJob(bool autoDelete)
+    : autoDelete_(autoDelete),
+      finished_(0, 1)
+    {}
+
+
+    // Destructor
+    // =============================================================================================
+    ThreadPoolJob::~ThreadPoolJob()
+    {}
+
+
+    // Wait until the job has been executed
+    // =============================================================================================
+    void ThreadPoolJob::waitUntilFinished()
+    {
+        finished_.wait();
+    }
+
+
+    // Execute the job and signal its completion
+    // =============================================================================================
+    void ThreadPoolJob::run()
+    {
+        execute();
+
+        if (autoDelete_)
+            delete this;
+        else
+            finished_.post(1);
+    }
+
+
+    // Constructor
+    // =============================================================================================
+    ThreadPool::ThreadPool(size_t noOfThreads, size_t maxQueueSize)
+    : maxQueueSize_(maxQueueSize > 0 ? maxQueueSize : 1),
+      jobsAvailable_(0, OpcUa_Int32_Max),
+      freeSlots_(maxQueueSize_, maxQueueSize_)
+    {
+        if (noOfThreads == 0)
+            noOfThreads = 1;
+
+        workers_.reserve(noOfThreads);
+        for (size_t i = 0; i < noOfThreads; i++)
+        {
+            Worker* worker = new Worker(this);
+            workers_.push_back(worker);
+            worker->start();
+        }
+    }
+
+
+    // Destructor
+    // =============================================================================================
+    ThreadPool::~ThreadPool()
+    {
+        // queue one stop request per worker, behind the jobs that are still pending
+        // (stop requests don't occupy a slot, so this never blocks)
+        jobsMutex_.lock();
+        for (size_t i = 0; i < workers_.size(); i++)
+            jobs_.push_back(NULL);
+        jobsMutex_.unlock();
+        jobsAvailable_.post(workers_.size());
+
+        for (size_t i = 0; i < workers_.size(); i++)
+        {
+            workers_[i]->wait();
+            delete workers_[i];
+        }
+        workers_.clear();
+    }
+
+
+    // Add a job
+    // =============================================================================================
+    bool ThreadPool::addJob(ThreadPoolJob* job, bool block)
+    {
+        if (job == NULL)
+            return false;
+
+        if (block)
+            freeSlots_.wait();
+        else if (OpcUa_IsNotGood(freeSlots_.timedWait(0)))
+            return false;
+
+        jobsMutex_.lock();
+        jobs_.push_back(job);
+        jobsMutex_.unlock();
+
+        jobsAvailable_.post(1);
+
+        return true;
+    }
+
+
+    // Get the number of queued jobs
+    // =============================================================================================
+    size_t ThreadPool::queueSize()
+    {
+        UaMutexLocker locker(&jobsMutex_);
+        return jobs_.size();
+    }
+
+
+    // Take the next job
+    // =============================================================================================
+    ThreadPoolJob* ThreadPool::takeJob()
+    {
+        jobsAvailable_.wait();
+
+        jobsMutex_.lock();
+        ThreadPoolJob* job = jobs_.front();
+        jobs_.pop_front();
+        jobsMutex_.unlock();
+
+        // a real job frees a slot of the queue (stop requests never occupied one)
+        if (job != NULL)
+            freeSlots_.post(1);
+
+        return job;
+    }
+
+
+    // Run method of a worker thread
+    // =============================================================================================
+    void ThreadPool::Worker::run()
+    {
+        ThreadPoolJob* job;
+        while ((job = pool_->takeJob()) != NULL)
+            job->run();
+    }
+
+}
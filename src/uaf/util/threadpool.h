@@ -0,0 +1,204 @@
+/* This file is part of the UAF (Unified Architecture Framework) project.
+ *
+ * Copyright (C) 2012 Wim Pessemier (Institute of Astronomy, KULeuven)
+ *
+ * Project website: http://www.ster.kuleuven.be/uaf
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UAF_THREADPOOL_H_
+#define UAF_THREADPOOL_H_
+
+
+// STD
+#include <deque>
+#include <vector>
+// SDK
+#include "uabasecpp/uathread.h"
+#include "uabasecpp/uamutex.h"
+#include "uabasecpp/uasemaphore.h"
+// UAF
+#include "uaf/util/util.h"
+
+
+namespace uaf
+{
+
+    // forward declaration
+    class ThreadPool;
+
+
+    /*******************************************************************************************//**
+    * A uaf::ThreadPoolJob is a unit of work that can be executed by a uaf::ThreadPool.
+    *
+    * Override the execute() method to define the work. The thread that submitted the job can
+    * wait for its completion via waitUntilFinished(), unless the job was constructed with
+    * autoDelete=true: in that case the pool deletes the job as soon as it has been executed,
+    * and the job must not be touched anymore after it was submitted.
+    *
+    * @ingroup Util
+    ***********************************************************************************************/
+    class UAF_EXPORT ThreadPoolJob
+    {
+    public:
+
+        /**
+         * Construct a job.
+         *
+         * @param autoDelete    True if the thread pool must delete the job after execution.
+         */
+        ThreadPoolJob(bool autoDelete = false);
+
+
+        /**
+         * Destruct the job.
+         */
+        virtual ~ThreadPoolJob();
+
+
+        /**
+         * The work to be done by a thread of the pool.
+         */
+        virtual void execute() = 0;
+
+
+        /**
+         * Block the calling thread until the job has been executed.
+         *
+         * Only call this method for jobs that are not automatically deleted!
+         */
+        void waitUntilFinished();
+
+
+    private:
+
+        DISALLOW_COPY_AND_ASSIGN(ThreadPoolJob);
+
+        friend class ThreadPool;
+
+        // execute the job and signal its completion (called by the pool)
+        void run();
+
+        // true if the pool must delete the job after execution
+        bool autoDelete_;
+        // semaphore that is posted when the job has been executed
+        UaSemaphore finished_;
+    };
+
+
+
+    /*******************************************************************************************//**
+    * A uaf::ThreadPool executes uaf::ThreadPoolJob instances on a fixed number of threads.
+    *
+    * The queue of pending jobs is bounded: when it is full, addJob() either blocks until a
+    * slot becomes free, or refuses the job (depending on its 'block' argument).
+    *
+    * @ingroup Util
+    ***********************************************************************************************/
+    class UAF_EXPORT ThreadPool
+    {
+    public:
+
+        /**
+         * Construct a thread pool and start its threads.
+         *
+         * @param noOfThreads   The number of threads that execute the jobs (at least 1).
+         * @param maxQueueSize  The maximum number of jobs waiting to be executed (at least 1).
+         */
+        ThreadPool(std::size_t noOfThreads, std::size_t maxQueueSize);
+
+
+        /**
+         * Destruct the thread pool.
+         *
+         * Jobs that were already queued are still executed before the threads are stopped.
+         */
+        ~ThreadPool();
+
+
+        /**
+         * Add a job to the queue.
+         *
+         * @param job   The job to execute (not owned by the pool, unless it is an autoDelete job).
+         * @param block True to wait for a free slot if the queue is full, false to refuse the job
+         *              immediately in that case.
+         * @return      True if the job was queued, false if it was refused. A refused autoDelete
+         *              job is not deleted by the pool.
+         */
+        bool addJob(uaf::ThreadPoolJob* job, bool block = true);
+
+
+        /**
+         * Get the number of threads of the pool.
+         */
+        std::size_t noOfThreads() const { return workers_.size(); }
+
+
+        /**
+         * Get the maximum number of queued jobs.
+         */
+        std::size_t maxQueueSize() const { return maxQueueSize_; }
+
+
+        /**
+         * Get the number of jobs that are currently queued (but not yet being executed).
+         */
+        std::size_t queueSize();
+
+
+    private:
+
+        DISALLOW_COPY_AND_ASSIGN(ThreadPool);
+
+
+        /**
+         * A thread of the pool.
+         */
+        class Worker : public UaThread
+        {
+        public:
+            Worker(ThreadPool* pool) : pool_(pool) {}
+        private:
+            void run();
+            ThreadPool* pool_;
+        };
+
+
+        /**
+         * Take the next job from the queue (blocking until one is available).
+         *
+         * @return The next job, or NULL if the worker must stop.
+         */
+        uaf::ThreadPoolJob* takeJob();
+
+
+        // the maximum number of queued jobs
+        std::size_t                         maxQueueSize_;
+        // the threads of the pool
+        std::vector<Worker*>                workers_;
+        // the queued jobs (a NULL job tells a worker to stop)
+        std::deque<uaf::ThreadPoolJob*>     jobs_;
+        // mutex to protect the jobs_ queue
+        UaMutex                             jobsMutex_;
+        // number of queued jobs (including stop requests)
+        UaSemaphore                         jobsAvailable_;
+        // number of free slots in the queue
+        UaSemaphore                         freeSlots_;
+    };
+
+}
+
+
+#endif /* UAF_THREADPOOL_H_ */
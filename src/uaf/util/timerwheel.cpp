@@ -0,0 +1,265 @@
+/* This file is part of the UAF (Unified Architecture Framework) project.
+ *
+ * Copyright (C) 2012 Wim Pessemier (Institute of Astronomy, KULeuven)
+ *
+ * Project website: http://www.ster.kuleuven.be/uaf
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "uaf/util/timerwheel.h"
+
+
+namespace uaf
+{
+    using namespace uaf;
+    using std::size_t;
+    using std::vector;
+
+
+    // Constructor
+    // =============================================================================================
+    TimerWheel::TimerWheel(size_t noOfSlots, uint32_t tickMs)
+    : tickMs_(tickMs > 0 ? tickMs : 1),
+      start_(Clock::now()),
+      slots_((noOfSlots > 0 ? noOfSlots : 1) + 1),
+      overdueSlot_(slots_.size() - 1),
+      lastTick_(0),
+      woken_(false),
+      wakeUp_(0, 1)
+    {}
+
+
+    // Get the current tick
+    // =============================================================================================
+    uint64_t TimerWheel::currentTick() const
+    {
+        int64_t elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+                Clock::now() - start_).count();
+        return uint64_t(elapsedMs) / tickMs_;
+    }
+
+
+    // Schedule a task
+    // =============================================================================================
+    void TimerWheel::schedule(uint64_t taskId, double delaySec)
+    {
+        int64_t elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+                Clock::now() - start_).count();
+        int64_t delayMs = delaySec > 0.0 ? int64_t(delaySec * 1000.0) : 0;
+
+        // round the deadline up, so that a task is never due too early
+        uint64_t deadlineTick = (uint64_t(elapsedMs + delayMs) + tickMs_ - 1) / tickMs_;
+
+        {
+            UaMutexLocker locker(&mutex_); // unlocks when out of scope
+
+            std::unordered_map<uint64_t, Location>::iterator it = locations_.find(taskId);
+            if (it != locations_.end())
+            {
+                // keep the earliest deadline
+                if (it->second.position->deadlineTick <= deadlineTick)
+                    return;
+
+                slots_[it->second.slot].erase(it->second.position);
+                locations_.erase(it);
+            }
+
+            insert(taskId, deadlineTick);
+        }
+
+        // the waiting thread must recompute how long it can sleep
+        wakeUp_.post(1);
+    }
+
+
+    // Cancel a task
+    // =============================================================================================
+    bool TimerWheel::cancel(uint64_t taskId)
+    {
+        UaMutexLocker locker(&mutex_); // unlocks when out of scope
+
+        std::unordered_map<uint64_t, Location>::iterator it = locations_.find(taskId);
+        if (it == locations_.end())
+            return false;
+
+        slots_[it->second.slot].erase(it->second.position);
+        locations_.erase(it);
+        return true;
+    }
+
+
+    // Check if a task is scheduled
+    // =============================================================================================
+    bool TimerWheel::isScheduled(uint64_t taskId)
+    {
+        UaMutexLocker locker(&mutex_); // unlocks when out of scope
+        return locations_.find(taskId) != locations_.end();
+    }
+
+
+    // Get the number of scheduled tasks
+    // =============================================================================================
+    size_t TimerWheel::noOfScheduledTasks()
+    {
+        UaMutexLocker locker(&mutex_); // unlocks when out of scope
+        return locations_.size();
+    }
+
+
+    // Wake up the waiting thread
+    // =============================================================================================
+    void TimerWheel::wake()
+    {
+        mutex_.lock();
+        woken_ = true;
+        mutex_.unlock();
+
+        wakeUp_.post(1);
+    }
+
+
+    // Take the due tasks
+    // =============================================================================================
+    void TimerWheel::takeDueTasks(vector<uint64_t>& dueTaskIds, uint32_t maxWaitMs)
+    {
+        Clock::time_point until = Clock::now() + std::chrono::milliseconds(maxWaitMs);
+
+        while (true)
+        {
+            Clock::time_point next;
+            {
+                UaMutexLocker locker(&mutex_); // unlocks when out of scope
+
+                if (woken_)
+                {
+                    woken_ = false;
+                    return;
+                }
+
+                uint64_t now = currentTick();
+                size_t noOfDueTasks = dueTaskIds.size();
+                advance(now, dueTaskIds);
+                if (dueTaskIds.size() > noOfDueTasks)
+                    return;
+
+                next = start_ + std::chrono::milliseconds(
+                        int64_t((now + ticksUntilNextDeadline(now)) * tickMs_));
+            }
+
+            Clock::time_point current = Clock::now();
+            if (current >= until)
+                return;
+            if (next > until)
+                next = until;
+
+            // sleep until the next deadline, unless a task is scheduled or wake() is called
+            // in the meantime (in both cases, the loop is simply run again)
+            // (one millisecond is added to make sure that the deadline has passed when we wake up)
+            int64_t waitMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    next - current).count();
+            wakeUp_.timedWait(uint32_t(waitMs > 0 ? waitMs : 0) + 1);
+        }
+    }
+
+
+    // Add a task to the wheel
+    // =============================================================================================
+    void TimerWheel::insert(uint64_t taskId, uint64_t deadlineTick)
+    {
+        size_t slot;
+        if (deadlineTick <= lastTick_)
+            slot = overdueSlot_;
+        else
+            slot = size_t(deadlineTick % overdueSlot_);
+
+        Timer timer;
+        timer.taskId       = taskId;
+        timer.deadlineTick = deadlineTick;
+
+        Location location;
+        location.slot     = slot;
+        location.position = slots_[slot].insert(slots_[slot].end(), timer);
+        locations_[taskId] = location;
+    }
+
+
+    // Take the tasks that are due
+    // =============================================================================================
+    void TimerWheel::advance(uint64_t now, vector<uint64_t>& dueTaskIds)
+    {
+        // the tasks that were already overdue when they were scheduled
+        Slot& overdue = slots_[overdueSlot_];
+        for (Slot::iterator it = overdue.begin(); it != overdue.end(); ++it)
+        {
+            dueTaskIds.push_back(it->taskId);
+            locations_.erase(it->taskId);
+        }
+        overdue.clear();
+
+        if (now <= lastTick_)
+            return;
+
+        // visit each slot that has passed since the last time, but each slot at most once
+        // (the tasks of later rotations stay in their slot)
+        uint64_t first = lastTick_ + 1;
+        if (now - lastTick_ > overdueSlot_)
+            first = now - overdueSlot_ + 1;
+
+        for (uint64_t tick = first; tick <= now; tick++)
+        {
+            Slot& slot = slots_[size_t(tick % overdueSlot_)];
+            Slot::iterator it = slot.begin();
+            while (it != slot.end())
+            {
+                if (it->deadlineTick <= now)
+                {
+                    dueTaskIds.push_back(it->taskId);
+                    locations_.erase(it->taskId);
+                    it = slot.erase(it);
+                }
+                else
+                {
+                    ++it;
+                }
+            }
+        }
+
+        lastTick_ = now;
+    }
+
+
+    // Get the number of ticks until the next deadline
+    // =============================================================================================
+    uint64_t TimerWheel::ticksUntilNextDeadline(uint64_t now) const
+    {
+        if (!slots_[overdueSlot_].empty())
+            return 0;
+
+        for (uint64_t ticks = 1; ticks <= overdueSlot_; ticks++)
+        {
+            const Slot& slot = slots_[size_t((now + ticks) % overdueSlot_)];
+            for (Slot::const_iterator it = slot.begin(); it != slot.end(); ++it)
+            {
+                if (it->deadlineTick <= now + ticks)
+                    return ticks;
+            }
+        }
+
+        // no task expires within one rotation of the wheel
+        return overdueSlot_;
+    }
+
+}
@@ -0,0 +1,185 @@
+/* This file is part of the UAF (Unified Architecture Framework) project.
+ *
+ * Copyright (C) 2012 Wim Pessemier (Institute of Astronomy, KULeuven)
+ *
+ * Project website: http://www.ster.kuleuven.be/uaf
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef UAF_TIMERWHEEL_H_
+#define UAF_TIMERWHEEL_H_
+
+
+// STD
+#include <vector>
+#include <list>
+#include <unordered_map>
+#include <chrono>
+#include <stdint.h>
+// SDK
+#include "uabasecpp/uamutex.h"
+#include "uabasecpp/uasemaphore.h"
+// UAF
+#include "uaf/util/util.h"
+
+
+namespace uaf
+{
+
+
+    /*******************************************************************************************//**
+    * A uaf::TimerWheel keeps track of the deadlines of tasks, and lets a thread sleep until the
+    * next task is due.
+    *
+    * Tasks are identified by a number, chosen by the user of the wheel. A task is scheduled at
+    * most once: scheduling a task that is already scheduled keeps the earliest deadline of both.
+    *
+    * The deadlines are stored in a hashed timer wheel: a ring of slots, each slot holding the
+    * tasks that expire at a multiple of the tick. Scheduling and cancelling a task therefore
+    * take constant time, and the thread that waits for the due tasks only needs to look at the
+    * slots until the next occupied one. When a task is scheduled, the waiting thread is woken up
+    * immediately, so it never sleeps longer than needed.
+    *
+    * @ingroup Util
+    ***********************************************************************************************/
+    class UAF_EXPORT TimerWheel
+    {
+    public:
+
+        /**
+         * Construct a timer wheel.
+         *
+         * @param noOfSlots The number of slots of the wheel (at least 1).
+         * @param tickMs    The resolution of the deadlines, in milliseconds (at least 1).
+         */
+        TimerWheel(std::size_t noOfSlots = 256, uint32_t tickMs = 50);
+
+
+        /**
+         * Schedule a task.
+         *
+         * If the task was already scheduled, it keeps the earliest deadline of both.
+         *
+         * @param taskId    The number identifying the task.
+         * @param delaySec  The number of seconds after which the task is due (0 = immediately).
+         */
+        void schedule(uint64_t taskId, double delaySec = 0.0);
+
+
+        /**
+         * Cancel a task.
+         *
+         * @param taskId    The number identifying the task.
+         * @return          True if the task was scheduled, false if not.
+         */
+        bool cancel(uint64_t taskId);
+
+
+        /**
+         * Check if a task is scheduled.
+         *
+         * @param taskId    The number identifying the task.
+         * @return          True if the task is scheduled (and not yet taken), false if not.
+         */
+        bool isScheduled(uint64_t taskId);
+
+
+        /**
+         * Get the number of scheduled tasks.
+         */
+        std::size_t noOfScheduledTasks();
+
+
+        /**
+         * Block the calling thread until at least one task is due, and take all due tasks.
+         *
+         * The taken tasks are not scheduled anymore, so periodic tasks must be scheduled again
+         * by the caller.
+         *
+         * @param dueTaskIds    Vector to which the numbers of the due tasks will be appended.
+         * @param maxWaitMs     The maximum time to wait, in milliseconds. When this time has
+         *                      elapsed, or when wake() is called, the method returns even if
+         *                      no task is due.
+         */
+        void takeDueTasks(std::vector<uint64_t>& dueTaskIds, uint32_t maxWaitMs);
+
+
+        /**
+         * Wake up the thread that is waiting in takeDueTasks().
+         */
+        void wake();
+
+
+    private:
+
+        DISALLOW_COPY_AND_ASSIGN(TimerWheel);
+
+        typedef std::chrono::steady_clock Clock;
+
+        // a scheduled task
+        struct Timer
+        {
+            uint64_t taskId;
+            uint64_t deadlineTick;
+        };
+
+        typedef std::list<Timer> Slot;
+
+        // the location of a scheduled task
+        struct Location
+        {
+            std::size_t     slot;
+            Slot::iterator  position;
+        };
+
+        // get the current tick (the number of ticks since the construction of the wheel)
+        uint64_t currentTick() const;
+
+        // add a task to the wheel (mutex_ must be locked, and the task must not be scheduled)
+        void insert(uint64_t taskId, uint64_t deadlineTick);
+
+        // move all tasks that are due at the given tick to dueTaskIds (mutex_ must be locked)
+        void advance(uint64_t now, std::vector<uint64_t>& dueTaskIds);
+
+        // get the number of ticks until the next deadline, or the number of slots if no task
+        // expires within one rotation of the wheel (mutex_ must be locked)
+        uint64_t ticksUntilNextDeadline(uint64_t now) const;
+
+        // the resolution of the deadlines
+        uint32_t                                    tickMs_;
+        // the time at which the wheel was constructed (i.e. tick 0)
+        Clock::time_point                           start_;
+        // the slots of the wheel, plus one extra slot (at the back) for tasks of which the
+        // deadline has already passed when they were scheduled
+        std::vector<Slot>                           slots_;
+        // the number of the slot that holds the overdue tasks
+        std::size_t                                 overdueSlot_;
+        // the location of each scheduled task
+        std::unordered_map<uint64_t, Location>      locations_;
+        // all ticks up to (and including) this one have been processed
+        uint64_t                                    lastTick_;
+        // true if wake() was called, and takeDueTasks() didn't return since then
+        bool                                        woken_;
+        // mutex to protect the members above
+        UaMutex                                     mutex_;
+        // semaphore that is posted when a task was scheduled or when wake() was called
+        UaSemaphore                                 wakeUp_;
+    };
+
+}
+
+
+#endif /* UAF_TIMERWHEEL_H_ */
@@ -25,35 +25,254 @@ namespace uaf
     using namespace uaf;
     using std::string;
     using std::stringstream;
+    using std::vector;
+
+
+    /***********************************************************************************************
+     *                                                                                             *
+     *                                          Payloads                                           *
+     *                                                                                             *
+     **********************************************************************************************/
+
+
+    // The base class of the heap-allocated payloads
+    // =============================================================================================
+    struct Variant::Payload
+    {
+        virtual ~Payload() {}
+        virtual Payload* clone() const = 0;
+    };
+
+
+    // A payload holding an SDK UaVariant
+    // =============================================================================================
+    struct Variant::SdkPayload : public Variant::Payload
+    {
+        virtual Payload* clone() const { return new SdkPayload(*this); }
+        UaVariant uaVariant;
+    };
+
+
+    // A payload holding native UAF instances
+    // (because these types support namespace URIs and/or server URIs instead of only namespace IDs
+    //  and/or server IDs). We store them as vectors, so that they can also represent arrays.
+    // =============================================================================================
+    template <typename _T>
+    struct Variant::NativePayload : public Variant::Payload
+    {
+        virtual Payload* clone() const { return new NativePayload<_T>(*this); }
+        vector<_T> values;
+    };
+
+
+
+    /***********************************************************************************************
+     *                                                                                             *
+     *                                          Variant                                            *
+     *                                                                                             *
+     **********************************************************************************************/
 
 
     // Constructor
     // =============================================================================================
     Variant::Variant()
-    : isNativeUaf_(false),
-      dataTypeIfNativeUaf_(opcuatypes::Null),
-      arrayTypeIfNativeUaf_(OpcUa_VariantArrayType_Scalar)
+    : storage_(NullStorage),
+      type_(opcuatypes::Null),
+      arrayType_(OpcUa_VariantArrayType_Scalar),
+      payload_(0)
     {}
 
 
     // Constructor
     // =============================================================================================
     Variant::Variant(const OpcUa_Variant& variant)
-    : uaVariant_(variant),
-      isNativeUaf_(false),
-      dataTypeIfNativeUaf_(opcuatypes::Null),
-      arrayTypeIfNativeUaf_(OpcUa_VariantArrayType_Scalar)
+    : storage_(NullStorage),
+      type_(opcuatypes::Null),
+      arrayType_(OpcUa_VariantArrayType_Scalar),
+      payload_(0)
+    {
+        fromSdk(variant);
+    }
+
+
+    // Copy constructor
+    // =============================================================================================
+    Variant::Variant(const Variant& other)
+    : storage_(other.storage_),
+      type_(other.type_),
+      arrayType_(other.arrayType_),
+      scalar_(other.scalar_),
+      payload_(other.payload_ == 0 ? 0 : other.payload_->clone())
     {}
 
 
+    // Copy assignment
+    // =============================================================================================
+    Variant& Variant::operator=(const Variant& other)
+    {
+        if (this != &other)
+        {
+            Payload* payload = (other.payload_ == 0 ? 0 : other.payload_->clone());
+            delete payload_;
+            storage_   = other.storage_;
+            type_      = other.type_;
+            arrayType_ = other.arrayType_;
+            scalar_    = other.scalar_;
+            payload_   = payload;
+        }
+        return *this;
+    }
+
+
+    // Move constructor
+    // =============================================================================================
+    Variant::Variant(Variant&& other)
+    : storage_(other.storage_),
+      type_(other.type_),
+      arrayType_(other.arrayType_),
+      scalar_(other.scalar_),
+      payload_(other.payload_)
+    {
+        other.payload_ = 0;
+        other.clear();
+    }
+
+
+    // Move assignment
+    // =============================================================================================
+    Variant& Variant::operator=(Variant&& other)
+    {
+        if (this != &other)
+        {
+            delete payload_;
+            storage_   = other.storage_;
+            type_      = other.type_;
+            arrayType_ = other.arrayType_;
+            scalar_    = other.scalar_;
+            payload_   = other.payload_;
+            other.payload_ = 0;
+            other.clear();
+        }
+        return *this;
+    }
+
+
+    // Destructor
+    // =============================================================================================
+    Variant::~Variant()
+    {
+        delete payload_;
+    }
+
+
+    // Clear the Variant
+    // =============================================================================================
+    void Variant::clear()
+    {
+        delete payload_;
+        payload_   = 0;
+        storage_   = NullStorage;
+        type_      = opcuatypes::Null;
+        arrayType_ = OpcUa_VariantArrayType_Scalar;
+    }
+
+
+    // Store a scalar inline
+    // =============================================================================================
+    void Variant::setInline(opcuatypes::OpcUaType type)
+    {
+        if (payload_ != 0)
+        {
+            delete payload_;
+            payload_ = 0;
+        }
+        storage_   = InlineStorage;
+        type_      = type;
+        arrayType_ = OpcUa_VariantArrayType_Scalar;
+    }
+
+
+    // Get a cleared UaVariant to store a value in
+    // =============================================================================================
+    UaVariant& Variant::sdkVariant()
+    {
+        if (storage_ == SdkStorage)
+        {
+            // reuse the existing payload
+            static_cast<SdkPayload*>(payload_)->uaVariant.clear();
+        }
+        else
+        {
+            clear();
+            payload_ = new SdkPayload;
+            storage_ = SdkStorage;
+        }
+        return static_cast<SdkPayload*>(payload_)->uaVariant;
+    }
+
+
+    // Get a cleared vector to store native UAF instances in
+    // =============================================================================================
+    template <typename _T>
+    vector<_T>& Variant::nativeValues(opcuatypes::OpcUaType type, OpcUa_Byte arrayType)
+    {
+        clear();
+        NativePayload<_T>* payload = new NativePayload<_T>;
+        payload_   = payload;
+        storage_   = NativeStorage;
+        type_      = type;
+        arrayType_ = arrayType;
+        return payload->values;
+    }
+
+
+    // Get the native UAF instances
+    // =============================================================================================
+    template <typename _T>
+    const vector<_T>& Variant::nativeValues() const
+    {
+        return static_cast<const NativePayload<_T>*>(payload_)->values;
+    }
+
+
+    // Get the variant as a UaVariant
+    // =============================================================================================
+    const UaVariant& Variant::asSdk(UaVariant& temporary) const
+    {
+        if (storage_ == SdkStorage)
+            return static_cast<const SdkPayload*>(payload_)->uaVariant;
+
+        toSdk(temporary);
+        return temporary;
+    }
+
+
+    // Is the variant empty?
+    // =============================================================================================
+    bool Variant::isNull() const
+    {
+        switch (storage_)
+        {
+            case NullStorage:
+                return true;
+            case SdkStorage:
+                return (bool)(static_cast<const SdkPayload*>(payload_)->uaVariant.isEmpty());
+            default:
+                return false;
+        }
+    }
+
+
     // Convert the variant to a native C++ uint8_t.
     // =============================================================================================
     Status Variant::toByteArray(std::vector<uint8_t>& vec) const
     {
+        UaVariant temporary;
+        const UaVariant& uaVariant = asSdk(temporary);
         UaByteArray arr;
         uaf::Status ret = evaluate(
-                uaVariant_.toByteArray(arr),
-                uaVariant_.type(),
+                uaVariant.toByteArray(arr),
+                uaVariant.type(),
                 OpcUaType_Byte);
         vec.resize(arr.size());
         for (int i = 0; i < arr.size(); i++)
@@ -65,14 +284,16 @@ namespace uaf
     // =============================================================================================
     Status Variant::toVariantArray(std::vector<uaf::Variant>& vec) const
     {
+        UaVariant temporary;
+        const UaVariant& uaVariant = asSdk(temporary);
         UaVariantArray arr;
         uaf::Status ret = evaluate(
-                uaVariant_.toVariantArray(arr),
-                uaVariant_.type(),
+                uaVariant.toVariantArray(arr),
+                uaVariant.type(),
                 OpcUaType_Variant);
         vec.resize(arr.length());
         for (uint32_t i = 0; i < arr.length(); i++)
-            vec[i] = arr[i];
+            vec[i].fromSdk(arr[i]);
         return ret;
     }
 
@@ -81,9 +302,16 @@ namespace uaf
     =========================================================================================== */ \
     Status Variant::to##XXX(CPPTYPE &val) const                                                    \
     {                                                                                              \
+        if (storage_ == InlineStorage && type_ == uaf::opcuatypes::XXX)                            \
+        {                                                                                          \
+            val = scalar_.XXX;                                                                     \
+            return uaf::statuscodes::Good;                                                         \
+        }                                                                                          \
+        UaVariant temporary;                                                                       \
+        const UaVariant& uaVariant = asSdk(temporary);                                             \
         return evaluate(                                                                           \
-                uaVariant_.to##XXX( (OpcUa_##XXX &) val ),                                         \
-                uaVariant_.type(),                                                                 \
+                uaVariant.to##XXX( (OpcUa_##XXX &) val ),                                          \
+                uaVariant.type(),                                                                  \
                 OpcUaType_##XXX);                                                                  \
     }
 
@@ -105,10 +333,12 @@ namespace uaf
     =========================================================================================== */ \
     Status Variant::to##XXX##Array(std::vector<CPPTYPE>& vec) const                                \
     {                                                                                              \
+        UaVariant temporary;                                                                       \
+        const UaVariant& uaVariant = asSdk(temporary);                                             \
         Ua##XXX##Array arr;                                                                        \
         uaf::Status ret = evaluate(                                                                \
-                uaVariant_.to##XXX##Array(arr),                                                    \
-                uaVariant_.type(),                                                                 \
+                uaVariant.to##XXX##Array(arr),                                                     \
+                uaVariant.type(),                                                                  \
                 OpcUaType_##XXX);                                                                  \
         vec.resize(arr.length());                                                                  \
         for (std::size_t i = 0; i < arr.length(); i++)                                             \
@@ -128,67 +358,71 @@ namespace uaf
 
 
 
-#define IMPLEMENT_VARIANT_TOXXX_METHOD_NATIVE_UAF(XXX, INTERNAL)                                   \
+#define IMPLEMENT_VARIANT_TOXXX_METHOD_NATIVE_UAF(XXX)                                             \
     /** Convert the variant to a (possibly native UAF) C++ type.                                   \
     =========================================================================================== */ \
     Status Variant::to##XXX(uaf::XXX& val) const                                                   \
     {                                                                                              \
         uaf::Status ret;                                                                           \
-        if (isNativeUaf_)                                                                          \
+        if (storage_ == NativeStorage)                                                             \
         {                                                                                          \
-            if (dataTypeIfNativeUaf_ != uaf::opcuatypes::XXX)                                      \
+            if (type_ != uaf::opcuatypes::XXX)                                                     \
                 ret = uaf::WrongTypeError();                                                       \
-            else if (arrayTypeIfNativeUaf_ != OpcUa_VariantArrayType_Scalar)                       \
+            else if (arrayType_ != OpcUa_VariantArrayType_Scalar)                                  \
                 ret = uaf::WrongTypeError();                                                       \
-            else if (INTERNAL.size() != 1)                                                         \
+            else if (nativeValues<uaf::XXX>().size() != 1)                                         \
                 ret = uaf::UnexpectedError("Bug: wrong size of internal vector");                  \
             else                                                                                   \
             {                                                                                      \
                 ret = uaf::statuscodes::Good;                                                      \
-                val = INTERNAL[0];                                                                 \
+                val = nativeValues<uaf::XXX>()[0];                                                 \
             }                                                                                      \
         }                                                                                          \
         else                                                                                       \
         {                                                                                          \
+            UaVariant temporary;                                                                   \
+            const UaVariant& uaVariant = asSdk(temporary);                                         \
             Ua##XXX uaObject;                                                                      \
-            ret = evaluate(uaVariant_.to##XXX(uaObject), uaVariant_.type(), OpcUaType_##XXX);      \
+            ret = evaluate(uaVariant.to##XXX(uaObject), uaVariant.type(), OpcUaType_##XXX);        \
             val.fromSdk(uaObject);                                                                 \
         }                                                                                          \
         return ret;                                                                                \
     }
 
-    IMPLEMENT_VARIANT_TOXXX_METHOD_NATIVE_UAF(NodeId          , nodeId_)
-    IMPLEMENT_VARIANT_TOXXX_METHOD_NATIVE_UAF(Guid            , guid_)
-    IMPLEMENT_VARIANT_TOXXX_METHOD_NATIVE_UAF(ExpandedNodeId  , expandedNodeId_)
-    IMPLEMENT_VARIANT_TOXXX_METHOD_NATIVE_UAF(QualifiedName   , qualifiedName_)
-    IMPLEMENT_VARIANT_TOXXX_METHOD_NATIVE_UAF(ExtensionObject , extensionObject_)
+    IMPLEMENT_VARIANT_TOXXX_METHOD_NATIVE_UAF(NodeId)
+    IMPLEMENT_VARIANT_TOXXX_METHOD_NATIVE_UAF(Guid)
+    IMPLEMENT_VARIANT_TOXXX_METHOD_NATIVE_UAF(ExpandedNodeId)
+    IMPLEMENT_VARIANT_TOXXX_METHOD_NATIVE_UAF(QualifiedName)
+    IMPLEMENT_VARIANT_TOXXX_METHOD_NATIVE_UAF(ExtensionObject)
 
 
 
-#define IMPLEMENT_VARIANT_TOXXXARRAY_METHOD_NATIVE_UAF(XXX, INTERNAL)                              \
+#define IMPLEMENT_VARIANT_TOXXXARRAY_METHOD_NATIVE_UAF(XXX)                                        \
     /** Convert the variant to a (possibly native UAF) C++ array.                                  \
     =========================================================================================== */ \
     uaf::Status Variant::to##XXX##Array(std::vector<uaf::XXX>& vec) const                          \
     {                                                                                              \
         uaf::Status ret;                                                                           \
-        if (isNativeUaf_)                                                                          \
+        if (storage_ == NativeStorage)                                                             \
         {                                                                                          \
-            if (dataTypeIfNativeUaf_ != uaf::opcuatypes::XXX)                                      \
+            if (type_ != uaf::opcuatypes::XXX)                                                     \
                 ret = uaf::WrongTypeError();                                                       \
-            else if (arrayTypeIfNativeUaf_ != OpcUa_VariantArrayType_Array)                        \
+            else if (arrayType_ != OpcUa_VariantArrayType_Array)                                   \
                 ret = uaf::WrongTypeError();                                                       \
             else                                                                                   \
             {                                                                                      \
                 ret = uaf::statuscodes::Good;                                                      \
-                vec = INTERNAL;                                                                    \
+                vec = nativeValues<uaf::XXX>();                                                    \
             }                                                                                      \
         }                                                                                          \
         else                                                                                       \
         {                                                                                          \
+            UaVariant temporary;                                                                   \
+            const UaVariant& uaVariant = asSdk(temporary);                                         \
             Ua##XXX##Array arr;                                                                    \
             ret = evaluate(                                                                        \
-                    uaVariant_.to##XXX##Array(arr),                                                \
-                    uaVariant_.type(),                                                             \
+                    uaVariant.to##XXX##Array(arr),                                                 \
+                    uaVariant.type(),                                                              \
                     OpcUaType_##XXX);                                                              \
             vec.resize(arr.length());                                                              \
             for (std::size_t i = 0; i < arr.length(); i++)                                         \
@@ -197,11 +431,11 @@ namespace uaf
         return ret;                                                                                \
     }
 
-    IMPLEMENT_VARIANT_TOXXXARRAY_METHOD_NATIVE_UAF(NodeId          , nodeId_)
-    IMPLEMENT_VARIANT_TOXXXARRAY_METHOD_NATIVE_UAF(Guid            , guid_)
-    IMPLEMENT_VARIANT_TOXXXARRAY_METHOD_NATIVE_UAF(ExpandedNodeId  , expandedNodeId_)
-    IMPLEMENT_VARIANT_TOXXXARRAY_METHOD_NATIVE_UAF(QualifiedName   , qualifiedName_)
-    IMPLEMENT_VARIANT_TOXXXARRAY_METHOD_NATIVE_UAF(ExtensionObject , extensionObject_)
+    IMPLEMENT_VARIANT_TOXXXARRAY_METHOD_NATIVE_UAF(NodeId)
+    IMPLEMENT_VARIANT_TOXXXARRAY_METHOD_NATIVE_UAF(Guid)
+    IMPLEMENT_VARIANT_TOXXXARRAY_METHOD_NATIVE_UAF(ExpandedNodeId)
+    IMPLEMENT_VARIANT_TOXXXARRAY_METHOD_NATIVE_UAF(QualifiedName)
+    IMPLEMENT_VARIANT_TOXXXARRAY_METHOD_NATIVE_UAF(ExtensionObject)
 
 
 
@@ -211,8 +445,8 @@ namespace uaf
     =========================================================================================== */ \
     void Variant::set##XXX(CPPTYPE val)                                                            \
     {                                                                                              \
-        clear();                                                                                   \
-        uaVariant_.set##XXX(val);                                                                  \
+        setInline(uaf::opcuatypes::XXX);                                                           \
+        scalar_.XXX = val;                                                                         \
     }
 
     IMPLEMENT_VARIANT_SETXXX_METHOD(SByte  , int8_t)
@@ -231,26 +465,22 @@ namespace uaf
     // ===========================================================================================
     void Variant::setByteArray(const std::vector<uint8_t>& vec)
     {
-        clear();
         UaByteArray arr;
         arr.resize(vec.size());
         for (std::size_t i = 0; i < vec.size(); i++) { arr[int(i)] = vec[i]; }
-        uaVariant_.setByteArray(arr);
+        sdkVariant().setByteArray(arr);
     }
 
     // Set the variant to a variant array.
     // ===========================================================================================
     void Variant::setVariantArray(const std::vector<uaf::Variant>& vec)
     {
-        clear();
         UaVariantArray arr;
         arr.resize(vec.size());
         for (std::size_t i = 0; i < vec.size(); i++) {
-            UaVariant v;
-            vec[i].toSdk(v);
-            v.copyTo(&arr[int(i)]);
+            vec[i].toSdk(&arr[int(i)]);
         }
-        uaVariant_.setVariantArray(arr);
+        sdkVariant().setVariantArray(arr);
     }
 
 
@@ -259,11 +489,10 @@ namespace uaf
     =========================================================================================== */ \
     void Variant::set##XXX##Array(const std::vector<CPPTYPE>& vec)                                 \
     {                                                                                              \
-        clear();                                                                                   \
         Ua##XXX##Array arr;                                                                        \
         arr.create(vec.size());                                                                    \
         for (std::size_t i = 0; i < vec.size(); i++) { arr[i] = vec[i]; }                          \
-        uaVariant_.set##XXX##Array(arr);                                                           \
+        sdkVariant().set##XXX##Array(arr);                                                         \
     }
 
     IMPLEMENT_VARIANT_SETXXXARRAY_METHOD(SByte  , int8_t)
@@ -281,8 +510,15 @@ namespace uaf
     // =============================================================================================
     Status Variant::toBoolean(bool &val) const
     {
+        if (storage_ == InlineStorage && type_ == opcuatypes::Boolean)
+        {
+            val = (scalar_.Boolean != OpcUa_False);
+            return uaf::statuscodes::Good;
+        }
+        UaVariant temporary;
+        const UaVariant& uaVariant = asSdk(temporary);
         OpcUa_Boolean opcUaVal;
-        Status ret = evaluate(uaVariant_.toBool(opcUaVal), uaVariant_.type(), OpcUaType_Boolean);
+        Status ret = evaluate(uaVariant.toBool(opcUaVal), uaVariant.type(), OpcUaType_Boolean);
         val = (bool)(opcUaVal);
         return ret;
     }
@@ -291,8 +527,10 @@ namespace uaf
     // =============================================================================================
     Status Variant::toBooleanArray(std::vector<bool>& vec) const
     {
+        UaVariant temporary;
+        const UaVariant& uaVariant = asSdk(temporary);
         UaBoolArray arr;
-        uaf::Status ret = evaluate(uaVariant_.toBoolArray(arr), uaVariant_.type(), OpcUaType_Boolean);
+        uaf::Status ret = evaluate(uaVariant.toBoolArray(arr), uaVariant.type(), OpcUaType_Boolean);
         vec.resize(arr.length());
         for (std::size_t i = 0; i < arr.length(); i++)
             vec[i] = arr[i];
@@ -303,19 +541,18 @@ namespace uaf
     // =============================================================================================
     void Variant::setBoolean(bool val)
     {
-        clear();
-        uaVariant_.setBool(val ? OpcUa_True : OpcUa_False);
+        setInline(opcuatypes::Boolean);
+        scalar_.Boolean = (val ? OpcUa_True : OpcUa_False);
     }
 
     // Set the variant to a boolean array.
     // =============================================================================================
     void Variant::setBooleanArray(const std::vector<bool>& vec)
     {
-        clear();
         UaBoolArray arr;
         arr.create(vec.size());
         for (std::size_t i = 0; i < vec.size(); i++) { arr[i] = vec[i]; }
-        uaVariant_.setBoolArray(arr);
+        sdkVariant().setBoolArray(arr);
     }
 
 
@@ -324,15 +561,18 @@ namespace uaf
     // =============================================================================================
     Status Variant::toString(string &val) const
     {
-        if (uaVariant_.isEmpty())
+        UaVariant temporary;
+        const UaVariant& uaVariant = asSdk(temporary);
+
+        if (uaVariant.isEmpty())
             val = string();
         else
         {
-            UaString uaString(uaVariant_.toString());
+            UaString uaString(uaVariant.toString());
             if (uaString.isEmpty() || uaString.isNull())
                 val = string();
             else
-                val = uaVariant_.toString().toUtf8();
+                val = uaString.toUtf8();
         }
 
 
@@ -344,8 +584,10 @@ namespace uaf
     // =============================================================================================
     Status Variant::toStringArray(std::vector<std::string>& vec) const
     {
+        UaVariant temporary;
+        const UaVariant& uaVariant = asSdk(temporary);
         UaStringArray arr;
-        Status ret = evaluate(uaVariant_.toStringArray(arr), uaVariant_.type(), OpcUaType_String);
+        Status ret = evaluate(uaVariant.toStringArray(arr), uaVariant.type(), OpcUaType_String);
         vec.resize(arr.length());
         for (std::size_t i = 0; i < arr.length(); i++)
         {
@@ -364,8 +606,7 @@ namespace uaf
     // =============================================================================================
     void Variant::setString(const std::string& val)
     {
-        clear();
-        uaVariant_.setString(UaString(val.c_str()));
+        sdkVariant().setString(UaString(val.c_str()));
     }
 
 
@@ -373,11 +614,10 @@ namespace uaf
     // =============================================================================================
     void Variant::setStringArray(const std::vector<std::string>& vec)
     {
-        clear();
         UaStringArray arr;
         arr.create(vec.size());
         for (std::size_t i = 0; i < vec.size(); i++) { UaString(vec[i].c_str()).copyTo(&arr[i]); }
-        uaVariant_.setStringArray(arr);
+        sdkVariant().setStringArray(arr);
     }
 
 
@@ -386,8 +626,10 @@ namespace uaf
     =========================================================================================== */ \
     Status Variant::to##XXX(uaf::XXX& val) const                                                   \
     {                                                                                              \
+        UaVariant temporary;                                                                       \
+        const UaVariant& uaVariant = asSdk(temporary);                                             \
         Ua##XXX ua##XXX;                                                                           \
-        Status ret = evaluate(uaVariant_.to##XXX(ua##XXX), uaVariant_.type(), OpcUaType_##XXX);    \
+        Status ret = evaluate(uaVariant.to##XXX(ua##XXX), uaVariant.type(), OpcUaType_##XXX);      \
         val.fromSdk(ua##XXX);                                                                      \
         return ret;                                                                                \
     }
@@ -395,7 +637,24 @@ namespace uaf
 
     IMPLEMENT_VARIANT_TOXXX_METHOD_COMPLEX(ByteString)
     IMPLEMENT_VARIANT_TOXXX_METHOD_COMPLEX(LocalizedText)
-    IMPLEMENT_VARIANT_TOXXX_METHOD_COMPLEX(DateTime)
+
+
+    // Convert the variant to a DateTime.
+    // =============================================================================================
+    Status Variant::toDateTime(uaf::DateTime& val) const
+    {
+        if (storage_ == InlineStorage && type_ == opcuatypes::DateTime)
+        {
+            val.fromSdk(UaDateTime(scalar_.DateTime));
+            return uaf::statuscodes::Good;
+        }
+        UaVariant temporary;
+        const UaVariant& uaVariant = asSdk(temporary);
+        UaDateTime uaDateTime;
+        Status ret = evaluate(uaVariant.toDateTime(uaDateTime), uaVariant.type(), OpcUaType_DateTime);
+        val.fromSdk(uaDateTime);
+        return ret;
+    }
 
 
 #define IMPLEMENT_VARIANT_TOXXXARRAY_METHOD_COMPLEX(XXX)                                           \
@@ -403,8 +662,10 @@ namespace uaf
     =========================================================================================== */ \
     Status Variant::to##XXX##Array(std::vector<uaf::XXX>& vec) const                               \
     {                                                                                              \
+        UaVariant temporary;                                                                       \
+        const UaVariant& uaVariant = asSdk(temporary);                                             \
         Ua##XXX##Array arr;                                                                        \
-        Status ret = evaluate(uaVariant_.to##XXX##Array(arr), uaVariant_.type(), OpcUaType_##XXX); \
+        Status ret = evaluate(uaVariant.to##XXX##Array(arr), uaVariant.type(), OpcUaType_##XXX);   \
         vec.resize(arr.length());                                                                  \
         for (std::size_t i = 0; i < arr.length(); i++)                                             \
             vec[i].fromSdk(Ua##XXX(arr[i]));                                                       \
@@ -416,15 +677,23 @@ namespace uaf
     IMPLEMENT_VARIANT_TOXXXARRAY_METHOD_COMPLEX(DateTime)
 
 
+    // Set the variant to a bytestring.
+    // =============================================================================================
+    void Variant::setByteString(uint8_t* data, int32_t length)
+    {
+        UaByteString byteString(length, data);
+        sdkVariant().setByteString(byteString, OpcUa_True);
+    }
+
+
 #define IMPLEMENT_VARIANT_SETXXX_METHOD_COMPLEX_WITH_DETACH(XXX)                                   \
     /** Convert the variant to a complex native C++ type.                                          \
     =========================================================================================== */ \
     void Variant::set##XXX(const uaf::XXX& val)                                                    \
     {                                                                                              \
-        clear();                                                                                   \
         Ua##XXX uaObject;                                                                          \
         val.toSdk(uaObject);                                                                       \
-        uaVariant_.set##XXX(uaObject, OpcUa_True);                                                 \
+        sdkVariant().set##XXX(uaObject, OpcUa_True);                                               \
     }
     IMPLEMENT_VARIANT_SETXXX_METHOD_COMPLEX_WITH_DETACH(ByteString)
 
@@ -434,64 +703,63 @@ namespace uaf
     =========================================================================================== */ \
     void Variant::set##XXX(const uaf::XXX& val)                                                    \
     {                                                                                              \
-        clear();                                                                                   \
         Ua##XXX uaObject;                                                                          \
         val.toSdk(uaObject);                                                                       \
-        uaVariant_.set##XXX(uaObject);                                                             \
+        sdkVariant().set##XXX(uaObject);                                                           \
     }
     IMPLEMENT_VARIANT_SETXXX_METHOD_COMPLEX(LocalizedText)
-    IMPLEMENT_VARIANT_SETXXX_METHOD_COMPLEX(DateTime)
+
+
+    // Set the variant to a DateTime.
+    // =============================================================================================
+    void Variant::setDateTime(const uaf::DateTime& val)
+    {
+        setInline(opcuatypes::DateTime);
+        val.toSdk(&scalar_.DateTime);
+    }
 
 
 #define IMPLEMENT_VARIANT_SETXXXARRAY_METHOD_COMPLEX(XXX)                                          \
     /** Convert the variant to a complex native C++ type.                                          \
     =========================================================================================== */ \
-    void Variant::set##XXX##Array(const std::vector<uaf::XXX>& vec)                                         \
+    void Variant::set##XXX##Array(const std::vector<uaf::XXX>& vec)                                \
     {                                                                                              \
-        clear();                                                                                   \
         Ua##XXX##Array arr;                                                                        \
         arr.create(vec.size());                                                                    \
         for (std::size_t i = 0; i < vec.size(); i++) { vec[i].toSdk(&arr[i]); }                    \
-        uaVariant_.set##XXX##Array(arr);                                                           \
+        sdkVariant().set##XXX##Array(arr);                                                         \
     }
     IMPLEMENT_VARIANT_SETXXXARRAY_METHOD_COMPLEX(ByteString)
     IMPLEMENT_VARIANT_SETXXXARRAY_METHOD_COMPLEX(LocalizedText)
     IMPLEMENT_VARIANT_SETXXXARRAY_METHOD_COMPLEX(DateTime)
 
 
-#define IMPLEMENT_VARIANT_SETXXX_METHOD_NATIVE_UAF(XXX, INTERNAL)                                  \
+#define IMPLEMENT_VARIANT_SETXXX_METHOD_NATIVE_UAF(XXX)                                            \
     /** Convert the variant to a native uaf:: C++ type.                                            \
     =========================================================================================== */ \
     void Variant::set##XXX(const uaf::XXX& val)                                                    \
     {                                                                                              \
-        clear();                                                                                   \
-        isNativeUaf_ = true;                                                                       \
-        dataTypeIfNativeUaf_  = uaf::opcuatypes::XXX;                                              \
-        INTERNAL.push_back(val);                                                                   \
+        nativeValues<uaf::XXX>(uaf::opcuatypes::XXX, OpcUa_VariantArrayType_Scalar).push_back(val);\
     }
-    IMPLEMENT_VARIANT_SETXXX_METHOD_NATIVE_UAF(QualifiedName, qualifiedName_)
-    IMPLEMENT_VARIANT_SETXXX_METHOD_NATIVE_UAF(NodeId, nodeId_)
-    IMPLEMENT_VARIANT_SETXXX_METHOD_NATIVE_UAF(Guid, guid_)
-    IMPLEMENT_VARIANT_SETXXX_METHOD_NATIVE_UAF(ExpandedNodeId, expandedNodeId_)
-    IMPLEMENT_VARIANT_SETXXX_METHOD_NATIVE_UAF(ExtensionObject, extensionObject_)
+    IMPLEMENT_VARIANT_SETXXX_METHOD_NATIVE_UAF(QualifiedName)
+    IMPLEMENT_VARIANT_SETXXX_METHOD_NATIVE_UAF(NodeId)
+    IMPLEMENT_VARIANT_SETXXX_METHOD_NATIVE_UAF(Guid)
+    IMPLEMENT_VARIANT_SETXXX_METHOD_NATIVE_UAF(ExpandedNodeId)
+    IMPLEMENT_VARIANT_SETXXX_METHOD_NATIVE_UAF(ExtensionObject)
 
 
-#define IMPLEMENT_VARIANT_SETXXXARRAY_METHOD_NATIVE_UAF(XXX, INTERNAL)                             \
+#define IMPLEMENT_VARIANT_SETXXXARRAY_METHOD_NATIVE_UAF(XXX)                                       \
     /** Convert the variant to a native uaf:: C++ type.                                            \
     =========================================================================================== */ \
     void Variant::set##XXX##Array(const std::vector<uaf::XXX>& vec)                                \
     {                                                                                              \
-        clear();                                                                                   \
-        isNativeUaf_ = true;                                                                       \
-        dataTypeIfNativeUaf_  = uaf::opcuatypes::XXX;                                              \
-        arrayTypeIfNativeUaf_ = OpcUa_VariantArrayType_Array;                                      \
-        INTERNAL = vec;                                                                            \
+        nativeValues<uaf::XXX>(uaf::opcuatypes::XXX, OpcUa_VariantArrayType_Array) = vec;          \
     }
-    IMPLEMENT_VARIANT_SETXXXARRAY_METHOD_NATIVE_UAF(QualifiedName, qualifiedName_)
-    IMPLEMENT_VARIANT_SETXXXARRAY_METHOD_NATIVE_UAF(NodeId, nodeId_)
-    IMPLEMENT_VARIANT_SETXXXARRAY_METHOD_NATIVE_UAF(Guid, guid_)
-    IMPLEMENT_VARIANT_SETXXXARRAY_METHOD_NATIVE_UAF(ExpandedNodeId, expandedNodeId_)
-    IMPLEMENT_VARIANT_SETXXXARRAY_METHOD_NATIVE_UAF(ExtensionObject, extensionObject_)
+    IMPLEMENT_VARIANT_SETXXXARRAY_METHOD_NATIVE_UAF(QualifiedName)
+    IMPLEMENT_VARIANT_SETXXXARRAY_METHOD_NATIVE_UAF(NodeId)
+    IMPLEMENT_VARIANT_SETXXXARRAY_METHOD_NATIVE_UAF(Guid)
+    IMPLEMENT_VARIANT_SETXXXARRAY_METHOD_NATIVE_UAF(ExpandedNodeId)
+    IMPLEMENT_VARIANT_SETXXXARRAY_METHOD_NATIVE_UAF(ExtensionObject)
 
 
     // Get a string representation
@@ -515,75 +783,59 @@ namespace uaf
         }
         else
         {
-            if (isNativeUaf_)
+            if (storage_ == NativeStorage)
             {
+                uint32_t first = 0;
+                uint32_t last  = 1;
+
                 if (isArray())
                 {
                     ss << "{";
-
-                    for (uint32_t i = 0; i < arraySize(); i++)
-                    {
-                        if (i > 0) ss << ",";
-
-                        switch (t)
-                        {
-                            case uaf::opcuatypes::NodeId:
-                                ss << nodeId_[i].toString();
-                                break;
-                            case uaf::opcuatypes::Guid:
-                                ss << guid_[i].toString();
-                                break;
-                            case uaf::opcuatypes::ExpandedNodeId:
-                                ss << expandedNodeId_[i].toString();
-                                break;
-                            case uaf::opcuatypes::QualifiedName:
-                                ss << qualifiedName_[i].toString();
-                                break;
-                            case uaf::opcuatypes::ExtensionObject:
-                                ss << '\n' << extensionObject_[i].toString(indent, colon);
-                                break;
-                            default:
-                                ss << "INVALID";
-                                break;
-                        }
-                    }
-
-                    ss << "}";
+                    last = arraySize();
                 }
-                else
+
+                for (uint32_t i = first; i < last; i++)
                 {
+                    if (i > 0) ss << ",";
+
                     switch (t)
                     {
                         case uaf::opcuatypes::NodeId:
-                            ss << nodeId_[0].toString();
+                            ss << nativeValues<uaf::NodeId>()[i].toString();
                             break;
                         case uaf::opcuatypes::Guid:
-                            ss << guid_[0].toString();
+                            ss << nativeValues<uaf::Guid>()[i].toString();
                             break;
                         case uaf::opcuatypes::ExpandedNodeId:
-                            ss << expandedNodeId_[0].toString();
+                            ss << nativeValues<uaf::ExpandedNodeId>()[i].toString();
                             break;
                         case uaf::opcuatypes::QualifiedName:
-                            ss << qualifiedName_[0].toString();
+                            ss << nativeValues<uaf::QualifiedName>()[i].toString();
                             break;
                         case uaf::opcuatypes::ExtensionObject:
-                            ss << '\n' << extensionObject_[0].toString(indent, colon);
+                            ss << '\n' << nativeValues<uaf::ExtensionObject>()[i].toString(indent, colon);
                             break;
                         default:
                             ss << "INVALID";
                             break;
                     }
                 }
+
+                if (isArray())
+                    ss << "}";
             }
             else
             {
-                if (uaVariant_.isEmpty())
+                UaVariant temporary;
+                const UaVariant& uaVariant = asSdk(temporary);
+
+                if (uaVariant.isEmpty())
                 {
                     ss << "";
                 }
                 else
                 {
-                    UaString uaString(uaVariant_.toString());
+                    UaString uaString(uaVariant.toString());
                     if (uaString.isNull())
                         ss << "NULL";
                     else if (uaString.isEmpty())
@@ -600,89 +852,200 @@ namespace uaf
 
 
 
-#define IMPLEMENT_VARIANT_TOSDK_NATIVE_UAF(TYPE, INTERNAL)                                         \
+#define IMPLEMENT_VARIANT_TOSDK_NATIVE_UAF(TYPE)                                                   \
     if (isArray())                                                                                 \
     {                                                                                              \
+        const std::vector<uaf::TYPE>& values = nativeValues<uaf::TYPE>();                          \
         Ua##TYPE##Array array;                                                                     \
-        array.resize(INTERNAL.size());                                                             \
-        for (std::size_t i = 0; i<INTERNAL.size(); i++)                                            \
-            INTERNAL[i].toSdk(&array[i]);                                                          \
+        array.resize(values.size());                                                               \
+        for (std::size_t i = 0; i<values.size(); i++)                                              \
+            values[i].toSdk(&array[i]);                                                            \
         uaVariant.set##TYPE##Array(array);                                                         \
     }                                                                                              \
     else                                                                                           \
     {                                                                                              \
         Ua##TYPE uaObject;                                                                         \
-        INTERNAL[0].toSdk(uaObject);                                                               \
+        nativeValues<uaf::TYPE>()[0].toSdk(uaObject);                                              \
         uaVariant.set##TYPE(uaObject);                                                             \
     }
 
-#define IMPLEMENT_VARIANT_TOSDK_NATIVE_UAF_WITH_DETACH(TYPE, INTERNAL)                             \
+#define IMPLEMENT_VARIANT_TOSDK_NATIVE_UAF_WITH_DETACH(TYPE)                                       \
     if (isArray())                                                                                 \
     {                                                                                              \
+        const std::vector<uaf::TYPE>& values = nativeValues<uaf::TYPE>();                          \
         Ua##TYPE##Array array;                                                                     \
-        array.resize(INTERNAL.size());                                                             \
-        for (std::size_t i = 0; i<INTERNAL.size(); i++)                                            \
-            INTERNAL[i].toSdk(&array[i]);                                                          \
+        array.resize(values.size());                                                               \
+        for (std::size_t i = 0; i<values.size(); i++)                                              \
+            values[i].toSdk(&array[i]);                                                            \
         uaVariant.set##TYPE##Array(array);                                                         \
     }                                                                                              \
     else                                                                                           \
     {                                                                                              \
         Ua##TYPE uaObject;                                                                         \
-        INTERNAL[0].toSdk(uaObject);                                                               \
+        nativeValues<uaf::TYPE>()[0].toSdk(uaObject);                                              \
         uaVariant.set##TYPE(uaObject, OpcUa_False);                                                \
     }
 
 
+#define IMPLEMENT_VARIANT_INLINE_CASE(XXX, STATEMENT)                                              \
+    case uaf::opcuatypes::XXX:                                                                     \
+        STATEMENT;                                                                                 \
+        break;
+
+// switch over the inline types, except for DateTime (which is a struct and must be handled apart)
+#define IMPLEMENT_VARIANT_INLINE_SWITCH(TYPE, STATEMENT_MACRO)                                     \
+    switch (TYPE)                                                                                  \
+    {                                                                                              \
+        IMPLEMENT_VARIANT_INLINE_CASE(Boolean  , STATEMENT_MACRO(Boolean))                         \
+        IMPLEMENT_VARIANT_INLINE_CASE(SByte    , STATEMENT_MACRO(SByte))                           \
+        IMPLEMENT_VARIANT_INLINE_CASE(Byte     , STATEMENT_MACRO(Byte))                            \
+        IMPLEMENT_VARIANT_INLINE_CASE(Int16    , STATEMENT_MACRO(Int16))                           \
+        IMPLEMENT_VARIANT_INLINE_CASE(UInt16   , STATEMENT_MACRO(UInt16))                          \
+        IMPLEMENT_VARIANT_INLINE_CASE(Int32    , STATEMENT_MACRO(Int32))                           \
+        IMPLEMENT_VARIANT_INLINE_CASE(UInt32   , STATEMENT_MACRO(UInt32))                          \
+        IMPLEMENT_VARIANT_INLINE_CASE(Int64    , STATEMENT_MACRO(Int64))                           \
+        IMPLEMENT_VARIANT_INLINE_CASE(UInt64   , STATEMENT_MACRO(UInt64))                          \
+        IMPLEMENT_VARIANT_INLINE_CASE(Float    , STATEMENT_MACRO(Float))                           \
+        IMPLEMENT_VARIANT_INLINE_CASE(Double   , STATEMENT_MACRO(Double))                          \
+        default:                                                                                   \
+            break;                                                                                 \
+    }
+
 
     // toSdk
     // =============================================================================================
     void Variant::toSdk(OpcUa_Variant* destination) const
     {
-        if (isNativeUaf_)
+        if (storage_ == InlineStorage)
+        {
+            // fill the stack object directly, without any intermediate SDK object
+            OpcUa_Variant_Initialize(destination);
+            destination->Datatype  = opcuatypes::fromUafToSdk(type_);
+            destination->ArrayType = OpcUa_VariantArrayType_Scalar;
+            if (type_ == uaf::opcuatypes::DateTime)
+                destination->Value.DateTime = scalar_.DateTime;
+#define UAF_VARIANT_COPY_TO_STACK(XXX) destination->Value.XXX = scalar_.XXX
+            IMPLEMENT_VARIANT_INLINE_SWITCH(type_, UAF_VARIANT_COPY_TO_STACK)
+#undef UAF_VARIANT_COPY_TO_STACK
+        }
+        else if (storage_ == SdkStorage)
+        {
+            static_cast<const SdkPayload*>(payload_)->uaVariant.copyTo(destination);
+        }
+        else
         {
             UaVariant uaVariant;
-            if (type() == uaf::opcuatypes::NodeId)
-            {
-                IMPLEMENT_VARIANT_TOSDK_NATIVE_UAF(NodeId, nodeId_)
-            }
-            else if (type() == uaf::opcuatypes::Guid)
+            toSdk(uaVariant);
+            uaVariant.copyTo(destination);
+        }
+    }
+
+
+    // toSdk
+    // =============================================================================================
+    void Variant::toSdk(UaVariant& uaVariant) const
+    {
+        switch (storage_)
+        {
+            case InlineStorage:
             {
-                IMPLEMENT_VARIANT_TOSDK_NATIVE_UAF(Guid, guid_)
+                switch (type_)
+                {
+                    case uaf::opcuatypes::Boolean:  uaVariant.setBool(scalar_.Boolean);     break;
+                    case uaf::opcuatypes::SByte:    uaVariant.setSByte(scalar_.SByte);      break;
+                    case uaf::opcuatypes::Byte:     uaVariant.setByte(scalar_.Byte);        break;
+                    case uaf::opcuatypes::Int16:    uaVariant.setInt16(scalar_.Int16);      break;
+                    case uaf::opcuatypes::UInt16:   uaVariant.setUInt16(scalar_.UInt16);    break;
+                    case uaf::opcuatypes::Int32:    uaVariant.setInt32(scalar_.Int32);      break;
+                    case uaf::opcuatypes::UInt32:   uaVariant.setUInt32(scalar_.UInt32);    break;
+                    case uaf::opcuatypes::Int64:    uaVariant.setInt64(scalar_.Int64);      break;
+                    case uaf::opcuatypes::UInt64:   uaVariant.setUInt64(scalar_.UInt64);    break;
+                    case uaf::opcuatypes::Float:    uaVariant.setFloat(scalar_.Float);      break;
+                    case uaf::opcuatypes::Double:   uaVariant.setDouble(scalar_.Double);    break;
+                    case uaf::opcuatypes::DateTime:
+                        uaVariant.setDateTime(UaDateTime(scalar_.DateTime));
+                        break;
+                    default:
+                        uaVariant.clear();
+                        break;
+                }
+                break;
             }
-            else if (type() == uaf::opcuatypes::ExpandedNodeId)
+            case SdkStorage:
             {
-                IMPLEMENT_VARIANT_TOSDK_NATIVE_UAF(ExpandedNodeId, expandedNodeId_)
+                uaVariant = static_cast<const SdkPayload*>(payload_)->uaVariant;
+                break;
             }
-            else if (type() == uaf::opcuatypes::QualifiedName)
+            case NativeStorage:
             {
-                IMPLEMENT_VARIANT_TOSDK_NATIVE_UAF(QualifiedName, qualifiedName_)
+                uaVariant.clear();
+                if (type_ == uaf::opcuatypes::NodeId)
+                {
+                    IMPLEMENT_VARIANT_TOSDK_NATIVE_UAF(NodeId)
+                }
+                else if (type_ == uaf::opcuatypes::Guid)
+                {
+                    IMPLEMENT_VARIANT_TOSDK_NATIVE_UAF(Guid)
+                }
+                else if (type_ == uaf::opcuatypes::ExpandedNodeId)
+                {
+                    IMPLEMENT_VARIANT_TOSDK_NATIVE_UAF(ExpandedNodeId)
+                }
+                else if (type_ == uaf::opcuatypes::QualifiedName)
+                {
+                    IMPLEMENT_VARIANT_TOSDK_NATIVE_UAF(QualifiedName)
+                }
+                else if (type_ == uaf::opcuatypes::ExtensionObject)
+                {
+                    IMPLEMENT_VARIANT_TOSDK_NATIVE_UAF_WITH_DETACH(ExtensionObject)
+                }
+                break;
             }
-            else if (type() == uaf::opcuatypes::ExtensionObject)
+            default:
             {
-                IMPLEMENT_VARIANT_TOSDK_NATIVE_UAF_WITH_DETACH(ExtensionObject, extensionObject_)
+                uaVariant.clear();
+                break;
             }
-            uaVariant.copyTo(destination);
-        }
-        else
-        {
-            uaVariant_.copyTo(destination);
         }
     }
 
 
-    // toSdk
+    // fromSdk
     // =============================================================================================
-    void Variant::toSdk(UaVariant& uaVariant) const
+    void Variant::fromSdk(const UaVariant& uaVariant)
     {
-    	uaVariant = uaVariant_;
+        fromSdk(*(const OpcUa_Variant*)uaVariant);
     }
 
 
-    // fromSdk
+    // Update the variant from a stack object
     // =============================================================================================
-    void Variant::fromSdk(const UaVariant& uaVariant)
+    void Variant::fromSdk(const OpcUa_Variant& variant)
     {
-    	uaVariant_ = uaVariant;
+        // scalar numbers, booleans and DateTimes are stored inline, other values by an UaVariant
+        if (variant.ArrayType == OpcUa_VariantArrayType_Scalar)
+        {
+            if (variant.Datatype == OpcUaType_Null)
+            {
+                clear();
+                return;
+            }
+
+            opcuatypes::OpcUaType t = opcuatypes::fromSdkToUaf((OpcUa_BuiltInType)variant.Datatype);
+
+            if (t == uaf::opcuatypes::DateTime)
+            {
+                setInline(t);
+                scalar_.DateTime = variant.Value.DateTime;
+                return;
+            }
+
+#define UAF_VARIANT_COPY_FROM_STACK(XXX) setInline(t); scalar_.XXX = variant.Value.XXX; return
+            IMPLEMENT_VARIANT_INLINE_SWITCH(t, UAF_VARIANT_COPY_FROM_STACK)
+#undef UAF_VARIANT_COPY_FROM_STACK
+        }
+
+        sdkVariant() = variant;
     }
 
 
@@ -756,30 +1119,15 @@ namespace uaf
     }
 
 
-    // Clear the Variant
-    // =============================================================================================
-    void Variant::clear()
-    {
-        uaVariant_.clear();
-        nodeId_.clear();
-        guid_.clear();
-        expandedNodeId_.clear();
-        qualifiedName_.clear();
-        extensionObject_.clear();
-        isNativeUaf_ = false;
-        dataTypeIfNativeUaf_ = opcuatypes::Null;
-        arrayTypeIfNativeUaf_ = OpcUa_VariantArrayType_Scalar;
-    }
-
-
     // Get the data type
     // =============================================================================================
     opcuatypes::OpcUaType Variant::type() const
     {
-        if (isNativeUaf_)
-            return dataTypeIfNativeUaf_;
+        if (storage_ == SdkStorage)
+            return uaf::opcuatypes::fromSdkToUaf(
+                    static_cast<const SdkPayload*>(payload_)->uaVariant.type());
         else
-            return uaf::opcuatypes::fromSdkToUaf(uaVariant_.type());
+            return type_;
     }
 
 
@@ -787,46 +1135,49 @@ namespace uaf
     // =============================================================================================
     bool Variant::isArray() const
     {
-        if (isNativeUaf_)
-            return arrayTypeIfNativeUaf_ == OpcUa_VariantArrayType_Array;
+        if (storage_ == SdkStorage)
+            return (bool)(static_cast<const SdkPayload*>(payload_)->uaVariant.isArray());
         else
-            return (bool)(uaVariant_.isArray());
+            return arrayType_ == OpcUa_VariantArrayType_Array;
     }
 
     // Does the variant represent a matrix?
     // =============================================================================================
     bool Variant::isMatrix() const
     {
-        if (isNativeUaf_)
-            return arrayTypeIfNativeUaf_ == OpcUa_VariantArrayType_Matrix;
+        if (storage_ == SdkStorage)
+            return (bool)(static_cast<const SdkPayload*>(payload_)->uaVariant.isMatrix());
         else
-            return (bool)(uaVariant_.isMatrix());
+            return arrayType_ == OpcUa_VariantArrayType_Matrix;
     }
 
     // Size of the array in case isArra() is True
     // =============================================================================================
     uint32_t Variant::arraySize() const
     {
-        if (isNativeUaf_)
+        if (storage_ == NativeStorage)
         {
-            switch (type())
+            switch (type_)
             {
                 case uaf::opcuatypes::NodeId:
-                    return nodeId_.size();
+                    return nativeValues<uaf::NodeId>().size();
                 case uaf::opcuatypes::Guid:
-                    return guid_.size();
+                    return nativeValues<uaf::Guid>().size();
                 case uaf::opcuatypes::ExpandedNodeId:
-                    return expandedNodeId_.size();
+                    return nativeValues<uaf::ExpandedNodeId>().size();
                 case uaf::opcuatypes::QualifiedName:
-                    return qualifiedName_.size();
+                    return nativeValues<uaf::QualifiedName>().size();
                 case uaf::opcuatypes::ExtensionObject:
-                    return extensionObject_.size();
+                    return nativeValues<uaf::ExtensionObject>().size();
                 default:
                     return -1;
             }
         }
         else
-            return uaVariant_.arraySize();
+        {
+            UaVariant temporary;
+            return asSdk(temporary).arraySize();
+        }
     }
 
 
@@ -834,22 +1185,58 @@ namespace uaf
     // =============================================================================================
     bool operator==(const Variant& object1, const Variant& object2)
     {
-        // first we test the most likely situation
-        if ( (!object1.isNativeUaf_) && (!object2.isNativeUaf_) )
-        {
-            return object1.uaVariant_ == object2.uaVariant_;
-        }
-        // else, test the whole lot
-        else
+        if (object1.storage_ != object2.storage_)
+            return false;
+
+        switch (object1.storage_)
         {
-            return    object1.uaVariant_ == object2.uaVariant_
-                   && object1.isNativeUaf_ == object2.isNativeUaf_
-                   && object1.arrayTypeIfNativeUaf_ == object2.arrayTypeIfNativeUaf_
-                   && object1.dataTypeIfNativeUaf_ == object2.dataTypeIfNativeUaf_
-                   && object1.expandedNodeId_ == object2.expandedNodeId_
-                   && object1.nodeId_ == object2.nodeId_
-                   && object1.guid_ == object2.guid_
-                   && object1.qualifiedName_ == object2.qualifiedName_;
+            case Variant::InlineStorage:
+            {
+                if (object1.type_ != object2.type_)
+                    return false;
+
+                if (object1.type_ == opcuatypes::DateTime)
+                    return    object1.scalar_.DateTime.dwLowDateTime
+                                == object2.scalar_.DateTime.dwLowDateTime
+                           && object1.scalar_.DateTime.dwHighDateTime
+                                == object2.scalar_.DateTime.dwHighDateTime;
+
+#define UAF_VARIANT_COMPARE_EQUAL(XXX) return object1.scalar_.XXX == object2.scalar_.XXX
+                IMPLEMENT_VARIANT_INLINE_SWITCH(object1.type_, UAF_VARIANT_COMPARE_EQUAL)
+#undef UAF_VARIANT_COMPARE_EQUAL
+                return false;
+            }
+            case Variant::SdkStorage:
+            {
+                return    static_cast<const Variant::SdkPayload*>(object1.payload_)->uaVariant
+                       == static_cast<const Variant::SdkPayload*>(object2.payload_)->uaVariant;
+            }
+            case Variant::NativeStorage:
+            {
+                if (object1.type_ != object2.type_ || object1.arrayType_ != object2.arrayType_)
+                    return false;
+
+                switch (object1.type_)
+                {
+                    case opcuatypes::NodeId:
+                        return    object1.nativeValues<NodeId>()
+                               == object2.nativeValues<NodeId>();
+                    case opcuatypes::Guid:
+                        return    object1.nativeValues<Guid>()
+                               == object2.nativeValues<Guid>();
+                    case opcuatypes::ExpandedNodeId:
+                        return    object1.nativeValues<ExpandedNodeId>()
+                               == object2.nativeValues<ExpandedNodeId>();
+                    case opcuatypes::QualifiedName:
+                        return    object1.nativeValues<QualifiedName>()
+                               == object2.nativeValues<QualifiedName>();
+                    default:
+                        // ExtensionObjects cannot be compared
+                        return true;
+                }
+            }
+            default:
+                return true;
         }
     }
 
@@ -861,26 +1248,69 @@ namespace uaf
         return !(object1 == object2);
     }
 
-    // operator==
+    // operator<
     // =============================================================================================
     bool operator<(const Variant& object1, const Variant& object2)
     {
-        if (object1.uaVariant_ != object2.uaVariant_)
-            return object1.uaVariant_ < object2.uaVariant_;
-        else if (object1.isNativeUaf_ != object2.isNativeUaf_)
-            return object1.isNativeUaf_ < object2.isNativeUaf_;
-        else if (object1.arrayTypeIfNativeUaf_ != object2.arrayTypeIfNativeUaf_)
-            return object1.arrayTypeIfNativeUaf_ < object2.arrayTypeIfNativeUaf_;
-        else if (object1.dataTypeIfNativeUaf_ != object2.dataTypeIfNativeUaf_)
-            return object1.dataTypeIfNativeUaf_ < object2.dataTypeIfNativeUaf_;
-        else if (object1.expandedNodeId_ != object2.expandedNodeId_)
-            return object1.expandedNodeId_ < object2.expandedNodeId_;
-        else if (object1.nodeId_ != object2.nodeId_)
-            return object1.nodeId_ < object2.nodeId_;
-        else if (object1.guid_ != object2.guid_)
-            return object1.guid_ < object2.guid_;
-        else
-            return object1.qualifiedName_ < object2.qualifiedName_;
+        if (object1.storage_ != object2.storage_)
+            return object1.storage_ < object2.storage_;
+
+        switch (object1.storage_)
+        {
+            case Variant::InlineStorage:
+            {
+                if (object1.type_ != object2.type_)
+                    return object1.type_ < object2.type_;
+
+                if (object1.type_ == opcuatypes::DateTime)
+                {
+                    const OpcUa_DateTime& dt1 = object1.scalar_.DateTime;
+                    const OpcUa_DateTime& dt2 = object2.scalar_.DateTime;
+                    if (dt1.dwHighDateTime != dt2.dwHighDateTime)
+                        return dt1.dwHighDateTime < dt2.dwHighDateTime;
+                    else
+                        return dt1.dwLowDateTime < dt2.dwLowDateTime;
+                }
+
+#define UAF_VARIANT_COMPARE_LESS(XXX) return object1.scalar_.XXX < object2.scalar_.XXX
+                IMPLEMENT_VARIANT_INLINE_SWITCH(object1.type_, UAF_VARIANT_COMPARE_LESS)
+#undef UAF_VARIANT_COMPARE_LESS
+                return false;
+            }
+            case Variant::SdkStorage:
+            {
+                return    static_cast<const Variant::SdkPayload*>(object1.payload_)->uaVariant
+                        < static_cast<const Variant::SdkPayload*>(object2.payload_)->uaVariant;
+            }
+            case Variant::NativeStorage:
+            {
+                if (object1.type_ != object2.type_)
+                    return object1.type_ < object2.type_;
+                else if (object1.arrayType_ != object2.arrayType_)
+                    return object1.arrayType_ < object2.arrayType_;
+
+                switch (object1.type_)
+                {
+                    case opcuatypes::NodeId:
+                        return    object1.nativeValues<NodeId>()
+                                < object2.nativeValues<NodeId>();
+                    case opcuatypes::Guid:
+                        return    object1.nativeValues<Guid>()
+                                < object2.nativeValues<Guid>();
+                    case opcuatypes::ExpandedNodeId:
+                        return    object1.nativeValues<ExpandedNodeId>()
+                                < object2.nativeValues<ExpandedNodeId>();
+                    case opcuatypes::QualifiedName:
+                        return    object1.nativeValues<QualifiedName>()
+                                < object2.nativeValues<QualifiedName>();
+                    default:
+                        // ExtensionObjects cannot be compared
+                        return false;
+                }
+            }
+            default:
+                return false;
+        }
     }
 
 
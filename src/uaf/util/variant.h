@@ -60,6 +60,11 @@ namespace uaf
     * A variant can hold primitive types and some OPC UA related non-primitive types (such as a
     * NodeId).
     *
+    * Scalar numbers, booleans and DateTimes are stored inline (without any heap allocation).
+    * All other values are stored in a single heap-allocated payload: either an SDK UaVariant, or
+    * a vector of native UAF instances (for the types that support namespace URIs and/or server
+    * URIs, such as NodeIds).
+    *
     * @ingroup Util
     ***********************************************************************************************/
     class UAF_EXPORT Variant
@@ -79,6 +84,38 @@ namespace uaf
         Variant(const OpcUa_Variant &variant);
 
 
+        /**
+         * Construct a copy of another variant.
+         */
+        Variant(const Variant& other);
+
+
+        /**
+         * Copy another variant.
+         */
+        Variant& operator=(const Variant& other);
+
+
+#ifndef SWIG
+        /**
+         * Construct a variant by moving the contents of another variant (which becomes NULL).
+         */
+        Variant(Variant&& other);
+
+
+        /**
+         * Move the contents of another variant (which becomes NULL) to this variant.
+         */
+        Variant& operator=(Variant&& other);
+#endif
+
+
+        /**
+         * Destruct the variant.
+         */
+        ~Variant();
+
+
         /**
          * Clear the variant.
          */
@@ -90,7 +127,7 @@ namespace uaf
          *
          * @return  True if empty.
          */
-        bool isNull() const { return (!isNativeUaf_) && ((bool)(uaVariant_.isEmpty())); }
+        bool isNull() const;
 
 
         /**
@@ -185,12 +222,7 @@ namespace uaf
          * @param data The data.
          * @param length Lenght of the data.
          */
-        void setByteString(uint8_t* data, int32_t length)
-        {
-            clear();
-            UaByteString byteString(length, data);
-            uaVariant_.setByteString(byteString, OpcUa_True);
-        }
+        void setByteString(uint8_t* data, int32_t length);
 
 
         /**
@@ -210,13 +242,21 @@ namespace uaf
 
 
         /**
-         * Update the internal UaVariant SDK object.
+         * Update the variant from a UaVariant SDK object.
          *
          * @param uaVariant SDK object to copy the contents from.
          */
         void fromSdk(const UaVariant& uaVariant);
 
 
+        /**
+         * Update the variant directly from an OpcUa_Variant stack object.
+         *
+         * @param variant   Stack object to copy the contents from.
+         */
+        void fromSdk(const OpcUa_Variant& variant);
+
+
         /**
          * Get a UTF-8 encoded string representation of the variant.
          *
@@ -260,22 +300,70 @@ namespace uaf
 
     private:
 
-        // internal SDK object - used for everything but the ones hereafter
-        UaVariant uaVariant_;
-
-        // variant types that must be stored as a native UAF instance
-        // (because these support namespace URIs and/or server URIs instead of only
-        //  namespace IDs and/or server IDs)
-        // We store them as vectors, so that they can also represent array types if necessary.
-        std::vector<uaf::NodeId> nodeId_;
-        std::vector<uaf::Guid> guid_;
-        std::vector<uaf::ExpandedNodeId> expandedNodeId_;
-        std::vector<uaf::QualifiedName> qualifiedName_;
-        std::vector<uaf::ExtensionObject> extensionObject_;
-
-        bool isNativeUaf_;
-        uaf::opcuatypes::OpcUaType dataTypeIfNativeUaf_;
-        OpcUa_Byte arrayTypeIfNativeUaf_;
+        // the kind of storage that is currently in use
+        enum Storage
+        {
+            NullStorage,    // the variant is empty
+            InlineStorage,  // a scalar number, boolean or DateTime, stored in scalar_
+            SdkStorage,     // any other value, stored in an SDK UaVariant (an SdkPayload)
+            NativeStorage   // a (vector of) native UAF instance(s) (a NativePayload)
+        };
+
+        // the heap-allocated payloads (the variant owns at most one of them)
+        struct Payload;
+        struct SdkPayload;
+        template <typename _T> struct NativePayload;
+
+        // the inline storage (the member names correspond to the OpcUa_Variant union members)
+        union Scalar
+        {
+            OpcUa_Boolean   Boolean;
+            OpcUa_SByte     SByte;
+            OpcUa_Byte      Byte;
+            OpcUa_Int16     Int16;
+            OpcUa_UInt16    UInt16;
+            OpcUa_Int32     Int32;
+            OpcUa_UInt32    UInt32;
+            OpcUa_Int64     Int64;
+            OpcUa_UInt64    UInt64;
+            OpcUa_Float     Float;
+            OpcUa_Double    Double;
+            OpcUa_DateTime  DateTime;
+        };
+
+        // the kind of storage that is currently in use
+        Storage storage_;
+
+        // the type of the value, in case of InlineStorage or NativeStorage
+        uaf::opcuatypes::OpcUaType type_;
+
+        // the array type of the value, in case of NativeStorage
+        OpcUa_Byte arrayType_;
+
+        // the value, in case of InlineStorage
+        Scalar scalar_;
+
+        // the heap-allocated value, in case of SdkStorage or NativeStorage (otherwise NULL)
+        Payload* payload_;
+
+
+        // store a scalar inline
+        void setInline(uaf::opcuatypes::OpcUaType type);
+
+        // get a (cleared) UaVariant to store a value in (switching to SdkStorage if needed)
+        UaVariant& sdkVariant();
+
+        // get a (cleared) vector to store native UAF instances in (switching to NativeStorage)
+        template <typename _T>
+        std::vector<_T>& nativeValues(uaf::opcuatypes::OpcUaType type, OpcUa_Byte arrayType);
+
+        // get the native UAF instances in case of NativeStorage
+        template <typename _T>
+        const std::vector<_T>& nativeValues() const;
+
+        // get the UaVariant in case of SdkStorage, or otherwise convert the variant to the given
+        // temporary UaVariant
+        const UaVariant& asSdk(UaVariant& temporary) const;
 
 
         /**
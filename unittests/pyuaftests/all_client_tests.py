@@ -27,6 +27,7 @@ ALL_MODULES = [ "client_client",
                 "client_subscriptionstatus",
                 "client_keepalive",
                 "client_setmonitoringmode",
+                "client_registernodes",
                 "client_kwargs",
                 "client_structures",
                 "subscriptioninformation",
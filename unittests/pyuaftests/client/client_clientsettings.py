@@ -1,6 +1,12 @@
 import pyuaf
+import os
+import shutil
+import tempfile
+import threading
+import time
 import unittest
 from pyuaf.util.unittesting import parseArgs
+from pyuaf.util import Address, ExpandedNodeId, RelativePathElement, QualifiedName
 
 
 ARGS = parseArgs()
@@ -14,6 +20,17 @@ def suite(args=None):
     return unittest.TestLoader().loadTestsFromTestCase(ClientSettingsTest)
 
 
+class BlockingClient(pyuaf.client.Client):
+    """A client of which the data change notifications block until they are released."""
+    
+    def __init__(self, settings):
+        pyuaf.client.Client.__init__(self, settings)
+        self.release = threading.Event()
+    
+    def dataChangesReceived(self, notifications):
+        self.release.wait()
+
+
 class ClientSettingsTest(unittest.TestCase):
     
     def setUp(self):
@@ -32,6 +49,41 @@ class ClientSettingsTest(unittest.TestCase):
         
         self.cs1.applicationName = "c1"
         self.cs2.applicationName = "c2"
+        
+        # the temporary directory of the test (if any), which is removed by tearDown()
+        self.tempDir = None
+    
+    def tearDown(self):
+        # delete the client instances manually (now!) instead of letting them be garbage collected
+        # automatically (which may happen during a another test, and which may cause logging output
+        # of the destruction to be mixed with the logging output of the other test).
+        del self.c0
+        del self.c1
+        del self.c2
+        
+        if self.tempDir is not None:
+            shutil.rmtree(self.tempDir, ignore_errors=True)
+    
+    def demoSettings(self):
+        settings = pyuaf.client.settings.ClientSettings()
+        settings.discoveryUrls.append(ARGS.demo_url)
+        settings.applicationName = "client"
+        settings.logToStdOutLevel = ARGS.loglevel
+        return settings
+    
+    def demoAddresses(self):
+        # the scalar variables of the demo server (more than the 16 shards of the address cache)
+        demoNsUri = ARGS.demo_ns_uri
+        address_Demo = Address(ExpandedNodeId("Demo", demoNsUri, ARGS.demo_server_uri))
+        names = ["Boolean", "Byte", "DateTime", "Double", "Float", "Int16", "Int32", "Int64",
+                 "SByte", "String", "UInt16", "UInt32", "UInt64"]
+        addresses = []
+        for folder in ["Static", "Dynamic"]:
+            for name in names:
+                addresses.append(Address(address_Demo, [RelativePathElement(QualifiedName(folder, demoNsUri)),
+                                                        RelativePathElement(QualifiedName("Scalar", demoNsUri)),
+                                                        RelativePathElement(QualifiedName(name, demoNsUri))]))
+        return addresses
     
     def test_client_Client_clientSettings(self):
         self.assertEqual( self.c0.clientSettings() , self.cs0 )
@@ -55,13 +107,234 @@ class ClientSettingsTest(unittest.TestCase):
         self.assertEqual( self.c1.clientSettings() , cs1_ )
         self.assertEqual( self.c2.clientSettings() , cs2_ )
     
-    def tearDown(self):
-        # delete the client instances manually (now!) instead of letting them be garbage collected 
-        # automatically (which may happen during a another test, and which may cause logging output
-        # of the destruction to be mixed with the logging output of the other test).
-        del self.c0
-        del self.c1
-        del self.c2
+    def test_client_ClientSettings_defaultsAndRoundTrip(self):
+        self.tempDir = tempfile.mkdtemp()
+        
+        # (attribute, default value, other value)
+        table = [ ("parallelInvocationsEnable"         , False  , True ),
+                  ("parallelInvocationsMaxSessions"    , 8      , 3    ),
+                  ("addressCacheMaxSize"               , 100000 , 10   ),
+                  ("addressCacheNegativeTtlSec"        , 10.0   , 0.0  ),
+                  ("addressCacheSnapshotPath"          , ""     , os.path.join(self.tempDir, "addresscache.snapshot") ),
+                  ("addressCacheAutosaveIntervalSec"   , 300.0  , 0.0  ),
+                  ("discoveryEndpointsCacheTimeoutSec" , 60.0   , 0.0  ),
+                  ("persistedRequestsRetryMinSec"      , 1.0    , 0.5  ),
+                  ("persistedRequestsRetryMaxSec"      , 60.0   , 10.0 ),
+                  ("notificationQueueEnable"           , False  , True ),
+                  ("notificationQueueSize"             , 1024   , 16   ),
+                  ("notificationDispatcherThreads"     , 2      , 4    ),
+                  ("latestValueCacheEnable"            , False  , True ),
+                  ("subscriptionMaxMonitoredItems"     , 0      , 1000 ),
+                  ("logAsynchronously"                 , False  , True ),
+                  ("logBufferSize"                     , 1024   , 16   ),
+                  ("logOverflowPolicy"                 , pyuaf.util.logoverflowpolicies.Drop,
+                                                         pyuaf.util.logoverflowpolicies.Block ) ]
+        
+        for (attribute, default, other) in table:
+            with self.subTest(attribute=attribute):
+                if isinstance(default, float):
+                    self.assertAlmostEqual( getattr(self.cs0, attribute) , default )
+                else:
+                    self.assertEqual( getattr(self.cs0, attribute) , default )
+                
+                cs_ = pyuaf.client.settings.ClientSettings()
+                setattr(cs_, attribute, other)
+                self.assertNotEqual( cs_ , self.cs0 )
+                
+                self.c0.setClientSettings(cs_)
+                self.assertEqual( self.c0.clientSettings() , cs_ )
+        
+        # a client that has done nothing yet, has no statistics yet
+        self.assertEqual( self.c0.noOfAddressCacheEvictions() , 0 )
+        self.assertEqual( self.c0.notificationQueueDepth() , 0 )
+        self.assertEqual( self.c0.maxNotificationQueueDepth() , 0 )
+        self.assertEqual( self.c0.noOfDroppedNotifications() , 0 )
+    
+    def test_client_ClientSettings_addressCacheAutosaveIntervalSec(self):
+        # the snapshot is saved periodically by the background timer wheel
+        self.tempDir = tempfile.mkdtemp()
+        path = os.path.join(self.tempDir, "addresscache.snapshot")
+        
+        cs_ = pyuaf.client.settings.ClientSettings()
+        cs_.addressCacheSnapshotPath = path
+        cs_.addressCacheAutosaveIntervalSec = 0.2
+        self.c0.setClientSettings(cs_)
+        
+        t_timeout = time.time() + 5.0
+        while time.time() < t_timeout and not os.path.exists(path):
+            time.sleep(0.01)
+        
+        self.assertTrue( os.path.exists(path) )
+    
+    def test_client_ClientSettings_addressCacheSnapshotPath(self):
+        self.tempDir = tempfile.mkdtemp()
+        path = os.path.join(self.tempDir, "addresscache.snapshot")
+        
+        # the snapshot doesn't exist yet, which is fine
+        cs_ = pyuaf.client.settings.ClientSettings()
+        cs_.addressCacheSnapshotPath = path
+        cs_.addressCacheAutosaveIntervalSec = 0.0
+        self.c0.setClientSettings(cs_)
+        
+        self.c0.saveAddressCacheSnapshot(path)
+        self.assertTrue( os.path.exists(path) )
+        self.c0.loadAddressCacheSnapshot(path)
+        
+        self.assertRaises(pyuaf.util.errors.PathNotExistsError,
+                          self.c0.loadAddressCacheSnapshot, path + ".missing")
+        
+        f = open(path, "wb")
+        f.write(b"not a snapshot")
+        f.close()
+        self.assertRaises(pyuaf.util.errors.UnexpectedError,
+                          self.c0.loadAddressCacheSnapshot, path)
+    
+    def test_client_ClientSettings_addressCacheSnapshot_reload(self):
+        self.tempDir = tempfile.mkdtemp()
+        path = os.path.join(self.tempDir, "addresscache.snapshot")
+        addresses = self.demoAddresses()[:3]
+        
+        # resolve the addresses with one client, and save them
+        client = pyuaf.client.Client(self.demoSettings())
+        client.read(addresses)
+        client.saveAddressCacheSnapshot(path)
+        del client
+        
+        # another client resolves them from the snapshot, once it has connected to the server
+        # (and has verified that the NamespaceArray of the server is still the same)
+        client = pyuaf.client.Client(self.demoSettings())
+        client.loadAddressCacheSnapshot(path)
+        client.manuallyConnect(ARGS.demo_server_uri)
+        
+        misses = client.noOfAddressCacheMisses()
+        hits   = client.noOfAddressCacheHits()
+        
+        result = client.read(addresses)
+        
+        self.assertTrue( result.overallStatus.isGood() )
+        self.assertEqual( client.noOfAddressCacheMisses() , misses )
+        self.assertGreaterEqual( client.noOfAddressCacheHits() - hits , len(addresses) )
+        del client
+    
+    def test_client_ClientSettings_addressCacheMaxSize_evictions(self):
+        settings = self.demoSettings()
+        settings.addressCacheMaxSize = 1
+        client = pyuaf.client.Client(settings)
+        addresses = self.demoAddresses()
+        
+        # the second read of an address is a hit (since it was used most recently)
+        client.read([addresses[0]])
+        hits = client.noOfAddressCacheHits()
+        client.read([addresses[0]])
+        self.assertGreater( client.noOfAddressCacheHits() , hits )
+        self.assertEqual( client.noOfAddressCacheEvictions() , 0 )
+        
+        # the cache can't hold more addresses than it has shards (16), so reading more addresses
+        # evicts the least recently used ones
+        misses = client.noOfAddressCacheMisses()
+        client.read(addresses[1:])
+        self.assertGreaterEqual( client.noOfAddressCacheMisses() - misses , len(addresses) - 1 )
+        self.assertGreater( client.noOfAddressCacheEvictions() , 0 )
+        del client
+    
+    def test_client_ClientSettings_notificationQueueSize_overflow(self):
+        settings = self.demoSettings()
+        settings.notificationQueueEnable = True
+        settings.notificationQueueSize = 2
+        settings.notificationDispatcherThreads = 1
+        client = BlockingClient(settings)
+        
+        subscriptionSettings = pyuaf.client.settings.SubscriptionSettings()
+        subscriptionSettings.publishingIntervalSec = 0.05
+        
+        address_Demo = Address(ExpandedNodeId("Demo", ARGS.demo_ns_uri, ARGS.demo_server_uri))
+        client.call(address_Demo, Address(address_Demo, [RelativePathElement(QualifiedName("StartSimulation", ARGS.demo_ns_uri))]))
+        
+        try:
+            # the dispatcher thread blocks on the first batch, so the queue fills up
+            client.createMonitoredData(self.demoAddresses()[:3],
+                                       subscriptionSettings=subscriptionSettings)
+            
+            t_timeout = time.time() + 10.0
+            while time.time() < t_timeout and client.noOfDroppedNotifications() == 0:
+                time.sleep(0.01)
+            
+            self.assertGreater( client.noOfDroppedNotifications() , 0 )
+            self.assertGreater( client.maxNotificationQueueDepth() , 0 )
+        finally:
+            client.release.set()
+            client.call(address_Demo, Address(address_Demo, [RelativePathElement(QualifiedName("StopSimulation", ARGS.demo_ns_uri))]))
+        
+        # once the callbacks don't block anymore, the queue is emptied
+        t_timeout = time.time() + 5.0
+        while time.time() < t_timeout and client.notificationQueueDepth() > 0:
+            time.sleep(0.01)
+        
+        self.assertEqual( client.notificationQueueDepth() , 0 )
+        del client
+    
+    def test_client_ClientSettings_logOverflowPolicy_block(self):
+        received = []
+        
+        cs_ = pyuaf.client.settings.ClientSettings()
+        cs_.logToCallbackLevel = pyuaf.util.loglevels.Debug
+        cs_.logAsynchronously = True
+        cs_.logBufferSize = 16
+        cs_.logOverflowPolicy = pyuaf.util.logoverflowpolicies.Block
+        
+        self.c0.registerLoggingCallback(received.append)
+        self.c0.setClientSettings(cs_)
+        
+        # log a bunch of messages (more than the buffer can hold), and switch back to synchronous
+        # logging, which makes sure all pending messages have been received
+        for i in range(100):
+            self.c0.setClientSettings(cs_)
+        cs_.logAsynchronously = False
+        self.c0.setClientSettings(cs_)
+        
+        # since the producers are blocked instead of dropping messages, none were lost
+        self.assertGreater( len(received) , 100 )
+        self.assertEqual( self.c0.noOfDroppedLogMessages() , 0 )
+    
+    def test_client_ClientSettings_persistedRequestsRetry_backoff(self):
+        # log the retries of the persisted requests
+        messages = []
+        lock = threading.Lock()
+        def loggingCallback(msg):
+            lock.acquire()
+            messages.append((time.time(), msg.message))
+            lock.release()
+        
+        cs_ = pyuaf.client.settings.ClientSettings()
+        cs_.logToCallbackLevel = pyuaf.util.loglevels.Debug
+        cs_.persistedRequestsRetryMinSec = 0.1
+        cs_.persistedRequestsRetryMaxSec = 0.4
+        
+        self.c0.registerLoggingCallback(loggingCallback)
+        self.c0.setClientSettings(cs_)
+        
+        # the monitored item of an unknown server can't be created, so it's retried in the
+        # background
+        address = Address(ExpandedNodeId("SomeNode", "urn:some:namespace", "urn:unknown:server"))
+        try:
+            self.c0.createMonitoredData([address])
+        except pyuaf.util.errors.UafError:
+            pass
+        
+        time.sleep(3.0)
+        
+        lock.acquire()
+        retries = [t for (t, m) in messages if "persistent requests need to be re-processed" in m]
+        lock.release()
+        
+        # without a backoff, there would be about 30 retries (one per 0.1 seconds), with the
+        # backoff the delays grow from 0.1 to 0.4 seconds, so there are about 9 of them
+        self.assertGreaterEqual( len(retries) , 3 )
+        self.assertLessEqual( len(retries) , 15 )
+        
+        # the delays never exceed the maximum (plus the tick of the timer wheel and some slack)
+        for i in range(1, len(retries)):
+            self.assertLess( retries[i] - retries[i-1] , 0.4 + 0.5 )
 
 
 if __name__ == '__main__':
@@ -24,14 +24,17 @@ def suite(args=None):
 
 class MyClient(pyuaf.client.Client):
 
-    def __init__(self, settings):
-        pyuaf.client.Client.__init__(self, settings)
+    def __init__(self, settings, **kwargs):
+        pyuaf.client.Client.__init__(self, settings, **kwargs)
         self.noOfSuccessFullyReceivedNotifications = 0
+        self.receivedClientHandles = set()
         self.lock = threading.Lock()
 
     def dataChangesReceived(self, notifications):
         self.lock.acquire()
         self.noOfSuccessFullyReceivedNotifications += len(notifications)
+        for notification in notifications:
+            self.receivedClientHandles.add(notification.clientHandle)
         self.lock.release()
 
 
@@ -108,6 +111,97 @@ class ClientMonitorDataTest(unittest.TestCase):
         self.assertGreaterEqual( t.noOfSuccessFullyReceivedNotifications , 2 )
 
 
+    def test_client_Client_createMonitoredData_with_ordered_callbacks(self):
+        settings = self.client.clientSettings()
+        client = MyClient(settings, notificationThreads=2, orderedNotifications=True)
+
+        t = TestClass()
+
+        client.createMonitoredData([self.address_Byte, self.address_Int32, self.address_Float],
+                                   notificationCallbacks=[t.myCallback, t.myCallback, t.myCallback])
+
+        # after a few seconds we should AT LEAST have received 2 notifications
+        t_timeout = time.time() + 5.0
+        while time.time() < t_timeout and t.noOfSuccessFullyReceivedNotifications < 2:
+            time.sleep(0.01)
+
+        self.assertGreaterEqual( t.noOfSuccessFullyReceivedNotifications , 2 )
+
+        del client
+
+
+    def test_client_Client_readCached(self):
+        settings = self.client.clientSettings()
+        settings.latestValueCacheEnable = True
+        self.client.setClientSettings(settings)
+
+        addresses = [self.address_Byte, self.address_Int32, self.address_Float]
+        createResult = self.client.createMonitoredData(addresses)
+        clientHandles = set([target.clientHandle for target in createResult.targets])
+
+        # wait until the values of all monitored items are in the cache
+        t_timeout = time.time() + 5.0
+        while time.time() < t_timeout and not clientHandles <= self.client.receivedClientHandles:
+            time.sleep(0.01)
+
+        self.assertTrue( clientHandles <= self.client.receivedClientHandles )
+
+        # the cached values are returned, without reading them from the server
+        result = self.client.readCached(addresses, 60.0)
+        self.assertTrue( result.overallStatus.isGood() )
+        self.assertEqual( len(result.targets) , 3 )
+        self.assertEqual( result.requestHandle , pyuaf.util.constants.REQUESTHANDLE_NOT_ASSIGNED )
+
+        # values that are too old are read from the server
+        result = self.client.readCached(addresses, 0.0)
+        self.assertTrue( result.overallStatus.isGood() )
+        self.assertEqual( len(result.targets) , 3 )
+        self.assertNotEqual( result.requestHandle , pyuaf.util.constants.REQUESTHANDLE_NOT_ASSIGNED )
+
+        # the cached values are only used if they were received by the given session
+        clientConnectionId = self.client.readCached(addresses, 60.0).targets[0].clientConnectionId
+        result = self.client.readCached(addresses, 60.0, clientConnectionId=clientConnectionId)
+        self.assertEqual( result.requestHandle , pyuaf.util.constants.REQUESTHANDLE_NOT_ASSIGNED )
+
+        otherSessionSettings = pyuaf.client.settings.SessionSettings()
+        otherSessionSettings.sessionTimeoutSec = 12.345
+        otherClientConnectionId = self.client.manuallyConnect(ARGS.demo_server_uri, otherSessionSettings)
+        self.assertNotEqual( otherClientConnectionId , clientConnectionId )
+
+        result = self.client.readCached(addresses, 60.0, clientConnectionId=otherClientConnectionId)
+        self.assertTrue( result.overallStatus.isGood() )
+        self.assertNotEqual( result.requestHandle , pyuaf.util.constants.REQUESTHANDLE_NOT_ASSIGNED )
+        for target in result.targets:
+            self.assertEqual( target.clientConnectionId , otherClientConnectionId )
+
+
+    def test_client_Client_createMonitoredData_partitioned(self):
+        settings = self.client.clientSettings()
+        settings.subscriptionMaxMonitoredItems = 2
+        self.client.setClientSettings(settings)
+
+        result = self.client.createMonitoredData([self.address_Byte, self.address_Int32, self.address_Float])
+        self.assertTrue( result.overallStatus.isGood() )
+
+        # the monitored items are spread over 2 subscriptions
+        self.assertEqual( len(self.client.allSubscriptionInformations()) , 2 )
+        self.assertEqual( result.targets[0].clientSubscriptionHandle ,
+                          result.targets[1].clientSubscriptionHandle )
+        self.assertNotEqual( result.targets[0].clientSubscriptionHandle ,
+                             result.targets[2].clientSubscriptionHandle )
+
+        for target in result.targets:
+            info = self.client.monitoredItemInformation(target.clientHandle)
+            self.assertEqual( info.clientSubscriptionHandle , target.clientSubscriptionHandle )
+
+        # the notifications of all subscriptions are received
+        t_timeout = time.time() + 5.0
+        while time.time() < t_timeout and self.client.noOfSuccessFullyReceivedNotifications < 3:
+            time.sleep(0.01)
+
+        self.assertGreaterEqual( self.client.noOfSuccessFullyReceivedNotifications , 3 )
+
+
     def tearDown(self):
         # stop the simulation
         self.client.call(self.address_Demo, self.address_StopSimulation)
@@ -0,0 +1,83 @@
+import pyuaf
+import unittest
+from pyuaf.util.unittesting import parseArgs
+
+from pyuaf.util import Address, ExpandedNodeId, RelativePathElement, QualifiedName
+from pyuaf.util.primitives import Int32
+
+
+
+ARGS = parseArgs()
+
+
+def suite(args=None):
+    if args is not None:
+        global ARGS
+        ARGS = args
+
+    return unittest.TestLoader().loadTestsFromTestCase(ClientRegisterNodesTest)
+
+
+class ClientRegisterNodesTest(unittest.TestCase):
+
+
+    def setUp(self):
+
+        # create a new ClientSettings instance and add the localhost to the URLs to discover
+        settings = pyuaf.client.settings.ClientSettings()
+        settings.discoveryUrls.append(ARGS.demo_url)
+        settings.applicationName = "client"
+        settings.logToStdOutLevel = ARGS.loglevel
+
+        self.client = pyuaf.client.Client(settings)
+
+        serverUri = ARGS.demo_server_uri
+        demoNsUri = ARGS.demo_ns_uri
+
+        # define some addresses
+        self.address0 = Address(ExpandedNodeId("Demo.SimulationSpeed", demoNsUri, serverUri))
+        self.address1 = Address(ExpandedNodeId("Demo.SimulationActive", demoNsUri, serverUri))
+        self.address2 = Address(Address(ExpandedNodeId("Demo.Static.Scalar", demoNsUri, serverUri)),
+                                [RelativePathElement(QualifiedName("Int32", demoNsUri))])
+
+    def test_client_Client_registerNodes(self):
+        statuses = self.client.registerNodes([self.address0, self.address1])
+        self.assertEqual( len(statuses) , 2 )
+        self.assertTrue( statuses[0].isGood() )
+        self.assertTrue( statuses[1].isGood() )
+
+    def test_client_Client_read_registered_nodes(self):
+        self.client.registerNodes([self.address0, self.address1])
+        result = self.client.read([self.address0, self.address1])
+        self.assertTrue( result.overallStatus.isGood() )
+        self.assertTrue( result.targets[0].status.isGood() )
+        self.assertTrue( result.targets[1].status.isGood() )
+
+    def test_client_Client_write_registered_node(self):
+        self.client.registerNodes(self.address2)
+        result = self.client.write([self.address2], [Int32(-123)])
+        self.assertTrue( result.overallStatus.isGood() )
+        result = self.client.read(self.address2)
+        self.assertEqual( result.targets[0].data.value , -123 )
+
+    def test_client_Client_unregisterNodes(self):
+        self.client.registerNodes([self.address0])
+        statuses = self.client.unregisterNodes([self.address0])
+        self.assertTrue( statuses[0].isGood() )
+
+        # the original NodeId must be used again
+        result = self.client.read(self.address0)
+        self.assertTrue( result.targets[0].status.isGood() )
+
+    def test_client_Client_unregisterNodes_of_unregistered_node(self):
+        self.assertRaises(pyuaf.util.errors.UafError, self.client.unregisterNodes, [self.address1])
+
+    def tearDown(self):
+        # delete the client instances manually (now!) instead of letting them be garbage collected
+        # automatically (which may happen during a another test, and which may cause logging output
+        # of the destruction to be mixed with the logging output of the other test).
+        del self.client
+
+
+if __name__ == '__main__':
+    unittest.TextTestRunner(verbosity = ARGS.verbosity).run(suite())
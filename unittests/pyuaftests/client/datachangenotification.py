@@ -24,6 +24,8 @@ class DataChangeNotificationTest(unittest.TestCase):
         self.notif1.clientHandle = 123
         self.notif1.data = pyuaf.util.primitives.UInt16(456)
         self.notif1.status = pyuaf.util.Status(pyuaf.util.errors.NoTargetsGivenError())
+        self.notif1.sourceTimestamp = pyuaf.util.DateTime.fromString("2013-05-01T12:34:56.789Z")
+        self.notif1.serverPicoseconds = 12
     
     def test_client_DataChangeNotification_clientHandle(self):
         self.assertEqual( self.notif1.clientHandle , 123 )
@@ -34,6 +36,13 @@ class DataChangeNotificationTest(unittest.TestCase):
     def test_client_DataChangeNotification_status(self):
         self.assertEqual( self.notif1.status , pyuaf.util.Status(pyuaf.util.errors.NoTargetsGivenError()) )
     
+    def test_client_DataChangeNotification_sourceTimestamp(self):
+        self.assertEqual( self.notif1.sourceTimestamp ,
+                          pyuaf.util.DateTime.fromString("2013-05-01T12:34:56.789Z") )
+    
+    def test_client_DataChangeNotification_serverPicoseconds(self):
+        self.assertEqual( self.notif1.serverPicoseconds , 12 )
+    
     def test_client_DataChangeNotificationVector(self):
         testVector(self, pyuaf.client.DataChangeNotificationVector, [self.notif0, self.notif1])
     
@@ -51,6 +51,45 @@ class MaskTest(unittest.TestCase):
         self.assertEqual( (self.m0 & self.m1) , logicalAndResult    )
         self.assertEqual( (self.m1 & self.m0) , (self.m0 & self.m1) )
     
+    def test_util_Mask___or__(self):
+        logicalOrResult = pyuaf.util.Mask(7, False)
+        logicalOrResult.set(0)
+        logicalOrResult.set(2)
+        logicalOrResult.set(3)
+        logicalOrResult.set(4)
+        self.assertEqual( (self.m0 | self.m1) , logicalOrResult     )
+        self.assertEqual( (self.m0 | self.m1).setCount() , 4        )
+        self.assertEqual( (self.m1 | self.m0) , (self.m0 | self.m1) )
+    
+    def test_util_Mask___or___differentSizes(self):
+        # the result has the size of the largest mask, also if the sizes differ in words
+        small = pyuaf.util.Mask(3, True)
+        large = pyuaf.util.Mask(100, False)
+        large.set(99)
+        self.assertEqual( (small | large).size() , 100 )
+        self.assertEqual( (large | small).size() , 100 )
+        self.assertEqual( (small | large).setCount() , 4 )
+        self.assertEqual( (small | large).nextSet(3) , 99 )
+        self.assertEqual( (small | large) , (large | small) )
+    
+    def test_util_Mask_nextSet(self):
+        self.assertEqual( self.m0.nextSet(0) , 0 )
+        self.assertEqual( self.m0.nextSet(1) , 3 )
+        self.assertEqual( self.m1.nextSet(4) , self.m1.size() )
+    
+    def test_util_Mask_nextUnset(self):
+        self.assertEqual( self.m0.nextUnset(0) , 1 )
+        self.assertEqual( self.m0.nextUnset(3) , self.m0.size() )
+    
+    def test_util_Mask_largeMask(self):
+        m = pyuaf.util.Mask(1000, False)
+        m.set(70)
+        m.set(999)
+        self.assertEqual( m.setCount() , 2 )
+        self.assertEqual( m.nextSet(71) , 999 )
+        m.resize(500)
+        self.assertEqual( m.setCount() , 1 )
+    
 
 
 if __name__ == '__main__':
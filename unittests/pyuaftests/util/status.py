@@ -61,6 +61,40 @@ class StatusTest(unittest.TestCase):
         self.assertEqual( self.s3.statusCode , pyuaf.util.statuscodes.UnexpectedError )
         self.assertEqual( self.s5.statusCode , pyuaf.util.statuscodes.FindServersError )
     
+    def test_util_Status_raisedBy_error(self):
+        self.assertEqual( self.s3.raisedBy_UnexpectedError.message , "Some connection error" )
+        self.assertEqual( self.s3.toString() , "Some connection error" )
+        self.assertEqual( self.s5.raisedBy_UnexpectedError.message , "Unexpected error" )
+        
+        s3 = pyuaf.util.Status(self.s3)
+        s3.raisedBy_UnexpectedError.message = "Another connection error"
+        self.assertEqual( s3.toString() , "Another connection error" )
+        self.assertEqual( pyuaf.util.Status(s3).toString() , "Another connection error" )
+    
+    def test_util_Status_copy(self):
+        s3Copy = pyuaf.util.Status(self.s3)
+        self.assertTrue( s3Copy == self.s3 )
+        s5 = pyuaf.util.Status(self.s5)
+        s5.setRaisedBy(self.s3)
+        s5Copy = pyuaf.util.Status(s5)
+        self.assertTrue( s5Copy.isRaisedBy() )
+        self.assertEqual( s5Copy.raisedBy().toString() , "Some connection error" )
+    
+    def test_util_Status_size(self):
+        helper = pyuaf.util.__unittesthelper__.UnitTestHelper()
+        # a status code plus a single pointer to the details
+        self.assertTrue( helper.sizeOfStatus() <= 2 * helper.sizeOfPointer() )
+    
+    def test_util_Status_copy_without_details(self):
+        # copying a Good status (or a status created from a code only) must not allocate details
+        self.assertFalse( pyuaf.util.Status(self.s1).hasDetails() )
+        self.assertFalse( pyuaf.util.Status(self.s2).hasDetails() )
+        s3 = pyuaf.util.Status(self.s3)
+        self.assertTrue( s3.hasDetails() )
+        s3.setGood()
+        self.assertFalse( s3.hasDetails() )
+        self.assertFalse( pyuaf.util.Status(s3).hasDetails() )
+    
     def test_util_Status___eq__(self):
         self.assertTrue( self.s3 == self.s3_ )
     